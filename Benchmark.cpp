@@ -0,0 +1,948 @@
+// orel8155@gmail.com
+#include "squaremat.hpp"
+#include "pagealloc.hpp"
+#include "numa.hpp"
+#include "perfcounters.hpp"
+#include "coroutine.hpp"
+#include "modmat.hpp"
+#include "mixed.hpp"
+#include "matview.hpp"
+#include "bareiss.hpp"
+#include "factorization.hpp"
+#include "expm.hpp"
+#include "threadpool.hpp"
+#include "trace.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace squaremat;
+
+/**
+ * @file Benchmark.cpp
+ * @brief Micro-benchmarks for the SquareMat operators
+ *
+ * Every measurement reports wall-clock time together with the heap traffic it caused,
+ * counted by the replacement global operator new below, and the hardware counters of every
+ * thread of the process (the caller and the pool workers) when perf_event_open is permitted.
+ */
+
+namespace
+{
+    std::atomic<size_t> heapAllocations(0); ///< Calls to operator new since program start
+    std::atomic<size_t> heapBytes(0);       ///< Bytes requested from operator new since program start
+
+    /**
+     * @brief Result of one benchmark run
+     */
+    struct Measurement
+    {
+        double seconds;     ///< Wall-clock time of all repetitions
+        size_t allocations; ///< Heap allocations made during the run
+        size_t bytes;       ///< Heap bytes requested during the run
+        perf::Sample counters; ///< Hardware counters of the run (all invalid if not permitted)
+    };
+
+    /**
+     * @brief Hardware counters shared by every measurement, opened on first use
+     *
+     * The pool is started first so each worker gets its own descriptors and the
+     * per-element figures cover the work of the parallel kernels.
+     * @return The counter set
+     */
+    perf::Counters &hardwareCounters()
+    {
+        ThreadPool::instance();
+        static perf::Counters counters;
+        return counters;
+    }
+
+    /**
+     * @brief Run a callable repeatedly and record time and heap traffic
+     * @param repetitions Number of calls
+     * @param body Callable to measure
+     * @return Measurement of the run
+     */
+    Measurement measure(size_t repetitions, const std::function<void()> &body)
+    {
+        size_t allocationsBefore = heapAllocations.load();
+        size_t bytesBefore = heapBytes.load();
+        perf::Counters &counters = hardwareCounters();
+        auto start = std::chrono::steady_clock::now();
+        counters.start();
+        for (size_t r = 0; r < repetitions; r++)
+        {
+            body();
+        }
+        perf::Sample sample = counters.stop();
+        auto stop = std::chrono::steady_clock::now();
+        return {std::chrono::duration<double>(stop - start).count(), heapAllocations.load() - allocationsBefore, heapBytes.load() - bytesBefore, sample};
+    }
+
+    /**
+     * @brief Print one benchmark line, followed by a counter line when counters were read
+     * @param name Label of the benchmark
+     * @param repetitions Number of calls that were measured
+     * @param m Measurement to print
+     * @param elements Matrix elements one call processes (0 skips the per-element figures)
+     */
+    void report(const std::string &name, size_t repetitions, const Measurement &m, size_t elements = 0)
+    {
+        std::cout << std::left << std::setw(36) << name
+                  << std::right << std::setw(10) << std::fixed << std::setprecision(3) << m.seconds * 1e3 / repetitions << " ms/iter"
+                  << std::setw(12) << m.allocations / repetitions << " allocs/iter"
+                  << std::setw(14) << m.bytes / repetitions << " bytes/iter";
+        if (elements > 0)
+        {
+            std::cout << std::setw(10) << std::setprecision(2) << elements * repetitions / m.seconds / 1e6 << " Melem/s";
+        }
+        std::cout << std::endl;
+        bool printed = false;
+        if (m.counters.has(perf::Event::Cycles) && m.counters.has(perf::Event::Instructions))
+        {
+            std::cout << "  IPC " << std::setprecision(2) << m.counters.ipc();
+            printed = true;
+        }
+        double total = static_cast<double>(elements * repetitions);
+        for (perf::Event event : {perf::Event::L1Misses, perf::Event::LLCMisses, perf::Event::DTLBMisses, perf::Event::BranchMisses})
+        {
+            if (!m.counters.has(event))
+            {
+                continue;
+            }
+            std::cout << "  " << perf::eventName(event) << " ";
+            if (elements > 0)
+            {
+                std::cout << std::setprecision(4) << m.counters[event] / total << "/elem";
+            }
+            else
+            {
+                std::cout << m.counters[event] / repetitions << "/iter";
+            }
+            printed = true;
+        }
+        if (printed)
+        {
+            std::cout << std::endl;
+        }
+    }
+
+    /**
+     * @brief Fill a matrix with a deterministic, non-trivial pattern
+     * @param mat Matrix to fill
+     * @param seed Pattern offset
+     */
+    void fill(SquareMat &mat, size_t seed)
+    {
+        for (size_t i = 0; i < mat.getSize(); i++)
+        {
+            for (size_t j = 0; j < mat.getSize(); j++)
+            {
+                mat[i][j] = static_cast<double>((i * 31 + j * 17 + seed) % 13) + 1;
+            }
+        }
+    }
+
+    /**
+     * @brief Long chain of element-wise operators with and without a scoped arena
+     */
+    void benchmarkExpressionChain()
+    {
+        const size_t n = 64;
+        const size_t repetitions = 2000;
+        SquareMat a(n), b(n), c(n), d(n), out(n);
+        fill(a, 1);
+        fill(b, 2);
+        fill(c, 3);
+        fill(d, 4);
+
+        std::cout << "Expression chain ((a + b) * 2 - c) % d + ~a - d / 3, n = " << n << std::endl;
+        report("heap", repetitions, measure(repetitions, [&]() {
+                   out = ((a + b) * 2 - c) % d + ~a - d / 3;
+               }));
+        report("arena", repetitions, measure(repetitions, [&]() {
+                   SquareMat::Arena arena(8 * ((n * n + n) * sizeof(double) + 64)); // Room for the eight temporaries
+                   out = ((a + b) * 2 - c) % d + ~a - d / 3;
+               }));
+        std::cout << std::endl;
+    }
+
+    /**
+     * @brief Large multiply and transpose with matrices on small pages and on huge pages
+     *
+     * The difference comes from TLB reach: column walks in operator* and operator~ touch a new
+     * 4 KB page on almost every access, but stay within a few 2 MB pages.
+     */
+    void benchmarkHugePages()
+    {
+        HugePageResource &pages = HugePageResource::instance();
+        size_t threshold = pages.getThreshold();
+        const size_t multiplySize = 768;
+        const size_t transposeSize = 2048;
+
+        std::cout << "Huge pages: multiply n = " << multiplySize << ", transpose n = " << transposeSize << std::endl;
+        for (bool huge : {false, true})
+        {
+            pages.setThreshold(huge ? HugePageResource::HugePageSize : SIZE_MAX);
+            SquareMat a(multiplySize), b(multiplySize), product(multiplySize);
+            fill(a, 1);
+            fill(b, 2);
+            SquareMat big(transposeSize), transposed(transposeSize);
+            fill(big, 3);
+            std::string label = huge ? "huge pages" : "small pages";
+            report("multiply, " + label, 3, measure(3, [&]() {
+                       product = a * b;
+                   }), multiplySize * multiplySize);
+            report("transpose, " + label, 5, measure(5, [&]() {
+                       transposed = ~big;
+                   }), transposeSize * transposeSize);
+            std::cout << "  mapped on huge pages: " << pages.hugePageBytes() / 1024 << " kB, resident per kernel: "
+                      << HugePageResource::residentHugePageBytes() / 1024 << " kB" << std::endl;
+        }
+        pages.setThreshold(threshold);
+        std::cout << std::endl;
+    }
+
+    /**
+     * @brief Multiply, transpose and determinant with the hardware counters they cause
+     *
+     * The per-element miss rates show where the column walks of operator* and operator~
+     * leave the caches and the TLB; the determinant shows the branchy cofactor expansion.
+     */
+    void benchmarkHardwareCounters()
+    {
+        std::cout << "Hardware counters (" << (hardwareCounters().available() ? "perf_event_open" : "not permitted, timing only") << ")" << std::endl;
+        for (size_t n : {128, 512})
+        {
+            SquareMat a(n), b(n), out(n);
+            fill(a, 1);
+            fill(b, 2);
+            std::string size = ", n = " + std::to_string(n);
+            report("a * b" + size, 3, measure(3, [&]() {
+                       out = a * b;
+                   }), n * n);
+            report("~a" + size, 10, measure(10, [&]() {
+                       out = ~a;
+                   }), n * n);
+        }
+        const size_t detSize = 8;
+        SquareMat small(detSize);
+        fill(small, 3);
+        volatile double sink = 0;
+        report("!a, n = " + std::to_string(detSize), 5, measure(5, [&]() {
+                   sink = !small;
+               }), detSize * detSize);
+        (void)sink;
+        std::cout << std::endl;
+    }
+
+    /**
+     * @brief One streaming pipeline as a coroutine: read, transform, multiply, write
+     * @param seed Pattern of the input matrix
+     * @param n Matrix size
+     * @param weights Right operand of the multiply
+     * @param out Slot for the written result
+     * @return Pipeline task
+     */
+    Task<void> coroutinePipeline(size_t seed, size_t n, const SquareMat &weights, double &out)
+    {
+        SquareMat input(n);
+        fill(input, seed);
+        auto transform = [input]() { return input * 0.5 + input % input; };
+        SquareMat transformed = co_await runAsync(transform);
+        SquareMat product = co_await multiplyAsync(transformed, weights);
+        out = product.sum();
+    }
+
+    /**
+     * @brief The same pipeline run synchronously on its own thread
+     * @param seed Pattern of the input matrix
+     * @param n Matrix size
+     * @param weights Right operand of the multiply
+     * @param out Slot for the written result
+     */
+    void blockingPipeline(size_t seed, size_t n, const SquareMat &weights, double &out)
+    {
+        SquareMat input(n);
+        fill(input, seed);
+        SquareMat transformed = input * 0.5 + input % input;
+        SquareMat product = transformed * weights;
+        out = product.sum();
+    }
+
+    /**
+     * @brief Many pipelines driven by one thread through coroutines versus one thread each
+     */
+    void benchmarkPipelines()
+    {
+        const size_t n = 96;
+        const size_t count = 32;
+        const size_t repetitions = 5;
+        SquareMat weights(n);
+        fill(weights, 7);
+        std::vector<double> results(count);
+        std::cout << "Pipelines read -> transform -> multiply -> write, n = " << n << ", pipelines = " << count << std::endl;
+        report("coroutines, one driving thread", repetitions, measure(repetitions, [&]() {
+                   std::vector<Task<void>> pipelines;
+                   for (size_t p = 0; p < count; p++)
+                   {
+                       pipelines.push_back(coroutinePipeline(p, n, weights, results[p]));
+                   }
+                   syncWaitAll(pipelines);
+               }), count * n * n);
+        report("thread per pipeline", repetitions, measure(repetitions, [&]() {
+                   std::vector<std::thread> threads;
+                   for (size_t p = 0; p < count; p++)
+                   {
+                       threads.emplace_back(blockingPipeline, p, n, std::cref(weights), std::ref(results[p]));
+                   }
+                   for (std::thread &t : threads)
+                   {
+                       t.join();
+                   }
+               }), count * n * n);
+        std::cout << std::endl;
+    }
+
+    /**
+     * @brief Accumulating a scaled product with operators versus in place
+     */
+    void benchmarkGemm()
+    {
+        std::cout << "Product accumulation C += alpha * A * B" << std::endl;
+        for (size_t n : {64, 256, 512})
+        {
+            const size_t repetitions = n <= 64 ? 200 : 3;
+            SquareMat a(n), b(n), c(n);
+            fill(a, 1);
+            fill(b, 2);
+            std::string size = ", n = " + std::to_string(n);
+            report("c += a * b * 0.5" + size, repetitions, measure(repetitions, [&]() {
+                       c += a * b * 0.5;
+                   }), n * n);
+            report("c.addProduct(a, b, 0.5)" + size, repetitions, measure(repetitions, [&]() {
+                       c.addProduct(a, b, 0.5);
+                   }), n * n);
+            report("gemm(0.5, a, b, 0.9, c)" + size, repetitions, measure(repetitions, [&]() {
+                       gemm(0.5, a, b, 0.9, c);
+                   }), n * n);
+        }
+        std::cout << std::endl;
+    }
+
+    /**
+     * @brief Scaled updates with operators versus the fused one-pass forms
+     */
+    void benchmarkFusedUpdates()
+    {
+        const size_t n = 2048;
+        const size_t repetitions = 10;
+        SquareMat a(n), b(n);
+        fill(a, 1);
+        fill(b, 2);
+        std::cout << "Scaled updates A += s * B, n = " << n << std::endl;
+        report("a += b * 0.5", repetitions, measure(repetitions, [&]() {
+                   a += b * 0.5;
+               }), n * n);
+        report("a.addScaled(b, 0.5)", repetitions, measure(repetitions, [&]() {
+                   a.addScaled(b, 0.5);
+               }), n * n);
+        report("a = a * 0.9 + b * 0.1", repetitions, measure(repetitions, [&]() {
+                   a = a * 0.9 + b * 0.1;
+               }), n * n);
+        report("a.scaleAndAdd(0.9, b, 0.1)", repetitions, measure(repetitions, [&]() {
+                   a.scaleAndAdd(0.9, b, 0.1);
+               }), n * n);
+        std::cout << std::endl;
+    }
+
+    /**
+     * @brief Read-only consumers that take a matrix by value, with deep copies versus shared storage
+     */
+    void benchmarkCopyOnWrite()
+    {
+        const size_t n = 1024;
+        const size_t repetitions = 50;
+        SquareMat values(n);
+        fill(values, 1);
+        SquareMat a(n);
+        a = values;
+        double checksum = 0;
+        auto consume = [&checksum](SquareMat m) {
+            const SquareMat &view = m;
+            checksum += view[0][0] + view[m.getSize() - 1][0];
+        };
+        std::cout << "Pass-by-value read-only consumers, n = " << n << std::endl;
+        report("consume(deep copy)", repetitions, measure(repetitions, [&]() {
+                   consume(SquareMat(a, std::pmr::new_delete_resource()));
+               }), n * n);
+        report("consume(a) (shared)", repetitions, measure(repetitions, [&]() {
+                   consume(a);
+               }));
+        report("copy, then write one element", repetitions, measure(repetitions, [&]() {
+                   SquareMat snapshot = a;
+                   snapshot[0][0] += 1;
+                   checksum += snapshot[0][0];
+               }), n * n);
+        std::cout << "checksum " << checksum << std::endl << std::endl;
+    }
+
+    /**
+     * @brief Cofactor expansion that packs every minor into a new matrix (the previous implementation)
+     * @param mat Matrix to expand
+     * @return Determinant
+     */
+    double copyingDeterminant(const SquareMat &mat)
+    {
+        size_t n = mat.getSize();
+        if (n == 1)
+        {
+            return mat[0][0];
+        }
+        if (n == 2)
+        {
+            return mat[0][0] * mat[1][1] - mat[0][1] * mat[1][0];
+        }
+        double det = 0;
+        for (size_t j = 0; j < n; j++)
+        {
+            SquareMat minor(n - 1);
+            for (size_t i = 1; i < n; i++)
+            {
+                for (size_t k = 0, c = 0; k < n; k++)
+                {
+                    if (k != j)
+                    {
+                        minor[i - 1][c++] = mat[i][k];
+                    }
+                }
+            }
+            det += (j % 2 == 0 ? 1.0 : -1.0) * mat[0][j] * copyingDeterminant(minor);
+        }
+        return det;
+    }
+
+    /**
+     * @brief Minors and block products with copied submatrices versus views
+     */
+    void benchmarkViews()
+    {
+        const size_t d = 9;
+        SquareMat small(d);
+        fill(small, 5);
+        small *= 0.5;
+        std::cout << "Determinant by cofactor expansion, n = " << d << std::endl;
+        double copied = 0, viewed = 0;
+        report("minors copied into new matrices", 1, measure(1, [&]() {
+                   copied = copyingDeterminant(small);
+               }));
+        report("minors addressed through a view", 1, measure(1, [&]() {
+                   viewed = !small;
+               }));
+        std::cout << "determinants " << copied << " / " << viewed << std::endl << std::endl;
+
+        const size_t n = 1024;
+        const size_t h = n / 2;
+        const size_t repetitions = 4;
+        SquareMat a(n), b(n);
+        fill(a, 1);
+        fill(b, 2);
+        SquareMat c11(h);
+        std::cout << "Block product C11 = A11 B11 + A12 B21, n = " << n << std::endl;
+        report("blocks copied out", repetitions, measure(repetitions, [&]() {
+                   SquareMatView av(a), bv(b);
+                   c11 = av.block(0, 0, h).toSquareMat() * bv.block(0, 0, h).toSquareMat() + av.block(0, h, h).toSquareMat() * bv.block(h, 0, h).toSquareMat();
+               }), h * h);
+        report("gemm on block views", repetitions, measure(repetitions, [&]() {
+                   gemm(1.0, SquareMatView(a, 0, 0, h), SquareMatView(b, 0, 0, h), 0.0, c11);
+                   gemm(1.0, SquareMatView(a, 0, h, h), SquareMatView(b, h, 0, h), 1.0, c11);
+               }), h * h);
+        std::cout << std::endl;
+    }
+
+    /**
+     * @brief Exact Bareiss determinants versus cofactor expansion, and the cost of promotion
+     */
+    void benchmarkExactDeterminant()
+    {
+        const size_t d = 10;
+        std::mt19937 generator(47);
+        std::uniform_int_distribution<int> entry(-99, 99);
+        SquareMat integer(d);
+        for (size_t i = 0; i < d; i++)
+        {
+            for (size_t j = 0; j < d; j++)
+            {
+                integer[i][j] = entry(generator);
+            }
+        }
+        SquareMat halved = integer * 0.5;
+        std::cout << "Determinant of an integer matrix, n = " << d << std::endl;
+        double expanded = 0;
+        BigInt exact;
+        report("cofactor expansion (double)", 1, measure(1, [&]() {
+                   expanded = std::ldexp(!halved, static_cast<int>(d));
+               }));
+        report("Bareiss (exact)", 100, measure(100, [&]() {
+                   exact = determinantExact(integer);
+               }));
+        std::cout << "determinants " << std::defaultfloat << std::setprecision(17) << expanded << " / " << exact << std::endl << std::endl;
+
+        std::cout << "Exact determinant, random entries in -99..99" << std::endl;
+        for (size_t n : {50, 100, 200})
+        {
+            SquareMat a(n);
+            for (size_t i = 0; i < n; i++)
+            {
+                for (size_t j = 0; j < n; j++)
+                {
+                    a[i][j] = entry(generator);
+                }
+            }
+            report("Bareiss, n = " + std::to_string(n), 1, measure(1, [&]() {
+                       exact = determinantExact(a);
+                   }), n * n);
+            std::cout << "determinant has " << exact.bitLength() << " bits, about " << std::scientific << std::setprecision(3) << exact.toDouble() << std::endl;
+        }
+        std::cout << std::endl;
+    }
+
+    /**
+     * @brief Log-determinants from Cholesky and LU, and a likelihood that reuses the factors
+     */
+    void benchmarkLogDeterminant()
+    {
+        std::mt19937 generator(48);
+        std::normal_distribution<double> entry(0.0, 1.0);
+        for (size_t n : {256, 512})
+        {
+            SquareMat a(n);
+            for (size_t i = 0; i < n; i++)
+            {
+                for (size_t j = 0; j < n; j++)
+                {
+                    a[i][j] = entry(generator);
+                }
+            }
+            SquareMat covariance = ~a * a;
+            Vector residual(n);
+            for (size_t i = 0; i < n; i++)
+            {
+                covariance[i][i] += 1;
+                residual[i] = std::cos(static_cast<double>(i));
+            }
+            std::cout << "Log-determinant, n = " << n << std::endl;
+            LogDeterminant result{};
+            report("LU, general matrix", 1, measure(1, [&]() {
+                       result = logDeterminant(a);
+                   }));
+            report("Cholesky, covariance", 1, measure(1, [&]() {
+                       result = logDeterminant(covariance);
+                   }));
+            double separate = 0, shared = 0;
+            report("likelihood, logDeterminant + solve", 1, measure(1, [&]() {
+                       Vector weights = solve(covariance, residual);
+                       separate = logDeterminant(covariance).logAbs + dot(residual, weights);
+                   }));
+            report("likelihood, one Factorization", 1, measure(1, [&]() {
+                       Factorization factors(covariance);
+                       shared = factors.logDeterminant().logAbs + dot(residual, factors.solve(residual));
+                   }));
+            std::cout << "log|det| " << std::defaultfloat << std::setprecision(10) << result.logAbs << " (det " << result.sign * std::exp(result.logAbs) << "), likelihood terms " << separate << " / " << shared << std::endl;
+        }
+        std::cout << std::endl;
+    }
+
+    /**
+     * @brief Rank-1 updates of determinant and inverse versus refactoring after every update
+     */
+    void benchmarkRankOneUpdates()
+    {
+        const size_t steps = 32;
+        std::mt19937 generator(49);
+        std::normal_distribution<double> entry(0.0, 1.0);
+        for (size_t n : {256, 512})
+        {
+            SquareMat a(n);
+            for (size_t i = 0; i < n; i++)
+            {
+                for (size_t j = 0; j < n; j++)
+                {
+                    a[i][j] = entry(generator) + (i == j ? 4 * std::sqrt(static_cast<double>(n)) : 0);
+                }
+            }
+            std::vector<Vector> us, vs;
+            for (size_t step = 0; step < steps; step++)
+            {
+                Vector u(n), v(n);
+                for (size_t i = 0; i < n; i++)
+                {
+                    u[i] = entry(generator);
+                    v[i] = entry(generator) / static_cast<double>(n);
+                }
+                us.push_back(u);
+                vs.push_back(v);
+            }
+            std::cout << "Rank-1 updates, n = " << n << ", " << steps << " updates" << std::endl;
+            double updated = 0, refactored = 0;
+            size_t refactors = 0;
+            report("RankOneUpdater::update", steps, measure(1, [&]() {
+                       RankOneUpdater updater(a);
+                       for (size_t step = 0; step < steps; step++)
+                       {
+                           updater.update(us[step], vs[step]);
+                       }
+                       updated = updater.logDeterminant().logAbs;
+                       refactors = updater.getRefactorCount();
+                   }));
+            report("update + Factorization", steps, measure(1, [&]() {
+                       SquareMat current = a;
+                       for (size_t step = 0; step < steps; step++)
+                       {
+                           for (size_t i = 0; i < n; i++)
+                           {
+                               for (size_t j = 0; j < n; j++)
+                               {
+                                   current[i][j] += us[step][i] * vs[step][j];
+                               }
+                           }
+                           Factorization factors(current);
+                           refactored = factors.logDeterminant().logAbs;
+                           SquareMat inverse = factors.inverse();
+                       }
+                   }));
+            std::cout << "log|det| " << std::defaultfloat << std::setprecision(12) << updated << " / " << refactored << ", " << refactors << " refactorization(s)" << std::endl;
+        }
+        std::cout << std::endl;
+    }
+
+    /**
+     * @brief Padé matrix exponential versus a truncated Taylor series of operator^ terms
+     */
+    void benchmarkExponential()
+    {
+        const int terms = 20;
+        for (size_t n : {128, 256})
+        {
+            SquareMat rates(n);
+            for (size_t i = 0; i < n; i++)
+            {
+                double total = 0;
+                for (size_t j = 0; j < n; j++)
+                {
+                    if (i != j && (i * 7 + j * 3) % 5 == 0)
+                    {
+                        rates[i][j] = 0.5 + 0.5 * std::sin(static_cast<double>(i * n + j));
+                        total += rates[i][j];
+                    }
+                }
+                rates[i][i] = -total;
+            }
+            SquareMat generator = rates * (2.0 / static_cast<double>(n));
+            std::cout << "Matrix exponential, n = " << n << std::endl;
+            SquareMat series(n), pade(n), scaled(n);
+            report("Taylor series, " + std::to_string(terms) + " operator^ terms", 1, measure(1, [&]() {
+                       series = generator ^ 0;
+                       double factorial = 1;
+                       for (int k = 1; k < terms; k++)
+                       {
+                           factorial *= k;
+                           series += (generator ^ k) / factorial;
+                       }
+                   }));
+            report("expm, small norm", 1, measure(1, [&]() {
+                       pade = expm(generator);
+                   }));
+            report("expm, 100 x generator (squared)", 1, measure(1, [&]() {
+                       scaled = expm(generator * 100.0);
+                   }));
+            double difference = 0, rowSum = 0;
+            for (size_t i = 0; i < n; i++)
+            {
+                for (size_t j = 0; j < n; j++)
+                {
+                    difference = std::max(difference, std::fabs(series[i][j] - pade[i][j]));
+                    rowSum += scaled[i][j];
+                }
+            }
+            std::cout << "max |series - expm| " << std::scientific << std::setprecision(2) << difference << ", mean row sum of exp(100 Q) " << std::defaultfloat << std::setprecision(15) << rowSum / static_cast<double>(n) << std::endl;
+        }
+        std::cout << std::endl;
+    }
+
+    /**
+     * @brief Huge powers of modular matrices with 64-bit and 128-bit accumulation
+     */
+    void benchmarkModularPower()
+    {
+        const uint64_t power = 1000000000000000000ULL;
+        std::cout << "Modular power A ^ 10^18" << std::endl;
+        for (uint64_t modulus : {uint64_t(998244353), (uint64_t(1) << 61) - 1})
+        {
+            for (size_t n : {64, 256})
+            {
+                const size_t repetitions = n <= 64 ? 10 : 1;
+                SquareMat source(n);
+                fill(source, 3);
+                ModMat a(source, modulus);
+                std::string label = "A ^ 10^18 mod " + std::to_string(modulus) + ", n = " + std::to_string(n);
+                report(label, repetitions, measure(repetitions, [&]() {
+                           ModMat result = a ^ power;
+                       }), n * n);
+            }
+        }
+        std::cout << std::endl;
+    }
+
+    /**
+     * @brief Double-precision product and solve versus the single-precision kernels
+     */
+    void benchmarkMixedPrecision()
+    {
+        const size_t n = 1024;
+        const size_t repetitions = 2;
+        SquareMat a(n), b(n);
+        fill(a, 1);
+        fill(b, 2);
+        Vector rhs(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            a[i][i] += static_cast<double>(8 * n);
+            rhs[i] = static_cast<double>(i % 7);
+        }
+        std::cout << "Mixed precision, n = " << n << std::endl;
+        report("a * b", repetitions, measure(repetitions, [&]() {
+                   SquareMat product = a * b;
+               }), n * n);
+        report("multiplyMixed(a, b)", repetitions, measure(repetitions, [&]() {
+                   SquareMat product = multiplyMixed(a, b);
+               }), n * n);
+        report("solve(a, rhs)", repetitions, measure(repetitions, [&]() {
+                   Vector x = solve(a, rhs);
+               }), n * n);
+        size_t iterations = 0;
+        report("MixedSolver(a).solve(rhs)", repetitions, measure(repetitions, [&]() {
+                   MixedSolver solver(a);
+                   Vector x = solver.solve(rhs);
+                   iterations = solver.getIterations();
+               }), n * n);
+        std::cout << "refinement steps: " << iterations << std::endl << std::endl;
+    }
+
+    /**
+     * @brief Memory-bound element-wise operators on a large matrix
+     */
+    void benchmarkElementwise()
+    {
+        const size_t n = 2048;
+        const size_t repetitions = 10;
+        SquareMat a(n), b(n), out(n);
+        fill(a, 1);
+        fill(b, 2);
+        std::cout << "Element-wise operators, n = " << n << ", threads = " << ThreadPool::instance().getThreadCount() << std::endl;
+        report("a + b", repetitions, measure(repetitions, [&]() {
+                   out = a + b;
+               }), n * n);
+        report("a % b", repetitions, measure(repetitions, [&]() {
+                   out = a % b;
+               }), n * n);
+        report("a * 2", repetitions, measure(repetitions, [&]() {
+                   out = a * 2;
+               }), n * n);
+        report("out += b", repetitions, measure(repetitions, [&]() {
+                   out += b;
+               }), n * n);
+        report("out /= 2", repetitions, measure(repetitions, [&]() {
+                   out /= 2;
+               }), n * n);
+        std::cout << std::endl;
+    }
+
+    /**
+     * @brief sum() in each accuracy mode on a large matrix
+     */
+    void benchmarkSum()
+    {
+        const size_t n = 2048;
+        const size_t repetitions = 20;
+        SquareMat a(n);
+        fill(a, 5);
+        std::cout << "sum(), n = " << n << std::endl;
+        volatile double sink = 0;
+        report("naive", repetitions, measure(repetitions, [&]() {
+                   sink = a.sum(SquareMat::Summation::Naive);
+               }), n * n);
+        report("pairwise", repetitions, measure(repetitions, [&]() {
+                   sink = a.sum(SquareMat::Summation::Pairwise);
+               }), n * n);
+        report("compensated", repetitions, measure(repetitions, [&]() {
+                   sink = a.sum(SquareMat::Summation::Compensated);
+               }), n * n);
+        (void)sink;
+        std::cout << std::endl;
+    }
+
+    /**
+     * @brief Cost of timeline tracing on a chain of small operators at several sampling rates
+     */
+    void benchmarkTracing()
+    {
+        const size_t n = 64;
+        const size_t repetitions = 2000;
+        SquareMat a(n), b(n), out(n);
+        fill(a, 1);
+        fill(b, 2);
+        auto chain = [&]() {
+            out = (a + b) * 2 - a % b;
+        };
+        std::cout << "Tracing overhead, (a + b) * 2 - a % b, n = " << n << std::endl;
+        report("tracing off", repetitions, measure(repetitions, chain));
+        for (unsigned every : {1u, 16u, 256u})
+        {
+            trace::clear();
+            trace::start(every);
+            Measurement m = measure(repetitions, chain);
+            trace::stop();
+            report("sample 1/" + std::to_string(every) + " (" + std::to_string(trace::eventCount()) + " events)", repetitions, m);
+        }
+        trace::clear();
+        std::cout << std::endl;
+    }
+
+    /**
+     * @brief Parallel first-touch construction and where its pages ended up
+     */
+    void benchmarkNumaPlacement()
+    {
+        const size_t n = 4096;
+        size_t bound = ThreadPool::instance().bindToNodes();
+        std::cout << "NUMA placement: n = " << n << ", nodes = " << numa::nodeCount() << ", bound workers = " << bound << std::endl;
+        report("construct (first touch)", 3, measure(3, [&]() {
+                   SquareMat fresh(n);
+               }));
+        SquareMat big(n);
+        std::vector<size_t> pages = numa::residentPages(big[0]);
+        for (size_t node = 0; node < pages.size(); node++)
+        {
+            std::cout << "  node " << node << ": " << pages[node] << " pages" << std::endl;
+        }
+        std::cout << std::endl;
+    }
+} // End of anonymous namespace
+
+// The replacements below pair malloc/aligned_alloc with free by design. When GCC inlines
+// them into library code it sees free() releasing memory from a (replaced) operator new
+// and reports -Wmismatched-new-delete, which does not apply to a replacement allocator.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+/**
+ * @brief Counting replacement for the global allocation function
+ * @param bytes Number of bytes requested
+ * @return Pointer to the allocated memory
+ */
+void *operator new(size_t bytes)
+{
+    heapAllocations++;
+    heapBytes += bytes;
+    if (void *memory = std::malloc(bytes ? bytes : 1))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+/**
+ * @brief Matching deallocation function
+ * @param memory Pointer returned by operator new
+ */
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+/**
+ * @brief Matching sized deallocation function
+ * @param memory Pointer returned by operator new
+ */
+void operator delete(void *memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+/**
+ * @brief Counting replacement for the over-aligned allocation function (used by std::pmr)
+ * @param bytes Number of bytes requested
+ * @param alignment Required alignment
+ * @return Pointer to the allocated memory
+ */
+void *operator new(size_t bytes, std::align_val_t alignment)
+{
+    heapAllocations++;
+    heapBytes += bytes;
+    size_t align = static_cast<size_t>(alignment);
+    if (void *memory = std::aligned_alloc(align, (bytes + align - 1) / align * align))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+/**
+ * @brief Matching over-aligned deallocation function
+ * @param memory Pointer returned by operator new
+ */
+void operator delete(void *memory, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+/**
+ * @brief Matching sized over-aligned deallocation function
+ * @param memory Pointer returned by operator new
+ */
+void operator delete(void *memory, size_t, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+int main()
+{
+    benchmarkExpressionChain();
+    benchmarkHugePages();
+    benchmarkHardwareCounters();
+    benchmarkGemm();
+    benchmarkFusedUpdates();
+    benchmarkCopyOnWrite();
+    benchmarkViews();
+    benchmarkExactDeterminant();
+    benchmarkLogDeterminant();
+    benchmarkRankOneUpdates();
+    benchmarkExponential();
+    benchmarkModularPower();
+    benchmarkMixedPrecision();
+    benchmarkElementwise();
+    benchmarkSum();
+    benchmarkTracing();
+    benchmarkPipelines();
+    benchmarkNumaPlacement();
+    if (stats::Enabled)
+    {
+        std::cout << "Operator counters: " << stats::toJson() << std::endl;
+    }
+    return 0;
+}
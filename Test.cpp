@@ -2,7 +2,28 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 #include "squaremat.hpp"
+#include "bandedmat.hpp"
+#include "matvec.hpp"
+#include "pagealloc.hpp"
+#include "numa.hpp"
+#include "stats.hpp"
+#include "trace.hpp"
+#include "perfcounters.hpp"
+#include "async.hpp"
+#include "graph.hpp"
+#include "coroutine.hpp"
+#include "modmat.hpp"
+#include "mixed.hpp"
+#include "matview.hpp"
+#include "bareiss.hpp"
+#include "factorization.hpp"
+#include "expm.hpp"
+#include "threadpool.hpp"
+#include <atomic>
+#include <cstdint>
 #include <sstream>
+#include <thread>
+#include <utility>
 
 using namespace squaremat;
 
@@ -840,4 +861,2262 @@ TEST_CASE("Matrix Index Operator (const) out of bounds")
     const SquareMat m2 = m1;
 
     CHECK_THROWS_AS(m2[2], std::out_of_range);
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Test banded matrix element access and conversion to a full matrix
+ */
+TEST_CASE("Banded Matrix Access and Conversion")
+{
+    BandedMat b(4, 1, 2);
+    b(0, 0) = 1;
+    b(0, 2) = 2;
+    b(3, 2) = 3;
+
+    const BandedMat &cb = b;
+    CHECK(cb(0, 0) == 1);
+    CHECK(cb(0, 3) == 0); // outside the band reads as zero
+    CHECK_THROWS_AS(b(0, 3) = 1, std::out_of_range);
+    CHECK_THROWS_AS(cb(4, 0), std::out_of_range);
+
+    SquareMat full = b.toSquareMat();
+    CHECK(full[0][2] == 2);
+    CHECK(full[3][2] == 3);
+
+    SquareMat m(3);
+    m[0][2] = 1;
+    CHECK_THROWS_AS(BandedMat(m, 1, 1), std::invalid_argument);
+    CHECK_THROWS_AS(BandedMat(0, 1, 1), std::invalid_argument);
+}
+
+/**
+ * @brief Test banded and tridiagonal determinants against the full cofactor expansion
+ */
+TEST_CASE("Banded Matrix Determinant")
+{
+    TridiagonalMat t({1, 2, 3, 4}, {5, 6, 7, 8, 9}, {-1, 2, -3, 4});
+    CHECK(!t == doctest::Approx(!t.toSquareMat()));
+
+    BandedMat b(6, 2, 1);
+    for (size_t i = 0; i < 6; i++)
+    {
+        for (size_t j = (i > 2 ? i - 2 : 0); j <= std::min<size_t>(5, i + 1); j++)
+        {
+            b(i, j) = static_cast<double>((i * 7 + j * 3) % 5) - 2.0;
+        }
+    }
+    CHECK(!b == doctest::Approx(!b.toSquareMat()));
+
+    BandedMat upper(3, 0, 2);
+    upper(0, 0) = 2;
+    upper(1, 1) = 3;
+    upper(2, 2) = 4;
+    upper(0, 2) = 9;
+    CHECK(!upper == 24);
+}
+
+/**
+ * @brief Test banded multiplication, power and solve against the full matrix results
+ */
+TEST_CASE("Banded Matrix Multiply, Power and Solve")
+{
+    TridiagonalMat t({1, 1, 1, 1}, {4, 4, 4, 4, 4}, {1, 1, 1, 1});
+    BandedMat p = t * t;
+    CHECK(p.getLower() == 2);
+    CHECK(p.getUpper() == 2);
+
+    SquareMat full = t.toSquareMat();
+    SquareMat expected = full * full;
+    SquareMat actual = p.toSquareMat();
+    SquareMat cubeExpected = full ^ 3;
+    SquareMat cubeActual = (t ^ 3).toSquareMat();
+    for (size_t i = 0; i < 5; i++)
+    {
+        for (size_t j = 0; j < 5; j++)
+        {
+            CHECK(actual[i][j] == expected[i][j]);
+            CHECK(cubeActual[i][j] == cubeExpected[i][j]);
+        }
+    }
+
+    std::vector<double> x = t.solve({5, 6, 6, 6, 5});
+    for (double value : x)
+    {
+        CHECK(value == doctest::Approx(1));
+    }
+
+    BandedMat wide(5, 0, 3);
+    wide(0, 3) = 2;
+    wide(4, 4) = 1;
+    SquareMat differenceExpected = full - wide.toSquareMat();
+    BandedMat difference = t - wide;
+    CHECK(difference.getLower() == 1);
+    CHECK(difference.getUpper() == 3);
+    SquareMat differenceActual = difference.toSquareMat();
+    SquareMat sumActual = (wide + t).toSquareMat();
+    for (size_t i = 0; i < 5; i++)
+    {
+        for (size_t j = 0; j < 5; j++)
+        {
+            CHECK(differenceActual[i][j] == differenceExpected[i][j]);
+            CHECK(sumActual[i][j] == full[i][j] + wide.toSquareMat()[i][j]);
+        }
+    }
+    CHECK_THROWS_AS(t - BandedMat(4, 1, 1), std::invalid_argument);
+
+    BandedMat taken(std::move(difference));
+    CHECK(taken.getSize() == 5);
+    CHECK(difference.getSize() == 0);
+    BandedMat target(2, 0, 0);
+    target = std::move(taken);
+    CHECK(target.getUpper() == 3);
+    CHECK(static_cast<const BandedMat &>(target)(0, 3) == -2);
+    CHECK(taken.getSize() == 2);
+
+    BandedMat singular(3, 1, 1);
+    CHECK_THROWS_AS(singular.solve({1, 2, 3}), std::invalid_argument);
+    CHECK_THROWS_AS(t.solve({1, 2}), std::invalid_argument);
+    CHECK_THROWS_AS(t ^ -1, std::invalid_argument);
+}
+
+/**
+ * @brief Test the structural classifier and its invalidation on writes
+ */
+TEST_CASE("Matrix Structure Detection")
+{
+    SquareMat m(3);
+    CHECK(m.hasStructure(SquareMat::Diagonal));
+    CHECK_FALSE(m.hasStructure(SquareMat::Permutation));
+
+    m[0][0] = 1;
+    m[1][1] = 1;
+    m[2][2] = 1;
+    CHECK(m.structure() == SquareMat::Identity);
+
+    m[0][2] = 5;
+    CHECK(m.structure() == SquareMat::UpperTriangular);
+    CHECK((~m).structure() == SquareMat::LowerTriangular);
+
+    m[2][0] = 1;
+    CHECK(m.structure() == SquareMat::General);
+
+    SquareMat p(3);
+    p[0][1] = 1;
+    p[1][2] = 1;
+    p[2][0] = 1;
+    CHECK(p.structure() == SquareMat::Permutation);
+    p += p;
+    CHECK(p.structure() == SquareMat::General);
+
+    SquareMat kept(3);
+    double *r = kept[0];
+    kept[1][1] = 1;
+    kept[2][2] = 1;
+    r[0] = 1;
+    CHECK(kept.hasStructure(SquareMat::Diagonal));
+    r[1] = 2;
+    CHECK_FALSE(kept.hasStructure(SquareMat::Diagonal));
+    CHECK((kept ^ 2)[0][1] == 4);
+    CHECK(!kept == 1);
+    SquareMat copied(kept);
+    r[2] = 3;
+    CHECK(copied.structure() == SquareMat::UpperTriangular);
+    CHECK(kept.structure() == SquareMat::UpperTriangular);
+    kept = copied;
+    CHECK(kept.structure() == SquareMat::UpperTriangular);
+}
+
+/**
+ * @brief Test the structured fast paths against the general algorithms
+ */
+TEST_CASE("Matrix Structured Fast Paths")
+{
+    SquareMat general(3);
+    general[0][0] = 2;
+    general[0][1] = -3;
+    general[0][2] = 1;
+    general[1][0] = 2;
+    general[1][1] = 0;
+    general[1][2] = -1;
+    general[2][0] = 1;
+    general[2][1] = 4;
+    general[2][2] = 5;
+
+    SquareMat d(3);
+    d[0][0] = 2;
+    d[1][1] = -1;
+    d[2][2] = 3;
+    CHECK(!d == -6);
+    SquareMat d5 = d ^ 5;
+    CHECK(d5[0][0] == 32);
+    CHECK(d5[1][1] == -1);
+    CHECK(d5[2][2] == 243);
+    CHECK(d5[0][1] == 0);
+
+    SquareMat dg = d * general;
+    SquareMat gd = general * d;
+    CHECK(dg[1][2] == 1);
+    CHECK(dg[2][1] == 12);
+    CHECK(gd[0][1] == 3);
+    CHECK(gd[2][2] == 15);
+
+    SquareMat p(3);
+    p[0][1] = 1;
+    p[1][2] = 1;
+    p[2][0] = 1;
+    CHECK(!p == 1);
+    SquareMat swap(3);
+    swap[0][1] = 1;
+    swap[1][0] = 1;
+    swap[2][2] = 1;
+    CHECK(!swap == -1);
+
+    SquareMat p3 = p ^ 3;
+    CHECK(p3.structure() == SquareMat::Identity);
+    SquareMat p2 = p ^ 2;
+    SquareMat p2Expected = p * p;
+    SquareMat pg = p * general;
+    SquareMat gp = general * p;
+    for (size_t i = 0; i < 3; i++)
+    {
+        CHECK(pg[i][0] == general[(i + 1) % 3][0]);
+        for (size_t j = 0; j < 3; j++)
+        {
+            CHECK(p2[i][j] == p2Expected[i][j]);
+            CHECK(gp[i][(j + 1) % 3] == general[i][j]);
+        }
+    }
+
+    SquareMat u(3);
+    u[0][0] = 1;
+    u[0][1] = 2;
+    u[0][2] = 3;
+    u[1][1] = 4;
+    u[1][2] = 5;
+    u[2][2] = 6;
+    CHECK(!u == 24);
+    SquareMat uu = u * u;
+    CHECK(uu[0][2] == 1 * 3 + 2 * 5 + 3 * 6);
+    CHECK(uu[2][0] == 0);
+    SquareMat ut = ~u;
+    CHECK(ut[2][0] == 3);
+    CHECK(ut[0][2] == 0);
+}
+
+/**
+ * @brief Test vector construction, arithmetic, AXPY and dot product
+ */
+TEST_CASE("Vector Operations")
+{
+    Vector x{1, 2, 3};
+    Vector y{4, 5, 6};
+
+    CHECK(dot(x, y) == 32);
+    Vector s = x + y;
+    CHECK(s[2] == 9);
+    Vector d = y - x;
+    CHECK(d[0] == 3);
+    CHECK((x * 2)[1] == 4);
+    CHECK(Vector{3, 4}.norm() == 5);
+
+    axpy(2, x, y);
+    CHECK(y[0] == 6);
+    CHECK(y[2] == 12);
+
+    CHECK_THROWS_AS(Vector(0), std::invalid_argument);
+    CHECK_THROWS_AS(x[3], std::out_of_range);
+    CHECK_THROWS_AS(dot(x, Vector(2)), std::invalid_argument);
+}
+
+/**
+ * @brief Test matrix-vector, vector-matrix, transposed and batched products
+ */
+TEST_CASE("Matrix-Vector Products")
+{
+    SquareMat m(3);
+    m[0][0] = 1;
+    m[0][1] = 2;
+    m[0][2] = 3;
+    m[1][0] = 4;
+    m[1][1] = 5;
+    m[1][2] = 6;
+    m[2][0] = 7;
+    m[2][1] = 8;
+    m[2][2] = 9;
+    Vector x{1, 0, -1};
+
+    Vector ax = m * x;
+    CHECK(ax[0] == -2);
+    CHECK(ax[1] == -2);
+    CHECK(ax[2] == -2);
+
+    Vector xa = x * m;
+    CHECK(xa[0] == -6);
+    CHECK(xa[1] == -6);
+    CHECK(xa[2] == -6);
+    Vector atx = transposeMultiply(m, x);
+    CHECK(atx[1] == xa[1]);
+
+    Vector y{1, 1, 1};
+    gemv(2, m, x, 3, y);
+    CHECK(y[0] == -1);
+
+    std::vector<Vector> xs;
+    for (int k = 0; k < 6; k++)
+    {
+        xs.push_back(Vector{double(k), 1, 2});
+    }
+    std::vector<Vector> batch = multiplyBatch(m, xs);
+    for (size_t k = 0; k < xs.size(); k++)
+    {
+        Vector single = m * xs[k];
+        for (size_t i = 0; i < 3; i++)
+        {
+            CHECK(batch[k][i] == single[i]);
+        }
+    }
+
+    CHECK_THROWS_AS(m * Vector(2), std::invalid_argument);
+    CHECK_THROWS_AS(gemv(1, m, x, 0, x), std::invalid_argument);
+}
+
+/**
+ * @brief Test that large matrix-vector products split across threads match the serial result
+ */
+TEST_CASE("Matrix-Vector Products Large")
+{
+    const size_t n = 300;
+    SquareMat m(n);
+    Vector x(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        x[i] = static_cast<double>(i % 7) - 3;
+        for (size_t j = 0; j < n; j++)
+        {
+            m[i][j] = static_cast<double>((i * 31 + j * 17) % 11) - 5;
+        }
+    }
+    Vector ax = m * x;
+    Vector atx = transposeMultiply(m, x);
+    for (size_t i = 0; i < n; i += 37)
+    {
+        double row = 0;
+        double column = 0;
+        for (size_t j = 0; j < n; j++)
+        {
+            row += m[i][j] * x[j];
+            column += m[j][i] * x[j];
+        }
+        CHECK(ax[i] == doctest::Approx(row));
+        CHECK(atx[i] == doctest::Approx(column));
+    }
+}
+
+/**
+ * @brief Test that the worker pool covers every index once and propagates exceptions
+ */
+TEST_CASE("Thread Pool Parallel For")
+{
+    ThreadPool pool(3);
+    CHECK(pool.getThreadCount() == 4);
+
+    std::vector<std::atomic<int>> hits(1000);
+    pool.parallelFor(0, 1000, 10, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; i++)
+        {
+            hits[i]++;
+        }
+    });
+    bool allOnce = true;
+    for (auto &hit : hits)
+    {
+        allOnce = allOnce && hit.load() == 1;
+    }
+    CHECK(allOnce);
+
+    CHECK_THROWS_AS(pool.parallelFor(0, 1000, 10, [](size_t first, size_t) {
+        if (first > 0)
+        {
+            throw std::runtime_error("chunk failed");
+        }
+    }),
+                    std::runtime_error);
+
+    std::atomic<int> ran(0);
+    pool.submit([&]() { ran++; });
+    pool.parallelFor(0, 4, 1, [](size_t, size_t) {});
+    while (ran.load() == 0)
+    {
+        std::this_thread::yield();
+    }
+    CHECK(ran.load() == 1);
+}
+
+/**
+ * @brief Test that matrices created in an arena scope allocate from it and results survive via assignment
+ */
+TEST_CASE("Matrix Arena Scope")
+{
+    SquareMat a(3);
+    a[0][0] = 1;
+    a[1][1] = 2;
+    a[2][2] = 3;
+    a[0][2] = 4;
+    SquareMat result(3);
+    CHECK(SquareMat::Arena::current() == nullptr);
+    {
+        SquareMat::Arena arena(256);
+        CHECK(SquareMat::Arena::current() == &arena);
+        result = (a + a) * a - ~a;
+        CHECK(arena.bytesUsed() > 0);
+        CHECK(arena.chunkCount() > 1); // 256 bytes can't hold all the temporaries
+
+        {
+            SquareMat::Arena inner;
+            CHECK(SquareMat::Arena::current() == &inner);
+            SquareMat temp = a * 2;
+            CHECK(inner.bytesUsed() > 0);
+            CHECK(temp[0][2] == 8);
+        }
+        CHECK(SquareMat::Arena::current() == &arena);
+
+        SquareMat big(4);
+        result = big; // different size: reallocated from the heap, where result came from
+    }
+    CHECK(SquareMat::Arena::current() == nullptr);
+    CHECK(result.getSize() == 4);
+
+    SquareMat expected = (a + a) * a - ~a;
+    {
+        SquareMat::Arena arena;
+        result = (a + a) * a - ~a;
+    }
+    CHECK(result[0][2] == expected[0][2]);
+    CHECK(result[2][0] == expected[2][0]);
+    CHECK(result[1][1] == expected[1][1]);
+}
+
+/**
+ * @brief Test move construction and move assignment
+ */
+TEST_CASE("Matrix Move Semantics")
+{
+    SquareMat a(2);
+    a[0][1] = 5;
+    SquareMat b(std::move(a));
+    CHECK(b[0][1] == 5);
+    CHECK(a.getSize() == 0);
+
+    SquareMat c(3);
+    c = std::move(b);
+    CHECK(c.getSize() == 2);
+    CHECK(c[0][1] == 5);
+
+    SquareMat d(2);
+    d = SquareMat(2) + c;
+    CHECK(d[0][1] == 5);
+}
+
+/**
+ * @brief Memory resource that counts the allocations it forwards to new/delete
+ */
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+    size_t allocations = 0;
+    size_t live = 0;
+
+private:
+    void *do_allocate(size_t bytes, size_t alignment) override
+    {
+        allocations++;
+        live++;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void *memory, size_t bytes, size_t alignment) override
+    {
+        live--;
+        std::pmr::new_delete_resource()->deallocate(memory, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+/**
+ * @brief Test that matrices allocate from an explicit memory resource and operator results inherit it
+ */
+TEST_CASE("Matrix Memory Resource")
+{
+    CountingResource counting;
+    {
+        SquareMat a(3, &counting);
+        CHECK(a.getResource() == &counting);
+        CHECK(counting.allocations == 1);
+        a[0][0] = 2;
+        a[1][1] = 3;
+        a[2][2] = 4;
+        a[0][1] = 1;
+
+        SquareMat chain = (a + a) * a - ~a * 2;
+        CHECK(chain.getResource() == &counting);
+        SquareMat copy(a);
+        CHECK(copy.getResource() == &counting);
+        CHECK(!a == 24);
+
+        SquareMat heap(a, std::pmr::new_delete_resource());
+        CHECK(heap.getResource() == std::pmr::new_delete_resource());
+        CHECK(heap[0][1] == 1);
+
+        SquareMat outside(3);
+        CHECK(outside.getResource() == SquareMat::heapResource());
+        outside = a * a; // assignment keeps the target's resource
+        CHECK(outside.getResource() == SquareMat::heapResource());
+        CHECK(outside[0][1] == 5);
+
+        SquareMat::Arena arena;
+        SquareMat scoped = a + a; // explicit resources win over the arena
+        CHECK(scoped.getResource() == &counting);
+        SquareMat temp = outside + outside; // default-resource operands follow the arena
+        CHECK(temp.getResource() == &arena);
+    }
+    CHECK(counting.live == 0);
+    CHECK(counting.allocations > 5);
+
+    std::pmr::monotonic_buffer_resource buffer;
+    SquareMat b(4, &buffer);
+    b[3][3] = 7;
+    SquareMat b2 = b * b;
+    CHECK(b2.getResource() == &buffer);
+    CHECK(b2[3][3] == 49);
+}
+
+/**
+ * @brief Test that large blocks are mapped on huge pages above the threshold and small ones go upstream
+ */
+TEST_CASE("Matrix Huge Page Resource")
+{
+    CountingResource counting;
+    HugePageResource pages(HugePageResource::HugePageSize, &counting);
+    CHECK(pages.getThreshold() == HugePageResource::HugePageSize);
+    pages.setThreshold(4096);
+    CHECK(pages.getThreshold() == HugePageResource::HugePageSize);
+
+    void *small = pages.allocate(1024, 64);
+    CHECK(counting.allocations == 1);
+    CHECK(pages.hugePageBytes() == 0);
+    pages.deallocate(small, 1024, 64);
+    CHECK(counting.live == 0);
+
+    const size_t n = 600; // 600 * 601 doubles is about 2.75 MB
+    {
+        SquareMat big(n, &pages);
+        CHECK(big.getResource() == &pages);
+        CHECK(pages.hugePageAllocations() + pages.fallbackAllocations() == 1);
+#if defined(__linux__)
+        CHECK(counting.allocations == 1);
+        CHECK(reinterpret_cast<uintptr_t>(big[0]) % HugePageResource::HugePageSize == 0);
+        if (pages.hugePageAllocations() == 1)
+        {
+            CHECK(pages.hugePageBytes() == 2 * HugePageResource::HugePageSize);
+        }
+#endif
+        big[n - 1][n - 1] = 5;
+        big[0][n - 1] = 2;
+        SquareMat t = ~big;
+        CHECK(t.getResource() == &pages);
+        CHECK(t[n - 1][0] == 2);
+        CHECK(t[n - 1][n - 1] == 5);
+    }
+    CHECK(pages.hugePageBytes() == 0);
+    CHECK(counting.live == 0);
+
+    pages.setThreshold(SIZE_MAX);
+    size_t before = pages.hugePageAllocations() + pages.fallbackAllocations();
+    {
+        SquareMat big(n, &pages);
+        CHECK(pages.hugePageAllocations() + pages.fallbackAllocations() == before);
+        CHECK(counting.live == 1);
+    }
+    CHECK(counting.live == 0);
+
+    CHECK(SquareMat::heapResource() == &HugePageResource::instance());
+
+    CountingResource replacement;
+    SquareMat alive(8);
+    alive[7][7] = 3;
+    std::pmr::memory_resource *previous = std::pmr::set_default_resource(&replacement);
+    {
+        SquareMat during(8);
+        during[0][0] = 1;
+        SquareMat copy = alive + during;
+        CHECK(copy[7][7] == 3);
+    }
+    alive = SquareMat(16);
+    std::pmr::set_default_resource(previous);
+    CHECK(replacement.allocations == 0);
+    CHECK(replacement.live == 0);
+    CHECK(alive.getSize() == 16);
+}
+
+/**
+ * @brief Test that chunks stay on the same worker across calls and that placement is visible in /proc
+ */
+TEST_CASE("Matrix NUMA Placement")
+{
+    CHECK(numa::nodeCount() >= 1);
+#if defined(__linux__)
+    CHECK(!numa::nodeCpus(0).empty());
+#endif
+    if (numa::nodeCount() == 1)
+    {
+        std::vector<double> page(4096);
+        CHECK(!numa::interleave(page.data(), page.size() * sizeof(double)));
+    }
+
+    ThreadPool pool(3);
+    std::vector<std::thread::id> firstRun(4), secondRun(4);
+    pool.parallelFor(0, 400, 100, [&](size_t first, size_t) {
+        firstRun[first / 100] = std::this_thread::get_id();
+    });
+    pool.parallelFor(0, 400, 100, [&](size_t first, size_t) {
+        secondRun[first / 100] = std::this_thread::get_id();
+    });
+    CHECK(firstRun == secondRun);
+    CHECK(firstRun[0] == std::this_thread::get_id());
+
+    size_t bound = pool.bindToNodes();
+    CHECK(bound <= 3);
+    for (size_t w = 0; w < 3; w++)
+    {
+        int node = pool.getWorkerNode(w);
+        CHECK(node >= -1);
+        CHECK(node < static_cast<int>(numa::nodeCount()));
+    }
+    CHECK(pool.getWorkerNode(3) == -1);
+    std::atomic<size_t> covered(0);
+    pool.parallelFor(0, 1000, 10, [&](size_t first, size_t last) {
+        covered += last - first;
+    });
+    CHECK(covered.load() == 1000);
+
+    ThreadPool busy(2);
+    std::atomic<size_t> started(0);
+    std::atomic<bool> release(false);
+    for (size_t t = 0; t < 2; t++)
+    {
+        busy.submit([&]() {
+            started++;
+            while (!release.load())
+            {
+                std::this_thread::yield();
+            }
+        });
+    }
+    while (started.load() < 2)
+    {
+        std::this_thread::yield();
+    }
+    std::vector<std::thread::id> runners(3);
+    busy.parallelFor(0, 3, 1, [&](size_t first, size_t) {
+        runners[first] = std::this_thread::get_id();
+    });
+    CHECK_FALSE(release.load());
+    CHECK(runners[1] == std::this_thread::get_id());
+    CHECK(runners[2] == std::this_thread::get_id());
+    release = true;
+
+    const size_t n = 1024;
+    SquareMat big(n);
+    big[n - 1][n - 1] = 1;
+    SquareMat copy(big);
+    CHECK(copy[n - 1][n - 1] == 1);
+    CHECK(copy[n / 2][n / 2] == 0);
+#if defined(__linux__)
+    std::vector<size_t> pages = numa::residentPages(big[n / 2]);
+    size_t resident = 0;
+    for (size_t count : pages)
+    {
+        resident += count;
+    }
+    CHECK(resident > 0);
+#endif
+}
+
+/**
+ * @brief Test that element-wise operators give the same results above the parallel threshold
+ */
+TEST_CASE("Matrix Parallel Element-wise Operators")
+{
+    const size_t n = 300;
+    SquareMat a(n), b(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t j = 0; j < n; j++)
+        {
+            a[i][j] = static_cast<double>((i * 7 + j * 3) % 11) + 1;
+            b[i][j] = static_cast<double>((i + j * 5) % 13) - 6;
+        }
+    }
+
+    SquareMat sum = a + b;
+    SquareMat difference = a - b;
+    SquareMat negated = -a;
+    SquareMat product = a % b;
+    SquareMat scaled = a * 2.5;
+    SquareMat divided = a / 4;
+    SquareMat remainder = a % 5;
+    bool allMatch = true;
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t j = 0; j < n; j++)
+        {
+            allMatch = allMatch && sum[i][j] == a[i][j] + b[i][j];
+            allMatch = allMatch && difference[i][j] == a[i][j] - b[i][j];
+            allMatch = allMatch && negated[i][j] == -a[i][j];
+            allMatch = allMatch && product[i][j] == a[i][j] * b[i][j];
+            allMatch = allMatch && scaled[i][j] == a[i][j] * 2.5;
+            allMatch = allMatch && divided[i][j] == a[i][j] / 4;
+            allMatch = allMatch && remainder[i][j] == fmod(a[i][j], 5);
+        }
+    }
+    CHECK(allMatch);
+
+    SquareMat c(a);
+    c += b;
+    CHECK(c == sum);
+    c -= b;
+    CHECK(c == a);
+    c %= b;
+    CHECK(c == product);
+    c = a;
+    c *= 2.5;
+    CHECK(c == scaled);
+    c /= 2.5;
+    CHECK(c == a);
+    c %= 5;
+    CHECK(c == remainder);
+    c = a;
+    c += c;
+    CHECK(c == a * 2);
+    ++c;
+    CHECK(c[n - 1][n - 1] == a[n - 1][n - 1] * 2 + 1);
+    --c;
+    CHECK(c == a * 2);
+    CHECK_THROWS_AS(a + SquareMat(n - 1), std::invalid_argument);
+}
+
+/**
+ * @brief Test the accuracy modes of sum() and that the result doesn't depend on the thread running it
+ */
+TEST_CASE("Matrix Sum Modes")
+{
+    const size_t n = 100;
+    SquareMat a(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t j = 0; j < n; j++)
+        {
+            a[i][j] = 1;
+        }
+    }
+    a[0][0] = 1e16;
+    a[n - 1][n - 1] = -1e16;
+    CHECK(a.sum(SquareMat::Summation::Compensated) == 9998);
+    CHECK(a.sum() == 9998);
+    CHECK(a.sum(SquareMat::Summation::Naive) != 9998);
+
+    SquareMat small(3);
+    small[0][0] = 1.5;
+    small[1][2] = 2.25;
+    small[2][1] = -0.75;
+    CHECK(small.sum(SquareMat::Summation::Naive) == 3);
+    CHECK(small.sum(SquareMat::Summation::Pairwise) == 3);
+    CHECK(small.sum(SquareMat::Summation::Compensated) == 3);
+
+    const size_t m = 700;
+    SquareMat big(m);
+    for (size_t i = 0; i < m; i++)
+    {
+        for (size_t j = 0; j < m; j++)
+        {
+            big[i][j] = 1.0 / static_cast<double>(i * m + j + 1);
+        }
+    }
+    double pairwise = big.sum(SquareMat::Summation::Pairwise);
+    double compensated = big.sum(SquareMat::Summation::Compensated);
+    CHECK(pairwise == doctest::Approx(compensated).epsilon(1e-12));
+
+    ThreadPool pool(2);
+    std::atomic<bool> done(false);
+    double onWorker[3] = {0, 0, 0};
+    pool.submit([&]() {
+        onWorker[0] = big.sum(SquareMat::Summation::Naive);
+        onWorker[1] = big.sum(SquareMat::Summation::Pairwise);
+        onWorker[2] = big.sum(SquareMat::Summation::Compensated);
+        done = true;
+    });
+    while (!done.load())
+    {
+        std::this_thread::yield();
+    }
+    CHECK(onWorker[0] == big.sum(SquareMat::Summation::Naive));
+    CHECK(onWorker[1] == pairwise);
+    CHECK(onWorker[2] == compensated);
+
+    SquareMat moved(std::move(small));
+    CHECK(small.sum() == 0);
+}
+
+/**
+ * @brief Test the operator counters (all zero unless built with SQUAREMAT_STATS, e.g. make test-stats)
+ */
+TEST_CASE("Matrix Operation Stats")
+{
+    stats::reset();
+    SquareMat a(4), b(4);
+    for (size_t i = 0; i < 4; i++)
+    {
+        a[i][i] = 2;
+        b[i][(i + 1) % 4] = 1;
+        b[i][i] = 1;
+    }
+    SquareMat sum = a + b;
+    SquareMat product = sum * b;
+    product += a;
+    SquareMat copy(product);
+    copy = sum;
+    double det = !b;
+    CHECK(det == 0);
+
+    stats::OperationStats add = stats::get(stats::Operation::Add);
+    stats::OperationStats multiply = stats::get(stats::Operation::Multiply);
+    stats::OperationStats determinant = stats::get(stats::Operation::Determinant);
+    std::string json = stats::toJson();
+    CHECK(std::string(add.name) == "+");
+    CHECK(stats::snapshot().size() == static_cast<size_t>(stats::Operation::Count));
+    if (stats::Enabled)
+    {
+        CHECK(add.calls == 1);
+        CHECK(add.elements == 48);
+        CHECK(add.flops == 16);
+        CHECK(add.allocations == 1);
+        CHECK(add.bytes == SquareMat::storageBytes(4));
+        CHECK(multiply.calls == 1);
+        CHECK(multiply.flops == 128);
+        CHECK(determinant.calls == 1);
+        CHECK(determinant.allocations == 0);
+        CHECK(stats::get(stats::Operation::AddAssign).calls == 1);
+        CHECK(stats::get(stats::Operation::Copy).calls == 1);
+        CHECK(stats::get(stats::Operation::Assign).calls == 1);
+        CHECK(stats::get(stats::Operation::Construct).allocations == 2);
+        CHECK(json.find("\"enabled\": true") != std::string::npos);
+        CHECK(json.find("\"+\": {\"calls\": 1, \"elements\": 48") != std::string::npos);
+    }
+    else
+    {
+        CHECK(add.calls == 0);
+        CHECK(multiply.flops == 0);
+        CHECK(json == "{\"enabled\": false, \"operations\": {}}");
+    }
+    stats::reset();
+    CHECK(stats::get(stats::Operation::Add).calls == 0);
+}
+
+/**
+ * @brief Test that sampled operators and their phases are written as Chrome trace events
+ */
+TEST_CASE("Matrix Trace Events")
+{
+    auto occurrences = [](const std::string &text, const std::string &pattern) {
+        size_t count = 0;
+        for (size_t at = text.find(pattern); at != std::string::npos; at = text.find(pattern, at + 1))
+        {
+            count++;
+        }
+        return count;
+    };
+    SquareMat a(3), b(3);
+    a[0][0] = 1;
+    b[1][1] = 2;
+
+    trace::clear();
+    CHECK(!trace::active());
+    SquareMat untraced = a + b;
+    CHECK(trace::eventCount() == 0);
+
+    trace::start();
+    CHECK(trace::active());
+    SquareMat sum = a + b;
+    trace::stop();
+    CHECK(trace::eventCount() == 4);
+    std::ostringstream json;
+    trace::writeChromeJson(json);
+    CHECK(json.str().find("{\"traceEvents\": [") == 0);
+    CHECK(occurrences(json.str(), "\"name\": \"+\", \"cat\": \"operator\", \"ph\": \"X\"") == 1);
+    CHECK(occurrences(json.str(), "\"name\": \"allocate\", \"cat\": \"phase\"") == 1);
+    CHECK(occurrences(json.str(), "\"name\": \"kernel\", \"cat\": \"phase\"") == 2);
+
+    trace::clear();
+    trace::start(4);
+    for (int i = 0; i < 8; i++)
+    {
+        SquareMat negated = -a;
+        CHECK(negated[0][0] == -1);
+    }
+    trace::stop();
+    std::ostringstream sampled;
+    trace::writeChromeJson(sampled);
+    CHECK(occurrences(sampled.str(), "\"name\": \"unary -\"") == 2);
+    CHECK(occurrences(sampled.str(), "\"name\": \"allocate\"") == 2);
+    CHECK(trace::eventCount() == 8);
+    trace::clear();
+    CHECK(trace::eventCount() == 0);
+}
+
+/** @brief Test hardware counters, which either count or report themselves unavailable */
+TEST_CASE("Matrix Hardware Counters")
+{
+    CHECK(std::string(perf::eventName(perf::Event::Cycles)) == "cycles");
+    CHECK(std::string(perf::eventName(perf::Event::BranchMisses)) == "branch-misses");
+
+    perf::Sample empty;
+    CHECK_FALSE(empty.has(perf::Event::Instructions));
+    CHECK(empty.ipc() == 0);
+
+    perf::Counters counters;
+    SquareMat a(64);
+    for (size_t i = 0; i < 64; i++)
+    {
+        a[i][i] = 1;
+    }
+    counters.start();
+    SquareMat product = a * a;
+    perf::Sample sample = counters.stop();
+    CHECK(product[5][5] == 1);
+    for (size_t e = 0; e < perf::EventCount; e++)
+    {
+        perf::Event event = static_cast<perf::Event>(e);
+        if (!counters.available(event))
+        {
+            CHECK_FALSE(sample.has(event));
+            CHECK(sample[event] == 0);
+        }
+    }
+    if (sample.has(perf::Event::Instructions))
+    {
+        CHECK(sample[perf::Event::Instructions] > 64 * 64);
+    }
+    if (sample.has(perf::Event::Cycles) && sample.has(perf::Event::Instructions))
+    {
+        CHECK(sample.ipc() > 0);
+    }
+
+    perf::Counters process;
+    process.start();
+    std::thread worker([]() {
+        volatile double total = 0;
+        for (size_t i = 0; i < 1000000; i++)
+        {
+            total = total + 1;
+        }
+    });
+    worker.join();
+    perf::Sample threaded = process.stop();
+    if (threaded.has(perf::Event::Instructions))
+    {
+        CHECK(threaded[perf::Event::Instructions] > 1000000);
+    }
+}
+
+/** @brief Test futures of the async operators, their continuations and joins */
+TEST_CASE("Matrix Async Operators")
+{
+    SquareMat a(3);
+    a[0][0] = 2; a[0][1] = 1; a[0][2] = 0;
+    a[1][0] = 1; a[1][1] = 3; a[1][2] = 1;
+    a[2][0] = 0; a[2][1] = 1; a[2][2] = 4;
+    SquareMat b(3);
+    b[0][0] = 1; b[1][1] = 1; b[2][2] = 1;
+
+    Future<SquareMat> product = multiplyAsync(a, b);
+    Future<SquareMat> power = powAsync(a, 2);
+    Future<double> det = determinantAsync(a);
+    Future<SquareMat> sum = addAsync(a, b);
+    Future<SquareMat> difference = subtractAsync(a, b);
+    Future<SquareMat> transposed = transposeAsync(a);
+    CHECK(product.get() == a);
+    CHECK(power.get() == a * a);
+    CHECK(det.get() == doctest::Approx(18));
+    CHECK(sum.get()[1][1] == 4);
+    CHECK(difference.get()[1][1] == 2);
+    CHECK(transposed.get()[0][1] == 1);
+    CHECK(product.ready());
+
+    Future<double> chained = multiplyAsync(a, a).then([](const SquareMat &p) { return !p; });
+    CHECK(chained.get() == doctest::Approx(324));
+    Future<double> scaled = powAsync(a, 3).then([](const SquareMat &p) { return p * 2; }).then([](const SquareMat &p) { return p[0][0]; });
+    CHECK(scaled.get() == (a ^ 3)[0][0] * 2);
+
+    Future<std::pair<SquareMat, double>> both = whenAll(powAsync(a, 2), determinantAsync(a));
+    Future<double> combined = both.then([](const std::pair<SquareMat, double> &r) { return r.first[0][0] + r.second; });
+    CHECK(combined.get() == doctest::Approx(5 + 18));
+
+    Future<SquareMat> failed = multiplyAsync(a, SquareMat(2));
+    bool called = false;
+    Future<double> skipped = failed.then([&](const SquareMat &p) { called = true; return !p; });
+    CHECK_THROWS_AS(failed.get(), std::invalid_argument);
+    CHECK_THROWS_AS(skipped.get(), std::invalid_argument);
+    CHECK_FALSE(called);
+    CHECK_THROWS_AS(powAsync(a, -1).get(), std::invalid_argument);
+    CHECK_THROWS_AS(whenAll(failed, det).get(), std::invalid_argument);
+
+    Future<SquareMat> detached;
+    {
+        SquareMat::Arena arena(1 << 16);
+        detached = addAsync(a, b);
+        detached.wait();
+    }
+    CHECK(detached.get()[2][2] == 5);
+    CHECK(detached.get().getResource() == SquareMat::heapResource());
+
+    Promise<int> promise;
+    Future<int> pending = promise.getFuture();
+    Future<int> doubled = pending.then([](const int &v) { return v * 2; });
+    CHECK_FALSE(pending.ready());
+    std::thread producer([&]() { promise.setValue(21); });
+    CHECK(doubled.get() == 42);
+    producer.join();
+    CHECK_THROWS_AS(promise.setValue(1), std::logic_error);
+    CHECK_THROWS_AS(Future<int>().get(), std::logic_error);
+
+    ThreadPool pool(2);
+    std::atomic<int> result(0);
+    pool.submit([&]() { result = static_cast<int>(determinantAsync(a).then([](const double &d) { return d + 1; }).get()); });
+    while (result.load() == 0)
+    {
+        std::this_thread::yield();
+    }
+    CHECK(result.load() == 19);
+
+    SquareMat operand(64);
+    double *row = operand[0];
+    Future<SquareMat> captured = transposeAsync(operand);
+    for (size_t j = 0; j < 64; j++)
+    {
+        row[j] = 1;
+    }
+    CHECK(captured.get().sum() == 0);
+    CHECK(!operand.isShared());
+}
+
+/** @brief Test lazy task graphs: dependency order, early release of intermediates and failures */
+TEST_CASE("Matrix Task Graph")
+{
+    SquareMat m1(3), m2(3);
+    for (size_t i = 0; i < 3; i++)
+    {
+        for (size_t j = 0; j < 3; j++)
+        {
+            m1[i][j] = static_cast<double>(i * 3 + j + 1);
+            m2[i][j] = static_cast<double>(9 - i * 3 - j);
+        }
+    }
+
+    TaskGraph graph;
+    TaskGraph::Node a = graph.input(m1);
+    TaskGraph::Node b = graph.input(m2);
+    TaskGraph::Node sum = a + b;
+    TaskGraph::Node diff = a - b;
+    TaskGraph::Node product = a * b;
+    TaskGraph::Node transposed = ~a;
+    TaskGraph::Node combined = (sum * 2 - product) % transposed;
+    CHECK(graph.size() == 9);
+    CHECK_FALSE(sum.hasValue());
+    CHECK(a.hasValue());
+    CHECK_THROWS_AS(sum.get(), std::logic_error);
+
+    graph.run({diff, combined});
+    CHECK(diff.get() == m1 - m2);
+    CHECK(combined.get() == (((m1 + m2) * 2 - m1 * m2) % ~m1));
+    CHECK_FALSE(sum.hasValue());
+    CHECK_FALSE(product.hasValue());
+    CHECK_FALSE(transposed.hasValue());
+
+    graph.run({product, combined});
+    CHECK(product.get() == m1 * m2);
+    CHECK_FALSE(sum.hasValue());
+
+    TaskGraph::Node squared = graph.apply([](const std::vector<const SquareMat *> &in) { return *in[0] * *in[0]; }, {diff});
+    TaskGraph::Node powered = (-a ^ 2) / 2 + 3 * (b % 4);
+    graph.run({squared, powered});
+    CHECK(squared.get() == (m1 - m2) * (m1 - m2));
+    CHECK(powered.get() == ((-m1) ^ 2) / 2 + 3 * (m2 % 4));
+
+    TaskGraph owned;
+    TaskGraph::Node id = owned.input(SquareMat(2));
+    TaskGraph::Node self = id * id + id;
+    owned.run({self});
+    CHECK(self.get() == SquareMat(2));
+    CHECK_THROWS_AS(owned.run({sum}), std::invalid_argument);
+    CHECK_THROWS_AS(id + a, std::invalid_argument);
+
+    TaskGraph failing;
+    TaskGraph::Node x = failing.input(m1);
+    TaskGraph::Node bad = x * failing.input(SquareMat(2));
+    TaskGraph::Node after = ~bad;
+    TaskGraph::Node fine = ~x;
+    CHECK_THROWS_AS(failing.run({after, fine}), std::invalid_argument);
+    CHECK_FALSE(after.hasValue());
+    CHECK(fine.get() == ~m1);
+
+    ThreadPool pool(2);
+    std::atomic<size_t> stolen(0);
+    pool.submit([&]() {
+        for (size_t i = 0; i < 8; i++)
+        {
+            pool.spawn([&]() { stolen++; });
+        }
+    });
+    while (stolen.load() < 8)
+    {
+        pool.runPendingTask();
+    }
+    CHECK(stolen.load() == 8);
+}
+
+/** @brief Coroutine that squares a matrix on the pool and returns the product's determinant */
+Task<double> squaredDeterminant(SquareMat mat)
+{
+    co_await schedule();
+    SquareMat squared = co_await multiplyAsync(mat, mat);
+    double det = co_await determinantAsync(squared);
+    co_return det;
+}
+
+/** @brief Coroutine pipeline: transform, multiply, then write the sum into a slot */
+Task<void> pipeline(SquareMat input, const SquareMat &weights, double &out)
+{
+    auto scale = [input]() { return input * 2; };
+    SquareMat scaled = co_await runAsync(scale);
+    SquareMat product = co_await multiplyAsync(scaled, weights);
+    double det = co_await squaredDeterminant(product);
+    out = product.sum() + det;
+}
+
+/** @brief Coroutine that fails in an awaited operation */
+Task<int> failingTask()
+{
+    SquareMat left(2), right(3);
+    SquareMat product = co_await multiplyAsync(left, right);
+    co_return static_cast<int>(product.getSize());
+}
+
+/** @brief Test coroutine pipelines awaiting operators on the pool */
+TEST_CASE("Matrix Coroutine Pipelines")
+{
+    SquareMat a(2);
+    a[0][0] = 1; a[0][1] = 2;
+    a[1][0] = 3; a[1][1] = 4;
+    CHECK(syncWait(squaredDeterminant(a)) == doctest::Approx(4));
+
+    SquareMat weights(2);
+    weights[0][0] = 1; weights[1][1] = 1;
+    std::vector<double> results(16, 0);
+    std::vector<Task<void>> pipelines;
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        pipelines.push_back(pipeline(a * static_cast<double>(i + 1), weights, results[i]));
+    }
+    syncWaitAll(pipelines);
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        double k = 2.0 * static_cast<double>(i + 1);
+        CHECK(results[i] == doctest::Approx(10 * k + (-2 * k * k) * (-2 * k * k)));
+    }
+
+    CHECK_THROWS_AS(syncWait(failingTask()), std::invalid_argument);
+    std::vector<Task<void>> broken;
+    double unused = 0;
+    broken.push_back(pipeline(SquareMat(3), weights, unused));
+    CHECK_THROWS_AS(syncWaitAll(broken), std::invalid_argument);
+}
+
+/** @brief Test in-place GEMM and addProduct against the operator expressions */
+TEST_CASE("Matrix GEMM")
+{
+    const size_t n = 300;
+    SquareMat a(n), b(n), c(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t j = 0; j < n; j++)
+        {
+            a[i][j] = static_cast<double>((i * 7 + j * 3) % 11) - 5;
+            b[i][j] = static_cast<double>((i * 5 + j * 13) % 7) - 3;
+            c[i][j] = static_cast<double>((i + j) % 5);
+        }
+    }
+    SquareMat expected = a * b * 2 + c * 3;
+    SquareMat result(c);
+    gemm(2, a, b, 3, result);
+    CHECK(result == expected);
+    CHECK(result[17][123] == expected[17][123]);
+
+    SquareMat accumulated(c);
+    accumulated.addProduct(a, b).addProduct(b, a, -0.5);
+    SquareMat sum = c + a * b - b * a * 0.5;
+    CHECK(accumulated[0][0] == sum[0][0]);
+    CHECK(accumulated[n - 1][5] == sum[n - 1][5]);
+
+    SquareMat small(3), upper(3), lower(3), target(3);
+    for (size_t i = 0; i < 3; i++)
+    {
+        for (size_t j = 0; j < 3; j++)
+        {
+            small[i][j] = static_cast<double>(i * 3 + j + 1);
+            upper[i][j] = j >= i ? static_cast<double>(i + j + 1) : 0;
+            lower[i][j] = j <= i ? static_cast<double>(2 * i + j + 1) : 0;
+            target[i][j] = std::nan("");
+        }
+    }
+    gemm(1, upper, lower, 0, target);
+    CHECK(target[0][0] == (upper * lower)[0][0]);
+    CHECK(target[2][1] == (upper * lower)[2][1]);
+    gemm(1, lower, small, 0, target);
+    CHECK(target[1][2] == (lower * small)[1][2]);
+    gemm(0, small, small, 0, target);
+    CHECK(target == SquareMat(3));
+
+    SquareMat aliased(small);
+    gemm(1, aliased, small, 1, aliased);
+    CHECK(aliased[1][1] == small[1][1] + (small * small)[1][1]);
+    SquareMat selfProduct(small);
+    selfProduct.addProduct(selfProduct, selfProduct, 2);
+    CHECK(selfProduct[2][0] == small[2][0] + 2 * (small * small)[2][0]);
+
+    CHECK_THROWS_AS(gemm(1, small, a, 0, target), std::invalid_argument);
+    CHECK_THROWS_AS(target.addProduct(small, SquareMat(2)), std::invalid_argument);
+
+    stats::reset();
+    SquareMat into(small);
+    into.addProduct(small, small, 3);
+    stats::OperationStats counted = stats::get(stats::Operation::Gemm);
+    CHECK(std::string(counted.name) == "gemm");
+    if (stats::Enabled)
+    {
+        CHECK(counted.calls == 1);
+        CHECK(counted.allocations == 0);
+        CHECK(counted.flops == 2 * 27);
+    }
+}
+
+/** @brief Test the fused addScaled, scaleAndAdd, axpy and axpby updates */
+TEST_CASE("Matrix Fused AXPY")
+{
+    const size_t n = 300;
+    SquareMat a(n), b(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t j = 0; j < n; j++)
+        {
+            a[i][j] = static_cast<double>((i * 7 + j * 3) % 13) - 6;
+            b[i][j] = static_cast<double>((i * 5 + j) % 11) * 0.5;
+        }
+    }
+    SquareMat expected = a + b * 2.5;
+    SquareMat updated(a);
+    updated.addScaled(b, 2.5);
+    CHECK(updated[0][0] == expected[0][0]);
+    CHECK(updated[n - 1][n - 2] == expected[n - 1][n - 2]);
+    CHECK(updated == expected);
+    updated.addScaled(b, -2.5);
+    CHECK(updated[123][45] == a[123][45]);
+
+    SquareMat combined(a);
+    combined.scaleAndAdd(0.5, b, -3);
+    CHECK(combined[17][299] == 0.5 * a[17][299] - 3 * b[17][299]);
+    SquareMat viaAxpy(a);
+    axpy(-1, b, viaAxpy);
+    CHECK(viaAxpy[250][3] == a[250][3] - b[250][3]);
+    SquareMat viaAxpby(a);
+    axpby(2, b, 4, viaAxpby);
+    CHECK(viaAxpby[9][8] == 4 * a[9][8] + 2 * b[9][8]);
+
+    SquareMat garbage(3), small(3);
+    for (size_t i = 0; i < 3; i++)
+    {
+        for (size_t j = 0; j < 3; j++)
+        {
+            garbage[i][j] = std::nan("");
+            small[i][j] = static_cast<double>(i + j);
+        }
+    }
+    garbage.scaleAndAdd(0, small, 2);
+    CHECK(garbage == small * 2);
+
+    SquareMat self(small);
+    self.addScaled(self, 1);
+    CHECK(self[2][1] == 2 * small[2][1]);
+    self.addScaled(self, -1);
+    CHECK(self == SquareMat(3));
+    SquareMat selfCombined(small);
+    selfCombined.scaleAndAdd(3, selfCombined, -1);
+    CHECK(selfCombined[1][2] == 2 * small[1][2]);
+
+    CHECK_THROWS_AS(small.addScaled(a, 1), std::invalid_argument);
+    CHECK_THROWS_AS(small.scaleAndAdd(1, SquareMat(2), 1), std::invalid_argument);
+    CHECK_THROWS_AS(axpy(1, small, a), std::invalid_argument);
+
+    stats::reset();
+    SquareMat into(small);
+    into.addScaled(small, 3);
+    stats::OperationStats counted = stats::get(stats::Operation::AddScaled);
+    CHECK(std::string(counted.name) == "axpy");
+    if (stats::Enabled)
+    {
+        CHECK(counted.calls == 1);
+        CHECK(counted.allocations == 0);
+        CHECK(counted.flops == 2 * 9);
+    }
+}
+
+/** @brief Test modular matrices: lazy-reduction products and huge powers */
+TEST_CASE("ModMat Operations")
+{
+    __extension__ typedef unsigned __int128 Exact;
+    const uint64_t prime = 1000000007;
+    const uint64_t mersenne = (uint64_t(1) << 61) - 1;
+    SquareMat step(2);
+    step[0][0] = 1;
+    step[0][1] = 1;
+    step[1][0] = 1;
+    ModMat fibonacci(step, prime);
+    ModMat f90 = fibonacci ^ 90;
+    CHECK(f90(0, 1) == 210345902);
+    CHECK(f90(0, 0) == 755204270);
+    CHECK((ModMat(step, mersenne) ^ 90)(0, 1) == 574224185157122169ULL);
+    CHECK((fibonacci ^ 0) == ModMat::identity(2, prime));
+
+    SquareMat triangle(3);
+    for (size_t i = 0; i < 3; i++)
+    {
+        for (size_t j = 0; j < 3; j++)
+        {
+            triangle[i][j] = i == j ? 0 : 1;
+        }
+    }
+    CHECK((ModMat(triangle, prime) ^ 60)(1, 1) == 512132171);
+
+    for (uint64_t modulus : {uint64_t(998244353), uint64_t(1) << 32, mersenne, uint64_t(1) << 63})
+    {
+        const size_t n = 50;
+        ModMat a(n, modulus), b(n, modulus);
+        for (size_t i = 0; i < n; i++)
+        {
+            for (size_t j = 0; j < n; j++)
+            {
+                a.set(i, j, static_cast<int64_t>((i * 7919 + j * 104729) * 2654435761ULL % 4000000000000000000ULL) - 2000000000000000000LL);
+                b.set(i, j, static_cast<int64_t>(i * 31 + j * 17) - 700);
+            }
+        }
+        ModMat product = a * b;
+        for (size_t i : {size_t(0), size_t(23), n - 1})
+        {
+            for (size_t j : {size_t(0), size_t(31), n - 1})
+            {
+                Exact expected = 0;
+                for (size_t k = 0; k < n; k++)
+                {
+                    expected = (expected + static_cast<Exact>(a(i, k)) * b(k, j)) % modulus;
+                }
+                CHECK(product(i, j) == static_cast<uint64_t>(expected));
+            }
+        }
+        const uint64_t huge = 1000000000000000000ULL;
+        CHECK((a ^ huge) == (a ^ (huge - 12345)) * (a ^ 12345));
+    }
+
+    ModMat small(2, 7);
+    small.set(0, 0, -1);
+    small.set(0, 1, 15);
+    small.set(1, 0, 6);
+    CHECK(small(0, 0) == 6);
+    CHECK(small(0, 1) == 1);
+    CHECK((small + small)(0, 0) == 5);
+    CHECK((small - small * 3)(0, 1) == 5);
+    CHECK((-small)(1, 1) == 0);
+    CHECK((-small)(1, 0) == 1);
+    CHECK((small * 10)(1, 0) == 4);
+    CHECK(small.toSquareMat()[0][0] == 6);
+    ModMat moved(std::move(small));
+    CHECK(moved(0, 1) == 1);
+
+    CHECK_THROWS_AS(ModMat(0, 7), std::invalid_argument);
+    CHECK_THROWS_AS(ModMat(2, 1), std::invalid_argument);
+    CHECK_THROWS_AS(ModMat(2, (uint64_t(1) << 63) + 1), std::invalid_argument);
+    CHECK_THROWS_AS(moved + ModMat(2, 11), std::invalid_argument);
+    CHECK_THROWS_AS(moved * ModMat(3, 7), std::invalid_argument);
+    CHECK_THROWS_AS(moved(2, 0), std::out_of_range);
+    step[1][1] = 0.5;
+    CHECK_THROWS_AS(ModMat(step, prime), std::invalid_argument);
+}
+
+/** @brief Test the mixed-precision product, the LU solve and iterative refinement */
+TEST_CASE("Mixed Precision")
+{
+    const size_t n = 300;
+    SquareMat a(n), b(n), c(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t j = 0; j < n; j++)
+        {
+            a[i][j] = static_cast<double>((i * 7 + j * 3) % 13) - 6;
+            b[i][j] = static_cast<double>((i * 5 + j) % 11) - 5;
+            c[i][j] = std::sin(static_cast<double>(i * n + j));
+        }
+    }
+    SquareMat exact = a * b;
+    SquareMat mixed = multiplyMixed(a, b);
+    double worst = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t j = 0; j < n; j++)
+        {
+            worst = std::max(worst, std::fabs(mixed[i][j] - exact[i][j]));
+        }
+    }
+    CHECK(worst == 0);
+    SquareMat product = multiplyMixed(a, b);
+    SquareMat shared(product);
+    CHECK(shared.isShared());
+    SquareMat rounded = multiplyMixed(c, c);
+    SquareMat reference = c * c;
+    CHECK(rounded[17][250] == doctest::Approx(reference[17][250]).epsilon(1e-4));
+    CHECK(std::fabs(rounded[299][0] - reference[299][0]) < 1e-4 * n);
+    CHECK_THROWS_AS(multiplyMixed(a, SquareMat(2)), std::invalid_argument);
+
+    SquareMat system(3);
+    system[0][0] = 2;
+    system[0][1] = 1;
+    system[1][0] = 1;
+    system[1][1] = 3;
+    system[1][2] = 1;
+    system[2][1] = 1;
+    system[2][2] = 4;
+    Vector x = solve(system, Vector{3, 5, 5});
+    CHECK(x[0] == doctest::Approx(1));
+    CHECK(x[1] == doctest::Approx(1));
+    CHECK(x[2] == doctest::Approx(1));
+    CHECK_THROWS_AS(solve(SquareMat(3), Vector{1, 2, 3}), std::invalid_argument);
+    CHECK_THROWS_AS(solve(system, Vector{1, 2}), std::invalid_argument);
+
+    SquareMat dominant(c);
+    Vector rhs(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        dominant[i][i] += n;
+        rhs[i] = std::cos(static_cast<double>(i));
+    }
+    MixedSolver solver(dominant, 1e-14);
+    Vector refined = solver.solve(rhs);
+    Vector residual(rhs);
+    gemv(-1, dominant, refined, 1, residual);
+    double residualNorm = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        residualNorm = std::max(residualNorm, std::fabs(residual[i]));
+    }
+    CHECK(residualNorm < 1e-11);
+    CHECK(solver.getIterations() >= 1);
+    CHECK_FALSE(solver.usedFallback());
+    Vector direct = solve(dominant, rhs);
+    CHECK(refined[42] == doctest::Approx(direct[42]).epsilon(1e-12));
+    Vector zero = solver.solve(Vector(n));
+    CHECK(zero[7] == 0);
+    CHECK(solver.getIterations() == 0);
+
+    const size_t h = 10;
+    SquareMat hilbert(h);
+    for (size_t i = 0; i < h; i++)
+    {
+        for (size_t j = 0; j < h; j++)
+        {
+            hilbert[i][j] = 1.0 / static_cast<double>(i + j + 1);
+        }
+    }
+    Vector ones(h);
+    for (size_t i = 0; i < h; i++)
+    {
+        ones[i] = 1;
+    }
+    MixedSolver illConditioned(hilbert);
+    Vector hx = illConditioned.solve(hilbert * ones);
+    CHECK(illConditioned.usedFallback());
+    CHECK(hx[3] == doctest::Approx(solve(hilbert, hilbert * ones)[3]));
+
+    SquareMat huge(system * 1e39);
+    MixedSolver wide(huge);
+    Vector wx = wide.solve(Vector{3e39, 5e39, 5e39});
+    CHECK(wide.usedFallback());
+    CHECK(wx[1] == doctest::Approx(1));
+
+    CHECK_THROWS_AS(MixedSolver(system, 0), std::invalid_argument);
+    CHECK_THROWS_AS(solver.solve(Vector{1, 2}), std::invalid_argument);
+    MixedSolver singular((SquareMat(3)));
+    CHECK_THROWS_AS(singular.solve(Vector{1, 2, 3}), std::invalid_argument);
+}
+
+/**
+ * @brief Test that copies share storage until the first write, across threads and resources
+ */
+TEST_CASE("Matrix Copy-On-Write")
+{
+    SquareMat filled(3);
+    filled[0][0] = 1;
+    filled[1][2] = 5;
+    SquareMat a(3);
+    a = filled;
+    CHECK(!a.isShared());
+    const SquareMat &original = a;
+
+    SquareMat b(a);
+    CHECK(a.isShared());
+    CHECK(b.isShared());
+    const SquareMat &view = b;
+    CHECK(view[1][2] == 5);
+    CHECK(b.isShared());
+    b[1][2] = 7;
+    CHECK(!a.isShared());
+    CHECK(!b.isShared());
+    CHECK(original[1][2] == 5);
+    CHECK(b[1][2] == 7);
+
+    SquareMat c(2);
+    c = a;
+    CHECK(c.getSize() == 3);
+    CHECK(c.isShared());
+    c += a;
+    CHECK(c[1][2] == 10);
+    CHECK(original[1][2] == 5);
+    CHECK(!a.isShared());
+
+    SquareMat d = a;
+    d *= 2;
+    SquareMat e = a;
+    e++;
+    CHECK(d[1][2] == 10);
+    CHECK(e[1][2] == 6);
+    CHECK(original[1][2] == 5);
+    SquareMat f = a;
+    SquareMat before = f--;
+    CHECK(before == a);
+    CHECK(before[1][2] == 5);
+    CHECK(f[1][2] == 4);
+    CHECK(original[0][0] == 1);
+
+    SquareMat g = a;
+    SquareMat moved(std::move(g));
+    CHECK(moved.isShared());
+    SquareMat h = a;
+    h = SquareMat(3);
+    CHECK(h[1][2] == 0);
+    CHECK(moved[1][2] == 5);
+    CHECK(!a.isShared());
+
+    CountingResource counting;
+    {
+        SquareMat local(3, &counting);
+        ++local;
+        SquareMat same(local);
+        CHECK(same.isShared());
+        SquareMat placed(local, std::pmr::new_delete_resource());
+        CHECK(!placed.isShared());
+        CHECK(placed.getResource() == std::pmr::new_delete_resource());
+        SquareMat heapCopy(a, &counting);
+        CHECK(!heapCopy.isShared());
+        CHECK(counting.allocations == 2);
+
+        SquareMat escaped(3);
+        SquareMat::Arena arena;
+        SquareMat temp = a + a;
+        SquareMat tempCopy(temp);
+        CHECK(tempCopy.isShared());
+        SquareMat fromHeap(a);
+        CHECK(fromHeap.isShared());
+        CHECK(fromHeap.getResource() == &arena);
+        escaped = temp;
+        CHECK(!escaped.isShared());
+        CHECK(escaped.getResource() == SquareMat::heapResource());
+        SquareMat arenaOwned = a * 1.0;
+        arenaOwned = a;
+        CHECK(arenaOwned.isShared());
+        arenaOwned[0][0] = 9;
+        CHECK(arenaOwned.getResource() == &arena);
+        CHECK(original[0][0] == 1);
+        same[0][0] = 8;
+        CHECK(static_cast<const SquareMat &>(local)[0][0] == 1);
+        CHECK(counting.allocations == 3);
+    }
+    CHECK(counting.live == 0);
+
+    SquareMat corner(64);
+    corner[63][63] = 1;
+    SquareMat big(64);
+    big = corner;
+    std::vector<SquareMat> copies;
+    for (int i = 0; i < 8; i++)
+    {
+        copies.push_back(big);
+    }
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++)
+    {
+        threads.emplace_back([&copies, &mismatches, t]() {
+            for (int round = 0; round < 50; round++)
+            {
+                SquareMat local(copies[2 * t]);
+                SquareMat other = copies[2 * t + 1];
+                local[0][0] = t;
+                if (local.sum() != t + 1 || other.sum() != 1)
+                {
+                    mismatches++;
+                }
+            }
+        });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    CHECK(mismatches == 0);
+    CHECK(big.sum() == 1);
+    CHECK(big.isShared());
+    copies.clear();
+    CHECK(!big.isShared());
+
+    SquareMat kept(3);
+    double *row = kept[0];
+    SquareMat snapshot(kept);
+    CHECK(!kept.isShared());
+    CHECK(!snapshot.isShared());
+    row[0] = 5;
+    CHECK(static_cast<const SquareMat &>(snapshot)[0][0] == 0);
+    CHECK(static_cast<const SquareMat &>(kept)[0][0] == 5);
+    SquareMat reassigned = kept;
+    CHECK(!reassigned.isShared());
+    kept = snapshot;
+    SquareMat sharedAgain(kept);
+    CHECK(sharedAgain.isShared());
+
+    SquareMat viewSum = SquareMatView(a) + SquareMatView(a);
+    SquareMat viewSumCopy(viewSum);
+    CHECK(viewSumCopy.isShared());
+    SquareMat exponential = expm(a);
+    SquareMat exponentialCopy = exponential;
+    CHECK(exponentialCopy.isShared());
+    SquareMat inverted = Factorization(exponential).inverse();
+    SquareMat invertedCopy(inverted);
+    CHECK(invertedCopy.isShared());
+    SquareMat raw(3);
+    raw.data()[4] = 2;
+    SquareMat rawCopy(raw);
+    CHECK(rawCopy.isShared());
+    CHECK(rawCopy.data()[4] == 2);
+    CHECK(!raw.isShared());
+    CHECK(std::as_const(raw).data()[4] == 2);
+
+    stats::reset();
+    SquareMat source(4);
+    SquareMat first(source);
+    SquareMat second = source;
+    second[0][0] = 1;
+    if (stats::Enabled)
+    {
+        CHECK(stats::get(stats::Operation::Copy).calls == 2);
+        CHECK(stats::get(stats::Operation::Copy).elements == 0);
+        CHECK(stats::get(stats::Operation::Copy).allocations == 0);
+        CHECK(stats::get(stats::Operation::Unshare).calls == 1);
+        CHECK(stats::get(stats::Operation::Unshare).allocations == 1);
+        CHECK(std::string(stats::get(stats::Operation::Unshare).name) == "unshare");
+    }
+    stats::reset();
+}
+
+/**
+ * @brief Test block and external-memory views: operators, GEMM on blocks, products and minors without copies
+ */
+TEST_CASE("Matrix Views")
+{
+    const size_t n = 6;
+    SquareMat a(n), b(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t j = 0; j < n; j++)
+        {
+            a[i][j] = static_cast<double>((i * 7 + j * 3) % 5) - 2;
+            b[i][j] = static_cast<double>((i + 2 * j) % 4) + 1;
+        }
+    }
+
+    SquareMatView whole(a);
+    CHECK(whole.getSize() == n);
+    CHECK(whole.getStride() == n);
+    SquareMatView block(a, 1, 2, 3);
+    CHECK(block.getSize() == 3);
+    CHECK(block.getStride() == n);
+    CHECK(block[0][0] == a[1][2]);
+    CHECK(block[2][1] == a[3][3]);
+    SquareMatView inner = block.block(1, 1, 2);
+    CHECK(inner[1][1] == a[3][4]);
+    CHECK_THROWS_AS(block[3], std::out_of_range);
+    CHECK_THROWS_AS(SquareMatView(a, 4, 0, 3), std::out_of_range);
+    CHECK_THROWS_AS(block.block(0, 0, 0), std::invalid_argument);
+    CHECK_THROWS_AS(SquareMatView(a[0], 3, 2), std::invalid_argument);
+
+    SquareMat copy = block.toSquareMat();
+    CHECK(copy.getSize() == 3);
+    CHECK(copy[1][2] == a[2][4]);
+    SquareMatView other(b, 3, 3, 3);
+    SquareMat otherCopy = other.toSquareMat();
+    CHECK((block + other) == copy + otherCopy);
+    CHECK((block + other)[2][2] == a[3][4] + b[5][5]);
+    CHECK((block - other)[0][1] == a[1][3] - b[3][4]);
+    CHECK((block % other)[1][0] == a[2][2] * b[4][3]);
+    CHECK((block * 2.0)[0][2] == 2 * a[1][4]);
+    CHECK((2.0 * block)[0][2] == 2 * a[1][4]);
+    CHECK((block / 2.0)[2][0] == a[3][2] / 2);
+    CHECK((-block)[1][1] == -a[2][3]);
+    CHECK((block % 2)[0][0] == fmod(a[1][2], 2));
+    CHECK((~block)[2][0] == a[1][4]);
+    CHECK((block ^ 3)[1][2] == (copy * copy * copy)[1][2]);
+    CHECK((block * other)[0][0] == (copy * otherCopy)[0][0]);
+    CHECK((copy * other)[2][1] == (copy * otherCopy)[2][1]);
+    CHECK(block.sum() == copy.sum());
+    CHECK(block.sum(SquareMat::Summation::Naive) == copy.sum(SquareMat::Summation::Naive));
+    CHECK(block == copy);
+    CHECK(copy == block);
+    CHECK(block != other);
+    CHECK((block < other) == (copy < otherCopy));
+    CHECK(!block == doctest::Approx(!copy));
+    CHECK(!whole == doctest::Approx(!a));
+    CHECK_THROWS_AS(block + whole, std::invalid_argument);
+    CHECK_THROWS_AS(block ^ -1, std::invalid_argument);
+    CHECK_THROWS_AS(block / 0.0, std::invalid_argument);
+
+    std::ostringstream viewOut, copyOut;
+    viewOut << block;
+    copyOut << copy;
+    CHECK(viewOut.str() == copyOut.str());
+
+    std::vector<double> raw(4 * 5, 0.0);
+    for (size_t i = 0; i < 4; i++)
+    {
+        for (size_t j = 0; j < 4; j++)
+        {
+            raw[i * 5 + j] = static_cast<double>(i == j ? 2 : 0);
+        }
+    }
+    SquareMatView external(raw.data(), 4, 5);
+    CHECK(!external == 16);
+    CHECK((external * external)[3][3] == 4);
+    Vector ones{1, 1, 1, 1};
+    CHECK((external * ones)[2] == 2);
+    CHECK((ones * external)[1] == 2);
+    Vector blockRow = block * Vector{1, 0, 0};
+    CHECK(blockRow[2] == a[3][2]);
+    CHECK(multiplyBatch(block, {Vector{0, 1, 0}})[0][1] == a[2][3]);
+
+    const size_t h = n / 2;
+    SquareMat blocked(n);
+    SquareMat quadrant(h);
+    for (size_t bi = 0; bi < 2; bi++)
+    {
+        for (size_t bj = 0; bj < 2; bj++)
+        {
+            gemm(1.0, SquareMatView(a, bi * h, 0, h), SquareMatView(b, 0, bj * h, h), 0.0, quadrant);
+            gemm(1.0, SquareMatView(a, bi * h, h, h), SquareMatView(b, h, bj * h, h), 1.0, quadrant);
+            for (size_t i = 0; i < h; i++)
+            {
+                for (size_t j = 0; j < h; j++)
+                {
+                    blocked[bi * h + i][bj * h + j] = quadrant[i][j];
+                }
+            }
+        }
+    }
+    SquareMat full = a * b;
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t j = 0; j < n; j++)
+        {
+            CHECK(blocked[i][j] == full[i][j]);
+        }
+    }
+
+    SquareMat target = copy;
+    SquareMat expected = copy * copy * 2.0 + copy;
+    gemm(2.0, SquareMatView(target), target, 1.0, target);
+    CHECK(target == expected);
+    CHECK(target[1][1] == expected[1][1]);
+
+    double viewDet = !whole;
+    stats::reset();
+    double det = !a;
+    CHECK(det == doctest::Approx(viewDet));
+    if (stats::Enabled)
+    {
+        CHECK(stats::get(stats::Operation::Determinant).calls == 1);
+        CHECK(stats::get(stats::Operation::Determinant).allocations == 0);
+        CHECK(stats::get(stats::Operation::Determinant).flops > 0);
+    }
+    stats::reset();
+}
+
+/** @brief Test multiprecision integers and the exact Bareiss determinant */
+TEST_CASE("Exact Determinant")
+{
+    BigInt factorial(1);
+    for (int64_t k = 2; k <= 30; k++)
+    {
+        factorial = factorial * BigInt(k);
+    }
+    CHECK(factorial.toString() == "265252859812191058636308480000000");
+    CHECK((-factorial).toString() == "-265252859812191058636308480000000");
+    CHECK(BigInt(INT64_MIN).toString() == "-9223372036854775808");
+    BigInt divisor = BigInt(1234567890123LL) * BigInt(987654321987LL) + BigInt(17);
+    BigInt quotient = factorial / divisor;
+    BigInt remainder = factorial % divisor;
+    CHECK(quotient * divisor + remainder == factorial);
+    CHECK(remainder < divisor);
+    CHECK(BigInt(0) < remainder);
+    CHECK((-factorial) / divisor == -quotient);
+    CHECK((-factorial) % divisor == -remainder);
+    BigInt power(1);
+    for (int64_t k = 1; k <= 60; k++)
+    {
+        power = power * BigInt(3 * k + 1);
+        BigInt modulus = power / BigInt(k * k * 7 + 5) + BigInt(k);
+        BigInt q = power * power / modulus;
+        BigInt r = power * power % modulus;
+        CHECK(q * modulus + r == power * power);
+        CHECK(r < modulus);
+        CHECK_FALSE(r < BigInt(0));
+    }
+    CHECK(BigInt(-7) / BigInt(2) == BigInt(-3));
+    CHECK(BigInt(-7) % BigInt(2) == BigInt(-1));
+    CHECK((factorial - factorial).isZero());
+    CHECK((factorial - factorial).sign() == 0);
+    CHECK_THROWS_AS(factorial / BigInt(0), std::invalid_argument);
+    CHECK(factorial.toDouble() == 265252859812191058636308480000000.0);
+    BigInt tie = BigInt((int64_t(1) << 53) + 1) * BigInt(int64_t(1) << 20);
+    CHECK(tie.toDouble() == std::ldexp(9007199254740992.0, 20));
+    CHECK((tie + BigInt(1)).toDouble() == std::ldexp(9007199254740994.0, 20));
+    CHECK(BigInt(-5).toDouble() == -5.0);
+
+    const size_t n = 13;
+    SquareMat vandermonde(n);
+    BigInt expected(1);
+    for (size_t i = 0; i < n; i++)
+    {
+        double power = 1;
+        for (size_t j = 0; j < n; j++)
+        {
+            vandermonde[i][j] = power;
+            power *= static_cast<double>(i + 1);
+        }
+        for (size_t j = 0; j < i; j++)
+        {
+            expected = expected * BigInt(static_cast<int64_t>(i - j));
+        }
+    }
+    CHECK(isIntegerValued(vandermonde));
+    BigInt det = determinantExact(vandermonde);
+    CHECK(det == expected);
+    CHECK(det.bitLength() > 128);
+    CHECK(!vandermonde == expected.toDouble());
+    CHECK(determinantExact(SquareMatView(vandermonde, 0, 0, 3)) == BigInt(2));
+
+    const size_t m = 40;
+    SquareMat lower(m), upper(m);
+    BigInt product(1);
+    for (size_t i = 0; i < m; i++)
+    {
+        for (size_t j = 0; j < m; j++)
+        {
+            lower[i][j] = i == j ? 1 : (j < i ? static_cast<double>((i * 5 + j * 3) % 19) - 9 : 0);
+            upper[i][j] = i == j ? static_cast<double>(i % 3 + 1) : (j > i ? static_cast<double>((i * 7 + j) % 17) - 8 : 0);
+        }
+        product = product * BigInt(static_cast<int64_t>(i % 3 + 1));
+    }
+    SquareMat factored = lower * upper;
+    CHECK(determinantExact(factored) == product);
+    std::swap_ranges(factored[0], factored[0] + m, factored[1]);
+    CHECK(determinantExact(factored) == -product);
+
+    SquareMat swapped(3);
+    swapped[0][1] = 2;
+    swapped[1][0] = 3;
+    swapped[2][2] = 5;
+    CHECK(determinantExact(swapped) == BigInt(-30));
+    swapped[2][0] = 6;
+    CHECK(!swapped == -30.0);
+    SquareMat singular(4);
+    for (size_t i = 0; i < 4; i++)
+    {
+        for (size_t j = 0; j < 4; j++)
+        {
+            singular[i][j] = static_cast<double>(i * 4 + j);
+        }
+    }
+    CHECK(determinantExact(singular).isZero());
+    CHECK(!singular == 0.0);
+
+    SquareMat fractional(2);
+    fractional[0][0] = 0.5;
+    fractional[1][1] = 4;
+    CHECK_FALSE(isIntegerValued(fractional));
+    CHECK_THROWS_AS(determinantExact(fractional), std::invalid_argument);
+    CHECK(!fractional == 2.0);
+    fractional[0][0] = 9223372036854775808.0;
+    CHECK_FALSE(isIntegerValued(fractional));
+    fractional[0][0] = -9223372036854775808.0;
+    CHECK(isIntegerValued(fractional));
+    CHECK(determinantExact(fractional) == BigInt(INT64_MIN) * BigInt(4));
+}
+
+/** @brief Test log-determinants and the shared Cholesky/LU factor cache */
+TEST_CASE("Log Determinant")
+{
+    SquareMat spd(4);
+    for (size_t i = 0; i < 4; i++)
+    {
+        for (size_t j = 0; j < 4; j++)
+        {
+            spd[i][j] = i == j ? 4.5 : 1.0 / static_cast<double>(i + j + 1);
+        }
+    }
+    stats::reset();
+    Factorization cached(spd);
+    CHECK(cached.getSize() == 4);
+    CHECK(cached.isPositiveDefinite());
+    LogDeterminant spdLog = cached.logDeterminant();
+    CHECK(spdLog.sign == 1);
+    CHECK(spdLog.logAbs == doctest::Approx(std::log(!spd)));
+    CHECK(cached.determinant() == doctest::Approx(!spd));
+    Vector x = cached.solve(Vector{1, 2, 3, 4});
+    Vector back = spd * x;
+    CHECK(back[0] == doctest::Approx(1));
+    CHECK(back[3] == doctest::Approx(4));
+    SquareMat identity = spd * cached.inverse();
+    CHECK(identity[1][1] == doctest::Approx(1));
+    CHECK(std::fabs(identity[2][0]) < 1e-14);
+    if (stats::Enabled)
+    {
+        CHECK(stats::get(stats::Operation::Factorize).calls == 1);
+        CHECK(std::string(stats::get(stats::Operation::Factorize).name) == "factorize");
+    }
+
+    SquareMat general(3);
+    general[0][0] = 1;
+    general[0][1] = 2;
+    general[0][2] = 0.5;
+    general[1][0] = 3;
+    general[1][1] = 1;
+    general[2][1] = 4;
+    general[2][2] = 2;
+    double generalDet = !general;
+    LogDeterminant generalLog = logDeterminant(general);
+    CHECK(generalLog.sign == (generalDet < 0 ? -1 : 1));
+    CHECK(generalLog.logAbs == doctest::Approx(std::log(std::fabs(generalDet))));
+    CHECK(logDeterminant(SquareMatView(spd, 1, 1, 2)).logAbs == doctest::Approx(std::log(4.5 * 4.5 - 0.0625)));
+
+    SquareMat indefinite(2);
+    indefinite[0][0] = 1;
+    indefinite[0][1] = 2;
+    indefinite[1][0] = 2;
+    indefinite[1][1] = 1;
+    stats::reset();
+    Factorization mixedSign(indefinite);
+    CHECK_FALSE(mixedSign.isPositiveDefinite());
+    CHECK(mixedSign.logDeterminant().sign == -1);
+    CHECK(mixedSign.determinant() == doctest::Approx(-3));
+    CHECK(mixedSign.solve(Vector{3, 3})[1] == doctest::Approx(1));
+    CHECK(mixedSign.inverse()[0][1] == doctest::Approx(2.0 / 3));
+    if (stats::Enabled)
+    {
+        CHECK(stats::get(stats::Operation::Factorize).calls == 2);
+    }
+
+    const size_t n = 300;
+    SquareMat lower(n), upper(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t j = 0; j < n; j++)
+        {
+            lower[i][j] = i == j ? 1 : (j < i ? std::sin(static_cast<double>(i * n + j)) / 4 : 0);
+            upper[i][j] = i == j ? (i % 2 == 0 ? 20 : -20) : (j > i ? std::cos(static_cast<double>(i + 3 * j)) : 0);
+        }
+    }
+    SquareMat large = lower * upper;
+    LogDeterminant largeLog = logDeterminant(large);
+    CHECK(std::isinf(std::pow(20.0, static_cast<double>(n))));
+    CHECK(largeLog.logAbs == doctest::Approx(n * std::log(20.0)).epsilon(1e-10));
+    CHECK(largeLog.sign == 1);
+    SquareMat small = large * 1e-3;
+    LogDeterminant smallLog = logDeterminant(small);
+    CHECK(smallLog.logAbs == doctest::Approx(n * std::log(0.02)).epsilon(1e-10));
+    SquareMat covariance = ~large * large;
+    Factorization gaussian(covariance);
+    CHECK(gaussian.isPositiveDefinite());
+    CHECK(gaussian.logDeterminant().logAbs == doctest::Approx(2 * n * std::log(20.0)).epsilon(1e-8));
+
+    SquareMat singular(3);
+    singular[0][0] = 1;
+    singular[1][1] = 1;
+    Factorization degenerate(singular);
+    CHECK_FALSE(degenerate.isPositiveDefinite());
+    CHECK(degenerate.logDeterminant().sign == 0);
+    CHECK(std::isinf(degenerate.logDeterminant().logAbs));
+    CHECK(degenerate.determinant() == 0);
+    CHECK_THROWS_AS(degenerate.solve(Vector{1, 2, 3}), std::invalid_argument);
+    CHECK_THROWS_AS(degenerate.inverse(), std::invalid_argument);
+    CHECK_THROWS_AS(cached.solve(Vector{1, 2}), std::invalid_argument);
+    stats::reset();
+}
+
+/** @brief Test rank-1 updates of the determinant, inverse and LU factors */
+TEST_CASE("Rank-One Updates")
+{
+    const size_t n = 40;
+    SquareMat base(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t j = 0; j < n; j++)
+        {
+            base[i][j] = i == j ? 6 + std::sin(static_cast<double>(i)) : std::cos(static_cast<double>(3 * i + j)) / 4;
+        }
+    }
+    RefactorPolicy never;
+    never.interval = 0;
+    never.tolerance = 0;
+    stats::reset();
+    RankOneUpdater updater(base, never);
+    CHECK(updater.getRefactorCount() == 1);
+    CHECK(updater.determinant() == doctest::Approx(Factorization(base).determinant()));
+    for (size_t step = 0; step < 10; step++)
+    {
+        Vector u(n), v(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            u[i] = std::sin(static_cast<double>(step * n + i)) / 2;
+            v[i] = std::cos(static_cast<double>(step + 7 * i)) / 2;
+        }
+        updater.update(u, v);
+    }
+    CHECK(updater.getRefactorCount() == 1);
+    CHECK(updater.getUpdatesSinceRefactor() == 10);
+    if (stats::Enabled)
+    {
+        CHECK(stats::get(stats::Operation::Factorize).calls == 2);
+    }
+    Factorization fresh(updater.matrix());
+    LogDeterminant expected = fresh.logDeterminant();
+    CHECK(updater.logDeterminant().sign == expected.sign);
+    CHECK(updater.logDeterminant().logAbs == doctest::Approx(expected.logAbs).epsilon(1e-12));
+    SquareMat inverse = fresh.inverse();
+    double inverseError = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t j = 0; j < n; j++)
+        {
+            inverseError = std::max(inverseError, std::fabs(updater.inverse()[i][j] - inverse[i][j]));
+        }
+    }
+    CHECK(inverseError < 1e-12);
+    Vector rhs(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        rhs[i] = static_cast<double>(i % 5) - 2;
+    }
+    Vector x = updater.solve(rhs);
+    Vector reference = fresh.solve(rhs);
+    for (size_t i = 0; i < n; i++)
+    {
+        CHECK(x[i] == doctest::Approx(reference[i]).epsilon(1e-11));
+    }
+
+    RefactorPolicy periodic;
+    periodic.interval = 4;
+    RankOneUpdater scheduled(base, periodic);
+    for (size_t step = 0; step < 10; step++)
+    {
+        Vector u(n), v(n);
+        u[step] = 0.5;
+        v[n - 1 - step] = 0.25;
+        scheduled.update(u, v);
+    }
+    CHECK(scheduled.getRefactorCount() == 3);
+    CHECK(scheduled.getUpdatesSinceRefactor() == 2);
+    CHECK(scheduled.getPolicy().interval == 4);
+    CHECK(scheduled.determinant() == doctest::Approx(Factorization(scheduled.matrix()).determinant()));
+
+    SquareMat identity(2);
+    identity[0][0] = 1;
+    identity[1][1] = 1;
+    RankOneUpdater pivotLoss(identity, never);
+    pivotLoss.update(Vector{-1, 1}, Vector{1, 1});
+    CHECK(pivotLoss.getRefactorCount() == 2);
+    CHECK(pivotLoss.determinant() == doctest::Approx(1));
+    CHECK(pivotLoss.solve(Vector{-1, 4})[0] == doctest::Approx(2));
+    CHECK(pivotLoss.inverse()[1][0] == doctest::Approx(-1));
+
+    RefactorPolicy probing;
+    probing.interval = 0;
+    probing.breakdown = 1e-14;
+    probing.tolerance = 1e-12;
+    RankOneUpdater growth(identity, probing);
+    growth.update(Vector{-1 + 1e-8, 1}, Vector{1, 1});
+    CHECK(growth.getRefactorCount() == 2);
+    Vector grown = growth.matrix() * growth.solve(Vector{1, 1});
+    CHECK(std::fabs(grown[0] - 1) < 1e-12);
+    CHECK(std::fabs(grown[1] - 1) < 1e-12);
+
+    RankOneUpdater degenerate(identity, never);
+    degenerate.update(Vector{-1, 0}, Vector{1, 0});
+    CHECK(degenerate.isSingular());
+    CHECK(degenerate.logDeterminant().sign == 0);
+    CHECK(degenerate.determinant() == 0);
+    CHECK_THROWS_AS(degenerate.inverse(), std::invalid_argument);
+    CHECK_THROWS_AS(degenerate.solve(Vector{1, 1}), std::invalid_argument);
+    degenerate.update(Vector{1, 0}, Vector{1, 0});
+    CHECK_FALSE(degenerate.isSingular());
+    CHECK(degenerate.determinant() == doctest::Approx(1));
+    CHECK(degenerate.inverse()[0][0] == doctest::Approx(1));
+    CHECK_THROWS_AS(degenerate.update(Vector{1, 0, 0}, Vector{1, 0}), std::invalid_argument);
+    CHECK_THROWS_AS(degenerate.solve(Vector{1}), std::invalid_argument);
+    stats::reset();
+}
+
+/** @brief Test the matrix exponential */
+TEST_CASE("Matrix Exponential")
+{
+    SquareMat zero(3);
+    SquareMat one = expm(zero);
+    CHECK(one[0][0] == 1);
+    CHECK(one[0][1] == 0);
+
+    SquareMat diagonal(2);
+    diagonal[0][0] = 2;
+    diagonal[1][1] = -1;
+    CHECK(expm(diagonal)[0][0] == doctest::Approx(std::exp(2.0)));
+    CHECK(expm(diagonal)[1][1] == doctest::Approx(std::exp(-1.0)));
+
+    SquareMat nilpotent(3);
+    nilpotent[0][1] = 1;
+    nilpotent[1][2] = 1;
+    SquareMat jordan = expm(nilpotent);
+    CHECK(jordan[0][0] == doctest::Approx(1));
+    CHECK(jordan[0][1] == doctest::Approx(1));
+    CHECK(jordan[0][2] == doctest::Approx(0.5));
+    CHECK(std::fabs(jordan[2][0]) < 1e-15);
+
+    for (double angle : {0.01, 0.2, 0.9, 2.0, 5.0, 40.0})
+    {
+        SquareMat generator(2);
+        generator[0][1] = -angle;
+        generator[1][0] = angle;
+        SquareMat rotation = expm(generator);
+        CHECK(rotation[0][0] == doctest::Approx(std::cos(angle)).epsilon(1e-13));
+        CHECK(rotation[1][0] == doctest::Approx(std::sin(angle)).epsilon(1e-13));
+        CHECK(rotation[0][1] == doctest::Approx(-std::sin(angle)).epsilon(1e-13));
+    }
+
+    const size_t n = 8;
+    SquareMat small(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t j = 0; j < n; j++)
+        {
+            small[i][j] = std::sin(static_cast<double>(3 * i + j + 1)) / 16;
+        }
+    }
+    SquareMat series(n), term(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        series[i][i] = 1;
+        term[i][i] = 1;
+    }
+    for (int k = 1; k < 30; k++)
+    {
+        term = term * small / k;
+        series += term;
+    }
+    SquareMat pade = expm(small);
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t j = 0; j < n; j++)
+        {
+            CHECK(pade[i][j] == doctest::Approx(series[i][j]).epsilon(1e-13));
+        }
+    }
+
+    const size_t states = 30;
+    SquareMat rates(states);
+    for (size_t i = 0; i < states; i++)
+    {
+        double total = 0;
+        for (size_t j = 0; j < states; j++)
+        {
+            if (i != j)
+            {
+                rates[i][j] = 1 + std::cos(static_cast<double>(i * states + j));
+                total += rates[i][j];
+            }
+        }
+        rates[i][i] = -total;
+    }
+    stats::reset();
+    SquareMat transition = expm(rates * 3.0);
+    if (stats::Enabled)
+    {
+        CHECK(stats::get(stats::Operation::Exponential).calls == 1);
+        CHECK(std::string(stats::get(stats::Operation::Exponential).name) == "expm");
+    }
+    for (size_t i = 0; i < states; i++)
+    {
+        double rowSum = 0;
+        for (size_t j = 0; j < states; j++)
+        {
+            CHECK(transition[i][j] >= 0);
+            rowSum += transition[i][j];
+        }
+        CHECK(rowSum == doctest::Approx(1).epsilon(1e-12));
+    }
+    SquareMat skew = (small - ~small) * 30.0;
+    SquareMat orthogonal = expm(skew);
+    SquareMat identity = orthogonal * expm(skew * -1.0);
+    SquareMat gram = orthogonal * ~orthogonal;
+    CHECK(identity[4][4] == doctest::Approx(1).epsilon(1e-12));
+    CHECK(std::fabs(identity[4][7]) < 1e-12);
+    CHECK(gram[2][2] == doctest::Approx(1).epsilon(1e-12));
+    CHECK(std::fabs(gram[0][5]) < 1e-12);
+    SquareMat half = expm(SquareMatView(rates, 0, 0, 10) * 0.5);
+    SquareMat whole = expm(SquareMatView(rates, 0, 0, 10));
+    SquareMat squared = half * half;
+    CHECK(squared[3][2] == doctest::Approx(whole[3][2]).epsilon(1e-12));
+
+    SquareMat power = small ^ 13;
+    SquareMat repeated = small;
+    for (int k = 1; k < 13; k++)
+    {
+        repeated = repeated * small;
+    }
+    CHECK(power[2][5] == doctest::Approx(repeated[2][5]).epsilon(1e-12));
+
+    SquareMat invalid(2);
+    invalid[0][1] = std::numeric_limits<double>::infinity();
+    CHECK(std::isnan(expm(invalid)[1][1]));
+    stats::reset();
+}
@@ -0,0 +1,108 @@
+// orel8155@gmail.com
+#include "async.hpp" // Include the header file for the async operations
+
+namespace squaremat // Start of the squaremat namespace
+{
+    namespace // Helpers private to this translation unit
+    {
+        /**
+         * @brief Heap copy of an operand that outlives the caller's matrix and any Arena
+         * @param mat Operand to copy
+         * @return Shared copy for the task
+         */
+        std::shared_ptr<const SquareMat> capture(const SquareMat &mat) // Operand capture
+        {
+            return std::make_shared<const SquareMat>(mat, SquareMat::heapResource()); // Never in a scoped arena
+        }
+
+        /**
+         * @brief Keep a result off a scoped arena
+         *
+         * Without workers the pool runs tasks inline, where an Arena of the caller may be
+         * active; the future must not point into it.
+         * @param result Result of the operation
+         * @return The result, on the heap resource
+         */
+        SquareMat detach(SquareMat result) // Result relocation
+        {
+            if (result.getResource() == SquareMat::heapResource()) // Usual case on a worker
+            {
+                return result; // Move it out as is
+            }
+            return SquareMat(result, SquareMat::heapResource()); // Copy it out of the arena
+        }
+    } // End of anonymous namespace
+
+    /**
+     * @brief Async addition implementation
+     * @param a Left operand
+     * @param b Right operand
+     * @return Future of the sum
+     */
+    Future<SquareMat> addAsync(const SquareMat &a, const SquareMat &b) // Async addition definition
+    {
+        auto left = capture(a);                                   // Own the left operand
+        auto right = capture(b);                                  // Own the right operand
+        return runAsync([left, right]() { return detach(*left + *right); }); // Add on the pool
+    }
+
+    /**
+     * @brief Async subtraction implementation
+     * @param a Left operand
+     * @param b Right operand
+     * @return Future of the difference
+     */
+    Future<SquareMat> subtractAsync(const SquareMat &a, const SquareMat &b) // Async subtraction definition
+    {
+        auto left = capture(a);                                   // Own the left operand
+        auto right = capture(b);                                  // Own the right operand
+        return runAsync([left, right]() { return detach(*left - *right); }); // Subtract on the pool
+    }
+
+    /**
+     * @brief Async multiplication implementation
+     * @param a Left operand
+     * @param b Right operand
+     * @return Future of the product
+     */
+    Future<SquareMat> multiplyAsync(const SquareMat &a, const SquareMat &b) // Async multiplication definition
+    {
+        auto left = capture(a);                                   // Own the left operand
+        auto right = capture(b);                                  // Own the right operand
+        return runAsync([left, right]() { return detach(*left * *right); }); // Multiply on the pool
+    }
+
+    /**
+     * @brief Async power implementation
+     * @param a Base matrix
+     * @param power Non-negative exponent
+     * @return Future of the power
+     */
+    Future<SquareMat> powAsync(const SquareMat &a, int power) // Async power definition
+    {
+        auto base = capture(a);                                  // Own the operand
+        return runAsync([base, power]() { return detach(*base ^ power); }); // Raise on the pool
+    }
+
+    /**
+     * @brief Async transpose implementation
+     * @param a Matrix to transpose
+     * @return Future of the transpose
+     */
+    Future<SquareMat> transposeAsync(const SquareMat &a) // Async transpose definition
+    {
+        auto mat = capture(a);                          // Own the operand
+        return runAsync([mat]() { return detach(~*mat); }); // Transpose on the pool
+    }
+
+    /**
+     * @brief Async determinant implementation
+     * @param a Matrix
+     * @return Future of the determinant
+     */
+    Future<double> determinantAsync(const SquareMat &a) // Async determinant definition
+    {
+        auto mat = capture(a);                          // Own the operand
+        return runAsync([mat]() { return !*mat; }); // Determinant on the pool
+    }
+} // End of squaremat namespace
@@ -0,0 +1,391 @@
+// orel8155@gmail.com
+#pragma once                // Ensures the header file is included only once
+#include <atomic>             // Include for the whenAll countdown
+#include <chrono>             // Include for the helping wait
+#include <condition_variable> // Include for blocking waits
+#include <exception>          // Include for std::exception_ptr
+#include <functional>         // Include for continuation callbacks
+#include <memory>             // Include for the shared state
+#include <mutex>              // Include for std::mutex
+#include <optional>           // Include for the stored value
+#include <stdexcept>          // Include for std::logic_error
+#include <type_traits>        // Include for result type deduction
+#include <utility>            // Include for std::pair and std::move
+#include <vector>             // Include for the continuation list
+#include "squaremat.hpp"      // Include for the matrix operands
+#include "threadpool.hpp"     // Include for the shared pool
+
+namespace squaremat // Start of namespace definition
+{
+    template <typename T>
+    class Promise; // Producer side of a Future, defined below
+
+    /**
+     * @class Future
+     * @brief Result of an operation running on ThreadPool::instance(), with continuations
+     *
+     * Futures share their state, so copies observe the same result and get() can be
+     * called any number of times. then() schedules a callable on the pool once the
+     * result is ready instead of blocking a thread; an exception skips the callable and
+     * is carried to the returned future. A thread that waits helps run queued pool
+     * tasks, so waiting on a worker thread cannot deadlock the pool.
+     * @tparam T Result type (not void)
+     */
+    template <typename T>
+    class Future // Class definition for the future
+    {
+        static_assert(!std::is_void<T>::value, "Future needs a result type"); // Every async operation returns a value
+
+    private:
+        /**
+         * @brief State shared by the promise and every copy of the future
+         */
+        struct State
+        {
+            std::mutex mutex;                                ///< Protects the other fields
+            std::condition_variable finished;                ///< Signals completion
+            bool done = false;                               ///< Result or exception is set
+            std::optional<T> value;                          ///< Result of the operation
+            std::exception_ptr failure;                      ///< Exception of the operation
+            std::vector<std::function<void()>> continuations; ///< Callbacks to run on completion
+        };
+
+        std::shared_ptr<State> state; ///< Shared state (null for a default-constructed future)
+
+        /**
+         * @brief Constructor used by Promise
+         * @param state Shared state
+         */
+        explicit Future(std::shared_ptr<State> state) : state(std::move(state)) {} // Constructor with initialization list
+
+        friend class Promise<T>; // The promise creates futures of its state
+
+    public:
+        /**
+         * @brief Default constructor that creates a future without a state
+         */
+        Future() = default; // Default constructor
+
+        /**
+         * @brief Check whether the future refers to an operation
+         * @return true unless default-constructed
+         */
+        bool valid() const { return state != nullptr; } // Validity check
+
+        /**
+         * @brief Check whether the operation has finished
+         * @return true once a result or an exception is available
+         * @throws std::logic_error if the future is not valid
+         */
+        bool ready() const // Readiness check
+        {
+            std::lock_guard<std::mutex> lock(checked().mutex); // Protect the flag
+            return state->done;                                // Return the flag
+        }
+
+        /**
+         * @brief Wait until the operation has finished, running queued pool tasks meanwhile
+         * @throws std::logic_error if the future is not valid
+         */
+        void wait() const // Blocking wait
+        {
+            State &s = checked(); // Shared state
+            for (;;)              // Until the result is there
+            {
+                {
+                    std::unique_lock<std::mutex> lock(s.mutex); // Protect the flag
+                    if (s.done)                                 // Finished
+                    {
+                        return; // Nothing to wait for
+                    }
+                }
+                if (ThreadPool::instance().runPendingTask()) // Help with queued work first
+                {
+                    continue; // It may have been our operation
+                }
+                std::unique_lock<std::mutex> lock(s.mutex); // Protect the flag
+                if (ThreadPool::onWorkerThread())           // Workers must keep helping
+                {
+                    s.finished.wait_for(lock, std::chrono::milliseconds(1), [&]() { return s.done; }); // Recheck the queue soon
+                }
+                else
+                {
+                    s.finished.wait(lock, [&]() { return s.done; }); // Free workers will finish the operation
+                }
+            }
+        }
+
+        /**
+         * @brief Wait for the result and return it
+         * @return Reference to the result (lives as long as any copy of this future)
+         * @throws The exception thrown by the operation, or std::logic_error if the future is not valid
+         */
+        const T &get() const // Result access
+        {
+            wait();                   // Block until finished
+            if (state->failure)       // The operation threw
+            {
+                std::rethrow_exception(state->failure); // Propagate it
+            }
+            return *state->value; // Return the result
+        }
+
+        /**
+         * @brief Run a callback once the operation has finished
+         *
+         * The callback runs on the thread that completes the operation, or right away if
+         * it already has; it should only hand work on (then() submits it to the pool).
+         * @param callback Callable without arguments
+         * @throws std::logic_error if the future is not valid
+         */
+        void whenReady(std::function<void()> callback) const // Completion hook
+        {
+            if (!whenPending(callback)) // Already finished
+            {
+                callback(); // Run it now
+            }
+        }
+
+        /**
+         * @brief Register a completion callback only if the operation is still running
+         *
+         * Lets an awaiting coroutine continue without suspending when the result arrived
+         * in the meantime, instead of being resumed from inside its own suspension.
+         * @param callback Callable without arguments, run by the thread that completes the operation
+         * @return true if the callback was registered, false if the operation had already finished
+         * @throws std::logic_error if the future is not valid
+         */
+        bool whenPending(std::function<void()> callback) const // Conditional completion hook
+        {
+            State &s = checked();                      // Shared state
+            std::lock_guard<std::mutex> lock(s.mutex); // Protect the list
+            if (s.done)                                // Finished already
+            {
+                return false; // Caller continues directly
+            }
+            s.continuations.push_back(std::move(callback)); // Run it on completion
+            return true;                                     // Registered
+        }
+
+        /**
+         * @brief Chain an operation on the result without blocking
+         * @param next Callable taking const T & and returning the next result
+         * @return Future of the callable's result (carries this future's exception instead)
+         * @throws std::logic_error if the future is not valid
+         */
+        template <typename F>
+        auto then(F next) const -> Future<std::decay_t<std::invoke_result_t<F &, const T &>>> // Continuation
+        {
+            using R = std::decay_t<std::invoke_result_t<F &, const T &>>; // Result of the continuation
+            Promise<R> promise;                                            // Producer of the next result
+            Future<T> self = *this;                                        // Keep the state alive
+            whenReady([self, promise, next]() {                            // Once this result is there
+                ThreadPool::instance().submit([self, promise, next]() mutable { // Run the continuation on the pool
+                    if (self.state->failure)                                   // Upstream failed
+                    {
+                        promise.setException(self.state->failure); // Pass the exception on
+                        return;                                     // Skip the continuation
+                    }
+                    try
+                    {
+                        promise.setValue(next(*self.state->value)); // Compute the next result
+                    }
+                    catch (...)
+                    {
+                        promise.setException(std::current_exception()); // Carry the exception
+                    }
+                });
+            });
+            return promise.getFuture(); // Return the chained future
+        }
+
+    private:
+        /**
+         * @brief Shared state, checked for validity
+         * @return Reference to the state
+         * @throws std::logic_error if the future is not valid
+         */
+        State &checked() const // Validity guard
+        {
+            if (!state) // Default-constructed
+            {
+                throw std::logic_error("Future has no state"); // Usage error
+            }
+            return *state; // Return the state
+        }
+    };
+
+    /**
+     * @class Promise
+     * @brief Producer side of a Future; set exactly once
+     * @tparam T Result type
+     */
+    template <typename T>
+    class Promise // Class definition for the promise
+    {
+    private:
+        std::shared_ptr<typename Future<T>::State> state; ///< State shared with the futures
+
+        /**
+         * @brief Mark the state finished and run the registered continuations
+         * @param lock Held lock of the state, released before the continuations run
+         */
+        void finish(std::unique_lock<std::mutex> &lock) // Completion step
+        {
+            state->done = true;                                                  // Publish the outcome
+            std::vector<std::function<void()>> callbacks = std::move(state->continuations); // Take the callbacks
+            state->continuations.clear();                                        // Leave the list empty
+            lock.unlock();                                                       // Never run callbacks under the lock
+            state->finished.notify_all();                                        // Wake the waiters
+            for (std::function<void()> &callback : callbacks)                    // Loop through the callbacks
+            {
+                callback(); // Hand the continuation on
+            }
+        }
+
+    public:
+        /**
+         * @brief Constructor that creates a fresh state
+         */
+        Promise() : state(std::make_shared<typename Future<T>::State>()) {} // Constructor with initialization list
+
+        /**
+         * @brief Future observing this promise
+         * @return Future sharing the state
+         */
+        Future<T> getFuture() const { return Future<T>(state); } // Future accessor
+
+        /**
+         * @brief Store the result
+         * @param value Result of the operation
+         * @throws std::logic_error if the promise was already set
+         */
+        void setValue(T value) // Result setter
+        {
+            std::unique_lock<std::mutex> lock(state->mutex); // Protect the state
+            if (state->done)                                 // Set twice
+            {
+                throw std::logic_error("Promise already satisfied"); // Usage error
+            }
+            state->value.emplace(std::move(value)); // Store the result
+            finish(lock);                           // Wake waiters and continuations
+        }
+
+        /**
+         * @brief Store an exception instead of a result
+         * @param failure Exception thrown by the operation
+         * @throws std::logic_error if the promise was already set
+         */
+        void setException(std::exception_ptr failure) // Exception setter
+        {
+            std::unique_lock<std::mutex> lock(state->mutex); // Protect the state
+            if (state->done)                                 // Set twice
+            {
+                throw std::logic_error("Promise already satisfied"); // Usage error
+            }
+            state->failure = failure; // Store the exception
+            finish(lock);             // Wake waiters and continuations
+        }
+    };
+
+    /**
+     * @brief Run a callable on the shared thread pool
+     * @param task Callable without arguments returning a value
+     * @return Future of the callable's result
+     */
+    template <typename F>
+    auto runAsync(F task) -> Future<std::decay_t<std::invoke_result_t<F &>>> // Generic async launcher
+    {
+        Promise<std::decay_t<std::invoke_result_t<F &>>> promise; // Producer of the result
+        ThreadPool::instance().submit([promise, task]() mutable { // Runs inline when the pool has no workers
+            try
+            {
+                promise.setValue(task()); // Compute the result
+            }
+            catch (...)
+            {
+                promise.setException(std::current_exception()); // Carry the exception
+            }
+        });
+        return promise.getFuture(); // Return the future
+    }
+
+    /**
+     * @brief Combine two futures without blocking
+     * @param first First future
+     * @param second Second future
+     * @return Future of both results (carries the first exception if either failed)
+     */
+    template <typename A, typename B>
+    Future<std::pair<A, B>> whenAll(const Future<A> &first, const Future<B> &second) // Join of two futures
+    {
+        Promise<std::pair<A, B>> promise;                              // Producer of the pair
+        auto pending = std::make_shared<std::atomic<int>>(2);          // Futures still running
+        auto join = [first, second, promise, pending]() mutable {      // Runs once per finished future
+            if (pending->fetch_sub(1) != 1)                            // The other one is still running
+            {
+                return; // The last one completes the pair
+            }
+            try
+            {
+                promise.setValue(std::pair<A, B>(first.get(), second.get())); // Both are ready, get() does not block
+            }
+            catch (...)
+            {
+                promise.setException(std::current_exception()); // Carry the exception
+            }
+        };
+        first.whenReady(join);  // Count the first future
+        second.whenReady(join); // Count the second future
+        return promise.getFuture(); // Return the joined future
+    }
+
+    /**
+     * @brief Asynchronous a + b
+     *
+     * Like every *Async operation, the operands are copied onto the heap before the call
+     * returns, so they may change or go away while the operation runs.
+     * @param a Left operand
+     * @param b Right operand
+     * @return Future of the sum (fails with std::invalid_argument if sizes differ)
+     */
+    Future<SquareMat> addAsync(const SquareMat &a, const SquareMat &b); // Declaration of async addition
+
+    /**
+     * @brief Asynchronous a - b
+     * @param a Left operand
+     * @param b Right operand
+     * @return Future of the difference (fails with std::invalid_argument if sizes differ)
+     */
+    Future<SquareMat> subtractAsync(const SquareMat &a, const SquareMat &b); // Declaration of async subtraction
+
+    /**
+     * @brief Asynchronous a * b
+     * @param a Left operand
+     * @param b Right operand
+     * @return Future of the product (fails with std::invalid_argument if sizes differ)
+     */
+    Future<SquareMat> multiplyAsync(const SquareMat &a, const SquareMat &b); // Declaration of async multiplication
+
+    /**
+     * @brief Asynchronous a ^ power
+     * @param a Base matrix
+     * @param power Non-negative exponent
+     * @return Future of the power (fails with std::invalid_argument if power is negative)
+     */
+    Future<SquareMat> powAsync(const SquareMat &a, int power); // Declaration of async power
+
+    /**
+     * @brief Asynchronous ~a
+     * @param a Matrix to transpose
+     * @return Future of the transpose
+     */
+    Future<SquareMat> transposeAsync(const SquareMat &a); // Declaration of async transpose
+
+    /**
+     * @brief Asynchronous !a
+     * @param a Matrix
+     * @return Future of the determinant
+     */
+    Future<double> determinantAsync(const SquareMat &a); // Declaration of async determinant
+} // End of namespace
@@ -0,0 +1,428 @@
+// orel8155@gmail.com
+#include "bandedmat.hpp" // Include the header file for BandedMat class
+#include <algorithm>     // Include for std::min, std::max and std::swap
+#include <cmath>         // Include for std::fabs
+
+namespace squaremat // Start of the squaremat namespace
+{
+    /**
+     * @brief Constructor implementation
+     * @param size The size of the square matrix (number of rows/columns)
+     * @param lower Number of diagonals below the main diagonal (clamped to size-1)
+     * @param upper Number of diagonals above the main diagonal (clamped to size-1)
+     * @throws std::invalid_argument if size is not positive
+     */
+    BandedMat::BandedMat(size_t size, size_t lower, size_t upper) : size(size), lower(0), upper(0), band(nullptr) // Constructor definition
+    {
+        if (size <= 0) // Check if size is valid
+        {
+            throw std::invalid_argument("Size must be positive"); // Throw exception for invalid size
+        }
+        this->lower = std::min(lower, size - 1);   // A band can't be wider than the matrix
+        this->upper = std::min(upper, size - 1);   // A band can't be wider than the matrix
+        band = new double[size * width()]();      // Allocate the band and initialize to 0
+    }
+
+    /**
+     * @brief Conversion constructor implementation
+     * @param mat The full matrix to convert
+     * @param lower Number of diagonals below the main diagonal (clamped to size-1)
+     * @param upper Number of diagonals above the main diagonal (clamped to size-1)
+     * @throws std::invalid_argument if mat has a non-zero element outside the band
+     */
+    BandedMat::BandedMat(const SquareMat &mat, size_t lower, size_t upper) : BandedMat(mat.getSize(), lower, upper) // Delegate allocation
+    {
+        for (size_t i = 0; i < size; i++) // Loop through rows
+        {
+            for (size_t j = 0; j < size; j++) // Loop through columns
+            {
+                if (inBand(i, j)) // Stored element
+                {
+                    (*this)(i, j) = mat[i][j]; // Copy the element into the band
+                }
+                else if (mat[i][j] != 0) // Non-zero element that can't be represented
+                {
+                    throw std::invalid_argument("Matrix has non-zero elements outside the band"); // Refuse lossy conversion
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Copy constructor implementation
+     * @param other The matrix to copy
+     */
+    BandedMat::BandedMat(const BandedMat &other) : size(other.size), lower(other.lower), upper(other.upper), band(new double[other.size * other.width()]) // Copy constructor definition
+    {
+        std::copy(other.band, other.band + size * width(), band); // Copy the stored band
+    }
+
+    /**
+     * @brief Assignment operator implementation
+     * @param other The matrix to assign from
+     * @return Reference to this matrix after assignment
+     */
+    BandedMat &BandedMat::operator=(const BandedMat &other) // Assignment operator definition
+    {
+        if (this == &other) // Check for self-assignment
+        {
+            return *this; // Return if self-assignment
+        }
+        double *fresh = new double[other.size * other.width()];                // Allocate before releasing (strong guarantee)
+        std::copy(other.band, other.band + other.size * other.width(), fresh); // Copy the stored band
+        delete[] band;                                                         // Free current resources
+        band = fresh;                                                          // Adopt the new storage
+        size = other.size;                                                     // Update size
+        lower = other.lower;                                                   // Update lower bandwidth
+        upper = other.upper;                                                   // Update upper bandwidth
+        return *this;                                                          // Return reference to modified matrix
+    }
+
+    /**
+     * @brief Shared addition kernel implementation
+     * @param other Matrix to combine with this matrix
+     * @param scale Factor applied to other
+     * @return New matrix with the wider of the two bandwidths
+     * @throws std::invalid_argument if matrix sizes don't match
+     */
+    BandedMat BandedMat::combine(const BandedMat &other, double scale) const // Shared addition kernel definition
+    {
+        if (size != other.size) // Check if matrices have same size
+        {
+            throw std::invalid_argument("Matrix sizes must match"); // Throw exception if sizes don't match
+        }
+        BandedMat result(size, std::max(lower, other.lower), std::max(upper, other.upper)); // Band that covers both operands
+        size_t stride = result.width();                                                    // Width of one result row
+        for (size_t i = 0; i < size; i++)                                                  // Loop through rows
+        {
+            size_t first = i > lower ? i - lower : 0;    // First stored column of this row
+            size_t last = std::min(size - 1, i + upper); // Last stored column of this row
+            for (size_t j = first; j <= last; j++)       // Copy this matrix's part of the row
+            {
+                result.band[i * stride + (j + result.lower - i)] = band[i * width() + (j + lower - i)]; // Element (i,j)
+            }
+            first = i > other.lower ? i - other.lower : 0; // First stored column of other's row
+            last = std::min(size - 1, i + other.upper);    // Last stored column of other's row
+            for (size_t j = first; j <= last; j++)         // Add other's part of the row
+            {
+                result.band[i * stride + (j + result.lower - i)] += scale * other.band[i * other.width() + (j + other.lower - i)]; // Element (i,j)
+            }
+        }
+        return result; // Return the resulting matrix
+    }
+
+    /**
+     * @brief Addition operator implementation
+     * @param other Matrix to add to this matrix
+     * @return New matrix with the wider of the two bandwidths
+     * @throws std::invalid_argument if matrix sizes don't match
+     */
+    BandedMat BandedMat::operator+(const BandedMat &other) const // Addition operator definition
+    {
+        return combine(other, 1.0); // Add the bands directly
+    }
+
+    /**
+     * @brief Subtraction operator implementation
+     * @param other Matrix to subtract from this matrix
+     * @return New matrix with the wider of the two bandwidths
+     * @throws std::invalid_argument if matrix sizes don't match
+     */
+    BandedMat BandedMat::operator-(const BandedMat &other) const // Subtraction operator definition
+    {
+        return combine(other, -1.0); // Subtract the bands directly (no negated temporary)
+    }
+
+    /**
+     * @brief Banded matrix multiplication implementation
+     * @param other Matrix to multiply with this matrix
+     * @return New matrix whose bandwidths are the sums of the operand bandwidths
+     * @throws std::invalid_argument if matrix sizes don't match
+     */
+    BandedMat BandedMat::operator*(const BandedMat &other) const // Matrix multiplication operator definition
+    {
+        if (size != other.size) // Check if matrices have compatible sizes
+        {
+            throw std::invalid_argument("Matrix sizes must match"); // Throw exception if sizes don't match
+        }
+        BandedMat result(size, lower + other.lower, upper + other.upper); // Product bandwidths add up
+        size_t stride = result.width();                                   // Width of one result row
+        for (size_t i = 0; i < size; i++)                                 // Loop through rows of this matrix
+        {
+            size_t kFirst = i > lower ? i - lower : 0;     // First stored column of row i
+            size_t kLast = std::min(size - 1, i + upper);  // Last stored column of row i
+            for (size_t k = kFirst; k <= kLast; k++)       // Loop through stored elements A(i,k)
+            {
+                double a = band[i * width() + (k + lower - i)];         // Element A(i,k)
+                size_t jFirst = k > other.lower ? k - other.lower : 0;  // First stored column of row k of B
+                size_t jLast = std::min(size - 1, k + other.upper);     // Last stored column of row k of B
+                for (size_t j = jFirst; j <= jLast; j++)                // Loop through stored elements B(k,j)
+                {
+                    result.band[i * stride + (j + result.lower - i)] += a * other.band[k * other.width() + (j + other.lower - k)]; // Accumulate A(i,k)*B(k,j)
+                }
+            }
+        }
+        return result; // Return the resulting matrix
+    }
+
+    /**
+     * @brief Scalar multiplication operator implementation
+     * @param scalar Value to multiply matrix elements by
+     * @return New matrix with scaled elements
+     */
+    BandedMat BandedMat::operator*(double scalar) const // Scalar multiplication operator definition
+    {
+        BandedMat result(*this);                   // Same band as this matrix
+        for (size_t k = 0; k < size * width(); k++) // Loop through stored elements
+        {
+            result.band[k] *= scalar; // Multiply each element by scalar
+        }
+        return result; // Return the resulting matrix
+    }
+
+    /**
+     * @brief Power operator implementation using repeated squaring
+     * @param power The exponent to raise the matrix to
+     * @return New matrix containing the result of matrix^power
+     * @throws std::invalid_argument if power is negative
+     */
+    BandedMat BandedMat::operator^(int power) const // Power operator definition
+    {
+        if (power < 0) // Check if power is negative
+        {
+            throw std::invalid_argument("Power must be non-negative"); // Throw exception if power is negative
+        }
+        BandedMat result(size, 0, 0);     // Identity is a diagonal band
+        for (size_t i = 0; i < size; i++) // Loop through diagonal elements
+        {
+            result(i, i) = 1; // Set diagonal elements to 1 (identity matrix)
+        }
+        BandedMat base(*this); // Running square A^(2^k)
+        while (power > 0)      // Process the exponent bit by bit
+        {
+            if (power & 1) // Current bit is set
+            {
+                result = result * base; // Multiply the running square into the result
+            }
+            power >>= 1;     // Move to the next bit
+            if (power > 0)   // Skip the last, unused squaring
+            {
+                base = base * base; // Square the base (bandwidths double, clamped to size-1)
+            }
+        }
+        return result; // Return the resulting matrix
+    }
+
+    /**
+     * @brief Banded LU factorization with partial pivoting
+     *
+     * Element (r, c) of the working band lives at work[r*ww + c + lower - r] with
+     * ww = 2*lower+upper+1, which leaves room for the fill-in that row interchanges
+     * push into the upper triangle. The multipliers of step k stay in column k.
+     * @param work Output working band holding U and the multipliers
+     * @param pivots Output row interchange performed at each elimination step
+     * @param sign Output sign of the row permutation (+1 or -1)
+     * @return false if a zero pivot was met (the matrix is singular), true otherwise
+     */
+    bool BandedMat::factorize(std::vector<double> &work, std::vector<size_t> &pivots, int &sign) const // Banded LU definition
+    {
+        size_t ww = 2 * lower + upper + 1; // Working row width including fill-in
+        work.assign(size * ww, 0.0);       // Zero the working band
+        pivots.assign(size, 0);            // Reset the pivot record
+        sign = 1;                          // No interchanges yet
+        for (size_t i = 0; i < size; i++)  // Copy the stored band into the working band
+        {
+            std::copy(band + i * width(), band + (i + 1) * width(), work.begin() + i * ww); // Same offsets, wider rows
+        }
+        auto at = [&](size_t r, size_t c) -> double & { return work[r * ww + (c + lower - r)]; }; // Working element accessor
+
+        for (size_t k = 0; k < size; k++) // Loop through elimination steps
+        {
+            size_t last = std::min(size - 1, k + lower);     // Last row with a non-zero in column k
+            size_t right = std::min(size - 1, k + lower + upper); // Last column reachable by U's row k
+            size_t pivot = k;                                // Row with the largest candidate pivot
+            for (size_t r = k + 1; r <= last; r++)           // Search the column below the diagonal
+            {
+                if (std::fabs(at(r, k)) > std::fabs(at(pivot, k))) // Larger magnitude found
+                {
+                    pivot = r; // Remember the better pivot row
+                }
+            }
+            pivots[k] = pivot;      // Record the interchange
+            if (at(pivot, k) == 0) // Whole column is zero
+            {
+                return false; // Singular matrix
+            }
+            if (pivot != k) // Interchange needed
+            {
+                for (size_t c = k; c <= right; c++) // Only columns >= k are still active
+                {
+                    std::swap(at(k, c), at(pivot, c)); // Swap the two rows
+                }
+                sign = -sign; // Each interchange flips the determinant sign
+            }
+            for (size_t r = k + 1; r <= last; r++) // Eliminate below the pivot
+            {
+                double factor = at(r, k) / at(k, k); // Multiplier for row r
+                at(r, k) = factor;                   // Keep the multiplier for solve()
+                for (size_t c = k + 1; c <= right; c++) // Update the rest of the row
+                {
+                    at(r, c) -= factor * at(k, c); // Subtract the scaled pivot row
+                }
+            }
+        }
+        return true; // Factorization completed
+    }
+
+    /**
+     * @brief Determinant operator implementation
+     * @return Determinant of the matrix
+     */
+    double BandedMat::operator!() const // Determinant operator definition
+    {
+        if (lower == 0 || upper == 0) // Diagonal or triangular band
+        {
+            double det = 1;                   // Initialize determinant to one
+            for (size_t i = 0; i < size; i++) // Loop through diagonal elements
+            {
+                det *= band[i * width() + lower]; // Product of the diagonal
+            }
+            return det; // Return the calculated determinant
+        }
+
+        if (lower == 1 && upper == 1) // Tridiagonal: three-term recurrence f_k = a_k f_{k-1} - b_{k-1} c_{k-1} f_{k-2}
+        {
+            double previous = 1;                 // f_{-1}
+            double current = band[1];            // f_0 = a_0
+            for (size_t k = 1; k < size; k++)    // Loop through the remaining leading minors
+            {
+                double next = band[k * 3 + 1] * current - band[(k - 1) * 3 + 2] * band[k * 3] * previous; // Recurrence step
+                previous = current;                                                                     // Shift f_{k-2}
+                current = next;                                                                         // Shift f_{k-1}
+            }
+            return current; // Determinant of the whole matrix
+        }
+
+        std::vector<double> work;   // Working band for the factorization
+        std::vector<size_t> pivots; // Row interchanges
+        int sign = 1;               // Permutation sign
+        if (!factorize(work, pivots, sign)) // Zero pivot
+        {
+            return 0; // Singular matrix has zero determinant
+        }
+        size_t ww = 2 * lower + upper + 1; // Working row width
+        double det = sign;                  // Start from the permutation sign
+        for (size_t i = 0; i < size; i++)   // Loop through diagonal of U
+        {
+            det *= work[i * ww + lower]; // Multiply the pivots
+        }
+        return det; // Return the calculated determinant
+    }
+
+    /**
+     * @brief Linear solver implementation
+     * @param rhs Right-hand side vector of length size
+     * @return Solution vector x
+     * @throws std::invalid_argument if rhs has the wrong length or the matrix is singular
+     */
+    std::vector<double> BandedMat::solve(const std::vector<double> &rhs) const // Linear solver definition
+    {
+        if (rhs.size() != size) // Check if the right-hand side fits
+        {
+            throw std::invalid_argument("Vector size must match matrix size"); // Throw exception if sizes don't match
+        }
+        std::vector<double> work;   // Working band for the factorization
+        std::vector<size_t> pivots; // Row interchanges
+        int sign = 1;               // Permutation sign (unused here)
+        if (!factorize(work, pivots, sign)) // Zero pivot
+        {
+            throw std::invalid_argument("Matrix is singular"); // No unique solution
+        }
+        size_t ww = 2 * lower + upper + 1;                                                   // Working row width
+        auto at = [&](size_t r, size_t c) { return work[r * ww + (c + lower - r)]; }; // Working element accessor
+        std::vector<double> x(rhs);                                                          // Solution starts as the right-hand side
+
+        for (size_t k = 0; k < size; k++) // Forward substitution with L, applying interchanges in order
+        {
+            std::swap(x[k], x[pivots[k]]);                // Apply the interchange of step k
+            size_t last = std::min(size - 1, k + lower);  // Rows touched by step k
+            for (size_t r = k + 1; r <= last; r++)        // Loop through eliminated rows
+            {
+                x[r] -= at(r, k) * x[k]; // Apply the stored multiplier
+            }
+        }
+        for (size_t i = size; i-- > 0;) // Back substitution with U
+        {
+            size_t right = std::min(size - 1, i + lower + upper); // Last non-zero column of U's row i
+            for (size_t c = i + 1; c <= right; c++)               // Loop through known unknowns
+            {
+                x[i] -= at(i, c) * x[c]; // Subtract their contribution
+            }
+            x[i] /= at(i, i); // Divide by the pivot
+        }
+        return x; // Return the solution vector
+    }
+
+    /**
+     * @brief Conversion to SquareMat implementation
+     * @return SquareMat holding the same elements
+     */
+    SquareMat BandedMat::toSquareMat() const // Conversion definition
+    {
+        SquareMat result(size);           // Zero-initialized full matrix
+        double *out = result.data();      // Elements of the result (contiguous)
+        for (size_t i = 0; i < size; i++) // Loop through rows
+        {
+            size_t first = i > lower ? i - lower : 0;  // First stored column of the row
+            size_t last = std::min(size - 1, i + upper); // Last stored column of the row
+            for (size_t j = first; j <= last; j++)     // Loop through stored columns
+            {
+                out[i * size + j] = band[i * width() + (j + lower - i)]; // Copy the stored element
+            }
+        }
+        return result; // Return the full matrix
+    }
+
+    /**
+     * @brief Output stream operator for BandedMat implementation
+     * @param os Output stream
+     * @param mat Matrix to output
+     * @return Reference to output stream
+     */
+    std::ostream &operator<<(std::ostream &os, const BandedMat &mat) // Output stream operator definition
+    {
+        for (size_t i = 0; i < mat.size; i++) // Loop through rows
+        {
+            for (size_t j = 0; j < mat.size; j++) // Loop through columns
+            {
+                os << mat(i, j) << "\t"; // Output element with tab separator
+            }
+            os << std::endl; // End line after each row
+        }
+        return os; // Return reference to output stream
+    }
+
+    /**
+     * @brief Tridiagonal constructor implementation
+     * @param sub Sub-diagonal (length size-1)
+     * @param diag Main diagonal (length size)
+     * @param super Super-diagonal (length size-1)
+     * @throws std::invalid_argument if the diagonal lengths are inconsistent
+     */
+    TridiagonalMat::TridiagonalMat(const std::vector<double> &sub, const std::vector<double> &diag, const std::vector<double> &super) : BandedMat(diag.size(), 1, 1) // Tridiagonal constructor definition
+    {
+        if (sub.size() + 1 != diag.size() || super.size() + 1 != diag.size()) // Off-diagonals are one shorter
+        {
+            throw std::invalid_argument("Diagonal lengths are inconsistent"); // Throw exception for bad input
+        }
+        for (size_t i = 0; i < diag.size(); i++) // Loop through rows
+        {
+            (*this)(i, i) = diag[i]; // Main diagonal
+            if (i > 0)               // Rows below the first have a sub-diagonal element
+            {
+                (*this)(i, i - 1) = sub[i - 1]; // Sub-diagonal
+                (*this)(i - 1, i) = super[i - 1]; // Super-diagonal
+            }
+        }
+    }
+} // End of squaremat namespace
@@ -0,0 +1,268 @@
+// orel8155@gmail.com
+#pragma once           // Ensures the header file is included only once
+#include <iostream>    // Include for input/output operations
+#include <stdexcept>   // Include for standard exceptions
+#include <utility>     // Include for std::swap
+#include <vector>      // Include for right-hand side and diagonal vectors
+#include "squaremat.hpp" // Include for conversion to and from SquareMat
+
+namespace squaremat // Start of namespace definition
+{
+    /**
+     * @class BandedMat
+     * @brief A square matrix whose non-zero elements lie inside a band around the diagonal
+     *
+     * Only the diagonals from `lower` below to `upper` above the main diagonal are stored,
+     * so an n x n matrix with bandwidth b takes O(n*b) memory instead of O(n^2).
+     * Determinant, multiplication, solve and power all run in O(n*b^2) (times log p for power),
+     * and tridiagonal determinants use the three-term recurrence in O(n).
+     */
+    class BandedMat // Class definition for banded matrix
+    {
+    private:
+        size_t size;  ///< Size of the square matrix (number of rows/columns)
+        size_t lower; ///< Number of stored diagonals below the main diagonal
+        size_t upper; ///< Number of stored diagonals above the main diagonal
+        double *band; ///< Row-wise band storage: row i holds columns i-lower .. i+upper
+
+        /**
+         * @brief Number of stored elements per row
+         * @return lower + upper + 1
+         */
+        size_t width() const { return lower + upper + 1; } // Width of one stored row
+
+        /**
+         * @brief Factorize a working copy of the band with partial pivoting (banded LU)
+         * @param work Output working band of width 2*lower+upper+1 holding U and the multipliers
+         * @param pivots Output row interchange performed at each elimination step
+         * @param sign Output sign of the row permutation (+1 or -1)
+         * @return false if a zero pivot was met (the matrix is singular), true otherwise
+         */
+        bool factorize(std::vector<double> &work, std::vector<size_t> &pivots, int &sign) const; // Declaration of banded LU
+
+        /**
+         * @brief Element-wise this + scale * other on the band storage
+         * @param other Matrix to combine with this matrix
+         * @param scale Factor applied to other (1 for addition, -1 for subtraction)
+         * @return New matrix with the wider of the two bandwidths
+         * @throws std::invalid_argument if matrix sizes don't match
+         */
+        BandedMat combine(const BandedMat &other, double scale) const; // Declaration of the shared addition kernel
+
+    public:
+        /**
+         * @brief Constructor that creates a zero banded matrix
+         * @param size The size of the square matrix (number of rows/columns)
+         * @param lower Number of diagonals below the main diagonal (clamped to size-1)
+         * @param upper Number of diagonals above the main diagonal (clamped to size-1)
+         * @throws std::invalid_argument if size is not positive
+         */
+        BandedMat(size_t size, size_t lower, size_t upper); // Declaration of constructor
+
+        /**
+         * @brief Constructor that extracts a band from a full matrix
+         * @param mat The full matrix to convert
+         * @param lower Number of diagonals below the main diagonal (clamped to size-1)
+         * @param upper Number of diagonals above the main diagonal (clamped to size-1)
+         * @throws std::invalid_argument if mat has a non-zero element outside the band
+         */
+        BandedMat(const SquareMat &mat, size_t lower, size_t upper); // Declaration of conversion constructor
+
+        /**
+         * @brief Copy constructor
+         * @param other The matrix to copy
+         */
+        BandedMat(const BandedMat &other); // Declaration of copy constructor
+
+        /**
+         * @brief Move constructor
+         * @param other The matrix to take the storage from (left empty)
+         */
+        BandedMat(BandedMat &&other) noexcept : size(other.size), lower(other.lower), upper(other.upper), band(other.band) // Move constructor definition
+        {
+            other.size = 0;       // Source no longer owns elements
+            other.band = nullptr; // Source no longer owns storage
+        }
+
+        /**
+         * @brief Destructor to free allocated memory
+         */
+        ~BandedMat() { delete[] band; } // Destructor definition
+
+        /**
+         * @brief Assignment operator
+         * @param other The matrix to assign from
+         * @return Reference to this matrix after assignment
+         */
+        BandedMat &operator=(const BandedMat &other); // Declaration of assignment operator
+
+        /**
+         * @brief Move assignment operator
+         * @param other The matrix to take the storage from (receives this matrix's storage)
+         * @return Reference to this matrix after assignment
+         */
+        BandedMat &operator=(BandedMat &&other) noexcept // Move assignment operator definition
+        {
+            std::swap(size, other.size);   // Exchange sizes
+            std::swap(lower, other.lower); // Exchange lower bandwidths
+            std::swap(upper, other.upper); // Exchange upper bandwidths
+            std::swap(band, other.band);   // Exchange storage (other frees ours)
+            return *this;                  // Return reference to modified matrix
+        }
+
+        /**
+         * @brief Get the size of the matrix
+         * @return Size of the matrix (number of rows/columns)
+         */
+        size_t getSize() const { return size; } // Getter method for matrix size
+
+        /**
+         * @brief Get the lower bandwidth
+         * @return Number of stored diagonals below the main diagonal
+         */
+        size_t getLower() const { return lower; } // Getter method for lower bandwidth
+
+        /**
+         * @brief Get the upper bandwidth
+         * @return Number of stored diagonals above the main diagonal
+         */
+        size_t getUpper() const { return upper; } // Getter method for upper bandwidth
+
+        /**
+         * @brief Check whether an element lies inside the stored band
+         * @param row Row index
+         * @param col Column index
+         * @return true if (row, col) is stored, false otherwise
+         */
+        bool inBand(size_t row, size_t col) const // Band membership check
+        {
+            return row < size && col < size && col + lower >= row && col <= row + upper; // Check both band edges
+        }
+
+        /**
+         * @brief Element access (non-const version)
+         * @param row Row index
+         * @param col Column index
+         * @return Reference to the stored element
+         * @throws std::out_of_range if (row, col) is outside the matrix or the band
+         */
+        double &operator()(size_t row, size_t col) // Non-const element access
+        {
+            if (!inBand(row, col)) // Only stored elements can be written
+            {
+                throw std::out_of_range("Index outside of band"); // Throw exception for invalid index
+            }
+            return band[row * width() + (col + lower - row)]; // Return reference to the stored element
+        }
+
+        /**
+         * @brief Element access (const version)
+         * @param row Row index
+         * @param col Column index
+         * @return Value of the element (zero outside the band)
+         * @throws std::out_of_range if (row, col) is outside the matrix
+         */
+        double operator()(size_t row, size_t col) const // Const element access
+        {
+            if (row >= size || col >= size) // Check if index is out of bounds
+            {
+                throw std::out_of_range("Index out of bounds"); // Throw exception for invalid index
+            }
+            return inBand(row, col) ? band[row * width() + (col + lower - row)] : 0.0; // Elements outside the band are zero
+        }
+
+        /**
+         * @brief Addition operator for banded matrices
+         * @param other Matrix to add to this matrix
+         * @return New matrix with the wider of the two bandwidths
+         * @throws std::invalid_argument if matrix sizes don't match
+         */
+        BandedMat operator+(const BandedMat &other) const; // Declaration of addition operator
+
+        /**
+         * @brief Subtraction operator for banded matrices
+         * @param other Matrix to subtract from this matrix
+         * @return New matrix with the wider of the two bandwidths
+         * @throws std::invalid_argument if matrix sizes don't match
+         */
+        BandedMat operator-(const BandedMat &other) const; // Declaration of subtraction operator
+
+        /**
+         * @brief Banded matrix multiplication in O(n * b1 * b2)
+         * @param other Matrix to multiply with this matrix
+         * @return New matrix whose bandwidths are the sums of the operand bandwidths
+         * @throws std::invalid_argument if matrix sizes don't match
+         */
+        BandedMat operator*(const BandedMat &other) const; // Declaration of matrix multiplication operator
+
+        /**
+         * @brief Scalar multiplication operator
+         * @param scalar Value to multiply matrix elements by
+         * @return New matrix with scaled elements
+         */
+        BandedMat operator*(double scalar) const; // Declaration of scalar multiplication operator
+
+        /**
+         * @brief Power operator using repeated squaring
+         * @param power The exponent to raise the matrix to
+         * @return New matrix containing the result of matrix^power
+         * @throws std::invalid_argument if power is negative
+         */
+        BandedMat operator^(int power) const; // Declaration of power operator
+
+        /**
+         * @brief Determinant operator
+         *
+         * Diagonal and triangular bands use the diagonal product, tridiagonal matrices the
+         * three-term recurrence in O(n), and all other bands a banded LU in O(n*b^2).
+         * @return Determinant of the matrix
+         */
+        double operator!() const; // Declaration of determinant operator
+
+        /**
+         * @brief Solve the linear system A*x = rhs with a banded LU in O(n*b^2)
+         * @param rhs Right-hand side vector of length size
+         * @return Solution vector x
+         * @throws std::invalid_argument if rhs has the wrong length or the matrix is singular
+         */
+        std::vector<double> solve(const std::vector<double> &rhs) const; // Declaration of linear solver
+
+        /**
+         * @brief Convert to a full square matrix
+         * @return SquareMat holding the same elements
+         */
+        SquareMat toSquareMat() const; // Declaration of conversion to SquareMat
+
+        /**
+         * @brief Output stream operator for BandedMat (prints the full matrix)
+         * @param os Output stream
+         * @param mat Matrix to output
+         * @return Reference to output stream
+         */
+        friend std::ostream &operator<<(std::ostream &os, const BandedMat &mat); // Declaration of friend output stream operator
+    };
+
+    /**
+     * @class TridiagonalMat
+     * @brief A banded matrix with exactly one diagonal below and one above the main diagonal
+     */
+    class TridiagonalMat : public BandedMat // Tridiagonal specialization of the banded matrix
+    {
+    public:
+        /**
+         * @brief Constructor that creates a zero tridiagonal matrix
+         * @param size The size of the square matrix (number of rows/columns)
+         * @throws std::invalid_argument if size is not positive
+         */
+        explicit TridiagonalMat(size_t size) : BandedMat(size, 1, 1) {} // Delegate to the banded constructor
+
+        /**
+         * @brief Constructor from the three diagonals
+         * @param sub Sub-diagonal (length size-1)
+         * @param diag Main diagonal (length size)
+         * @param super Super-diagonal (length size-1)
+         * @throws std::invalid_argument if the diagonal lengths are inconsistent
+         */
+        TridiagonalMat(const std::vector<double> &sub, const std::vector<double> &diag, const std::vector<double> &super); // Declaration of diagonal constructor
+    };
+} // End of namespace
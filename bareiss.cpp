@@ -0,0 +1,234 @@
+// orel8155@gmail.com
+#include "bareiss.hpp"    // Include the header file for the exact determinant
+#include "threadpool.hpp" // Include for the parallel row updates
+#include <algorithm>      // Include for std::swap_ranges
+#include <atomic>         // Include for the overflow flag shared by the row chunks
+#include <cmath>          // Include for std::trunc
+#include <cstdint>        // Include for int64_t
+#include <utility>        // Include for std::swap
+#include <vector>         // Include for the working matrices
+
+namespace squaremat // Start of the squaremat namespace
+{
+    namespace // Helpers private to this file
+    {
+        __extension__ typedef __int128 Wide; ///< Second tier: signed 128-bit integers (GCC/Clang extension)
+
+        /**
+         * @brief One Bareiss update on int64_t: (x * pivot - y * z) / prev
+         *
+         * Both products and their difference fit in 128 bits (each product is below
+         * 2^126), so only the exact quotient has to be range-checked.
+         * @return false if the quotient does not fit in int64_t
+         */
+        bool combine(int64_t x, int64_t pivot, int64_t y, int64_t z, int64_t prev, int64_t &out) // First-tier update
+        {
+            Wide value = (Wide(x) * pivot - Wide(y) * z) / prev; // Exact in 128 bits
+            if (value < Wide(INT64_MIN) || value > Wide(INT64_MAX)) // Leaves the tier
+            {
+                return false; // Redo the step on 128-bit integers
+            }
+            out = static_cast<int64_t>(value); // Narrow the exact result
+            return true;                       // Stored
+        }
+
+        /**
+         * @brief One Bareiss update on 128-bit integers with overflow checks
+         * @return false if a product, the difference or the quotient overflows
+         */
+        bool combine(Wide x, Wide pivot, Wide y, Wide z, Wide prev, Wide &out) // Second-tier update
+        {
+            Wide left, right, difference;                      // Checked intermediates
+            if (__builtin_mul_overflow(x, pivot, &left) ||     // x * pivot
+                __builtin_mul_overflow(y, z, &right) ||        // y * z
+                __builtin_sub_overflow(left, right, &difference)) // Their difference
+            {
+                return false; // Redo the step on BigInt
+            }
+            if (prev == -1) // The only quotient that can overflow (-2^127 / -1)
+            {
+                return !__builtin_sub_overflow(Wide(0), difference, &out); // Checked negation
+            }
+            out = difference / prev; // Exact division
+            return true;             // Stored
+        }
+
+        /**
+         * @brief One Bareiss update on BigInt (never overflows)
+         * @return true
+         */
+        bool combine(const BigInt &x, const BigInt &pivot, const BigInt &y, const BigInt &z, const BigInt &prev, BigInt &out) // Last-tier update
+        {
+            out = (x * pivot - y * z) / prev; // Exact division
+            return true;                      // Always stored
+        }
+
+        /**
+         * @brief Convert a 128-bit integer to BigInt
+         * @param value Value to convert
+         * @return The same value
+         */
+        BigInt toBigInt(Wide value) // Tier promotion
+        {
+            const BigInt limb(int64_t(1) << 32);                                 // 2^32
+            uint64_t low = static_cast<uint64_t>(value);                         // Low 64 bits
+            BigInt result(static_cast<int64_t>(value >> 64));                    // Signed high 64 bits
+            result = result * limb + BigInt(static_cast<int64_t>(low >> 32));    // Append bits 32..63
+            return result * limb + BigInt(static_cast<int64_t>(low & 0xFFFFFFFFu)); // Append bits 0..31
+        }
+
+        /**
+         * @brief Run Bareiss steps on one integer type until done or overflow
+         *
+         * Step k reads only rows and columns k..n-1 of cur and writes rows and columns
+         * k+1..n-1 of next, then the buffers are swapped, so a step that overflows
+         * leaves cur untouched and can be redone on a wider type. A zero pivot is
+         * replaced by a lower row (flipping the sign) before the step.
+         * @tparam T int64_t, Wide or BigInt
+         * @param cur Working matrix (row-major), holds the latest step on return
+         * @param next Scratch matrix of the same size
+         * @param n Matrix size
+         * @param k Next step; on overflow, the step to redo
+         * @param prev Pivot of the previous step (1 before the first)
+         * @param sign Sign from the row interchanges
+         * @param singular Set when a pivot column is all zero
+         * @param flops Operation counter
+         * @return false if step k overflowed T
+         */
+        template <typename T>
+        bool eliminate(std::vector<T> &cur, std::vector<T> &next, size_t n, size_t &k, T &prev, int &sign, bool &singular, uint64_t &flops) // Bareiss driver for one tier
+        {
+            const T zero(0);          // Comparison constant
+            for (; k + 1 < n; k++)    // Every step but the last leaves a smaller trailing block
+            {
+                if (cur[k * n + k] == zero) // Need a nonzero pivot
+                {
+                    size_t row = k + 1;                                 // Search below the pivot
+                    while (row < n && cur[row * n + k] == zero) // First nonzero in column k
+                    {
+                        row++; // Keep looking
+                    }
+                    if (row == n) // Column is zero from the pivot down
+                    {
+                        singular = true; // Determinant is zero
+                        return true;     // Done
+                    }
+                    std::swap_ranges(cur.begin() + k * n + k, cur.begin() + k * n + n, cur.begin() + row * n + k); // Swap the trailing parts of the rows
+                    sign = -sign;                                                                                  // An interchange flips the sign
+                }
+                const T &pivot = cur[k * n + k]; // Current pivot
+                std::atomic<bool> overflow(false); // Set by any chunk that leaves the tier
+                size_t width = n - k - 1;          // Trailing block size
+                ThreadPool::instance().parallelFor(k + 1, n, ThreadPool::rowGrain(width), [&](size_t first, size_t last) {
+                    for (size_t i = first; i < last && !overflow.load(std::memory_order_relaxed); i++) // Loop through the chunk's rows
+                    {
+                        const T &left = cur[i * n + k];       // Element under the pivot
+                        for (size_t j = k + 1; j < n; j++) // Loop through the trailing columns
+                        {
+                            if (!combine(cur[i * n + j], pivot, left, cur[k * n + j], prev, next[i * n + j])) // Fraction-free update
+                            {
+                                overflow.store(true, std::memory_order_relaxed); // Stop every chunk
+                                return;                                         // Leave the rest undone
+                            }
+                        }
+                    }
+                });
+                if (overflow.load()) // Step must be redone on a wider type
+                {
+                    return false; // cur still holds step k's input
+                }
+                flops += 4 * uint64_t(width) * width; // Two products, a difference and a division per element
+                prev = pivot;                         // Divisor of the next step
+                std::swap(cur, next);                 // The new trailing block becomes current
+            }
+            return true; // All steps done
+        }
+    } // End of anonymous namespace
+
+    /**
+     * @brief Integer check implementation
+     * @param mat Matrix or view to check
+     * @return true if every element is integral and in [-2^63, 2^63)
+     */
+    bool isIntegerValued(const SquareMatView &mat) // Integer check definition
+    {
+        size_t n = mat.getSize();     // Matrix size
+        for (size_t i = 0; i < n; i++) // Loop through rows
+        {
+            const double *row = mat[i];    // Current row
+            for (size_t j = 0; j < n; j++) // Loop through columns
+            {
+                double value = row[j];                                                                       // Element to check
+                if (std::trunc(value) != value || value < -9223372036854775808.0 || value >= 9223372036854775808.0) // Not an int64 value (NaN fails too)
+                {
+                    return false; // Not integer-valued
+                }
+            }
+        }
+        return true; // Every element converts exactly
+    }
+
+    /**
+     * @brief Exact determinant implementation
+     * @param mat Matrix or view with integer elements
+     * @return Determinant of mat
+     * @throws std::invalid_argument if an element is not an integer below 2^63 in magnitude
+     */
+    BigInt determinantExact(const SquareMatView &mat) // Exact determinant definition
+    {
+        if (!isIntegerValued(mat)) // Elements must convert exactly
+        {
+            throw std::invalid_argument("Elements must be integers below 2^63"); // Refuse lossy conversion
+        }
+        size_t n = mat.getSize();                           // Matrix size
+        SQUAREMAT_STAT_SCOPE(Determinant, n * n, 0);        // Count the call
+        SQUAREMAT_TRACE_SCOPE("determinantExact", "operator"); // Timeline event
+        std::vector<int64_t> small(n * n), smallNext(n * n); // First-tier working matrices
+        for (size_t i = 0; i < n; i++)                      // Loop through rows
+        {
+            std::copy(mat[i], mat[i] + n, small.begin() + i * n); // Exact conversion (checked above)
+        }
+        size_t k = 0;          // Next elimination step
+        int sign = 1;          // Sign from row interchanges
+        bool singular = false; // Set by a zero pivot column
+        uint64_t flops = 0;    // Work of all tiers
+        BigInt det;            // Result (zero until set)
+
+        int64_t smallPrev = 1;                                                    // Previous pivot on the first tier
+        bool done = eliminate(small, smallNext, n, k, smallPrev, sign, singular, flops); // Machine integers
+        if (done && !singular)                                                    // Finished without overflow
+        {
+            det = BigInt(small[n * n - 1]); // Last pivot is the determinant
+        }
+        std::vector<Wide> wide;      // Second-tier working matrix
+        Wide widePrev = smallPrev;   // Previous pivot on the second tier
+        if (!done)                   // Promote to 128 bits
+        {
+            wide.assign(small.begin(), small.end()); // Widen every element (only the trailing block is live)
+            std::vector<Wide> wideNext(n * n);       // Scratch for the second tier
+            done = eliminate(wide, wideNext, n, k, widePrev, sign, singular, flops); // 128-bit integers
+            if (done && !singular)                                                   // Finished without overflow
+            {
+                det = toBigInt(wide[n * n - 1]); // Last pivot is the determinant
+            }
+        }
+        if (!done) // Promote to multiprecision
+        {
+            std::vector<BigInt> big, bigNext(n * n); // Last-tier working matrices
+            big.reserve(n * n);                     // One conversion per element
+            for (Wide value : wide)                 // Convert every element
+            {
+                big.push_back(toBigInt(value)); // Exact promotion
+            }
+            BigInt bigPrev = toBigInt(widePrev);                             // Previous pivot on the last tier
+            eliminate(big, bigNext, n, k, bigPrev, sign, singular, flops); // Cannot overflow
+            if (!singular)                                                   // Nonzero determinant
+            {
+                det = big[n * n - 1]; // Last pivot is the determinant
+            }
+        }
+        SQUAREMAT_STAT_FLOPS(flops); // Count the elimination's work
+        (void)flops;                 // Unused when counters are compiled out
+        return sign < 0 ? -det : det; // Apply the interchanges
+    }
+} // End of the squaremat namespace
@@ -0,0 +1,30 @@
+// orel8155@gmail.com
+#pragma once           // Ensures the header file is included only once
+#include "bigint.hpp"  // Include for the exact result type
+#include "matview.hpp" // Include for the matrix operand (SquareMat converts implicitly)
+
+namespace squaremat // Start of namespace definition
+{
+    /**
+     * @brief Check whether every element is an integer representable as int64_t
+     * @param mat Matrix or view to check
+     * @return true if every element is integral and in [-2^63, 2^63)
+     */
+    bool isIntegerValued(const SquareMatView &mat); // Declaration of the integer check
+
+    /**
+     * @brief Exact determinant by Bareiss fraction-free elimination
+     *
+     * Step k replaces each trailing element by (a_ij a_kk - a_ik a_kj) / a_{k-1,k-1};
+     * the division is exact and every intermediate is a minor of the input, so the
+     * entries stay bounded by Hadamard's inequality and the whole run is O(n^3)
+     * integer operations. Elimination starts on int64_t with 128-bit products; a
+     * step whose results leave that range is redone on 128-bit integers, and one
+     * that overflows those is redone on BigInt, so small inputs never leave machine
+     * integers and large ones switch type only from the step that needs it.
+     * @param mat Matrix or view with integer elements
+     * @return Determinant of mat
+     * @throws std::invalid_argument if an element is not an integer below 2^63 in magnitude
+     */
+    BigInt determinantExact(const SquareMatView &mat); // Declaration of the exact determinant
+} // End of namespace
@@ -0,0 +1,434 @@
+// orel8155@gmail.com
+#include "bigint.hpp" // Include the header file for BigInt
+#include <algorithm>  // Include for std::reverse
+#include <bit>        // Include for std::countl_zero
+#include <cmath>      // Include for std::ldexp
+#include <stdexcept>  // Include for standard exceptions
+
+namespace squaremat // Start of the squaremat namespace
+{
+    namespace // Helpers private to this file
+    {
+        __extension__ typedef unsigned __int128 Wide; ///< Two-limb intermediate (GCC/Clang extension)
+
+        const uint64_t DecimalChunk = 10000000000000000000ULL; ///< 10^19, the largest power of ten below 2^64
+    } // End of anonymous namespace
+
+    /**
+     * @brief Constructor implementation
+     * @param value Initial value
+     */
+    BigInt::BigInt(int64_t value) : limbs(), negative(value < 0) // Constructor with initialization list
+    {
+        if (value != 0) // Zero has no limbs
+        {
+            limbs.push_back(value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value)); // |value| without overflow at INT64_MIN
+        }
+    }
+
+    /**
+     * @brief Normalization implementation
+     */
+    void BigInt::trim() // Normalization definition
+    {
+        while (!limbs.empty() && limbs.back() == 0) // Leading zero limbs
+        {
+            limbs.pop_back(); // Drop it
+        }
+        if (limbs.empty()) // Zero
+        {
+            negative = false; // Zero is never negative
+        }
+    }
+
+    /**
+     * @brief Magnitude comparison implementation
+     * @param a First magnitude
+     * @param b Second magnitude
+     * @return -1, 0 or 1 as |a| is less than, equal to or greater than |b|
+     */
+    int BigInt::compareMagnitude(const std::vector<uint64_t> &a, const std::vector<uint64_t> &b) // Magnitude comparison definition
+    {
+        if (a.size() != b.size()) // More limbs means larger (no leading zeros)
+        {
+            return a.size() < b.size() ? -1 : 1; // Compare lengths
+        }
+        for (size_t i = a.size(); i-- > 0;) // From the most significant limb
+        {
+            if (a[i] != b[i]) // First difference decides
+            {
+                return a[i] < b[i] ? -1 : 1; // Compare limbs
+            }
+        }
+        return 0; // Equal magnitudes
+    }
+
+    /**
+     * @brief Magnitude sum implementation
+     * @param a First magnitude
+     * @param b Second magnitude
+     * @return |a| + |b|
+     */
+    std::vector<uint64_t> BigInt::addMagnitude(const std::vector<uint64_t> &a, const std::vector<uint64_t> &b) // Magnitude sum definition
+    {
+        const std::vector<uint64_t> &longer = a.size() >= b.size() ? a : b;  // Operand with more limbs
+        const std::vector<uint64_t> &shorter = a.size() >= b.size() ? b : a; // Operand with fewer limbs
+        std::vector<uint64_t> result(longer.size() + 1);                     // Room for the final carry
+        uint64_t carry = 0;                                                  // Carry between limbs
+        for (size_t i = 0; i < longer.size(); i++)                           // Loop through limbs
+        {
+            Wide sum = Wide(longer[i]) + (i < shorter.size() ? shorter[i] : 0) + carry; // Limb sum
+            result[i] = static_cast<uint64_t>(sum);                                    // Low 64 bits
+            carry = static_cast<uint64_t>(sum >> 64);                                  // Carry out
+        }
+        result[longer.size()] = carry; // Final carry
+        return result;                 // Caller trims
+    }
+
+    /**
+     * @brief Magnitude difference implementation
+     * @param a Larger magnitude
+     * @param b Smaller magnitude
+     * @return |a| - |b|
+     */
+    std::vector<uint64_t> BigInt::subtractMagnitude(const std::vector<uint64_t> &a, const std::vector<uint64_t> &b) // Magnitude difference definition
+    {
+        std::vector<uint64_t> result(a.size()); // At most as long as a
+        uint64_t borrow = 0;                    // Borrow between limbs
+        for (size_t i = 0; i < a.size(); i++)   // Loop through limbs
+        {
+            uint64_t subtrahend = i < b.size() ? b[i] : 0; // Limb of b
+            uint64_t difference = a[i] - subtrahend;       // Wraps on borrow
+            uint64_t outgoing = a[i] < subtrahend;         // Borrow from the limb difference
+            result[i] = difference - borrow;               // Apply the incoming borrow
+            borrow = outgoing + (difference < borrow);     // Borrow out (at most one of the two)
+        }
+        return result; // Caller trims
+    }
+
+    /**
+     * @brief Signed sum implementation
+     * @param a First operand
+     * @param b Magnitude of the second operand
+     * @param bNegative Sign of the second operand
+     * @return a + (bNegative ? -|b| : |b|)
+     */
+    BigInt BigInt::addSigned(const BigInt &a, const std::vector<uint64_t> &b, bool bNegative) // Signed sum definition
+    {
+        BigInt result;               // Zero
+        if (a.negative == bNegative) // Same sign: add magnitudes
+        {
+            result.limbs = addMagnitude(a.limbs, b); // |a| + |b|
+            result.negative = bNegative;             // Common sign
+        }
+        else if (compareMagnitude(a.limbs, b) >= 0) // a's magnitude dominates
+        {
+            result.limbs = subtractMagnitude(a.limbs, b); // |a| - |b|
+            result.negative = a.negative;                 // Sign of a
+        }
+        else // b's magnitude dominates
+        {
+            result.limbs = subtractMagnitude(b, a.limbs); // |b| - |a|
+            result.negative = bNegative;                  // Sign of b
+        }
+        result.trim();  // Normalize
+        return result; // Return the sum
+    }
+
+    /**
+     * @brief Magnitude division implementation (Knuth, TAOCP vol. 2, 4.3.1, algorithm D)
+     * @param a Dividend
+     * @param b Divisor (non-zero)
+     * @param remainder Receives |a| mod |b|
+     * @return floor(|a| / |b|)
+     */
+    std::vector<uint64_t> BigInt::divideMagnitude(const std::vector<uint64_t> &a, const std::vector<uint64_t> &b, std::vector<uint64_t> &remainder) // Magnitude division definition
+    {
+        if (compareMagnitude(a, b) < 0) // Quotient is zero
+        {
+            remainder = a; // Everything remains
+            return {};     // Zero quotient
+        }
+        size_t n = b.size();                   // Divisor limbs
+        size_t m = a.size() - n;               // Extra dividend limbs
+        std::vector<uint64_t> quotient(m + 1); // Quotient limbs
+        if (n == 1)                            // Short division by one limb
+        {
+            uint64_t rest = 0;                  // Running remainder
+            for (size_t i = a.size(); i-- > 0;) // From the most significant limb
+            {
+                Wide current = (Wide(rest) << 64) | a[i];            // Two-limb window
+                quotient[i] = static_cast<uint64_t>(current / b[0]); // Quotient digit
+                rest = static_cast<uint64_t>(current % b[0]);        // Carry the remainder
+            }
+            remainder.assign(1, rest); // Single-limb remainder
+            return quotient;           // Caller trims
+        }
+
+        unsigned shift = static_cast<unsigned>(std::countl_zero(b.back())); // Normalize so the divisor's top bit is set
+        std::vector<uint64_t> vn(n), un(a.size() + 1);                      // Normalized divisor and dividend
+        for (size_t i = n; i-- > 0;)                                         // Shift the divisor
+        {
+            Wide window = (Wide(b[i]) << 64) | (i > 0 ? b[i - 1] : 0); // Limb and the one below it
+            vn[i] = static_cast<uint64_t>(window >> (64 - shift));     // Shifted limb (128-bit shift, no special case for 0)
+        }
+        un[a.size()] = static_cast<uint64_t>(Wide(a.back()) >> (64 - shift)); // Bits shifted out of the top
+        for (size_t i = a.size(); i-- > 0;)                                   // Shift the dividend
+        {
+            Wide window = (Wide(a[i]) << 64) | (i > 0 ? a[i - 1] : 0); // Limb and the one below it
+            un[i] = static_cast<uint64_t>(window >> (64 - shift));     // Shifted limb
+        }
+
+        const Wide base = Wide(1) << 64; // Limb base
+        for (size_t j = m + 1; j-- > 0;) // Quotient digits from the top
+        {
+            Wide numerator = (Wide(un[j + n]) << 64) | un[j + n - 1];                 // Top two limbs of the window
+            Wide qhat = numerator / vn[n - 1];                                        // Estimated digit
+            Wide rhat = numerator % vn[n - 1];                                        // Remainder of the estimate
+            while (qhat >= base || qhat * vn[n - 2] > ((rhat << 64) | un[j + n - 2])) // Estimate too large (at most twice)
+            {
+                qhat--;            // Lower the estimate
+                rhat += vn[n - 1]; // Adjust its remainder
+                if (rhat >= base)  // Test no longer needed
+                {
+                    break; // Estimate is now exact or one too large
+                }
+            }
+            uint64_t digit = static_cast<uint64_t>(qhat); // Fits in one limb now
+            uint64_t carry = 0, borrow = 0;               // Multiply and subtract digit * divisor
+            for (size_t i = 0; i < n; i++)                // Loop through divisor limbs
+            {
+                Wide product = Wide(digit) * vn[i] + carry;    // Limb product plus the carry
+                carry = static_cast<uint64_t>(product >> 64);  // High half carries on
+                uint64_t low = static_cast<uint64_t>(product); // Low half is subtracted
+                uint64_t difference = un[i + j] - low;         // Wraps on borrow
+                uint64_t outgoing = un[i + j] < low;           // Borrow from the subtraction
+                un[i + j] = difference - borrow;               // Apply the incoming borrow
+                borrow = outgoing + (difference < borrow);     // Borrow out
+            }
+            Wide owed = Wide(carry) + borrow;                    // Still to subtract from the top limb
+            bool overshot = Wide(un[j + n]) < owed;              // Subtracted one divisor too many (rare)
+            un[j + n] = static_cast<uint64_t>(un[j + n] - owed); // Top limb of the window (wraps when overshot)
+            quotient[j] = digit;                                 // Tentative digit
+            if (overshot)                                        // Add the divisor back
+            {
+                quotient[j]--;                 // Correct the digit
+                uint64_t back = 0;             // Carry of the addition
+                for (size_t i = 0; i < n; i++) // Loop through divisor limbs
+                {
+                    Wide sum = Wide(un[i + j]) + vn[i] + back; // Limb sum
+                    un[i + j] = static_cast<uint64_t>(sum);    // Low 64 bits
+                    back = static_cast<uint64_t>(sum >> 64);   // Carry out
+                }
+                un[j + n] += back; // Final carry cancels the borrow
+            }
+        }
+
+        remainder.assign(n, 0);        // Unnormalize the remainder
+        for (size_t i = 0; i < n; i++) // Loop through its limbs
+        {
+            Wide window = (Wide(un[i + 1]) << 64) | un[i];         // Limb and the one above it
+            remainder[i] = static_cast<uint64_t>(window >> shift); // Shifted limb
+        }
+        return quotient; // Caller trims
+    }
+
+    /**
+     * @brief Bit length implementation
+     * @return 0 for zero, otherwise floor(log2 |value|) + 1
+     */
+    size_t BigInt::bitLength() const // Bit length definition
+    {
+        if (limbs.empty()) // Zero
+        {
+            return 0; // No bits
+        }
+        return 64 * limbs.size() - static_cast<size_t>(std::countl_zero(limbs.back())); // Full limbs minus the leading zeros of the top one
+    }
+
+    /**
+     * @brief Conversion to double implementation
+     * @return Correctly rounded value (infinite beyond the double range)
+     */
+    double BigInt::toDouble() const // Conversion to double definition
+    {
+        size_t bits = bitLength();                                             // Significant bits
+        auto bit = [&](size_t k) { return (limbs[k / 64] >> (k % 64)) & 1u; }; // Bit k of the magnitude
+        uint64_t top = 0;                                                      // Leading (at most) 64 bits
+        size_t shift = bits > 64 ? bits - 64 : 0;                              // Bits below the window
+        for (size_t k = bits; k-- > shift;)                                    // Copy the window
+        {
+            top = (top << 1) | bit(k); // Next bit
+        }
+        for (size_t k = 0; k < shift && !(top & 1u); k++) // Any bit below the window rounds like a nonzero tail
+        {
+            top |= bit(k); // Sticky bit
+        }
+        double value = std::ldexp(static_cast<double>(top), static_cast<int>(shift)); // 64 bits with a sticky bit round exactly once
+        return negative ? -value : value;                                             // Apply the sign
+    }
+
+    /**
+     * @brief Decimal conversion implementation
+     * @return Decimal digits with a leading '-' if negative
+     */
+    std::string BigInt::toString() const // Decimal conversion definition
+    {
+        if (limbs.empty()) // Zero
+        {
+            return "0"; // Single digit
+        }
+        std::vector<uint64_t> rest = limbs; // Magnitude consumed by repeated division
+        std::string digits;                 // Digits, least significant first
+        while (!rest.empty())               // Nineteen digits per pass
+        {
+            uint64_t chunk = 0;                    // Remainder modulo 10^19
+            for (size_t i = rest.size(); i-- > 0;) // Short division from the top
+            {
+                Wide current = (Wide(chunk) << 64) | rest[i];            // Two-limb window
+                rest[i] = static_cast<uint64_t>(current / DecimalChunk); // Quotient limb
+                chunk = static_cast<uint64_t>(current % DecimalChunk);   // Carry the remainder
+            }
+            while (!rest.empty() && rest.back() == 0) // Drop leading zero limbs
+            {
+                rest.pop_back(); // Shorter quotient
+            }
+            for (int d = 0; d < 19 && (chunk != 0 || !rest.empty()); d++) // Digits of the chunk (no padding on the last one)
+            {
+                digits.push_back(static_cast<char>('0' + chunk % 10)); // Next digit
+                chunk /= 10;                                           // Remaining digits
+            }
+        }
+        if (negative) // Sign goes in front
+        {
+            digits.push_back('-'); // Reversed below
+        }
+        std::reverse(digits.begin(), digits.end()); // Most significant first
+        return digits;                              // Return the decimal string
+    }
+
+    /**
+     * @brief Unary minus operator implementation
+     * @return Value with the opposite sign
+     */
+    BigInt BigInt::operator-() const // Unary minus operator definition
+    {
+        BigInt result = *this;                         // Same magnitude
+        result.negative = !negative && !limbs.empty(); // Flip the sign (zero stays positive)
+        return result;                                 // Return the negated value
+    }
+
+    /**
+     * @brief Addition operator implementation
+     * @param other Value to add
+     * @return Sum
+     */
+    BigInt BigInt::operator+(const BigInt &other) const // Addition operator definition
+    {
+        return addSigned(*this, other.limbs, other.negative); // Signed sum
+    }
+
+    /**
+     * @brief Subtraction operator implementation
+     * @param other Value to subtract
+     * @return Difference
+     */
+    BigInt BigInt::operator-(const BigInt &other) const // Subtraction operator definition
+    {
+        return addSigned(*this, other.limbs, !other.negative && !other.limbs.empty()); // Add with the opposite sign
+    }
+
+    /**
+     * @brief Multiplication operator implementation
+     * @param other Value to multiply by
+     * @return Product
+     */
+    BigInt BigInt::operator*(const BigInt &other) const // Multiplication operator definition
+    {
+        BigInt result;                            // Zero
+        if (limbs.empty() || other.limbs.empty()) // Either factor is zero
+        {
+            return result; // Zero product
+        }
+        result.limbs.assign(limbs.size() + other.limbs.size(), 0); // Room for every product limb
+        for (size_t i = 0; i < limbs.size(); i++)                  // Loop through this value's limbs
+        {
+            uint64_t carry = 0;                             // Carry along the row
+            for (size_t j = 0; j < other.limbs.size(); j++) // Loop through the other value's limbs
+            {
+                Wide current = Wide(limbs[i]) * other.limbs[j] + result.limbs[i + j] + carry; // At most 2^128 - 1
+                result.limbs[i + j] = static_cast<uint64_t>(current);                         // Low 64 bits
+                carry = static_cast<uint64_t>(current >> 64);                                 // Carry out
+            }
+            result.limbs[i + other.limbs.size()] = carry; // Final carry of the row
+        }
+        result.negative = negative != other.negative; // Product sign
+        result.trim();                                // Normalize
+        return result;                                // Return the product
+    }
+
+    /**
+     * @brief Division operator implementation
+     * @param other Divisor
+     * @return Quotient truncated toward zero
+     * @throws std::invalid_argument if other is zero
+     */
+    BigInt BigInt::operator/(const BigInt &other) const // Division operator definition
+    {
+        if (other.limbs.empty()) // Check for division by zero
+        {
+            throw std::invalid_argument("Division by zero"); // Throw exception for division by zero
+        }
+        BigInt result;                                                 // Quotient
+        std::vector<uint64_t> remainder;                               // Unused remainder
+        result.limbs = divideMagnitude(limbs, other.limbs, remainder); // |a| / |b|
+        result.negative = negative != other.negative;                  // Quotient sign
+        result.trim();                                                 // Normalize
+        return result;                                                 // Return the quotient
+    }
+
+    /**
+     * @brief Remainder operator implementation
+     * @param other Divisor
+     * @return this - (this / other) * other
+     * @throws std::invalid_argument if other is zero
+     */
+    BigInt BigInt::operator%(const BigInt &other) const // Remainder operator definition
+    {
+        if (other.limbs.empty()) // Check for division by zero
+        {
+            throw std::invalid_argument("Division by zero"); // Throw exception for division by zero
+        }
+        BigInt result;                                     // Remainder
+        divideMagnitude(limbs, other.limbs, result.limbs); // |a| mod |b|
+        result.negative = negative;                        // Sign of the dividend
+        result.trim();                                     // Normalize
+        return result;                                     // Return the remainder
+    }
+
+    /**
+     * @brief Less than operator implementation
+     * @param other Value to compare with
+     * @return true if this value is smaller
+     */
+    bool BigInt::operator<(const BigInt &other) const // Less than operator definition
+    {
+        if (negative != other.negative) // Different signs
+        {
+            return negative; // The negative one is smaller
+        }
+        int order = compareMagnitude(limbs, other.limbs); // Compare magnitudes
+        return negative ? order > 0 : order < 0;          // Larger magnitude is smaller when negative
+    }
+
+    /**
+     * @brief Output stream operator implementation
+     * @param os Output stream to write to
+     * @param value Value to output
+     * @return Reference to the output stream
+     */
+    std::ostream &operator<<(std::ostream &os, const BigInt &value) // Output stream operator definition
+    {
+        return os << value.toString(); // Decimal digits
+    }
+} // End of the squaremat namespace
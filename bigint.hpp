@@ -0,0 +1,180 @@
+// orel8155@gmail.com
+#pragma once        // Ensures the header file is included only once
+#include <cstdint>  // Include for fixed-width integers
+#include <iostream> // Include for input/output operations
+#include <string>   // Include for decimal conversion
+#include <vector>   // Include for the limb storage
+
+namespace squaremat // Start of namespace definition
+{
+    /**
+     * @class BigInt
+     * @brief Arbitrary-precision signed integer for exact determinants
+     *
+     * Sign and magnitude, with the magnitude in base 2^64 limbs (least significant
+     * first, no leading zero limbs; zero has no limbs and is never negative).
+     * Division truncates toward zero like the built-in integers.
+     */
+    class BigInt // Class definition for the multiprecision integer
+    {
+    private:
+        std::vector<uint64_t> limbs; ///< Magnitude, least significant limb first
+        bool negative;               ///< Sign (false for zero)
+
+        /**
+         * @brief Drop leading zero limbs and clear the sign of zero
+         */
+        void trim(); // Declaration of the normalization
+
+        /**
+         * @brief Compare magnitudes
+         * @param a First magnitude
+         * @param b Second magnitude
+         * @return -1, 0 or 1 as |a| is less than, equal to or greater than |b|
+         */
+        static int compareMagnitude(const std::vector<uint64_t> &a, const std::vector<uint64_t> &b); // Declaration of the magnitude comparison
+
+        /**
+         * @brief Add magnitudes
+         * @param a First magnitude
+         * @param b Second magnitude
+         * @return |a| + |b|
+         */
+        static std::vector<uint64_t> addMagnitude(const std::vector<uint64_t> &a, const std::vector<uint64_t> &b); // Declaration of the magnitude sum
+
+        /**
+         * @brief Subtract magnitudes
+         * @param a Larger magnitude
+         * @param b Smaller magnitude
+         * @return |a| - |b| (requires |a| >= |b|)
+         */
+        static std::vector<uint64_t> subtractMagnitude(const std::vector<uint64_t> &a, const std::vector<uint64_t> &b); // Declaration of the magnitude difference
+
+        /**
+         * @brief Signed sum without a temporary for the negated operand
+         * @param a First operand
+         * @param b Magnitude of the second operand
+         * @param bNegative Sign of the second operand
+         * @return a + (bNegative ? -|b| : |b|)
+         */
+        static BigInt addSigned(const BigInt &a, const std::vector<uint64_t> &b, bool bNegative); // Declaration of the signed sum
+
+        /**
+         * @brief Divide magnitudes (Knuth's algorithm D)
+         * @param a Dividend
+         * @param b Divisor (non-zero)
+         * @param remainder Receives |a| mod |b|
+         * @return floor(|a| / |b|)
+         */
+        static std::vector<uint64_t> divideMagnitude(const std::vector<uint64_t> &a, const std::vector<uint64_t> &b, std::vector<uint64_t> &remainder); // Declaration of the magnitude division
+
+    public:
+        /**
+         * @brief Constructor from a built-in integer
+         * @param value Initial value (default zero)
+         */
+        BigInt(int64_t value = 0); // Declaration of constructor
+
+        /**
+         * @brief Check for zero
+         * @return true if the value is zero
+         */
+        bool isZero() const { return limbs.empty(); } // Zero has no limbs
+
+        /**
+         * @brief Sign of the value
+         * @return -1, 0 or 1
+         */
+        int sign() const { return limbs.empty() ? 0 : (negative ? -1 : 1); } // Sign from the flag and the limbs
+
+        /**
+         * @brief Number of significant bits of the magnitude
+         * @return 0 for zero, otherwise floor(log2 |value|) + 1
+         */
+        size_t bitLength() const; // Declaration of the bit length
+
+        /**
+         * @brief Convert to the nearest double
+         * @return Correctly rounded value (infinite beyond the double range)
+         */
+        double toDouble() const; // Declaration of the conversion to double
+
+        /**
+         * @brief Convert to decimal
+         * @return Decimal digits with a leading '-' if negative
+         */
+        std::string toString() const; // Declaration of the decimal conversion
+
+        /**
+         * @brief Unary minus operator
+         * @return Value with the opposite sign
+         */
+        BigInt operator-() const; // Declaration of unary minus operator
+
+        /**
+         * @brief Addition operator
+         * @param other Value to add
+         * @return Sum
+         */
+        BigInt operator+(const BigInt &other) const; // Declaration of addition operator
+
+        /**
+         * @brief Subtraction operator
+         * @param other Value to subtract
+         * @return Difference
+         */
+        BigInt operator-(const BigInt &other) const; // Declaration of subtraction operator
+
+        /**
+         * @brief Multiplication operator (schoolbook)
+         * @param other Value to multiply by
+         * @return Product
+         */
+        BigInt operator*(const BigInt &other) const; // Declaration of multiplication operator
+
+        /**
+         * @brief Division operator, truncating toward zero
+         * @param other Divisor
+         * @return Quotient
+         * @throws std::invalid_argument if other is zero
+         */
+        BigInt operator/(const BigInt &other) const; // Declaration of division operator
+
+        /**
+         * @brief Remainder operator (sign of the dividend)
+         * @param other Divisor
+         * @return this - (this / other) * other
+         * @throws std::invalid_argument if other is zero
+         */
+        BigInt operator%(const BigInt &other) const; // Declaration of remainder operator
+
+        /**
+         * @brief Equality operator
+         * @param other Value to compare with
+         * @return true if the values are equal
+         */
+        bool operator==(const BigInt &other) const { return negative == other.negative && limbs == other.limbs; } // Same sign and magnitude
+
+        /**
+         * @brief Inequality operator
+         * @param other Value to compare with
+         * @return true if the values differ
+         */
+        bool operator!=(const BigInt &other) const { return !(*this == other); } // Negate equality comparison
+
+        /**
+         * @brief Less than operator
+         * @param other Value to compare with
+         * @return true if this value is smaller
+         */
+        bool operator<(const BigInt &other) const; // Declaration of less than operator
+
+        /**
+         * @brief Output stream operator (decimal)
+         * @param os Output stream to write to
+         * @param value Value to output
+         * @return Reference to the output stream
+         */
+        friend std::ostream &operator<<(std::ostream &os, const BigInt &value); // Declaration of friend output stream operator
+    };
+} // End of namespace
@@ -0,0 +1,109 @@
+// orel8155@gmail.com
+#include "coroutine.hpp" // Include the header file for the coroutine pipelines
+#include <chrono>        // Include for the helping wait
+
+namespace squaremat // Start of the squaremat namespace
+{
+    /**
+     * @brief Hop implementation
+     * @param awaiting Coroutine to resume on the pool
+     */
+    void ScheduleAwaiter::await_suspend(std::coroutine_handle<> awaiting) const // Hop definition
+    {
+        ThreadPool::instance().submit([awaiting]() { awaiting.resume(); }); // Inline when the pool has no workers
+    }
+
+    /**
+     * @brief Arrival implementation
+     */
+    void SyncLatch::arrive() // Arrival definition
+    {
+        std::lock_guard<std::mutex> lock(mutex); // Notify under the lock so wait() can't return early
+        if (--remaining == 0)                    // Last coroutine
+        {
+            zero.notify_all(); // Wake the waiter
+        }
+    }
+
+    /**
+     * @brief Helping wait implementation
+     */
+    void SyncLatch::wait() // Helping wait definition
+    {
+        ThreadPool &pool = ThreadPool::instance(); // Pool the coroutines continue on
+        for (;;)                                   // Until every coroutine arrived
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex); // Protect the count
+                if (remaining == 0)                      // All done
+                {
+                    return; // Stop waiting
+                }
+            }
+            if (pool.runPendingTask()) // Resume a coroutine or run an operation here
+            {
+                continue; // Check again
+            }
+            std::unique_lock<std::mutex> lock(mutex);                                               // Protect the wait
+            zero.wait_for(lock, std::chrono::milliseconds(1), [&]() { return remaining == 0; }); // Recheck the queue soon
+        }
+    }
+
+    /**
+     * @brief Void driver implementation
+     * @param task Task to run
+     * @param failure Output exception
+     * @param latch Latch to arrive at
+     * @return Detached driver
+     */
+    SyncDriver driveTask(Task<void> &task, std::exception_ptr &failure, SyncLatch &latch) // Void driver definition
+    {
+        try
+        {
+            co_await task; // Run the task to completion
+        }
+        catch (...)
+        {
+            failure = std::current_exception(); // Keep the exception
+        }
+        latch.arrive(); // Signal completion
+    }
+
+    /**
+     * @brief Void bridge implementation
+     * @param task Task to run
+     */
+    void syncWait(Task<void> task) // Void bridge definition
+    {
+        std::exception_ptr failure;     // Exception of the task
+        SyncLatch latch(1);             // One task to wait for
+        driveTask(task, failure, latch); // Start it
+        latch.wait();                   // Help until it is done
+        if (failure)                    // The task threw
+        {
+            std::rethrow_exception(failure); // Propagate it
+        }
+    }
+
+    /**
+     * @brief Many-pipeline bridge implementation
+     * @param pipelines Tasks to run
+     */
+    void syncWaitAll(std::vector<Task<void>> &pipelines) // Many-pipeline bridge definition
+    {
+        std::vector<std::exception_ptr> failures(pipelines.size()); // One slot per pipeline
+        SyncLatch latch(pipelines.size());                          // Every pipeline must arrive
+        for (size_t i = 0; i < pipelines.size(); i++)               // Start them in order
+        {
+            driveTask(pipelines[i], failures[i], latch); // Runs until its first suspension
+        }
+        latch.wait();                                  // Help until all are done
+        for (const std::exception_ptr &failure : failures) // Loop through the outcomes
+        {
+            if (failure) // This pipeline threw
+            {
+                std::rethrow_exception(failure); // Propagate the first one
+            }
+        }
+    }
+} // End of squaremat namespace
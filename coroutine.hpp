@@ -0,0 +1,474 @@
+// orel8155@gmail.com
+#pragma once                // Ensures the header file is included only once
+#include <condition_variable> // Include for the blocking wait
+#include <coroutine>          // Include for the coroutine machinery
+#include <exception>          // Include for std::exception_ptr
+#include <mutex>              // Include for the blocking wait
+#include <optional>           // Include for task results
+#include <utility>            // Include for std::move and std::exchange
+#include <vector>             // Include for waiting on many pipelines
+#include "async.hpp"          // Include for the futures the coroutines await
+
+namespace squaremat // Start of namespace definition
+{
+    template <typename T = void>
+    class Task; // Lazy coroutine, defined below
+
+    /**
+     * @brief Promise parts shared by every Task
+     */
+    class TaskPromiseBase // Class definition for the common promise
+    {
+    protected:
+        std::coroutine_handle<> continuation; ///< Coroutine awaiting this one
+        std::exception_ptr failure;           ///< Exception that escaped the body
+
+        /**
+         * @brief Final suspension that resumes the awaiting coroutine
+         */
+        struct FinalAwaiter
+        {
+            /**
+             * @brief Always suspend so the Task owns the frame until it is destroyed
+             * @return false
+             */
+            bool await_ready() const noexcept { return false; } // Never ready
+
+            /**
+             * @brief Transfer control to the awaiting coroutine, if any
+             * @param finished Handle of the finished coroutine
+             * @return Coroutine to resume next
+             */
+            template <typename Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> finished) noexcept // Symmetric transfer
+            {
+                std::coroutine_handle<> next = finished.promise().continuation;  // Awaiting coroutine
+                return next ? next : std::noop_coroutine();                      // Nothing to resume when started detached
+            }
+
+            /**
+             * @brief Never resumed
+             */
+            void await_resume() const noexcept {} // Nothing to return
+        };
+
+    public:
+        /**
+         * @brief Tasks start only when awaited
+         * @return Suspension at the start
+         */
+        std::suspend_always initial_suspend() noexcept { return {}; } // Lazy start
+
+        /**
+         * @brief Resume the awaiting coroutine at the end
+         * @return Final awaiter
+         */
+        FinalAwaiter final_suspend() noexcept { return {}; } // Continue the caller
+
+        /**
+         * @brief Keep an exception for the awaiting coroutine
+         */
+        void unhandled_exception() noexcept { failure = std::current_exception(); } // Capture the exception
+
+        /**
+         * @brief Remember who resumes after this task
+         * @param awaiting Awaiting coroutine
+         */
+        void setContinuation(std::coroutine_handle<> awaiting) { continuation = awaiting; } // Continuation setter
+
+        /**
+         * @brief Rethrow the exception of the body, if any
+         */
+        void rethrowIfFailed() const // Failure propagation
+        {
+            if (failure) // The body threw
+            {
+                std::rethrow_exception(failure); // Propagate it
+            }
+        }
+    };
+
+    /**
+     * @class Task
+     * @brief Lazily started coroutine that produces a T
+     *
+     * A Task runs when it is co_awaited (or handed to syncWait) and resumes its awaiter
+     * when it finishes. Inside, co_await on a Future suspends without blocking the thread;
+     * the coroutine continues on the pool once the result is there.
+     * @tparam T Result type (void for pipelines without a result)
+     */
+    template <typename T>
+    class Task // Class definition for the coroutine task
+    {
+    public:
+        /**
+         * @brief Promise of a Task with a result
+         */
+        class promise_type : public TaskPromiseBase // Class definition for the promise
+        {
+        private:
+            std::optional<T> value; ///< Result of the body
+
+            friend class Task; // The task reads the result
+
+        public:
+            /**
+             * @brief Task owning this frame
+             * @return The task
+             */
+            Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); } // Task creation
+
+            /**
+             * @brief Store the result of co_return
+             * @param result Result of the body
+             */
+            void return_value(T result) { value.emplace(std::move(result)); } // Result setter
+        };
+
+        /**
+         * @brief Move constructor
+         * @param other Task to take over (left empty)
+         */
+        Task(Task &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {} // Move constructor with initialization list
+
+        /**
+         * @brief Destructor that destroys the coroutine frame
+         */
+        ~Task() // Destructor definition
+        {
+            if (handle) // Still owns a frame
+            {
+                handle.destroy(); // Release it
+            }
+        }
+
+        Task(const Task &) = delete;            // Frames are owned once
+        Task &operator=(const Task &) = delete; // Frames are owned once
+
+        /**
+         * @brief A task always has to run first
+         * @return false
+         */
+        bool await_ready() const noexcept { return false; } // Never ready before it starts
+
+        /**
+         * @brief Start the task and resume the awaiter when it finishes
+         * @param awaiting Awaiting coroutine
+         * @return The task's coroutine, resumed right away
+         */
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) // Start by symmetric transfer
+        {
+            handle.promise().setContinuation(awaiting); // Come back here at the end
+            return handle;                              // Run the task
+        }
+
+        /**
+         * @brief Result of the finished task
+         * @return The result
+         * @throws The exception that escaped the task's body
+         */
+        T await_resume() // Result access
+        {
+            handle.promise().rethrowIfFailed();   // Propagate a failure
+            return std::move(*handle.promise().value); // Hand the result over
+        }
+
+    private:
+        std::coroutine_handle<promise_type> handle; ///< Owned coroutine frame
+
+        /**
+         * @brief Constructor used by the promise
+         * @param handle Coroutine frame
+         */
+        explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {} // Constructor with initialization list
+    };
+
+    /**
+     * @class Task<void>
+     * @brief Lazily started coroutine without a result
+     */
+    template <>
+    class Task<void> // Class definition for the void task
+    {
+    public:
+        /**
+         * @brief Promise of a Task without a result
+         */
+        class promise_type : public TaskPromiseBase // Class definition for the promise
+        {
+        public:
+            /**
+             * @brief Task owning this frame
+             * @return The task
+             */
+            Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); } // Task creation
+
+            /**
+             * @brief End of the body
+             */
+            void return_void() {} // Nothing to store
+        };
+
+        /**
+         * @brief Move constructor
+         * @param other Task to take over (left empty)
+         */
+        Task(Task &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {} // Move constructor with initialization list
+
+        /**
+         * @brief Destructor that destroys the coroutine frame
+         */
+        ~Task() // Destructor definition
+        {
+            if (handle) // Still owns a frame
+            {
+                handle.destroy(); // Release it
+            }
+        }
+
+        Task(const Task &) = delete;            // Frames are owned once
+        Task &operator=(const Task &) = delete; // Frames are owned once
+
+        /**
+         * @brief A task always has to run first
+         * @return false
+         */
+        bool await_ready() const noexcept { return false; } // Never ready before it starts
+
+        /**
+         * @brief Start the task and resume the awaiter when it finishes
+         * @param awaiting Awaiting coroutine
+         * @return The task's coroutine, resumed right away
+         */
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) // Start by symmetric transfer
+        {
+            handle.promise().setContinuation(awaiting); // Come back here at the end
+            return handle;                              // Run the task
+        }
+
+        /**
+         * @brief Finish the await
+         * @throws The exception that escaped the task's body
+         */
+        void await_resume() { handle.promise().rethrowIfFailed(); } // Propagate a failure
+
+    private:
+        std::coroutine_handle<promise_type> handle; ///< Owned coroutine frame
+
+        /**
+         * @brief Constructor used by the promise
+         * @param handle Coroutine frame
+         */
+        explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {} // Constructor with initialization list
+    };
+
+    /**
+     * @brief Awaiter that continues the coroutine on the shared pool
+     */
+    struct ScheduleAwaiter
+    {
+        /**
+         * @brief Skip the hop when the pool has no workers (it would resume inline)
+         * @return true if there is no other thread to continue on
+         */
+        bool await_ready() const { return ThreadPool::instance().getThreadCount() == 1; } // Nothing to hop to
+
+        /**
+         * @brief Queue the coroutine on the pool
+         * @param awaiting Coroutine to resume there
+         */
+        void await_suspend(std::coroutine_handle<> awaiting) const; // Declaration of the hop
+
+        /**
+         * @brief Nothing to return after the hop
+         */
+        void await_resume() const noexcept {} // Nothing to return
+    };
+
+    /**
+     * @brief Continue the current coroutine on ThreadPool::instance()
+     *
+     * Useful before CPU-heavy work in a pipeline started by syncWait, so the thread that
+     * drives many pipelines only starts them. Without workers the coroutine continues inline.
+     * @return Awaiter for co_await
+     */
+    inline ScheduleAwaiter schedule() { return {}; } // Scheduler awaitable
+
+    /**
+     * @brief Awaiter of a Future
+     * @tparam T Result type of the future
+     */
+    template <typename T>
+    struct FutureAwaiter
+    {
+        Future<T> future; ///< Awaited future (keeps the result alive)
+
+        /**
+         * @brief Skip the suspension when the result is already there
+         * @return true if the future is ready
+         */
+        bool await_ready() const { return future.ready(); } // Fast path
+
+        /**
+         * @brief Resume the coroutine on the pool once the future is ready
+         * @param awaiting Suspended coroutine
+         * @return false to continue right away if the result arrived meanwhile
+         */
+        bool await_suspend(std::coroutine_handle<> awaiting) const // Suspension
+        {
+            return future.whenPending([awaiting]() { ThreadPool::instance().submit([awaiting]() { awaiting.resume(); }); }); // Resume as a pool task, never nested in the completing call
+        }
+
+        /**
+         * @brief Result of the future
+         * @return Reference to the result (valid until the end of the full expression)
+         * @throws The exception of the operation
+         */
+        const T &await_resume() const { return future.get(); } // Ready, so get() does not block
+    };
+
+    /**
+     * @brief Make a Future awaitable: `SquareMat p = co_await multiplyAsync(a, b);`
+     * @param future Future to await
+     * @return Awaiter
+     */
+    template <typename T>
+    FutureAwaiter<T> operator co_await(const Future<T> &future) { return FutureAwaiter<T>{future}; } // Awaitable adapter
+
+    /**
+     * @brief Completion signal of coroutines started by syncWait
+     */
+    class SyncLatch // Class definition for the latch
+    {
+    private:
+        std::mutex mutex;               ///< Protects remaining
+        std::condition_variable zero;   ///< Signals the last arrival
+        size_t remaining;               ///< Coroutines still running
+
+    public:
+        /**
+         * @brief Constructor
+         * @param count Number of arrivals to wait for
+         */
+        explicit SyncLatch(size_t count) : remaining(count) {} // Constructor with initialization list
+
+        /**
+         * @brief Record one finished coroutine
+         */
+        void arrive(); // Declaration of the arrival
+
+        /**
+         * @brief Wait for every arrival, running queued pool tasks meanwhile
+         */
+        void wait(); // Declaration of the helping wait
+    };
+
+    /**
+     * @brief Detached coroutine used to drive a Task from ordinary code
+     */
+    struct SyncDriver
+    {
+        /**
+         * @brief Promise of a detached driver that frees its own frame
+         */
+        struct promise_type
+        {
+            /**
+             * @brief Nothing to hand back to the caller
+             * @return Empty driver
+             */
+            SyncDriver get_return_object() { return {}; } // Driver creation
+
+            /**
+             * @brief Start immediately
+             * @return No suspension
+             */
+            std::suspend_never initial_suspend() noexcept { return {}; } // Eager start
+
+            /**
+             * @brief Free the frame at the end
+             * @return No suspension
+             */
+            std::suspend_never final_suspend() noexcept { return {}; } // Self-destruction
+
+            /**
+             * @brief End of the body
+             */
+            void return_void() {} // Nothing to store
+
+            /**
+             * @brief Drivers catch everything themselves
+             */
+            void unhandled_exception() noexcept { std::terminate(); } // Unreachable
+        };
+    };
+
+    /**
+     * @brief Driver body: await the task, keep its outcome and arrive at the latch
+     * @param task Task to run
+     * @param result Output result
+     * @param failure Output exception
+     * @param latch Latch to arrive at
+     * @return Detached driver
+     */
+    template <typename T>
+    SyncDriver driveTask(Task<T> &task, std::optional<T> &result, std::exception_ptr &failure, SyncLatch &latch) // Driver for tasks with a result
+    {
+        try
+        {
+            result.emplace(co_await task); // Run the task to completion
+        }
+        catch (...)
+        {
+            failure = std::current_exception(); // Keep the exception
+        }
+        latch.arrive(); // Signal completion
+    }
+
+    /**
+     * @brief Driver body for tasks without a result
+     * @param task Task to run
+     * @param failure Output exception
+     * @param latch Latch to arrive at
+     * @return Detached driver
+     */
+    SyncDriver driveTask(Task<void> &task, std::exception_ptr &failure, SyncLatch &latch); // Declaration of the void driver
+
+    /**
+     * @brief Run a task from ordinary code and wait for its result
+     * @param task Task to run
+     * @return The result
+     * @throws The exception that escaped the task
+     */
+    template <typename T>
+    T syncWait(Task<T> task) // Blocking bridge for tasks with a result
+    {
+        std::optional<T> result;                  // Result of the task
+        std::exception_ptr failure;               // Exception of the task
+        SyncLatch latch(1);                       // One task to wait for
+        driveTask(task, result, failure, latch);  // Start it
+        latch.wait();                             // Help until it is done
+        if (failure)                              // The task threw
+        {
+            std::rethrow_exception(failure); // Propagate it
+        }
+        return std::move(*result); // Return the result
+    }
+
+    /**
+     * @brief Run a task without a result from ordinary code and wait for it
+     * @param task Task to run
+     * @throws The exception that escaped the task
+     */
+    void syncWait(Task<void> task); // Declaration of the void bridge
+
+    /**
+     * @brief Start every pipeline from the calling thread and wait until all have finished
+     *
+     * Each pipeline runs until its first suspension, then the next one starts; suspended
+     * pipelines continue on the pool while the caller helps.
+     * @param pipelines Tasks to run
+     * @throws The first exception (in pipeline order) that escaped a pipeline
+     */
+    void syncWaitAll(std::vector<Task<void>> &pipelines); // Declaration of the many-pipeline bridge
+} // End of namespace
@@ -0,0 +1,243 @@
+// orel8155@gmail.com
+#include "expm.hpp"           // Include the header file for the matrix exponential
+#include "kernels.hpp"        // Include for the LU kernels
+#include "threadpool.hpp"     // Include for the parallel combinations and solves
+#include <algorithm>          // Include for std::max and std::fill
+#include <cmath>              // Include for std::exp, std::ceil, std::log2 and std::ldexp
+#include <initializer_list>   // Include for the lists of terms
+#include <limits>             // Include for quiet NaN
+#include <stdexcept>          // Include for standard exceptions
+#include <utility>            // Include for std::swap
+#include <vector>             // Include for the LU storage
+
+namespace squaremat // Start of the squaremat namespace
+{
+    namespace // Helpers private to this file
+    {
+        const double Theta[] = {1.495585217958292e-2, 2.539398330063230e-1, 9.504178996162932e-1, 2.097847961257068e0, 5.371920351148152e0}; ///< Largest 1-norm for degrees 3, 5, 7, 9 and 13 (Higham 2005, Table 2.3)
+
+        const double Pade3[] = {120, 60, 12, 1};                                                                                        ///< Coefficients b_0..b_3 of r_3
+        const double Pade5[] = {30240, 15120, 3360, 420, 30, 1};                                                                        ///< Coefficients b_0..b_5 of r_5
+        const double Pade7[] = {17297280, 8648640, 1995840, 277200, 25200, 1512, 56, 1};                                                ///< Coefficients b_0..b_7 of r_7
+        const double Pade9[] = {17643225600., 8821612800., 2075673600., 302702400., 30270240., 2162160., 110880., 3960., 90., 1.};       ///< Coefficients b_0..b_9 of r_9
+        const double Pade13[] = {64764752532480000., 32382376266240000., 7771770303897600., 1187353796428800., 129060195264000., 10559470521600.,
+                                 670442572800., 33522128640., 1323241920., 40840800., 960960., 16380., 182., 1.}; ///< Coefficients b_0..b_13 of r_13
+
+        /**
+         * @brief One term of a matrix polynomial
+         */
+        struct Term
+        {
+            double coefficient;     ///< Scale of the power
+            const SquareMat *power; ///< Power of A
+        };
+
+        /**
+         * @brief out = identity * I + sum of coefficient * power, in one parallel pass
+         * @param out Matrix that receives the combination (not one of the powers)
+         * @param identity Coefficient of I
+         * @param terms Scaled powers to add
+         */
+        void combine(SquareMat &out, double identity, std::initializer_list<Term> terms) // Polynomial combination
+        {
+            size_t n = out.getSize(); // Matrix size
+            double *result = out.data(); // Elements of out (contiguous)
+            ThreadPool::instance().parallelFor(0, n, ThreadPool::rowGrain(n), [&](size_t first, size_t last) {
+                std::fill(result + first * n, result + last * n, 0.0); // Clear the chunk
+                for (const Term &term : terms)                         // Add each power
+                {
+                    const SquareMat &power = *term.power; // Read without unsharing
+                    for (size_t i = first; i < last; i++) // Rows of the chunk
+                    {
+                        kernels::axpy(term.coefficient, power[i], result + i * n, n); // Row of the power
+                    }
+                }
+                for (size_t i = first; i < last; i++) // Diagonal of the chunk
+                {
+                    result[i * n + i] += identity; // Scaled identity
+                }
+            });
+        }
+
+        /**
+         * @brief Odd and even parts of r_m for m <= 9: u = A (sum b_odd A^(k-1)), v = sum b_even A^k
+         * @param a Matrix A
+         * @param b Padé coefficients b_0..b_m
+         * @param m Degree (3, 5, 7 or 9)
+         * @param powers A^2, A^4, A^6, A^8 (as many as m needs, computed here)
+         * @param odd Scratch for the odd polynomial
+         * @param u Receives the odd part
+         * @param v Receives the even part
+         */
+        void padeLow(const SquareMat &a, const double *b, int m, SquareMat *powers, SquareMat &odd, SquareMat &u, SquareMat &v) // Degrees 3 to 9
+        {
+            gemm(1, a, a, 0, powers[0]); // A^2
+            for (int k = 1; 2 * k + 2 < m; k++) // A^4, A^6, A^8 as needed
+            {
+                gemm(1, powers[k - 1], powers[0], 0, powers[k]); // A^(2k+2)
+            }
+            switch (m) // Terms of the degree
+            {
+            case 3:
+                combine(odd, b[1], {{b[3], &powers[0]}}); // b_1 I + b_3 A^2
+                combine(v, b[0], {{b[2], &powers[0]}});   // b_0 I + b_2 A^2
+                break;
+            case 5:
+                combine(odd, b[1], {{b[3], &powers[0]}, {b[5], &powers[1]}}); // Odd coefficients
+                combine(v, b[0], {{b[2], &powers[0]}, {b[4], &powers[1]}});   // Even coefficients
+                break;
+            case 7:
+                combine(odd, b[1], {{b[3], &powers[0]}, {b[5], &powers[1]}, {b[7], &powers[2]}}); // Odd coefficients
+                combine(v, b[0], {{b[2], &powers[0]}, {b[4], &powers[1]}, {b[6], &powers[2]}});   // Even coefficients
+                break;
+            default:
+                combine(odd, b[1], {{b[3], &powers[0]}, {b[5], &powers[1]}, {b[7], &powers[2]}, {b[9], &powers[3]}}); // Odd coefficients
+                combine(v, b[0], {{b[2], &powers[0]}, {b[4], &powers[1]}, {b[6], &powers[2]}, {b[8], &powers[3]}});   // Even coefficients
+                break;
+            }
+            gemm(1, a, odd, 0, u); // Odd part
+        }
+
+        /**
+         * @brief Odd and even parts of r_13 with six products
+         *
+         * u = A [A^6 (b_13 A^6 + b_11 A^4 + b_9 A^2) + b_7 A^6 + b_5 A^4 + b_3 A^2 + b_1 I]
+         * and v = A^6 (b_12 A^6 + b_10 A^4 + b_8 A^2) + b_6 A^6 + b_4 A^4 + b_2 A^2 + b_0 I.
+         * @param a Matrix A (already scaled)
+         * @param powers A^2, A^4, A^6 (computed here)
+         * @param outer Scratch for the high-order combination
+         * @param u Receives the odd part
+         * @param v Receives the even part
+         * @param odd Scratch for the odd polynomial
+         */
+        void pade13(const SquareMat &a, SquareMat *powers, SquareMat &outer, SquareMat &u, SquareMat &v, SquareMat &odd) // Degree 13
+        {
+            const double *b = Pade13;                          // Coefficients
+            gemm(1, a, a, 0, powers[0]);                       // A^2
+            gemm(1, powers[0], powers[0], 0, powers[1]);       // A^4
+            gemm(1, powers[1], powers[0], 0, powers[2]);       // A^6
+            combine(outer, 0, {{b[13], &powers[2]}, {b[11], &powers[1]}, {b[9], &powers[0]}}); // High odd terms
+            combine(odd, b[1], {{b[7], &powers[2]}, {b[5], &powers[1]}, {b[3], &powers[0]}});  // Low odd terms
+            gemm(1, powers[2], outer, 1, odd);                                                 // Odd polynomial
+            gemm(1, a, odd, 0, u);                                                             // Odd part
+            combine(outer, 0, {{b[12], &powers[2]}, {b[10], &powers[1]}, {b[8], &powers[0]}}); // High even terms
+            combine(v, b[0], {{b[6], &powers[2]}, {b[4], &powers[1]}, {b[2], &powers[0]}});    // Low even terms
+            gemm(1, powers[2], outer, 1, v);                                                   // Even part
+        }
+
+        /**
+         * @brief Solve (v - u) X = v + u for all columns, leaving X in u
+         *
+         * The denominator q_m(A) = v - u is factorized once with partial pivoting and the
+         * columns of the numerator are substituted across the thread pool.
+         * @param u Odd part on entry, r_m(A) on return
+         * @param v Even part (overwritten with the denominator)
+         * @throws std::invalid_argument if the denominator is singular
+         */
+        void solveRational(SquareMat &u, SquareMat &v) // Rational approximant
+        {
+            size_t n = u.getSize(); // Matrix size
+            double *p = u.data();   // Numerator, then the solution
+            double *q = v.data();   // Denominator
+            ThreadPool::instance().parallelFor(0, n, ThreadPool::rowGrain(n), [&](size_t first, size_t last) {
+                for (size_t k = first * n; k < last * n; k++) // Loop through the chunk's elements
+                {
+                    double odd = p[k];   // u_k
+                    p[k] = q[k] + odd;   // p_m(A) = v + u
+                    q[k] = q[k] - odd;   // q_m(A) = v - u
+                }
+            });
+            std::vector<double> lu(q, q + n * n); // Working copy for the factors
+            std::vector<size_t> pivots;           // Row interchanges
+            if (!kernels::luFactorize(lu, pivots, n)) // Factorize the denominator
+            {
+                throw std::invalid_argument("Matrix is singular"); // Throw exception for a singular denominator
+            }
+            ThreadPool::instance().parallelFor(0, n, ThreadPool::rowGrain(n), [&](size_t first, size_t last) {
+                std::vector<double> column(n);        // One right-hand side
+                for (size_t j = first; j < last; j++) // Columns of the chunk
+                {
+                    for (size_t i = 0; i < n; i++) // Gather column j
+                    {
+                        column[i] = p[i * n + j]; // Strided load
+                    }
+                    kernels::luSubstitute(lu, pivots, n, column.data()); // Solve in place
+                    for (size_t i = 0; i < n; i++)                      // Scatter it back
+                    {
+                        p[i * n + j] = column[i]; // Strided store
+                    }
+                }
+            });
+        }
+    } // End of anonymous namespace
+
+    /**
+     * @brief Matrix exponential implementation
+     * @param mat Matrix A (a SquareMat or a view)
+     * @return exp(A); NaN elements if A has a non-finite element
+     */
+    SquareMat expm(const SquareMatView &mat) // Matrix exponential definition
+    {
+        size_t n = mat.getSize();                      // Matrix size
+        SQUAREMAT_STAT_SCOPE(Exponential, n * n, 0);   // Count the call (products count their own flops)
+        SQUAREMAT_TRACE_SCOPE("expm", "operator");     // Timeline event
+        SquareMat a = mat.toSquareMat();               // Working copy (scaled in place)
+        if (a.hasStructure(SquareMat::Diagonal))       // exp of a diagonal matrix is element-wise
+        {
+            double *diagonal = a.data();   // Elements of A (contiguous)
+            for (size_t i = 0; i < n; i++) // Loop through diagonal elements
+            {
+                diagonal[i * n + i] = std::exp(diagonal[i * n + i]); // Scalar exponential
+            }
+            return a; // Still diagonal
+        }
+
+        double norm = 0;               // 1-norm: largest column sum of magnitudes
+        std::vector<double> columns(n); // Column sums
+        for (size_t i = 0; i < n; i++)  // Loop through rows
+        {
+            const double *row = static_cast<const SquareMat &>(a)[i]; // Read without unsharing
+            for (size_t j = 0; j < n; j++)                             // Loop through columns
+            {
+                columns[j] += std::fabs(row[j]); // Accumulate magnitudes
+            }
+        }
+        for (double sum : columns) // Largest column sum
+        {
+            if (!std::isfinite(sum)) // Infinity or NaN in the column
+            {
+                std::fill(a.data(), a.data() + n * n, std::numeric_limits<double>::quiet_NaN()); // No meaningful value
+                return a; // Like std::exp propagating NaN
+            }
+            norm = std::max(norm, sum); // Keep the largest
+        }
+
+        SquareMat powers[] = {SquareMat(n), SquareMat(n), SquareMat(n), SquareMat(n)}; // Even powers of A (A^8 only for degree 9)
+        SquareMat odd(n), u(n), v(n);                                                 // Odd polynomial, odd part, even part
+        const double *low[] = {Pade3, Pade5, Pade7, Pade9};                           // Coefficients below degree 13
+        for (int k = 0; k < 4; k++)                                                   // Cheapest degree that is accurate enough
+        {
+            if (norm <= Theta[k]) // Degree 2k+3 suffices without scaling
+            {
+                padeLow(a, low[k], 2 * k + 3, powers, odd, u, v); // Odd and even parts
+                solveRational(u, v);                              // r_m(A)
+                return u;                                         // exp(A) to double precision
+            }
+        }
+
+        int squarings = std::max(0, static_cast<int>(std::ceil(std::log2(norm / Theta[4])))); // ||A / 2^s|| <= theta_13
+        if (squarings > 0) // Scale into the range of r_13
+        {
+            a *= std::ldexp(1.0, -squarings); // Exact power-of-two scaling
+        }
+        pade13(a, powers, powers[3], u, v, odd); // Odd and even parts
+        solveRational(u, v);                     // r_13(A / 2^s)
+        SquareMat *current = &u, *next = &v;     // Square between two buffers
+        for (int k = 0; k < squarings; k++)      // exp(A) = r_13(A / 2^s)^(2^s)
+        {
+            gemm(1, *current, *current, 0, *next); // Square on the parallel path
+            std::swap(current, next);              // The square becomes current
+        }
+        return std::move(*current); // Hand over the final buffer
+    }
+} // End of the squaremat namespace
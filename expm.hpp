@@ -0,0 +1,23 @@
+// orel8155@gmail.com
+#pragma once             // Ensures the header file is included only once
+#include "squaremat.hpp" // Include for the result type
+#include "matview.hpp"   // Include for the matrix operand (SquareMat converts implicitly)
+
+namespace squaremat // Start of namespace definition
+{
+    /**
+     * @brief Matrix exponential exp(A) by scaling and squaring with Padé approximants
+     *
+     * Follows Higham (2005): the 1-norm of A selects the cheapest diagonal Padé
+     * approximant r_m (m = 3, 5, 7, 9 or 13) whose backward error stays at double
+     * precision, and norms beyond the degree-13 bound are first scaled by 2^-s, with
+     * the result squared s times. r_m = q_m(A)^-1 p_m(A) is evaluated from the even
+     * powers of A only (m = 13 needs A^2, A^4, A^6 and three more products), and the
+     * denominator is solved with one LU factorization for all columns. Every product
+     * goes through the parallel gemm() into buffers that are reused across steps;
+     * diagonal matrices take the element-wise exponential directly.
+     * @param mat Matrix A (a SquareMat or a view)
+     * @return exp(A); NaN elements if A has a non-finite element
+     */
+    SquareMat expm(const SquareMatView &mat); // Declaration of the matrix exponential
+} // End of namespace
@@ -0,0 +1,493 @@
+// orel8155@gmail.com
+#include "factorization.hpp" // Include the header file for Factorization
+#include "kernels.hpp"       // Include for the AXPY, dot and LU kernels
+#include "threadpool.hpp"    // Include for the parallel trailing updates and inverse columns
+#include <algorithm>         // Include for std::fill and std::max
+#include <cmath>             // Include for std::sqrt, std::frexp, std::log and std::exp
+#include <stdexcept>         // Include for standard exceptions
+
+namespace squaremat // Start of the squaremat namespace
+{
+    namespace // Helpers private to this file
+    {
+        /**
+         * @brief Multiply |value| into a product kept as mantissa and binary exponent
+         * @param value Factor (non-zero, finite)
+         * @param mantissa Running mantissa in [0.5, 1)
+         * @param exponent Running binary exponent
+         */
+        void accumulate(double value, double &mantissa, long &exponent) // Overflow-free product step
+        {
+            int shift = 0;                                    // Exponent of the factor or product
+            mantissa *= std::frexp(std::fabs(value), &shift); // Multiply the mantissas
+            exponent += shift;                                // Add the exponents
+            mantissa = std::frexp(mantissa, &shift);          // Renormalize to [0.5, 1)
+            exponent += shift;                                // Keep the exponent in step
+        }
+
+        /**
+         * @brief Solve U^T U x = b with the Cholesky factor
+         * @param u Upper factor (row-major, upper triangle)
+         * @param n Matrix size
+         * @param x Right-hand side on entry, solution on exit
+         */
+        void choleskySubstitute(const std::vector<double> &u, size_t n, double *x) // Triangular solves
+        {
+            for (size_t k = 0; k < n; k++) // Forward substitution with U^T, column by column
+            {
+                const double *row = u.data() + k * n;                   // Row k of U is column k of U^T
+                x[k] /= row[k];                                         // Solve for unknown k
+                kernels::axpy(-x[k], row + k + 1, x + k + 1, n - k - 1); // Eliminate it from the rest
+            }
+            for (size_t i = n; i-- > 0;) // Back substitution with U
+            {
+                const double *row = u.data() + i * n;                                  // Row of U
+                x[i] = (x[i] - kernels::dot(row + i + 1, x + i + 1, n - i - 1)) / row[i]; // Known unknowns to the right
+            }
+        }
+
+        /**
+         * @brief Log-determinant from LU factors
+         * @param lu Factors from kernels::luFactorize()
+         * @param pivots Interchanges from kernels::luFactorize()
+         * @param n Matrix size
+         * @return sign and log |det A|
+         */
+        LogDeterminant luLogDeterminant(const std::vector<double> &lu, const std::vector<size_t> &pivots, size_t n) // Pivot product
+        {
+            double mantissa = 1;           // Product of the pivots, mantissa
+            long exponent = 0;             // Product of the pivots, binary exponent
+            int sign = 1;                  // Sign of the product
+            for (size_t k = 0; k < n; k++) // Diagonal of U and the interchanges
+            {
+                double pivot = lu[k * n + k];          // Pivot of step k
+                sign = pivot < 0 ? -sign : sign;       // Negative pivots flip the sign
+                sign = pivots[k] != k ? -sign : sign;  // So does every interchange
+                accumulate(pivot, mantissa, exponent); // Magnitude
+            }
+            return {std::log(mantissa) + exponent * std::log(2.0), sign}; // log |prod| = log m + e log 2
+        }
+
+        /**
+         * @brief Inverse column by column, with the columns split across the thread pool
+         * @param n Matrix size
+         * @param out Row-major n x n output
+         * @param substitute Callable substitute(x) replacing b by A^-1 b in place
+         */
+        template <typename Substitute>
+        void invertColumns(size_t n, double *out, Substitute substitute) // Inverse from factors
+        {
+            ThreadPool::instance().parallelFor(0, n, ThreadPool::rowGrain(n * n), [&](size_t first, size_t last) {
+                std::vector<double> column(n);        // Unit vector, then column of the inverse
+                for (size_t j = first; j < last; j++) // Columns of the chunk
+                {
+                    std::fill(column.begin(), column.end(), 0.0); // Clear
+                    column[j] = 1;                                // e_j
+                    substitute(column.data());                    // A^-1 e_j
+                    for (size_t i = 0; i < n; i++)                // Scatter into column j
+                    {
+                        out[i * n + j] = column[i]; // Strided store
+                    }
+                }
+            });
+        }
+    } // End of anonymous namespace
+
+    /**
+     * @brief Constructor implementation
+     * @param mat Matrix A (a SquareMat or a view)
+     */
+    Factorization::Factorization(const SquareMatView &mat)
+        : mat(mat.toSquareMat()), symmetric(true), choleskyTried(false), choleskyValid(false), luTried(false), luValid(false) // Constructor definition
+    {
+        size_t n = mat.getSize();                   // Matrix size
+        for (size_t i = 0; i < n && symmetric; i++) // Loop through rows
+        {
+            for (size_t j = i + 1; j < n; j++) // Loop through the upper triangle
+            {
+                if (mat[i][j] != mat[j][i]) // Mirror element differs
+                {
+                    symmetric = false; // Cholesky does not apply
+                    break;             // No need to look further
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Lazy Cholesky factorization implementation
+     *
+     * Right-looking on the upper triangle: step k scales row k by 1 / sqrt(a_kk) and
+     * subtracts its outer product from the trailing rows, which are split across the
+     * thread pool like the LU's.
+     * @return true if A is symmetric positive definite
+     */
+    bool Factorization::ensureCholesky() // Lazy Cholesky definition
+    {
+        if (choleskyTried || !symmetric) // Already decided
+        {
+            return choleskyValid; // Cached answer
+        }
+        choleskyTried = true;                                            // Attempt only once
+        size_t n = mat.getSize();                                        // Matrix size
+        SQUAREMAT_STAT_SCOPE(Factorize, n * n, uint64_t(n) * n * n / 3); // Count the factorization
+        SQUAREMAT_TRACE_SCOPE("cholesky", "phase");                      // Timeline event
+        const SquareMat &source = mat;                                   // Read without unsharing
+        std::vector<double> u(source[0], source[0] + n * n);             // Working copy (storage is contiguous)
+        for (size_t k = 0; k < n; k++)                                   // Elimination steps
+        {
+            double *top = u.data() + k * n; // Row k becomes row k of U
+            double pivot = top[k];          // Remaining diagonal element
+            if (!(pivot > 0) || !std::isfinite(pivot)) // Not positive definite (or not finite)
+            {
+                return false; // Fall back to LU
+            }
+            pivot = std::sqrt(pivot);          // Diagonal of U
+            top[k] = pivot;                    // Store it
+            for (size_t j = k + 1; j < n; j++) // Rest of the row
+            {
+                top[j] /= pivot; // Off-diagonal of U
+            }
+            ThreadPool::instance().parallelFor(k + 1, n, ThreadPool::rowGrain(std::max<size_t>(n - k - 1, 1)), [&](size_t first, size_t last) {
+                for (size_t i = first; i < last; i++) // Trailing rows of the chunk
+                {
+                    double factor = top[i]; // u_ki
+                    if (factor != 0)        // Rows without coupling stay unchanged
+                    {
+                        kernels::axpy(-factor, top + i, u.data() + i * n + i, n - i); // a_ij -= u_ki u_kj for j >= i
+                    }
+                }
+            });
+        }
+        cholesky.swap(u);     // Keep the factor
+        choleskyValid = true; // A is positive definite
+        return true;          // Factorization succeeded
+    }
+
+    /**
+     * @brief Lazy LU factorization implementation
+     * @return true if A is non-singular
+     */
+    bool Factorization::ensureLU() // Lazy LU definition
+    {
+        if (luTried) // Already decided
+        {
+            return luValid; // Cached answer
+        }
+        luTried = true;                                // Attempt only once
+        size_t n = mat.getSize();                      // Matrix size
+        SQUAREMAT_TRACE_SCOPE("lu", "phase");          // Timeline event
+        const SquareMat &source = mat;                 // Read without unsharing
+        lu.assign(source[0], source[0] + n * n);       // Working copy (storage is contiguous)
+        luValid = kernels::luFactorize(lu, pivots, n); // Eliminate
+        if (!luValid)                                  // Zero pivot
+        {
+            lu.clear();     // Release the partial factors
+            pivots.clear(); // And their interchanges
+        }
+        return luValid; // Factorization result
+    }
+
+    /**
+     * @brief Definiteness check implementation
+     * @return true if A is symmetric and its Cholesky factorization succeeds
+     */
+    bool Factorization::isPositiveDefinite() // Definiteness check definition
+    {
+        return ensureCholesky(); // Decided by the factorization
+    }
+
+    /**
+     * @brief Log-determinant implementation
+     * @return sign and log |det A|; sign 0 and logAbs -infinity if A is singular
+     */
+    LogDeterminant Factorization::logDeterminant() // Log-determinant definition
+    {
+        size_t n = mat.getSize(); // Matrix size
+        if (ensureCholesky())     // det A = prod(u_kk)^2
+        {
+            double mantissa = 1;           // Product of the pivots, mantissa
+            long exponent = 0;             // Product of the pivots, binary exponent
+            for (size_t k = 0; k < n; k++) // Diagonal of U
+            {
+                accumulate(cholesky[k * n + k], mantissa, exponent); // Positive pivots
+            }
+            return {2 * (std::log(mantissa) + exponent * std::log(2.0)), 1}; // Square of the product
+        }
+        if (!ensureLU()) // Zero pivot
+        {
+            return {-HUGE_VAL, 0}; // Singular
+        }
+        return luLogDeterminant(lu, pivots, n); // Pivots and interchanges
+    }
+
+    /**
+     * @brief Determinant implementation
+     * @return sign * exp(logAbs)
+     */
+    double Factorization::determinant() // Determinant definition
+    {
+        LogDeterminant result = logDeterminant();     // Shared factors
+        return result.sign * std::exp(result.logAbs); // 0 when singular (exp(-inf) = 0)
+    }
+
+    /**
+     * @brief Solve implementation
+     * @param rhs Right-hand side b
+     * @return Solution x
+     * @throws std::invalid_argument if the sizes don't match or the matrix is singular
+     */
+    Vector Factorization::solve(const Vector &rhs) // Solve definition
+    {
+        size_t n = mat.getSize(); // Matrix size
+        if (rhs.getSize() != n)   // Check if sizes are compatible
+        {
+            throw std::invalid_argument("Vector size must match matrix size"); // Throw exception if sizes don't match
+        }
+        Vector x(rhs);        // Start from the right-hand side
+        if (ensureCholesky()) // Half the work of LU
+        {
+            choleskySubstitute(cholesky, n, x.values()); // Solve in place
+            return x;                                     // Return the solution
+        }
+        if (!ensureLU()) // Zero pivot
+        {
+            throw std::invalid_argument("Matrix is singular"); // Throw exception for a singular matrix
+        }
+        kernels::luSubstitute(lu, pivots, n, x.values()); // Solve in place
+        return x;                                          // Return the solution
+    }
+
+    /**
+     * @brief Inverse implementation
+     * @return A^-1
+     * @throws std::invalid_argument if the matrix is singular
+     */
+    SquareMat Factorization::inverse() // Inverse definition
+    {
+        size_t n = mat.getSize();    // Matrix size
+        bool spd = ensureCholesky(); // Preferred factors
+        if (!spd && !ensureLU())     // Zero pivot
+        {
+            throw std::invalid_argument("Matrix is singular"); // Throw exception for a singular matrix
+        }
+        SquareMat result(n); // Inverse
+        if (spd)             // Cholesky factors
+        {
+            invertColumns(n, result.data(), [&](double *x) { choleskySubstitute(cholesky, n, x); }); // Columns of U^-1 U^-T
+        }
+        else // LU factors
+        {
+            invertColumns(n, result.data(), [&](double *x) { kernels::luSubstitute(lu, pivots, n, x); }); // Columns of U^-1 L^-1 P
+        }
+        return result; // Return the inverse
+    }
+
+    /**
+     * @brief Constructor implementation
+     * @param mat Matrix A (a SquareMat or a view)
+     * @param policy When to refactor
+     */
+    RankOneUpdater::RankOneUpdater(const SquareMatView &mat, const RefactorPolicy &policy)
+        : mat(mat.toSquareMat()), inv(mat.getSize()), logDet{-HUGE_VAL, 0}, policy(policy), sinceRefactor(0), refactors(0), singular(true) // Constructor definition
+    {
+        refactor(); // Initial factors
+    }
+
+    /**
+     * @brief Refactorization implementation
+     */
+    void RankOneUpdater::refactor() // Refactorization definition
+    {
+        size_t n = mat.getSize();                   // Matrix size
+        SQUAREMAT_TRACE_SCOPE("refactor", "phase"); // Timeline event
+        const SquareMat &source = mat;              // Read without unsharing
+        lu.assign(source[0], source[0] + n * n);    // Working copy (storage is contiguous)
+        sinceRefactor = 0;                          // Fresh factors
+        refactors++;                                // Count the O(n^3) work
+        singular = !kernels::luFactorize(lu, pivots, n); // Eliminate
+        if (singular)                                    // Zero pivot
+        {
+            logDet = {-HUGE_VAL, 0}; // Determinant is zero
+            return;                  // No inverse
+        }
+        logDet = luLogDeterminant(lu, pivots, n);                                              // Pivots and interchanges
+        invertColumns(n, inv.data(), [&](double *x) { kernels::luSubstitute(lu, pivots, n, x); }); // Columns of A^-1
+    }
+
+    /**
+     * @brief LU update implementation (Bennett, 1965)
+     *
+     * With L U + x y^T split as [1 0; l L2] [p r^T; 0 U2] + [x1; x2] [y1 y2^T], the
+     * new pivot is p + x1 y1, the new row r + x1 y2, the new column (p l + y1 x2) / pivot,
+     * and the trailing factors take the rank-1 update (x2 - x1 l) (y2 - y1 / pivot * row)^T.
+     * @param u Column vector of the update
+     * @param v Row vector of the update
+     * @return false if a pivot broke down
+     */
+    bool RankOneUpdater::updateFactors(const Vector &u, const Vector &v) // LU update definition
+    {
+        size_t n = mat.getSize();              // Matrix size
+        Vector x(u), y(v);                     // Working copies, consumed by the sweep
+        for (size_t k = 0; k < n; k++)         // Apply the interchanges: x = P u
+        {
+            std::swap(x[k], x[pivots[k]]); // Same swap as the rows
+        }
+        for (size_t j = 0; j < n; j++) // Sweep down the diagonal
+        {
+            double *row = lu.data() + j * n;        // Row j of U (and L to its left)
+            double old = row[j];                    // Old pivot
+            double term = x[j] * y[j];              // Update of the pivot
+            double pivot = old + term;              // New pivot
+            if (!(std::fabs(pivot) > policy.breakdown * (std::fabs(old) + std::fabs(term)))) // Cancelled (or not finite)
+            {
+                return false; // Refactor with fresh pivoting
+            }
+            row[j] = pivot;                // Store it
+            double xj = x[j], yj = y[j];   // Multipliers of this step
+            for (size_t i = j + 1; i < n; i++) // Column j of L
+            {
+                double l = lu[i * n + j];               // Old multiplier
+                lu[i * n + j] = (l * old + x[i] * yj) / pivot; // New multiplier
+                x[i] -= xj * l;                         // Trailing column vector
+            }
+            double scale = yj / pivot;              // Trailing row factor
+            for (size_t k = j + 1; k < n; k++)      // Row j of U
+            {
+                row[k] += xj * y[k];    // New row of U
+                y[k] -= scale * row[k]; // Trailing row vector
+            }
+        }
+        return true; // Factors updated
+    }
+
+    /**
+     * @brief Rank-1 update implementation
+     * @param u Column vector
+     * @param v Row vector
+     * @throws std::invalid_argument if a vector size doesn't match the matrix
+     */
+    void RankOneUpdater::update(const Vector &u, const Vector &v) // Rank-1 update definition
+    {
+        size_t n = mat.getSize();                   // Matrix size
+        if (u.getSize() != n || v.getSize() != n)   // Check if sizes are compatible
+        {
+            throw std::invalid_argument("Vector size must match matrix size"); // Throw exception if sizes don't match
+        }
+        double *a = mat.data(); // Elements of A (contiguous)
+        ThreadPool::instance().parallelFor(0, n, ThreadPool::rowGrain(n), [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; i++) // Rows of the chunk
+            {
+                kernels::axpy(u[i], v.values(), a + i * n, n); // A += u v^T
+            }
+        });
+        sinceRefactor++;                                                // One more update on these factors
+        if (singular || (policy.interval > 0 && sinceRefactor >= policy.interval)) // Singular before, or due
+        {
+            refactor(); // Recompute everything
+            return;     // Done
+        }
+
+        Vector w = inv * u;                      // A^-1 u
+        Vector z = transposeMultiply(inv, v);    // A^-T v
+        double denominator = 1 + dot(v, w);      // Determinant lemma factor
+        double magnitude = 1;                    // Sum of the magnitudes of its terms
+        for (size_t i = 0; i < n; i++)           // Loop through the terms
+        {
+            magnitude += std::fabs(v[i] * w[i]); // |v_i w_i|
+        }
+        if (!(std::fabs(denominator) > policy.breakdown * magnitude)) // New matrix (nearly) singular
+        {
+            refactor(); // Sherman-Morrison would divide by noise
+            return;     // Done
+        }
+
+        double *out = inv.data(); // Elements of A^-1 (contiguous)
+        ThreadPool::instance().parallelFor(0, n, ThreadPool::rowGrain(n), [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; i++) // Rows of the chunk
+            {
+                kernels::axpy(-w[i] / denominator, z.values(), out + i * n, n); // A^-1 -= w z^T / (1 + v^T w)
+            }
+        });
+        logDet.logAbs += std::log(std::fabs(denominator)); // det(A + u v^T) = det A (1 + v^T A^-1 u)
+        logDet.sign = denominator < 0 ? -logDet.sign : logDet.sign; // Sign of the factor
+        if (!updateFactors(u, v))                                     // Bennett broke down
+        {
+            refactor(); // Fresh pivoting
+            return;     // Done
+        }
+
+        if (policy.tolerance > 0) // Probe one column of the inverse and of the LU solve for drift
+        {
+            size_t j = (refactors + sinceRefactor) % n; // Different column each update
+            auto drift = [&](const Vector &column) {    // Largest element of A column - e_j
+                Vector residual = mat * column;         // Should be e_j
+                residual[j] -= 1;                       // Subtract e_j
+                double largest = 0;                     // Infinity norm
+                for (size_t i = 0; i < n; i++)          // Loop through the residual
+                {
+                    largest = std::max(largest, std::fabs(residual[i])); // Largest so far
+                }
+                return largest; // Return the norm
+            };
+            Vector column(n);              // Column j of A^-1
+            for (size_t i = 0; i < n; i++) // Gather it
+            {
+                column[i] = out[i * n + j]; // Strided load
+            }
+            Vector solved(n);                                      // A^-1 e_j through the updated LU, as solve() computes it
+            solved[j] = 1;                                         // e_j
+            kernels::luSubstitute(lu, pivots, n, solved.values()); // Bennett's factors may drift apart from the inverse
+            if (!(drift(column) <= policy.tolerance && drift(solved) <= policy.tolerance)) // Either drifted too far (or not finite)
+            {
+                refactor(); // Recompute from A
+            }
+        }
+    }
+
+    /**
+     * @brief Inverse getter implementation
+     * @return A^-1
+     * @throws std::invalid_argument if the matrix is singular
+     */
+    const SquareMat &RankOneUpdater::inverse() const // Inverse getter definition
+    {
+        if (singular) // No inverse
+        {
+            throw std::invalid_argument("Matrix is singular"); // Throw exception for a singular matrix
+        }
+        return inv; // Maintained inverse
+    }
+
+    /**
+     * @brief Solve implementation
+     * @param rhs Right-hand side b
+     * @return Solution x
+     * @throws std::invalid_argument if the sizes don't match or the matrix is singular
+     */
+    Vector RankOneUpdater::solve(const Vector &rhs) const // Solve definition
+    {
+        size_t n = mat.getSize(); // Matrix size
+        if (rhs.getSize() != n)   // Check if sizes are compatible
+        {
+            throw std::invalid_argument("Vector size must match matrix size"); // Throw exception if sizes don't match
+        }
+        if (singular) // No factors
+        {
+            throw std::invalid_argument("Matrix is singular"); // Throw exception for a singular matrix
+        }
+        Vector x(rhs);                                     // Start from the right-hand side
+        kernels::luSubstitute(lu, pivots, n, x.values()); // Solve in place
+        return x;                                          // Return the solution
+    }
+
+    /**
+     * @brief Free log-determinant implementation
+     * @param mat Matrix A (a SquareMat or a view)
+     * @return sign and log |det A|; sign 0 and logAbs -infinity if A is singular
+     */
+    LogDeterminant logDeterminant(const SquareMatView &mat) // Free log-determinant definition
+    {
+        return Factorization(mat).logDeterminant(); // One-off factors
+    }
+} // End of the squaremat namespace
@@ -0,0 +1,246 @@
+// orel8155@gmail.com
+#pragma once             // Ensures the header file is included only once
+#include <cmath>         // Include for std::exp
+#include <cstddef>       // Include for size_t
+#include <vector>        // Include for factor storage
+#include "squaremat.hpp" // Include for the factored matrix and the inverse
+#include "matvec.hpp"    // Include for right-hand sides and solutions
+#include "matview.hpp"   // Include for the matrix operand (SquareMat converts implicitly)
+
+namespace squaremat // Start of namespace definition
+{
+    /**
+     * @brief Determinant as sign and logarithm of the magnitude
+     *
+     * det A = sign * exp(logAbs), which stays representable when det A itself
+     * overflows or underflows double (n in the hundreds).
+     */
+    struct LogDeterminant // Structure definition for the log-determinant
+    {
+        double logAbs; ///< log |det A| (-infinity when singular)
+        int sign;      ///< -1, 0 (singular) or 1
+    };
+
+    /**
+     * @class Factorization
+     * @brief Cached Cholesky and LU factors of one matrix, shared by determinant, solve and inverse
+     *
+     * Factors are computed on first use and kept: a symmetric matrix is first tried
+     * with Cholesky (A = U^T U, n^3/3 flops), which also decides positive definiteness;
+     * any other matrix, or a symmetric one that is not positive definite, gets an LU
+     * factorization with partial pivoting (2n^3/3 flops). Every later query reuses the
+     * factors, so logDeterminant(), solve() and inverse() on the same object pay for
+     * one factorization in total.
+     */
+    class Factorization // Class definition for the cached factorization
+    {
+    private:
+        SquareMat mat;                   ///< Factored matrix A
+        bool symmetric;                  ///< A equals its transpose exactly
+        bool choleskyTried;              ///< Cholesky was attempted
+        bool choleskyValid;              ///< A is positive definite and cholesky holds U
+        std::vector<double> cholesky;    ///< Upper factor U with A = U^T U (row-major, upper triangle)
+        bool luTried;                    ///< LU was attempted
+        bool luValid;                    ///< A is non-singular and lu holds the factors
+        std::vector<double> lu;          ///< Unit-lower L and U with P A = L U (row-major)
+        std::vector<size_t> pivots;      ///< Row interchanged with row k at step k of the LU
+
+        /**
+         * @brief Compute the Cholesky factor on first use
+         * @return true if A is symmetric positive definite
+         */
+        bool ensureCholesky(); // Declaration of the lazy Cholesky factorization
+
+        /**
+         * @brief Compute the LU factors on first use
+         * @return true if A is non-singular
+         */
+        bool ensureLU(); // Declaration of the lazy LU factorization
+
+    public:
+        /**
+         * @brief Constructor that copies the matrix; no factorization happens yet
+         * @param mat Matrix A (a SquareMat or a view)
+         */
+        explicit Factorization(const SquareMatView &mat); // Declaration of constructor
+
+        /**
+         * @brief Get the size of the factored matrix
+         * @return Size of A
+         */
+        size_t getSize() const { return mat.getSize(); } // Getter method for the matrix size
+
+        /**
+         * @brief Check for a symmetric positive definite matrix (computes the Cholesky factor)
+         * @return true if A is symmetric and its Cholesky factorization succeeds
+         */
+        bool isPositiveDefinite(); // Declaration of the definiteness check
+
+        /**
+         * @brief Log-determinant with sign, from the Cholesky factor if A is SPD and the LU otherwise
+         *
+         * The pivots are multiplied as mantissa and binary exponent, so the result needs
+         * one log call and cannot overflow for any n.
+         * @return sign and log |det A|; sign 0 and logAbs -infinity if A is singular
+         */
+        LogDeterminant logDeterminant(); // Declaration of the log-determinant
+
+        /**
+         * @brief Determinant from the cached factors
+         * @return sign * exp(logAbs), which overflows to infinity or underflows to 0 like the product would
+         */
+        double determinant(); // Declaration of the determinant
+
+        /**
+         * @brief Solve A x = b with the cached factors
+         * @param rhs Right-hand side b
+         * @return Solution x
+         * @throws std::invalid_argument if the sizes don't match or the matrix is singular
+         */
+        Vector solve(const Vector &rhs); // Declaration of the solve
+
+        /**
+         * @brief Inverse from the cached factors, one column per solve across the thread pool
+         * @return A^-1
+         * @throws std::invalid_argument if the matrix is singular
+         */
+        SquareMat inverse(); // Declaration of the inverse
+    };
+
+    /**
+     * @brief When a RankOneUpdater recomputes its factors from scratch
+     */
+    struct RefactorPolicy // Structure definition for the refactoring policy
+    {
+        size_t interval = 64;    ///< Refactor after this many updates (0: only on breakdown or drift)
+        double tolerance = 1e-9; ///< Refactor when the probed residual ||A x - e_j|| of the inverse column or the LU solve exceeds this (0: no probe)
+        double breakdown = 1e-8; ///< Refactor when 1 + v^T A^-1 u or an updated LU pivot loses all but this fraction of its terms
+    };
+
+    /**
+     * @class RankOneUpdater
+     * @brief A matrix with its LU factors, inverse and log-determinant, kept current under A += u v^T
+     *
+     * Each update costs O(n^2): the matrix determinant lemma
+     * det(A + u v^T) = det A (1 + v^T A^-1 u) updates the log-determinant, the
+     * Sherman-Morrison formula updates the inverse, and Bennett's algorithm updates
+     * the LU factors in place (with P (A + u v^T) = L U + (P u) v^T, keeping the pivots).
+     * Rounding errors accumulate, so the factors are recomputed from the updated matrix
+     * (O(n^3)) according to a RefactorPolicy: every interval updates, when the residual
+     * of one column of the inverse or of the same column solved through the LU factors
+     * (a different column each update) exceeds the tolerance, and whenever an update would divide by a value that cancelled down to
+     * the breakdown fraction of its terms (A close to singular).
+     */
+    class RankOneUpdater // Class definition for the rank-1 updater
+    {
+    private:
+        SquareMat mat;              ///< Current matrix A
+        SquareMat inv;              ///< A^-1 (stale while singular)
+        std::vector<double> lu;     ///< Unit-lower L and U with P A = L U (row-major)
+        std::vector<size_t> pivots; ///< Row interchanged with row k at step k of the last refactor
+        LogDeterminant logDet;      ///< sign and log |det A|
+        RefactorPolicy policy;      ///< When to refactor
+        size_t sinceRefactor;       ///< Updates applied to the current factors
+        size_t refactors;           ///< Refactorizations so far (including the initial one)
+        bool singular;              ///< The last refactor found a zero pivot
+
+        /**
+         * @brief Bennett's update of the LU factors with (P u) v^T
+         * @param u Column vector of the update
+         * @param v Row vector of the update
+         * @return false if a pivot broke down (the factors are then partially updated)
+         */
+        bool updateFactors(const Vector &u, const Vector &v); // Declaration of the LU update
+
+    public:
+        /**
+         * @brief Constructor that factorizes A
+         * @param mat Matrix A (a SquareMat or a view)
+         * @param policy When to refactor
+         */
+        explicit RankOneUpdater(const SquareMatView &mat, const RefactorPolicy &policy = RefactorPolicy()); // Declaration of constructor
+
+        /**
+         * @brief Apply A += u v^T and update the factors, inverse and determinant
+         * @param u Column vector
+         * @param v Row vector
+         * @throws std::invalid_argument if a vector size doesn't match the matrix
+         */
+        void update(const Vector &u, const Vector &v); // Declaration of the rank-1 update
+
+        /**
+         * @brief Recompute the LU factors, inverse and determinant from the current matrix (O(n^3))
+         */
+        void refactor(); // Declaration of the refactorization
+
+        /**
+         * @brief Get the current matrix
+         * @return A with every update applied
+         */
+        const SquareMat &matrix() const { return mat; } // Getter method for the matrix
+
+        /**
+         * @brief Get the maintained inverse
+         * @return A^-1
+         * @throws std::invalid_argument if the matrix is singular
+         */
+        const SquareMat &inverse() const; // Declaration of the inverse getter
+
+        /**
+         * @brief Get the maintained log-determinant
+         * @return sign and log |det A|; sign 0 and logAbs -infinity if A is singular
+         */
+        LogDeterminant logDeterminant() const { return logDet; } // Getter method for the log-determinant
+
+        /**
+         * @brief Get the maintained determinant
+         * @return sign * exp(logAbs)
+         */
+        double determinant() const { return logDet.sign * std::exp(logDet.logAbs); } // Determinant from its logarithm
+
+        /**
+         * @brief Solve A x = b with the maintained LU factors (O(n^2))
+         * @param rhs Right-hand side b
+         * @return Solution x
+         * @throws std::invalid_argument if the sizes don't match or the matrix is singular
+         */
+        Vector solve(const Vector &rhs) const; // Declaration of the solve
+
+        /**
+         * @brief Check for a singular matrix
+         * @return true if the last refactor found a zero pivot
+         */
+        bool isSingular() const { return singular; } // Getter method for the singular flag
+
+        /**
+         * @brief Number of refactorizations, including the one in the constructor
+         * @return Refactorization count
+         */
+        size_t getRefactorCount() const { return refactors; } // Getter method for the refactor count
+
+        /**
+         * @brief Number of O(n^2) updates applied since the last refactorization
+         * @return Update count
+         */
+        size_t getUpdatesSinceRefactor() const { return sinceRefactor; } // Getter method for the update count
+
+        /**
+         * @brief Get the refactoring policy
+         * @return Current policy
+         */
+        const RefactorPolicy &getPolicy() const { return policy; } // Getter method for the policy
+
+        /**
+         * @brief Replace the refactoring policy (takes effect at the next update)
+         * @param policy New policy
+         */
+        void setPolicy(const RefactorPolicy &policy) { this->policy = policy; } // Setter method for the policy
+    };
+
+    /**
+     * @brief Log-determinant with sign of a matrix (one-off Factorization)
+     * @param mat Matrix A (a SquareMat or a view)
+     * @return sign and log |det A|; sign 0 and logAbs -infinity if A is singular
+     */
+    LogDeterminant logDeterminant(const SquareMatView &mat); // Declaration of the free log-determinant
+} // End of namespace
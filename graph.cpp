@@ -0,0 +1,348 @@
+// orel8155@gmail.com
+#include "graph.hpp"      // Include the header file for the task graph
+#include "threadpool.hpp" // Include for spawning node tasks
+#include <chrono>         // Include for the helping wait
+#include <condition_variable> // Include for the completion wait
+#include <exception>      // Include for std::exception_ptr
+#include <mutex>          // Include for the run bookkeeping
+#include <stdexcept>      // Include for standard exceptions
+
+namespace squaremat // Start of the squaremat namespace
+{
+    /**
+     * @brief Bookkeeping of one run, alive until run() returns
+     */
+    struct TaskGraph::Run
+    {
+        std::atomic<size_t> remaining{0}; ///< Vertices still to finish
+        std::exception_ptr failure;       ///< First exception thrown by a vertex
+        std::mutex mutex;                 ///< Protects failure and the completion wait
+        std::condition_variable finished; ///< Signals the last vertex
+    };
+
+    /**
+     * @brief Value access implementation
+     * @return Reference to the value
+     */
+    const SquareMat &TaskGraph::Node::get() const // Value access definition
+    {
+        const SquareMat *value = graph->vertices[id]->current(); // Current value
+        if (!value)                                              // Never computed, or freed
+        {
+            throw std::logic_error("Node has no value"); // Usage error
+        }
+        return *value; // Return the value
+    }
+
+    /**
+     * @brief Value check implementation
+     * @return true for inputs and for outputs of a finished run()
+     */
+    bool TaskGraph::Node::hasValue() const // Value check definition
+    {
+        return graph->vertices[id]->current() != nullptr; // Any value present
+    }
+
+    /**
+     * @brief Lazy addition implementation
+     * @param other Right operand
+     * @return New node
+     */
+    TaskGraph::Node TaskGraph::Node::operator+(const Node &other) const // Lazy addition definition
+    {
+        return graph->add([](const std::vector<const SquareMat *> &in) { return *in[0] + *in[1]; }, {*this, other}); // Record a + b
+    }
+
+    /**
+     * @brief Lazy subtraction implementation
+     * @param other Right operand
+     * @return New node
+     */
+    TaskGraph::Node TaskGraph::Node::operator-(const Node &other) const // Lazy subtraction definition
+    {
+        return graph->add([](const std::vector<const SquareMat *> &in) { return *in[0] - *in[1]; }, {*this, other}); // Record a - b
+    }
+
+    /**
+     * @brief Lazy negation implementation
+     * @return New node
+     */
+    TaskGraph::Node TaskGraph::Node::operator-() const // Lazy negation definition
+    {
+        return graph->add([](const std::vector<const SquareMat *> &in) { return -*in[0]; }, {*this}); // Record -a
+    }
+
+    /**
+     * @brief Lazy multiplication implementation
+     * @param other Right operand
+     * @return New node
+     */
+    TaskGraph::Node TaskGraph::Node::operator*(const Node &other) const // Lazy multiplication definition
+    {
+        return graph->add([](const std::vector<const SquareMat *> &in) { return *in[0] * *in[1]; }, {*this, other}); // Record a * b
+    }
+
+    /**
+     * @brief Lazy scalar multiplication implementation
+     * @param scalar Factor
+     * @return New node
+     */
+    TaskGraph::Node TaskGraph::Node::operator*(double scalar) const // Lazy scalar multiplication definition
+    {
+        return graph->add([scalar](const std::vector<const SquareMat *> &in) { return *in[0] * scalar; }, {*this}); // Record a * s
+    }
+
+    /**
+     * @brief Lazy element-wise multiplication implementation
+     * @param other Right operand
+     * @return New node
+     */
+    TaskGraph::Node TaskGraph::Node::operator%(const Node &other) const // Lazy element-wise multiplication definition
+    {
+        return graph->add([](const std::vector<const SquareMat *> &in) { return *in[0] % *in[1]; }, {*this, other}); // Record a % b
+    }
+
+    /**
+     * @brief Lazy modulo implementation
+     * @param modulus Integer modulus
+     * @return New node
+     */
+    TaskGraph::Node TaskGraph::Node::operator%(int modulus) const // Lazy modulo definition
+    {
+        return graph->add([modulus](const std::vector<const SquareMat *> &in) { return *in[0] % modulus; }, {*this}); // Record a % m
+    }
+
+    /**
+     * @brief Lazy division implementation
+     * @param scalar Divisor
+     * @return New node
+     */
+    TaskGraph::Node TaskGraph::Node::operator/(double scalar) const // Lazy division definition
+    {
+        return graph->add([scalar](const std::vector<const SquareMat *> &in) { return *in[0] / scalar; }, {*this}); // Record a / s
+    }
+
+    /**
+     * @brief Lazy transpose implementation
+     * @return New node
+     */
+    TaskGraph::Node TaskGraph::Node::operator~() const // Lazy transpose definition
+    {
+        return graph->add([](const std::vector<const SquareMat *> &in) { return ~*in[0]; }, {*this}); // Record ~a
+    }
+
+    /**
+     * @brief Lazy power implementation
+     * @param power Non-negative exponent
+     * @return New node
+     */
+    TaskGraph::Node TaskGraph::Node::operator^(int power) const // Lazy power definition
+    {
+        return graph->add([power](const std::vector<const SquareMat *> &in) { return *in[0] ^ power; }, {*this}); // Record a ^ p
+    }
+
+    /**
+     * @brief Borrowed input implementation
+     * @param mat Matrix that must stay alive and unchanged until the last run()
+     * @return Node of the matrix
+     */
+    TaskGraph::Node TaskGraph::input(const SquareMat &mat) // Borrowed input definition
+    {
+        vertices.push_back(std::make_unique<Vertex>()); // New vertex
+        vertices.back()->borrowed = &mat;              // Refer to the caller's matrix
+        return Node(this, vertices.size() - 1);        // Return its handle
+    }
+
+    /**
+     * @brief Owned input implementation
+     * @param mat Matrix to move into the graph
+     * @return Node of the matrix
+     */
+    TaskGraph::Node TaskGraph::input(SquareMat &&mat) // Owned input definition
+    {
+        vertices.push_back(std::make_unique<Vertex>()); // New vertex
+        vertices.back()->value.emplace(std::move(mat)); // Take the matrix over
+        vertices.back()->keep = true;                   // Inputs are never freed
+        return Node(this, vertices.size() - 1);         // Return its handle
+    }
+
+    /**
+     * @brief Generic node implementation
+     * @param operation Callable receiving the input values in order
+     * @param inputs Nodes of the same graph the operation reads
+     * @return New node
+     */
+    TaskGraph::Node TaskGraph::apply(Operation operation, const std::vector<Node> &inputs) // Generic node definition
+    {
+        return add(std::move(operation), inputs); // Same path as the operators
+    }
+
+    /**
+     * @brief Vertex creation implementation
+     * @param operation Work of the node
+     * @param inputs Nodes the operation reads
+     * @return Handle of the new node
+     */
+    TaskGraph::Node TaskGraph::add(Operation operation, const std::vector<Node> &inputs) // Vertex creation definition
+    {
+        auto vertex = std::make_unique<Vertex>(); // New vertex
+        for (const Node &in : inputs)             // Loop through the inputs
+        {
+            if (in.graph != this) // Mixed graphs
+            {
+                throw std::invalid_argument("Node belongs to another graph"); // Cannot depend across graphs
+            }
+            vertex->inputs.push_back(in.id); // Record the edge
+        }
+        vertex->operation = std::move(operation);  // Store the work
+        vertices.push_back(std::move(vertex));     // Append (inputs always have smaller ids)
+        return Node(this, vertices.size() - 1);    // Return its handle
+    }
+
+    /**
+     * @brief Evaluation implementation
+     * @param outputs Nodes to keep after the run
+     */
+    void TaskGraph::run(const std::vector<Node> &outputs) // Evaluation definition
+    {
+        for (const Node &out : outputs) // Loop through the outputs
+        {
+            if (out.graph != this) // Foreign node
+            {
+                throw std::invalid_argument("Node belongs to another graph"); // Cannot evaluate it here
+            }
+            vertices[out.id]->keep = true;                                       // Keep its value
+            vertices[out.id]->needed = vertices[out.id]->current() == nullptr; // Compute it unless it has a value
+        }
+
+        Run run;            // Bookkeeping of this run
+        size_t needed = 0; // Vertices to compute
+        for (size_t id = vertices.size(); id-- > 0;) // Reverse creation order visits consumers before inputs
+        {
+            Vertex &v = *vertices[id]; // Current vertex
+            v.consumers.clear();       // Forget the previous run
+            v.pendingReads = 0;        // Forget the previous run
+            if (!v.needed)             // Not part of this run
+            {
+                continue; // Skip it
+            }
+            needed++;                      // Count it
+            for (size_t in : v.inputs)     // Its inputs must be available
+            {
+                vertices[in]->needed = vertices[in]->needed || vertices[in]->current() == nullptr; // Compute missing inputs too
+            }
+        }
+        if (needed == 0) // Everything requested is already there
+        {
+            return; // Nothing to do
+        }
+
+        std::vector<size_t> ready;                   // Vertices without pending inputs
+        for (size_t id = 0; id < vertices.size(); id++) // Creation order is a topological order
+        {
+            Vertex &v = *vertices[id]; // Current vertex
+            if (!v.needed)             // Not part of this run
+            {
+                continue; // Skip it
+            }
+            size_t pending = 0;        // Inputs computed by this run
+            for (size_t in : v.inputs) // Loop through the inputs
+            {
+                Vertex &input = *vertices[in]; // Input vertex
+                input.consumers.push_back(id); // Wake this vertex when it is done
+                input.pendingReads++;          // One more read before it can be freed
+                pending += input.needed;       // Wait for it if this run computes it
+            }
+            v.pendingInputs = pending; // Remaining inputs
+            if (pending == 0)          // Only reads existing values
+            {
+                ready.push_back(id); // Start it right away
+            }
+        }
+
+        run.remaining = needed;                        // Vertices to finish
+        ThreadPool &pool = ThreadPool::instance();     // Shared pool
+        for (size_t id : ready)                        // Loop through the ready vertices
+        {
+            pool.spawn([this, &run, id]() { execute(run, id); }); // Independent vertices run concurrently
+        }
+        for (;;) // Help until the run is finished
+        {
+            if (run.remaining.load() == 0) // Finished
+            {
+                break; // Stop helping
+            }
+            if (pool.runPendingTask()) // Run a queued or stolen vertex
+            {
+                continue; // Check again
+            }
+            std::unique_lock<std::mutex> lock(run.mutex);                                                       // Protect the wait
+            run.finished.wait_for(lock, std::chrono::milliseconds(1), [&]() { return run.remaining.load() == 0; }); // Recheck the queue soon
+        }
+        {
+            std::lock_guard<std::mutex> lock(run.mutex); // The last vertex may still hold the lock
+        }
+        for (auto &vertex : vertices) // Clear the run marks
+        {
+            vertex->needed = false; // Next run starts fresh
+        }
+        if (run.failure) // A vertex failed
+        {
+            std::rethrow_exception(run.failure); // Propagate the first exception
+        }
+    }
+
+    /**
+     * @brief Node task implementation
+     * @param run Bookkeeping of the run
+     * @param id Vertex to compute
+     */
+    void TaskGraph::execute(Run &run, size_t id) // Node task definition
+    {
+        Vertex &v = *vertices[id]; // Vertex to compute
+        bool skip = false;         // An input failed
+        std::vector<const SquareMat *> args; // Input values
+        for (size_t in : v.inputs)           // Loop through the inputs
+        {
+            const SquareMat *value = vertices[in]->current(); // Input value
+            skip = skip || value == nullptr;                  // Missing after an upstream failure
+            args.push_back(value);                            // Pass it on
+        }
+        if (!skip) // All inputs are there
+        {
+            try
+            {
+                v.value.emplace(v.operation(args)); // Compute the node
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(run.mutex); // Protect failure
+                if (!run.failure)                            // Keep the first exception only
+                {
+                    run.failure = std::current_exception(); // Capture it
+                }
+            }
+        }
+        for (size_t in : v.inputs) // This vertex no longer reads its inputs
+        {
+            Vertex &input = *vertices[in];                                  // Input vertex
+            if (input.pendingReads.fetch_sub(1) == 1 && !input.keep && !input.borrowed) // Last reader of an intermediate
+            {
+                input.value.reset(); // Free its buffer now
+            }
+        }
+        ThreadPool &pool = ThreadPool::instance(); // Shared pool
+        for (size_t c : v.consumers)               // Vertices that read this one
+        {
+            if (vertices[c]->pendingInputs.fetch_sub(1) == 1) // This was its last pending input
+            {
+                pool.spawn([this, &run, c]() { execute(run, c); }); // Run it, preferably on this thread next
+            }
+        }
+        std::lock_guard<std::mutex> lock(run.mutex); // Count down under the lock so run() can't leave early
+        if (run.remaining.fetch_sub(1) == 1)          // Last vertex of the run
+        {
+            run.finished.notify_all(); // Wake the caller
+        }
+    }
+} // End of squaremat namespace
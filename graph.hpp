@@ -0,0 +1,233 @@
+// orel8155@gmail.com
+#pragma once                // Ensures the header file is included only once
+#include <atomic>             // Include for the dependency counters
+#include <cstddef>            // Include for size_t
+#include <functional>         // Include for node operations
+#include <memory>             // Include for vertex ownership
+#include <optional>           // Include for node values
+#include <vector>             // Include for the vertex list
+#include "squaremat.hpp"      // Include for the matrix values
+
+namespace squaremat // Start of namespace definition
+{
+    /**
+     * @class TaskGraph
+     * @brief Lazily built matrix expressions evaluated with independent nodes in parallel
+     *
+     * Operators on TaskGraph::Node handles only record work. run() evaluates what the
+     * requested outputs depend on: every node whose inputs are ready is spawned on the
+     * shared ThreadPool, whose workers steal from each other, and the calling thread helps
+     * until the outputs are done. The value of an intermediate node is freed as soon as its
+     * last consumer has finished; requested outputs are kept for Node::get() and for
+     * later runs.
+     */
+    class TaskGraph // Class definition for the computation graph
+    {
+    public:
+        using Operation = std::function<SquareMat(const std::vector<const SquareMat *> &)>; ///< Work of a node, given its input values
+
+        /**
+         * @class Node
+         * @brief Handle of one matrix-valued node of a graph
+         */
+        class Node // Class definition for the node handle
+        {
+        private:
+            TaskGraph *graph; ///< Owning graph
+            size_t id;        ///< Position in the graph's vertex list
+
+            friend class TaskGraph; // The graph creates handles
+
+            /**
+             * @brief Constructor used by the graph
+             * @param graph Owning graph
+             * @param id Position of the vertex
+             */
+            Node(TaskGraph *graph, size_t id) : graph(graph), id(id) {} // Constructor with initialization list
+
+        public:
+            /**
+             * @brief Value of the node after run()
+             * @return Reference to the value (valid until the graph is destroyed)
+             * @throws std::logic_error if the node has no value (not requested, or freed)
+             */
+            const SquareMat &get() const; // Declaration of the value access
+
+            /**
+             * @brief Check whether the node currently holds a value
+             * @return true for inputs and for outputs of a finished run()
+             */
+            bool hasValue() const; // Declaration of the value check
+
+            /**
+             * @brief Node for this + other
+             * @param other Right operand (same graph)
+             * @return New node
+             */
+            Node operator+(const Node &other) const; // Declaration of lazy addition
+
+            /**
+             * @brief Node for this - other
+             * @param other Right operand (same graph)
+             * @return New node
+             */
+            Node operator-(const Node &other) const; // Declaration of lazy subtraction
+
+            /**
+             * @brief Node for -this
+             * @return New node
+             */
+            Node operator-() const; // Declaration of lazy negation
+
+            /**
+             * @brief Node for this * other
+             * @param other Right operand (same graph)
+             * @return New node
+             */
+            Node operator*(const Node &other) const; // Declaration of lazy multiplication
+
+            /**
+             * @brief Node for this * scalar
+             * @param scalar Factor
+             * @return New node
+             */
+            Node operator*(double scalar) const; // Declaration of lazy scalar multiplication
+
+            /**
+             * @brief Node for scalar * node
+             * @param scalar Factor
+             * @param node Matrix node
+             * @return New node
+             */
+            friend Node operator*(double scalar, const Node &node) { return node * scalar; } // Lazy left scalar multiplication
+
+            /**
+             * @brief Node for this % other (element-wise product)
+             * @param other Right operand (same graph)
+             * @return New node
+             */
+            Node operator%(const Node &other) const; // Declaration of lazy element-wise multiplication
+
+            /**
+             * @brief Node for this % modulus
+             * @param modulus Integer modulus
+             * @return New node
+             */
+            Node operator%(int modulus) const; // Declaration of lazy modulo
+
+            /**
+             * @brief Node for this / scalar
+             * @param scalar Divisor
+             * @return New node
+             */
+            Node operator/(double scalar) const; // Declaration of lazy division
+
+            /**
+             * @brief Node for ~this
+             * @return New node
+             */
+            Node operator~() const; // Declaration of lazy transpose
+
+            /**
+             * @brief Node for this ^ power
+             * @param power Non-negative exponent
+             * @return New node
+             */
+            Node operator^(int power) const; // Declaration of lazy power
+        };
+
+        /**
+         * @brief Constructor that creates an empty graph
+         */
+        TaskGraph() = default; // Default constructor
+
+        TaskGraph(const TaskGraph &) = delete;            // Node handles point into the graph
+        TaskGraph &operator=(const TaskGraph &) = delete; // Node handles point into the graph
+
+        /**
+         * @brief Add an input that refers to a matrix owned by the caller
+         * @param mat Matrix that must stay alive and unchanged until the last run()
+         * @return Node of the matrix
+         */
+        Node input(const SquareMat &mat); // Declaration of the borrowed input
+
+        /**
+         * @brief Add an input that the graph takes over
+         * @param mat Matrix to move into the graph
+         * @return Node of the matrix
+         */
+        Node input(SquareMat &&mat); // Declaration of the owned input
+
+        /**
+         * @brief Add a node computed by a custom operation
+         * @param operation Callable receiving the input values in order
+         * @param inputs Nodes of the same graph the operation reads
+         * @return New node
+         * @throws std::invalid_argument if an input belongs to another graph
+         */
+        Node apply(Operation operation, const std::vector<Node> &inputs); // Declaration of the generic node
+
+        /**
+         * @brief Evaluate the given outputs and everything they depend on
+         *
+         * Nodes that already hold a value are not recomputed. Must not be called
+         * concurrently on the same graph.
+         * @param outputs Nodes to keep after the run
+         * @throws std::invalid_argument if an output belongs to another graph
+         * @throws Rethrows the first exception thrown by a node (its dependants are skipped)
+         */
+        void run(const std::vector<Node> &outputs); // Declaration of the evaluation
+
+        /**
+         * @brief Number of nodes in the graph
+         * @return Node count
+         */
+        size_t size() const { return vertices.size(); } // Getter for the node count
+
+    private:
+        /**
+         * @brief One node with its operation, value and dependency counters
+         */
+        struct Vertex
+        {
+            Operation operation;                  ///< Work of the node (empty for inputs)
+            std::vector<size_t> inputs;           ///< Vertices the operation reads
+            std::vector<size_t> consumers;        ///< Vertices of the current run that read this one
+            const SquareMat *borrowed = nullptr;  ///< Caller-owned input value
+            std::optional<SquareMat> value;       ///< Owned value (computed or moved in)
+            bool keep = false;                    ///< Requested as an output, never freed
+            bool needed = false;                  ///< Computed by the current run
+            std::atomic<size_t> pendingInputs{0}; ///< Inputs of the current run still being computed
+            std::atomic<size_t> pendingReads{0};  ///< Consumers of the current run still to finish
+
+            /**
+             * @brief Current value of the vertex
+             * @return Pointer to the value, or nullptr if there is none
+             */
+            const SquareMat *current() const { return borrowed ? borrowed : (value ? &*value : nullptr); } // Value lookup
+        };
+
+        std::vector<std::unique_ptr<Vertex>> vertices; ///< Nodes in creation order (inputs always come first)
+
+        /**
+         * @brief Add a vertex for an operation on existing nodes
+         * @param operation Work of the node
+         * @param inputs Nodes the operation reads
+         * @return Handle of the new node
+         * @throws std::invalid_argument if an input belongs to another graph
+         */
+        Node add(Operation operation, const std::vector<Node> &inputs); // Declaration of vertex creation
+
+        /**
+         * @brief Shared bookkeeping of one run
+         */
+        struct Run;
+
+        /**
+         * @brief Compute one vertex, free inputs that are no longer read and spawn ready consumers
+         * @param run Bookkeeping of the run
+         * @param id Vertex to compute
+         */
+        void execute(Run &run, size_t id); // Declaration of the node task
+    };
+} // End of namespace
@@ -0,0 +1,331 @@
+// orel8155@gmail.com
+#pragma once         // Ensures the header file is included only once
+#include <algorithm>      // Include for std::min, std::max and std::swap_ranges
+#include <cmath>          // Include for std::fabs and std::isfinite
+#include <cstddef>        // Include for size_t
+#include <cstdint>        // Include for uint64_t
+#include <utility>        // Include for std::swap
+#include <vector>         // Include for the LU factors
+#include "stats.hpp"      // Include for the factorization counters
+#include "threadpool.hpp" // Include for the parallel LU row updates
+
+/**
+ * @file kernels.hpp
+ * @brief Contiguous inner loops shared by the matrix and vector operations, and the
+ * cache-blocked product and LU factorization built from them
+ *
+ * The loops are written with independent accumulators and no aliasing between
+ * input and output, so the compiler can vectorize them at -O2 without -ffast-math.
+ * The makefile adds -fvect-cost-model=cheap because GCC's default -O2 cost model
+ * skips every loop whose trip count is only known at run time.
+ */
+namespace squaremat // Start of namespace definition
+{
+    namespace kernels // Start of the inner-loop namespace
+    {
+        /**
+         * @brief Dot product of two contiguous arrays
+         * @param a First array
+         * @param b Second array
+         * @param n Number of elements
+         * @return Sum of a[i]*b[i]
+         */
+        inline double dot(const double *a, const double *b, size_t n) // Dot product kernel
+        {
+            double s0 = 0, s1 = 0, s2 = 0, s3 = 0; // Independent accumulators break the add dependency chain
+            size_t i = 0;                           // Element index
+            for (; i + 4 <= n; i += 4)              // Four elements per step
+            {
+                s0 += a[i] * b[i];         // Lane 0
+                s1 += a[i + 1] * b[i + 1]; // Lane 1
+                s2 += a[i + 2] * b[i + 2]; // Lane 2
+                s3 += a[i + 3] * b[i + 3]; // Lane 3
+            }
+            for (; i < n; i++) // Remaining elements
+            {
+                s0 += a[i] * b[i]; // Tail
+            }
+            return (s0 + s1) + (s2 + s3); // Combine the lanes
+        }
+
+        /**
+         * @brief y += alpha * x over contiguous arrays
+         * @param alpha Scale factor
+         * @param x Input array
+         * @param y Output array (must not overlap x)
+         * @param n Number of elements
+         */
+        inline void axpy(double alpha, const double *__restrict__ x, double *__restrict__ y, size_t n) // AXPY kernel
+        {
+            for (size_t i = 0; i < n; i++) // Independent iterations vectorize directly
+            {
+                y[i] += alpha * x[i]; // Scaled accumulate
+            }
+        }
+
+        /**
+         * @brief y += alpha * x over contiguous single-precision arrays
+         * @param alpha Scale factor
+         * @param x Input array
+         * @param y Output array (must not overlap x)
+         * @param n Number of elements
+         */
+        inline void axpy(float alpha, const float *__restrict__ x, float *__restrict__ y, size_t n) // Single-precision AXPY kernel
+        {
+            for (size_t i = 0; i < n; i++) // Twice as many lanes per vector as double
+            {
+                y[i] += alpha * x[i]; // Scaled accumulate
+            }
+        }
+
+        /**
+         * @brief y = alpha * x + beta * y over contiguous arrays
+         * @param alpha Scale of x
+         * @param x Input array
+         * @param beta Scale of y (0 overwrites y without reading it)
+         * @param y Output array (must not overlap x)
+         * @param n Number of elements
+         */
+        inline void axpby(double alpha, const double *__restrict__ x, double beta, double *__restrict__ y, size_t n) // AXPBY kernel
+        {
+            if (beta == 0) // NaNs in y must not propagate
+            {
+                for (size_t i = 0; i < n; i++) // Independent iterations vectorize directly
+                {
+                    y[i] = alpha * x[i]; // Overwrite
+                }
+                return; // Done
+            }
+            for (size_t i = 0; i < n; i++) // Independent iterations vectorize directly
+            {
+                y[i] = alpha * x[i] + beta * y[i]; // Scaled combine
+            }
+        }
+
+        /**
+         * @brief Sum of a contiguous array with four independent accumulators
+         * @param a Array
+         * @param n Number of elements
+         * @return Sum of a[i]
+         */
+        inline double sum(const double *a, size_t n) // Naive sum kernel
+        {
+            double s0 = 0, s1 = 0, s2 = 0, s3 = 0; // Independent accumulators break the add dependency chain
+            size_t i = 0;                           // Element index
+            for (; i + 4 <= n; i += 4)              // Four elements per step
+            {
+                s0 += a[i];     // Lane 0
+                s1 += a[i + 1]; // Lane 1
+                s2 += a[i + 2]; // Lane 2
+                s3 += a[i + 3]; // Lane 3
+            }
+            for (; i < n; i++) // Remaining elements
+            {
+                s0 += a[i]; // Tail
+            }
+            return (s0 + s1) + (s2 + s3); // Combine the lanes
+        }
+
+        /**
+         * @brief Pairwise (cascade) sum of a contiguous array, error O(log n) instead of O(n)
+         * @param a Array
+         * @param n Number of elements
+         * @return Sum of a[i]
+         */
+        inline double pairwiseSum(const double *a, size_t n) // Pairwise sum kernel
+        {
+            if (n <= 32) // Short runs are accurate enough
+            {
+                return sum(a, n); // Base case
+            }
+            size_t half = n / 2;                                      // Split point
+            return pairwiseSum(a, half) + pairwiseSum(a + half, n - half); // Sum the halves
+        }
+
+        /**
+         * @brief Add x to the running sum s with Neumaier compensation c
+         * @param s Running sum
+         * @param c Running compensation (lost low-order bits)
+         * @param x Value to add
+         */
+        inline void neumaierAdd(double &s, double &c, double x) // Compensated accumulate
+        {
+            double t = s + x;                               // Rounded sum
+            c += std::fabs(s) >= std::fabs(x) ? (s - t) + x : (x - t) + s; // Recover what the rounding dropped from the smaller operand
+            s = t;                                          // Keep the rounded sum
+        }
+
+        /**
+         * @brief Neumaier-compensated sum of a contiguous array with four lanes
+         * @param a Array
+         * @param n Number of elements
+         * @param s Output rounded sum
+         * @param c Output compensation (s + c is the accurate sum)
+         */
+        inline void compensatedSum(const double *a, size_t n, double &s, double &c) // Compensated sum kernel
+        {
+            double sums[4] = {0, 0, 0, 0};  // Lane sums
+            double comps[4] = {0, 0, 0, 0}; // Lane compensations
+            size_t i = 0;                   // Element index
+            for (; i + 4 <= n; i += 4)      // Four elements per step
+            {
+                for (size_t lane = 0; lane < 4; lane++) // Independent lanes
+                {
+                    neumaierAdd(sums[lane], comps[lane], a[i + lane]); // Compensated accumulate
+                }
+            }
+            for (; i < n; i++) // Remaining elements
+            {
+                neumaierAdd(sums[0], comps[0], a[i]); // Tail
+            }
+            s = 0;                                  // Combine the lanes
+            c = 0;                                  // Combined compensation
+            for (size_t lane = 0; lane < 4; lane++) // Fixed lane order
+            {
+                neumaierAdd(s, c, sums[lane]); // Lane sum
+                c += comps[lane];              // Lane compensation
+            }
+        }
+
+        constexpr size_t ProductBlockK = 128; ///< Rows of b per block of productRows (the panel stays in L2)
+        constexpr size_t ProductBlockJ = 512; ///< Columns per block of productRows (a row segment of c stays in L1)
+        constexpr unsigned UpperTriangular = 1u << 0; ///< Operand flag of productRows: zeros below the diagonal (bit of SquareMat::UpperTriangular)
+        constexpr unsigned LowerTriangular = 1u << 1; ///< Operand flag of productRows: zeros above the diagonal (bit of SquareMat::LowerTriangular)
+
+        /**
+         * @brief c[first..last) += alpha * a * b over the given rows, cache-blocked in i-k-j order
+         *
+         * Each element still accumulates its terms in ascending k, so the result matches the
+         * plain triple loop bit for bit. Triangular operands skip their known zeros. Rows of
+         * each operand are contiguous and start lda, ldb or ldc elements apart, so blocks of
+         * larger matrices are multiplied in place.
+         * @param alpha Scale of the product
+         * @param a Left operand elements (n x n, row stride lda)
+         * @param lda Row stride of a
+         * @param b Right operand elements (n x n, row stride ldb)
+         * @param ldb Row stride of b
+         * @param c Accumulated elements (n x n, row stride ldc, must not overlap a or b)
+         * @param ldc Row stride of c
+         * @param n Matrix size
+         * @param left Triangular flags of a
+         * @param right Triangular flags of b
+         * @param first First row of c to update
+         * @param last One past the last row of c to update
+         */
+        inline void productRows(double alpha, const double *a, size_t lda, const double *b, size_t ldb, double *c, size_t ldc, size_t n, unsigned left, unsigned right, size_t first, size_t last) // Product kernel
+        {
+            for (size_t kk = 0; kk < n; kk += ProductBlockK) // Blocks of b's rows
+            {
+                for (size_t jj = 0; jj < n; jj += ProductBlockJ) // Blocks of columns
+                {
+                    size_t jEnd = std::min(jj + ProductBlockJ, n); // End of the column block
+                    for (size_t i = first; i < last; i++)          // Rows of the chunk
+                    {
+                        size_t kLo = std::max(kk, (left & UpperTriangular) ? i : 0);                      // Upper a: a[i][k] = 0 for k < i
+                        size_t kHi = std::min(kk + ProductBlockK, (left & LowerTriangular) ? i + 1 : n); // Lower a: a[i][k] = 0 for k > i
+                        for (size_t k = kLo; k < kHi; k++)                                              // Terms of the row
+                        {
+                            size_t jLo = std::max(jj, (right & UpperTriangular) ? k : 0);          // Upper b: b[k][j] = 0 for j < k
+                            size_t jHi = std::min(jEnd, (right & LowerTriangular) ? k + 1 : n);   // Lower b: b[k][j] = 0 for j > k
+                            if (jLo < jHi)                                                        // Anything left in the block
+                            {
+                                axpy(alpha * a[i * lda + k], b + k * ldb + jLo, c + i * ldc + jLo, jHi - jLo); // Row of b into row of c
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief LU factorization with partial pivoting, in place
+         *
+         * Right-looking elimination; the trailing rows of each step are updated in parallel.
+         * Counted as stats Operation::Factorize.
+         * @tparam T Storage precision (float or double)
+         * @param lu Row-major n x n matrix, replaced by unit-lower L and U
+         * @param pivots Output row interchanged with row k at step k
+         * @param n Matrix size
+         * @return false if a pivot was zero or not finite, true otherwise
+         */
+        template <typename T>
+        bool luFactorize(std::vector<T> &lu, std::vector<size_t> &pivots, size_t n) // LU kernel
+        {
+            SQUAREMAT_STAT_SCOPE(Factorize, n * n, 2 * uint64_t(n) * n * n / 3); // Count the factorization
+            pivots.resize(n);              // One interchange per step
+            for (size_t k = 0; k < n; k++) // Elimination steps
+            {
+                size_t pivot = k;                    // Row with the largest candidate
+                T best = std::fabs(lu[k * n + k]);   // Its magnitude
+                for (size_t i = k + 1; i < n; i++)   // Search the rest of the column
+                {
+                    if (std::fabs(lu[i * n + k]) > best) // Larger candidate
+                    {
+                        pivot = i;                      // Remember its row
+                        best = std::fabs(lu[i * n + k]); // And its magnitude
+                    }
+                }
+                if (!(best > 0) || !std::isfinite(best)) // Singular, or overflowed in this precision
+                {
+                    return false; // No usable factorization
+                }
+                pivots[k] = pivot; // Record the interchange
+                if (pivot != k)    // Bring the pivot row up
+                {
+                    std::swap_ranges(lu.begin() + k * n, lu.begin() + (k + 1) * n, lu.begin() + pivot * n); // Swap whole rows
+                }
+                const T *top = lu.data() + k * n; // Pivot row
+                size_t width = n - k - 1;         // Trailing columns
+                ThreadPool::instance().parallelFor(k + 1, n, ThreadPool::rowGrain(std::max<size_t>(width, 1)), [&](size_t first, size_t last) {
+                    for (size_t i = first; i < last; i++) // Trailing rows of the chunk
+                    {
+                        T *row = lu.data() + i * n; // Row to eliminate
+                        T factor = row[k] /= top[k]; // Multiplier, stored in L
+                        if (factor != 0)              // Rows that are already zero stay unchanged
+                        {
+                            axpy(-factor, top + k + 1, row + k + 1, width); // Subtract the pivot row
+                        }
+                    }
+                });
+            }
+            return true; // Factorization succeeded
+        }
+
+        /**
+         * @brief Solve with LU factors, substituting in double precision
+         * @tparam T Storage precision of the factors
+         * @param lu Factors from luFactorize()
+         * @param pivots Interchanges from luFactorize()
+         * @param n Matrix size
+         * @param x Right-hand side on entry, solution on exit
+         */
+        template <typename T>
+        void luSubstitute(const std::vector<T> &lu, const std::vector<size_t> &pivots, size_t n, double *x) // Triangular solves
+        {
+            for (size_t k = 0; k < n; k++) // Apply the interchanges in order
+            {
+                std::swap(x[k], x[pivots[k]]); // Same swap as the rows
+            }
+            for (size_t i = 0; i < n; i++) // Forward substitution with unit L
+            {
+                double sum = x[i];                 // Start from the right-hand side
+                const T *row = lu.data() + i * n;  // Row of L
+                for (size_t k = 0; k < i; k++)     // Known unknowns
+                {
+                    sum -= static_cast<double>(row[k]) * x[k]; // Eliminate them
+                }
+                x[i] = sum; // Store the intermediate
+            }
+            for (size_t i = n; i-- > 0;) // Back substitution with U
+            {
+                double sum = x[i];                 // Start from the intermediate
+                const T *row = lu.data() + i * n;  // Row of U
+                for (size_t k = i + 1; k < n; k++) // Known unknowns
+                {
+                    sum -= static_cast<double>(row[k]) * x[k]; // Eliminate them
+                }
+                x[i] = sum / static_cast<double>(row[i]); // Divide by the pivot
+            }
+        }
+    } // End of kernels namespace
+} // End of namespace
@@ -1,5 +1,6 @@
 // orel8155@gmail.com
 #include "squaremat.hpp"
+#include "graph.hpp"
 
 using namespace squaremat;
 
@@ -192,6 +193,20 @@ int main()
                   << postDec << std::endl;
         std::cout << "New value of matrix: " << std::endl
                   << mat1 << std::endl;
+
+        // Independent operations evaluated concurrently through a task graph
+        TaskGraph graph;
+        TaskGraph::Node node1 = graph.input(mat1);
+        TaskGraph::Node node2 = graph.input(mat2);
+        TaskGraph::Node graphSum = node1 + node2;
+        TaskGraph::Node graphDiff = node1 - node2;
+        TaskGraph::Node graphProduct = node1 * node2;
+        TaskGraph::Node graphTranspose = ~node1;
+        graph.run({graphSum, graphDiff, graphProduct, graphTranspose});
+        std::cout << "Task graph product of matrices:" << std::endl
+                  << graphProduct.get() << std::endl;
+        std::cout << "Task graph transpose of matrix 1:" << std::endl
+                  << graphTranspose.get() << std::endl;
     }
     catch (const std::exception &e)
     {
@@ -0,0 +1,314 @@
+// orel8155@gmail.com
+#include "matvec.hpp"     // Include the header file for Vector and GEMV
+#include "kernels.hpp"    // Include for the shared inner loops
+#include "threadpool.hpp" // Include for the shared worker pool
+#include <algorithm>      // Include for std::copy
+#include <cmath>          // Include for std::sqrt
+
+namespace squaremat // Start of the squaremat namespace
+{
+    /**
+     * @brief Constructor implementation
+     * @param size Number of elements
+     * @throws std::invalid_argument if size is not positive
+     */
+    Vector::Vector(size_t size) : size(size), data(nullptr) // Constructor definition
+    {
+        if (size <= 0) // Check if size is valid
+        {
+            throw std::invalid_argument("Size must be positive"); // Throw exception for invalid size
+        }
+        data = new double[size](); // Allocate and initialize to 0
+    }
+
+    /**
+     * @brief List constructor implementation
+     * @param values Elements of the vector
+     * @throws std::invalid_argument if the list is empty
+     */
+    Vector::Vector(std::initializer_list<double> values) : Vector(values.size()) // Delegate allocation
+    {
+        std::copy(values.begin(), values.end(), data); // Copy the elements
+    }
+
+    /**
+     * @brief Copy constructor implementation
+     * @param other The vector to copy
+     */
+    Vector::Vector(const Vector &other) : size(other.size), data(new double[other.size]) // Copy constructor definition
+    {
+        std::copy(other.data, other.data + size, data); // Copy the elements
+    }
+
+    /**
+     * @brief Assignment operator implementation
+     * @param other The vector to assign from
+     * @return Reference to this vector after assignment
+     */
+    Vector &Vector::operator=(const Vector &other) // Assignment operator definition
+    {
+        if (this == &other) // Check for self-assignment
+        {
+            return *this; // Return if self-assignment
+        }
+        if (size != other.size) // Storage must be resized
+        {
+            double *fresh = new double[other.size]; // Allocate before releasing (strong guarantee)
+            delete[] data;                          // Free current resources
+            data = fresh;                           // Adopt the new storage
+            size = other.size;                      // Update size
+        }
+        std::copy(other.data, other.data + size, data); // Copy the elements
+        return *this;                                   // Return reference to modified vector
+    }
+
+    /**
+     * @brief Addition operator implementation
+     * @param other Vector to add
+     * @return New vector containing the sum
+     * @throws std::invalid_argument if vector sizes don't match
+     */
+    Vector Vector::operator+(const Vector &other) const // Addition operator definition
+    {
+        Vector result(*this);   // Start from this vector
+        axpy(1.0, other, result); // Add the other vector
+        return result;          // Return the resulting vector
+    }
+
+    /**
+     * @brief Subtraction operator implementation
+     * @param other Vector to subtract
+     * @return New vector containing the difference
+     * @throws std::invalid_argument if vector sizes don't match
+     */
+    Vector Vector::operator-(const Vector &other) const // Subtraction operator definition
+    {
+        Vector result(*this);    // Start from this vector
+        axpy(-1.0, other, result); // Subtract the other vector
+        return result;           // Return the resulting vector
+    }
+
+    /**
+     * @brief Scalar multiplication operator implementation
+     * @param scalar Value to multiply elements by
+     * @return New vector with scaled elements
+     */
+    Vector Vector::operator*(double scalar) const // Scalar multiplication operator definition
+    {
+        Vector result(*this);             // Start from this vector
+        for (size_t i = 0; i < size; i++) // Loop through elements
+        {
+            result.data[i] *= scalar; // Scale each element
+        }
+        return result; // Return the resulting vector
+    }
+
+    /**
+     * @brief Euclidean norm implementation
+     * @return sqrt(dot(x, x))
+     */
+    double Vector::norm() const // Norm definition
+    {
+        return std::sqrt(kernels::dot(data, data, size)); // Root of the self dot product
+    }
+
+    /**
+     * @brief Output stream operator for Vector implementation
+     * @param os Output stream
+     * @param vec Vector to output
+     * @return Reference to output stream
+     */
+    std::ostream &operator<<(std::ostream &os, const Vector &vec) // Output stream operator definition
+    {
+        for (size_t i = 0; i < vec.size; i++) // Loop through elements
+        {
+            os << vec.data[i] << "\t"; // Output element with tab separator
+        }
+        os << std::endl; // End the line
+        return os;       // Return reference to output stream
+    }
+
+    /**
+     * @brief GEMV implementation
+     * @param alpha Scale of the product
+     * @param mat Matrix A
+     * @param x Input vector
+     * @param beta Scale of the existing y (0 ignores its contents)
+     * @param y Output vector (must not be x)
+     * @param transpose Use the transpose of A
+     * @throws std::invalid_argument if sizes don't match or y is x
+     */
+    void gemv(double alpha, const SquareMatView &mat, const Vector &x, double beta, Vector &y, bool transpose) // GEMV definition
+    {
+        size_t n = mat.getSize();                // Matrix size
+        if (x.getSize() != n || y.getSize() != n) // Check if vector sizes fit the matrix
+        {
+            throw std::invalid_argument("Vector size must match matrix size"); // Throw exception if sizes don't match
+        }
+        if (&x == &y) // Output would overwrite the input while it is read
+        {
+            throw std::invalid_argument("Output vector must differ from input vector"); // Throw exception for aliasing
+        }
+        const double *in = x.values(); // Input storage
+        double *out = y.values();      // Output storage
+
+        if (!transpose) // y_i = alpha * (row_i . x) + beta * y_i, rows split across threads
+        {
+            ThreadPool::instance().parallelFor(0, n, ThreadPool::rowGrain(n), [&](size_t first, size_t last) {
+                for (size_t i = first; i < last; i++) // Loop through the chunk's rows
+                {
+                    double product = alpha * kernels::dot(mat[i], in, n);        // Row dot product
+                    out[i] = (beta == 0) ? product : product + beta * out[i]; // Combine with the old value
+                }
+            });
+            return; // Done
+        }
+
+        // y = alpha * A^T x + beta * y accumulates whole rows of A, so threads own column blocks
+        ThreadPool::instance().parallelFor(0, n, ThreadPool::rowGrain(n), [&](size_t first, size_t last) {
+            size_t width = last - first;            // Columns owned by this chunk
+            for (size_t j = first; j < last; j++)   // Apply beta to the owned slice
+            {
+                out[j] = (beta == 0) ? 0 : beta * out[j]; // Scale or clear the old value
+            }
+            for (size_t i = 0; i < n; i++) // Stream the rows of A
+            {
+                kernels::axpy(alpha * in[i], mat[i] + first, out + first, width); // Add x_i times the row slice
+            }
+        });
+    }
+
+    /**
+     * @brief Matrix-vector product implementation
+     * @param mat Matrix A
+     * @param x Column vector
+     * @return New vector A * x
+     * @throws std::invalid_argument if sizes don't match
+     */
+    Vector operator*(const SquareMatView &mat, const Vector &x) // Matrix-vector product definition
+    {
+        Vector result(mat.getSize());          // Output vector
+        gemv(1.0, mat, x, 0.0, result, false); // result = A x
+        return result;                         // Return the product
+    }
+
+    /**
+     * @brief Vector-matrix product implementation
+     * @param x Row vector
+     * @param mat Matrix A
+     * @return New vector x^T * A
+     * @throws std::invalid_argument if sizes don't match
+     */
+    Vector operator*(const Vector &x, const SquareMatView &mat) // Vector-matrix product definition
+    {
+        return transposeMultiply(mat, x); // x^T A is (A^T x)^T
+    }
+
+    /**
+     * @brief Transposed product implementation
+     * @param mat Matrix A
+     * @param x Column vector
+     * @return New vector A^T * x
+     * @throws std::invalid_argument if sizes don't match
+     */
+    Vector transposeMultiply(const SquareMatView &mat, const Vector &x) // Transposed product definition
+    {
+        Vector result(mat.getSize());         // Output vector
+        gemv(1.0, mat, x, 0.0, result, true); // result = A^T x
+        return result;                        // Return the product
+    }
+
+    /**
+     * @brief Batched GEMV implementation
+     * @param mat Matrix A
+     * @param xs Input vectors
+     * @return Products A * x_k in the same order
+     * @throws std::invalid_argument if any size doesn't match
+     */
+    std::vector<Vector> multiplyBatch(const SquareMatView &mat, const std::vector<Vector> &xs) // Batched GEMV definition
+    {
+        size_t n = mat.getSize(); // Matrix size
+        for (const Vector &x : xs) // Validate every input first
+        {
+            if (x.getSize() != n) // Check if vector size fits the matrix
+            {
+                throw std::invalid_argument("Vector size must match matrix size"); // Throw exception if sizes don't match
+            }
+        }
+        std::vector<Vector> results(xs.size(), Vector(n)); // Zero outputs
+        size_t count = xs.size();                          // Number of vectors
+
+        ThreadPool::instance().parallelFor(0, n, ThreadPool::rowGrain(n), [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; i++) // Loop through the chunk's rows
+            {
+                const double *row = mat[i]; // Row i of A, reused for every vector
+                size_t k = 0;               // Vector index
+                for (; k + 4 <= count; k += 4) // Four vectors share one pass over the row
+                {
+                    const double *x0 = xs[k].values();     // Vector k
+                    const double *x1 = xs[k + 1].values(); // Vector k+1
+                    const double *x2 = xs[k + 2].values(); // Vector k+2
+                    const double *x3 = xs[k + 3].values(); // Vector k+3
+                    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;  // One accumulator per vector
+                    for (size_t j = 0; j < n; j++)          // Loop through the row
+                    {
+                        double a = row[j]; // Loaded once, used four times
+                        s0 += a * x0[j];   // Vector k
+                        s1 += a * x1[j];   // Vector k+1
+                        s2 += a * x2[j];   // Vector k+2
+                        s3 += a * x3[j];   // Vector k+3
+                    }
+                    results[k].values()[i] = s0;     // Store vector k
+                    results[k + 1].values()[i] = s1; // Store vector k+1
+                    results[k + 2].values()[i] = s2; // Store vector k+2
+                    results[k + 3].values()[i] = s3; // Store vector k+3
+                }
+                for (; k < count; k++) // Remaining vectors one at a time
+                {
+                    results[k].values()[i] = kernels::dot(row, xs[k].values(), n); // Plain dot product
+                }
+            }
+        });
+        return results; // Return the products
+    }
+
+    /**
+     * @brief AXPY implementation
+     * @param alpha Scale factor
+     * @param x Input vector
+     * @param y Vector to update
+     * @throws std::invalid_argument if sizes don't match
+     */
+    void axpy(double alpha, const Vector &x, Vector &y) // AXPY definition
+    {
+        if (x.getSize() != y.getSize()) // Check if vectors have same size
+        {
+            throw std::invalid_argument("Vector sizes must match"); // Throw exception if sizes don't match
+        }
+        if (&x == &y) // y += alpha * y
+        {
+            for (size_t i = 0; i < y.getSize(); i++) // Loop through elements
+            {
+                y.values()[i] *= 1 + alpha; // Scale in place
+            }
+            return; // Done
+        }
+        kernels::axpy(alpha, x.values(), y.values(), y.getSize()); // Vectorized update
+    }
+
+    /**
+     * @brief Dot product implementation
+     * @param x First vector
+     * @param y Second vector
+     * @return Sum of x[i]*y[i]
+     * @throws std::invalid_argument if sizes don't match
+     */
+    double dot(const Vector &x, const Vector &y) // Dot product definition
+    {
+        if (x.getSize() != y.getSize()) // Check if vectors have same size
+        {
+            throw std::invalid_argument("Vector sizes must match"); // Throw exception if sizes don't match
+        }
+        return kernels::dot(x.values(), y.values(), x.getSize()); // Multi-accumulator kernel
+    }
+} // End of squaremat namespace
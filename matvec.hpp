@@ -0,0 +1,222 @@
+// orel8155@gmail.com
+#pragma once                // Ensures the header file is included only once
+#include <initializer_list> // Include for list construction
+#include <iostream>         // Include for input/output operations
+#include <stdexcept>        // Include for standard exceptions
+#include <vector>           // Include for batches of vectors
+#include "squaremat.hpp"    // Include for the matrix operand of GEMV
+#include "matview.hpp"      // Include for views accepted by the products
+
+namespace squaremat // Start of namespace definition
+{
+    /**
+     * @class Vector
+     * @brief A dense vector of doubles used as the operand of matrix-vector products
+     */
+    class Vector // Class definition for dense vector
+    {
+    private:
+        size_t size;  ///< Number of elements
+        double *data; ///< Contiguous element storage
+
+    public:
+        /**
+         * @brief Constructor that creates a zero vector
+         * @param size Number of elements
+         * @throws std::invalid_argument if size is not positive
+         */
+        explicit Vector(size_t size); // Declaration of constructor
+
+        /**
+         * @brief Constructor from a list of values
+         * @param values Elements of the vector
+         * @throws std::invalid_argument if the list is empty
+         */
+        Vector(std::initializer_list<double> values); // Declaration of list constructor
+
+        /**
+         * @brief Copy constructor
+         * @param other The vector to copy
+         */
+        Vector(const Vector &other); // Declaration of copy constructor
+
+        /**
+         * @brief Move constructor
+         * @param other The vector to take the storage from (left empty)
+         */
+        Vector(Vector &&other) noexcept : size(other.size), data(other.data) // Move constructor definition
+        {
+            other.size = 0;       // Source no longer owns elements
+            other.data = nullptr; // Source no longer owns storage
+        }
+
+        /**
+         * @brief Destructor to free allocated memory
+         */
+        ~Vector() { delete[] data; } // Destructor definition
+
+        /**
+         * @brief Assignment operator
+         * @param other The vector to assign from
+         * @return Reference to this vector after assignment
+         */
+        Vector &operator=(const Vector &other); // Declaration of assignment operator
+
+        /**
+         * @brief Element access (non-const version)
+         * @param index Element index
+         * @return Reference to the element
+         * @throws std::out_of_range if index is out of bounds
+         */
+        double &operator[](size_t index) // Non-const subscript operator overload
+        {
+            if (index >= size) // Check if index is out of bounds
+            {
+                throw std::out_of_range("Index out of bounds"); // Throw exception for invalid index
+            }
+            return data[index]; // Return reference to the element
+        }
+
+        /**
+         * @brief Element access (const version)
+         * @param index Element index
+         * @return Value of the element
+         * @throws std::out_of_range if index is out of bounds
+         */
+        double operator[](size_t index) const // Const subscript operator overload
+        {
+            if (index >= size) // Check if index is out of bounds
+            {
+                throw std::out_of_range("Index out of bounds"); // Throw exception for invalid index
+            }
+            return data[index]; // Return the element
+        }
+
+        /**
+         * @brief Get the number of elements
+         * @return Size of the vector
+         */
+        size_t getSize() const { return size; } // Getter method for vector size
+
+        /**
+         * @brief Raw contiguous storage (for kernels)
+         * @return Pointer to the first element
+         */
+        double *values() { return data; } // Mutable storage getter
+
+        /**
+         * @brief Raw contiguous storage (for kernels, const version)
+         * @return Const pointer to the first element
+         */
+        const double *values() const { return data; } // Const storage getter
+
+        /**
+         * @brief Addition operator for vectors
+         * @param other Vector to add
+         * @return New vector containing the sum
+         * @throws std::invalid_argument if vector sizes don't match
+         */
+        Vector operator+(const Vector &other) const; // Declaration of addition operator
+
+        /**
+         * @brief Subtraction operator for vectors
+         * @param other Vector to subtract
+         * @return New vector containing the difference
+         * @throws std::invalid_argument if vector sizes don't match
+         */
+        Vector operator-(const Vector &other) const; // Declaration of subtraction operator
+
+        /**
+         * @brief Scalar multiplication operator
+         * @param scalar Value to multiply elements by
+         * @return New vector with scaled elements
+         */
+        Vector operator*(double scalar) const; // Declaration of scalar multiplication operator
+
+        /**
+         * @brief Euclidean norm
+         * @return sqrt(dot(x, x))
+         */
+        double norm() const; // Declaration of norm
+
+        /**
+         * @brief Output stream operator for Vector
+         * @param os Output stream
+         * @param vec Vector to output
+         * @return Reference to output stream
+         */
+        friend std::ostream &operator<<(std::ostream &os, const Vector &vec); // Declaration of friend output stream operator
+    };
+
+    /**
+     * @brief General matrix-vector product y = alpha * op(A) * x + beta * y in O(n^2)
+     *
+     * op(A) is A or its transpose. Rows (or column blocks for the transpose) are split
+     * across the shared thread pool for large matrices.
+     * A may be a whole SquareMat or any SquareMatView, e.g. a block of a larger matrix.
+     * @param alpha Scale of the product
+     * @param mat Matrix A
+     * @param x Input vector
+     * @param beta Scale of the existing y (0 ignores its contents)
+     * @param y Output vector (must not be x)
+     * @param transpose Use the transpose of A
+     * @throws std::invalid_argument if sizes don't match or y is x
+     */
+    void gemv(double alpha, const SquareMatView &mat, const Vector &x, double beta, Vector &y, bool transpose = false); // Declaration of GEMV
+
+    /**
+     * @brief Matrix-vector product A * x
+     * @param mat Matrix A
+     * @param x Column vector
+     * @return New vector A * x
+     * @throws std::invalid_argument if sizes don't match
+     */
+    Vector operator*(const SquareMatView &mat, const Vector &x); // Declaration of matrix-vector product
+
+    /**
+     * @brief Vector-matrix product x^T * A (row vector times matrix)
+     * @param x Row vector
+     * @param mat Matrix A
+     * @return New vector x^T * A
+     * @throws std::invalid_argument if sizes don't match
+     */
+    Vector operator*(const Vector &x, const SquareMatView &mat); // Declaration of vector-matrix product
+
+    /**
+     * @brief Transposed product A^T * x without forming the transpose
+     * @param mat Matrix A
+     * @param x Column vector
+     * @return New vector A^T * x
+     * @throws std::invalid_argument if sizes don't match
+     */
+    Vector transposeMultiply(const SquareMatView &mat, const Vector &x); // Declaration of transposed product
+
+    /**
+     * @brief Batched matrix-vector product A * x_k for many vectors
+     *
+     * Each row of A is read once per group of four vectors instead of once per vector.
+     * @param mat Matrix A
+     * @param xs Input vectors
+     * @return Products A * x_k in the same order
+     * @throws std::invalid_argument if any size doesn't match
+     */
+    std::vector<Vector> multiplyBatch(const SquareMatView &mat, const std::vector<Vector> &xs); // Declaration of batched GEMV
+
+    /**
+     * @brief In-place AXPY: y += alpha * x
+     * @param alpha Scale factor
+     * @param x Input vector
+     * @param y Vector to update
+     * @throws std::invalid_argument if sizes don't match
+     */
+    void axpy(double alpha, const Vector &x, Vector &y); // Declaration of AXPY
+
+    /**
+     * @brief Dot product of two vectors
+     * @param x First vector
+     * @param y Second vector
+     * @return Sum of x[i]*y[i]
+     * @throws std::invalid_argument if sizes don't match
+     */
+    double dot(const Vector &x, const Vector &y); // Declaration of dot product
+} // End of namespace
@@ -0,0 +1,523 @@
+// orel8155@gmail.com
+#include "matview.hpp"    // Include the header file for SquareMatView
+#include "bareiss.hpp"    // Include for the exact determinant of integer matrices
+#include "kernels.hpp"    // Include for the row kernels and the blocked product
+#include "threadpool.hpp" // Include for the parallel row loops
+#include <algorithm>      // Include for std::copy and std::rotate
+#include <cmath>          // Include for fmod
+#include <cstdint>        // Include for uintptr_t
+#include <vector>         // Include for the remaining-column list
+
+namespace squaremat // Start of the squaremat namespace
+{
+    namespace // Helpers private to this translation unit
+    {
+        /**
+         * @brief Build a new matrix from the rows of a view
+         * @param view Source view
+         * @param op Callable op(in, out, n) that fills one output row from one input row
+         * @return New matrix of the view's size
+         */
+        template <typename RowOp>
+        SquareMat mapRows(const SquareMatView &view, RowOp op) // Row-wise unary helper
+        {
+            size_t n = view.getSize();   // View size
+            SquareMat result(n);         // Result from the default resource
+            double *out = result.data(); // Elements of the result (contiguous)
+            ThreadPool::instance().parallelFor(0, n, ThreadPool::rowGrain(n), [&](size_t first, size_t last) {
+                for (size_t i = first; i < last; i++) // Loop through the chunk's rows
+                {
+                    op(view[i], out + i * n, n); // Fill one row
+                }
+            });
+            return result; // Return the resulting matrix
+        }
+
+        /**
+         * @brief Build a new matrix from the rows of two views of the same size
+         * @param a Left operand
+         * @param b Right operand
+         * @param op Callable op(x, y, out, n) that fills one output row
+         * @return New matrix of the operands' size
+         * @throws std::invalid_argument if sizes don't match
+         */
+        template <typename RowOp>
+        SquareMat combineRows(const SquareMatView &a, const SquareMatView &b, RowOp op) // Row-wise binary helper
+        {
+            if (a.getSize() != b.getSize()) // Check if the views have compatible sizes
+            {
+                throw std::invalid_argument("Matrix sizes must match"); // Throw exception if sizes don't match
+            }
+            size_t n = a.getSize();      // View size
+            SquareMat result(n);         // Result from the default resource
+            double *out = result.data(); // Elements of the result (contiguous)
+            ThreadPool::instance().parallelFor(0, n, ThreadPool::rowGrain(n), [&](size_t first, size_t last) {
+                for (size_t i = first; i < last; i++) // Loop through the chunk's rows
+                {
+                    op(a[i], b[i], out + i * n, n); // Fill one row
+                }
+            });
+            return result; // Return the resulting matrix
+        }
+
+        /**
+         * @brief Check whether a view reads any element of a matrix's storage
+         * @param view View to check
+         * @param mat Matrix to check against
+         * @return true if the address ranges overlap
+         */
+        bool overlaps(const SquareMatView &view, const SquareMat &mat) // Aliasing check
+        {
+            size_t n = view.getSize();                                                       // View size
+            uintptr_t viewFirst = reinterpret_cast<uintptr_t>(view[0]);                      // First viewed element
+            uintptr_t viewLast = reinterpret_cast<uintptr_t>(view[n - 1] + n);               // One past the last viewed element
+            uintptr_t matFirst = reinterpret_cast<uintptr_t>(mat[0]);                        // First element of mat
+            uintptr_t matLast = reinterpret_cast<uintptr_t>(mat[0] + mat.getSize() * mat.getSize()); // One past the last element of mat
+            return viewFirst < matLast && matFirst < viewLast;                               // Ranges intersect
+        }
+
+        /**
+         * @brief Cofactor expansion of the minor made of rows row.. and the given columns
+         * @param view Matrix being expanded
+         * @param row First remaining row
+         * @param columns Remaining columns in ascending order (reordered and restored in place)
+         * @param count Number of remaining columns (equals the remaining rows)
+         * @param flops Running count of multiply-adds times two, plus the sign flips
+         * @return Determinant of the minor
+         */
+        double cofactor(const SquareMatView &view, size_t row, size_t *columns, size_t count, uint64_t &flops) // Recursive expansion
+        {
+            const double *top = view[row]; // First remaining row
+            if (count == 1)                // Base case: 1x1 minor
+            {
+                return top[columns[0]]; // Return the single element
+            }
+            if (count == 2) // Base case: 2x2 minor
+            {
+                const double *next = view[row + 1]; // Second remaining row
+                flops += 3;                         // Two products and a difference
+                return top[columns[0]] * next[columns[1]] - top[columns[1]] * next[columns[0]]; // Use 2x2 determinant formula
+            }
+
+            double det = 0;                    // Initialize determinant to zero
+            for (size_t p = 0; p < count; p++) // Loop through the remaining columns
+            {
+                double element = top[columns[p]]; // Element of the first remaining row
+                if (element == 0)                 // The whole term vanishes
+                {
+                    continue; // Skip its minor
+                }
+                std::rotate(columns, columns + p, columns + p + 1);                    // Move column p to the front, keeping the others in order
+                double minor = cofactor(view, row + 1, columns + 1, count - 1, flops); // Minor without this row and column
+                std::rotate(columns, columns + 1, columns + p + 1);                    // Restore the order
+                double sign = (p % 2 == 0) ? 1.0 : -1.0;                               // Determine sign based on column position
+                det += sign * element * minor;                                         // Add term to determinant
+                flops += 3;                                                            // Sign, product and sum
+            }
+            return det; // Return the calculated determinant
+        }
+    } // End of anonymous namespace
+
+    /**
+     * @brief Whole-matrix view constructor implementation
+     * @param mat Matrix to view
+     * @throws std::invalid_argument if mat has no elements (moved from)
+     */
+    SquareMatView::SquareMatView(const SquareMat &mat) : origin(nullptr), size(mat.getSize()), stride(mat.getSize()) // Constructor with initialization list
+    {
+        if (size == 0) // Moved-from matrices have no elements
+        {
+            throw std::invalid_argument("Size must be positive"); // Throw exception for invalid size
+        }
+        origin = mat[0]; // Storage is contiguous from row 0
+    }
+
+    /**
+     * @brief Block view constructor implementation
+     * @param mat Matrix to view
+     * @param row First row of the block
+     * @param col First column of the block
+     * @param size Size of the block
+     * @throws std::invalid_argument if size is not positive
+     * @throws std::out_of_range if the block does not fit in mat
+     */
+    SquareMatView::SquareMatView(const SquareMat &mat, size_t row, size_t col, size_t size) : SquareMatView(SquareMatView(mat).block(row, col, size)) // Delegate to the sub-block of the whole view
+    {
+    }
+
+    /**
+     * @brief External memory view constructor implementation
+     * @param data Element (0, 0)
+     * @param size Size of the view
+     * @param stride Distance in elements between the starts of consecutive rows
+     * @throws std::invalid_argument if data is null, size is not positive or stride < size
+     */
+    SquareMatView::SquareMatView(const double *data, size_t size, size_t stride) : origin(data), size(size), stride(stride) // Constructor with initialization list
+    {
+        if (size == 0) // Check if size is valid
+        {
+            throw std::invalid_argument("Size must be positive"); // Throw exception for invalid size
+        }
+        if (data == nullptr || stride < size) // Rows would be missing or overlap
+        {
+            throw std::invalid_argument("Stride must be at least the size"); // Throw exception for invalid layout
+        }
+    }
+
+    /**
+     * @brief Sub-block implementation
+     * @param row First row of the block
+     * @param col First column of the block
+     * @param size Size of the block
+     * @return View of the block (same stride)
+     * @throws std::invalid_argument if size is not positive
+     * @throws std::out_of_range if the block does not fit in this view
+     */
+    SquareMatView SquareMatView::block(size_t row, size_t col, size_t size) const // Sub-block definition
+    {
+        if (size == 0) // Check if size is valid
+        {
+            throw std::invalid_argument("Size must be positive"); // Throw exception for invalid size
+        }
+        if (row >= this->size || col >= this->size || size > this->size - row || size > this->size - col) // Block must fit
+        {
+            throw std::out_of_range("Index out of bounds"); // Throw exception for invalid block
+        }
+        return SquareMatView(origin + row * stride + col, size, stride); // Same stride, shifted origin
+    }
+
+    /**
+     * @brief Materialization implementation
+     * @param resource Memory resource for the copy (nullptr uses SquareMat::defaultResource())
+     * @return Matrix with the same elements
+     */
+    SquareMat SquareMatView::toSquareMat(std::pmr::memory_resource *resource) const // Materialization definition
+    {
+        SQUAREMAT_STAT_SCOPE(Copy, 2 * size * size, 0); // Count the call
+        SQUAREMAT_TRACE_SCOPE("copy", "operator");      // Timeline event
+        SquareMat result(size, resource);               // Zero matrix of the view's size
+        double *out = result.data();                    // Elements of the result (contiguous)
+        ThreadPool::instance().parallelFor(0, size, ThreadPool::rowGrain(size), [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; i++) // Loop through the chunk's rows
+            {
+                std::copy(origin + i * stride, origin + i * stride + size, out + i * size); // Copy one row
+            }
+        });
+        return result; // Return the copy
+    }
+
+    /**
+     * @brief Reduction implementation
+     * @param mode Accuracy mode
+     * @return Sum of all viewed elements
+     */
+    double SquareMatView::sum(SquareMat::Summation mode) const // Reduction definition
+    {
+        SQUAREMAT_TRACE_SCOPE("sum", "operator"); // Timeline event
+        if (mode == SquareMat::Summation::Compensated) // Carry every row's compensation to the end
+        {
+            double s = 0, c = 0;              // Combined sum and compensation
+            for (size_t i = 0; i < size; i++) // Loop through rows in order
+            {
+                double rowSum = 0, rowComp = 0;                                  // Row result
+                kernels::compensatedSum(origin + i * stride, size, rowSum, rowComp); // Row kernel
+                kernels::neumaierAdd(s, c, rowSum);                              // Row sum
+                c += rowComp;                                                    // Row compensation
+            }
+            return s + c; // Apply the compensation
+        }
+        std::vector<double> rows(size);   // Per-row results
+        for (size_t i = 0; i < size; i++) // Loop through rows
+        {
+            const double *start = origin + i * stride;                                                                   // First element of the row
+            rows[i] = mode == SquareMat::Summation::Pairwise ? kernels::pairwiseSum(start, size) : kernels::sum(start, size); // Row kernel
+        }
+        return mode == SquareMat::Summation::Pairwise ? kernels::pairwiseSum(rows.data(), size) : kernels::sum(rows.data(), size); // Combine in a fixed order
+    }
+
+    /**
+     * @brief Unary minus operator implementation
+     * @return New matrix with negated elements
+     */
+    SquareMat SquareMatView::operator-() const // Unary minus operator definition
+    {
+        SQUAREMAT_STAT_SCOPE(Negate, 2 * size * size, size * size); // Count the call
+        SQUAREMAT_TRACE_SCOPE("unary -", "operator");               // Timeline event
+        return mapRows(*this, [](const double *in, double *out, size_t n) {
+            for (size_t j = 0; j < n; j++) // Loop through the row
+            {
+                out[j] = -in[j]; // Negate each element
+            }
+        });
+    }
+
+    /**
+     * @brief Scalar multiplication operator implementation
+     * @param scalar Value to multiply elements by
+     * @return New matrix with scaled elements
+     */
+    SquareMat SquareMatView::operator*(double scalar) const // Scalar multiplication operator definition
+    {
+        SQUAREMAT_STAT_SCOPE(ScalarMultiply, 2 * size * size, size * size); // Count the call
+        SQUAREMAT_TRACE_SCOPE("* scalar", "operator");                      // Timeline event
+        return mapRows(*this, [scalar](const double *in, double *out, size_t n) {
+            for (size_t j = 0; j < n; j++) // Loop through the row
+            {
+                out[j] = in[j] * scalar; // Multiply each element by scalar
+            }
+        });
+    }
+
+    /**
+     * @brief Division operator implementation
+     * @param scalar Value to divide elements by
+     * @return New matrix with divided elements
+     * @throws std::invalid_argument if scalar is zero
+     */
+    SquareMat SquareMatView::operator/(double scalar) const // Division operator definition
+    {
+        SQUAREMAT_STAT_SCOPE(Divide, 2 * size * size, size * size); // Count the call
+        SQUAREMAT_TRACE_SCOPE("/", "operator");                     // Timeline event
+        if (scalar == 0) // Check if scalar is zero
+        {
+            throw std::invalid_argument("Division by zero"); // Throw exception for division by zero
+        }
+        return mapRows(*this, [scalar](const double *in, double *out, size_t n) {
+            for (size_t j = 0; j < n; j++) // Loop through the row
+            {
+                out[j] = in[j] / scalar; // Divide each element by scalar
+            }
+        });
+    }
+
+    /**
+     * @brief Modulo operator implementation
+     * @param scalar Value to compute modulo with
+     * @return New matrix with elements modulo scalar
+     * @throws std::invalid_argument if scalar is zero
+     */
+    SquareMat SquareMatView::operator%(int scalar) const // Modulo operator definition
+    {
+        SQUAREMAT_STAT_SCOPE(Modulo, 2 * size * size, size * size); // Count the call
+        SQUAREMAT_TRACE_SCOPE("% scalar", "operator");              // Timeline event
+        if (scalar == 0) // Check if scalar is zero
+        {
+            throw std::invalid_argument("Scalar must be non-zero"); // Throw exception if scalar is zero
+        }
+        return mapRows(*this, [scalar](const double *in, double *out, size_t n) {
+            for (size_t j = 0; j < n; j++) // Loop through the row
+            {
+                out[j] = fmod(in[j], scalar); // Apply modulo to each element
+            }
+        });
+    }
+
+    /**
+     * @brief Power operator implementation
+     * @param power The exponent to raise the view to
+     * @return New matrix containing the result
+     * @throws std::invalid_argument if power is negative
+     */
+    SquareMat SquareMatView::operator^(int power) const // Power operator definition
+    {
+        if (power < 0) // Check if power is negative
+        {
+            throw std::invalid_argument("Power must be non-negative"); // Throw exception if power is negative
+        }
+        return toSquareMat() ^ power; // One copy, then the structured SquareMat power
+    }
+
+    /**
+     * @brief Transpose operator implementation
+     * @return New matrix that is the transpose of the view
+     */
+    SquareMat SquareMatView::operator~() const // Transpose operator definition
+    {
+        SQUAREMAT_STAT_SCOPE(Transpose, 2 * size * size, 0); // Count the call
+        SQUAREMAT_TRACE_SCOPE("~", "operator");              // Timeline event
+        SquareMat result(size);                              // Result from the default resource
+        double *out = result.data();                         // Elements of the result (contiguous)
+        ThreadPool::instance().parallelFor(0, size, ThreadPool::rowGrain(size), [&](size_t first, size_t last) {
+            for (size_t j = first; j < last; j++) // Loop through the chunk's output rows
+            {
+                for (size_t i = 0; i < size; i++) // Loop through the column of the view
+                {
+                    out[j * size + i] = origin[i * stride + j]; // Swap row and column indices
+                }
+            }
+        });
+        return result; // Return the transposed matrix
+    }
+
+    /**
+     * @brief Determinant operator implementation
+     * @return Determinant of the viewed block
+     */
+    double SquareMatView::operator!() const // Determinant operator definition
+    {
+        SQUAREMAT_STAT_SCOPE(Determinant, size * size, 0); // Count the call
+        SQUAREMAT_TRACE_SCOPE("!", "operator");            // Timeline event
+        if (isIntegerValued(*this))                        // Exact O(n^3) path
+        {
+            return determinantExact(*this).toDouble(); // Correctly rounded exact determinant
+        }
+        std::vector<size_t> columns(size);                 // All columns remain at the top level
+        for (size_t j = 0; j < size; j++)                  // Loop through columns
+        {
+            columns[j] = j; // Ascending order
+        }
+        uint64_t flops = 0;                                            // Work of the whole expansion
+        double det = cofactor(*this, 0, columns.data(), size, flops); // Expand along the first row
+        SQUAREMAT_STAT_FLOPS(flops);                                   // Count the expansion's work
+        (void)flops;                                                   // Unused when counters are compiled out
+        return det;                                                    // Return the calculated determinant
+    }
+
+    /**
+     * @brief Addition operator implementation
+     * @param a Left operand
+     * @param b Right operand
+     * @return New matrix containing the sum
+     * @throws std::invalid_argument if sizes don't match
+     */
+    SquareMat operator+(const SquareMatView &a, const SquareMatView &b) // Addition operator definition
+    {
+        SQUAREMAT_STAT_SCOPE(Add, 3 * a.size * a.size, a.size * a.size); // Count the call
+        SQUAREMAT_TRACE_SCOPE("+", "operator");                          // Timeline event
+        return combineRows(a, b, [](const double *x, const double *y, double *out, size_t n) {
+            for (size_t j = 0; j < n; j++) // Loop through the row
+            {
+                out[j] = x[j] + y[j]; // Add corresponding elements
+            }
+        });
+    }
+
+    /**
+     * @brief Subtraction operator implementation
+     * @param a Left operand
+     * @param b Right operand
+     * @return New matrix containing the difference
+     * @throws std::invalid_argument if sizes don't match
+     */
+    SquareMat operator-(const SquareMatView &a, const SquareMatView &b) // Subtraction operator definition
+    {
+        SQUAREMAT_STAT_SCOPE(Subtract, 3 * a.size * a.size, a.size * a.size); // Count the call
+        SQUAREMAT_TRACE_SCOPE("-", "operator");                               // Timeline event
+        return combineRows(a, b, [](const double *x, const double *y, double *out, size_t n) {
+            for (size_t j = 0; j < n; j++) // Loop through the row
+            {
+                out[j] = x[j] - y[j]; // Subtract corresponding elements
+            }
+        });
+    }
+
+    /**
+     * @brief Matrix multiplication operator implementation
+     * @param a Left factor
+     * @param b Right factor
+     * @return New matrix containing a * b
+     * @throws std::invalid_argument if sizes don't match
+     */
+    SquareMat operator*(const SquareMatView &a, const SquareMatView &b) // Matrix multiplication operator definition
+    {
+        SQUAREMAT_STAT_SCOPE(Multiply, 3 * a.size * a.size, 0); // Count the call (gemm counts the flops)
+        SQUAREMAT_TRACE_SCOPE("*", "operator");                 // Timeline event
+        if (a.size != b.size) // Check if the views have compatible sizes
+        {
+            throw std::invalid_argument("Matrix sizes must match"); // Throw exception if sizes don't match
+        }
+        SquareMat result(a.size);      // Zero result from the default resource
+        gemm(1.0, a, b, 0.0, result); // Blocked kernel over the strided factors
+        return result;                 // Return the resulting matrix
+    }
+
+    /**
+     * @brief Element-wise multiplication operator implementation
+     * @param a Left operand
+     * @param b Right operand
+     * @return New matrix with element-wise products
+     * @throws std::invalid_argument if sizes don't match
+     */
+    SquareMat operator%(const SquareMatView &a, const SquareMatView &b) // Element-wise multiplication operator definition
+    {
+        SQUAREMAT_STAT_SCOPE(ElementwiseMultiply, 3 * a.size * a.size, a.size * a.size); // Count the call
+        SQUAREMAT_TRACE_SCOPE("% matrix", "operator");                                   // Timeline event
+        return combineRows(a, b, [](const double *x, const double *y, double *out, size_t n) {
+            for (size_t j = 0; j < n; j++) // Loop through the row
+            {
+                out[j] = x[j] * y[j]; // Multiply corresponding elements
+            }
+        });
+    }
+
+    /**
+     * @brief Output stream operator implementation
+     * @param os Output stream to write to
+     * @param view View to output
+     * @return Reference to the output stream
+     */
+    std::ostream &operator<<(std::ostream &os, const SquareMatView &view) // Output stream operator definition
+    {
+        for (size_t i = 0; i < view.size; i++) // Loop through rows
+        {
+            for (size_t j = 0; j < view.size; j++) // Loop through columns
+            {
+                os << view.origin[i * view.stride + j] << "\t"; // Output element with tab separator
+            }
+            os << std::endl; // End line after each row
+        }
+        return os; // Return reference to output stream
+    }
+
+    /**
+     * @brief View GEMM implementation
+     * @param alpha Scale of the product
+     * @param a Left factor
+     * @param b Right factor
+     * @param beta Scale of the previous contents of c (0 ignores them)
+     * @param c Matrix that receives the result
+     * @throws std::invalid_argument if sizes don't match
+     */
+    void gemm(double alpha, const SquareMatView &a, const SquareMatView &b, double beta, SquareMat &c) // View GEMM definition
+    {
+        size_t n = c.getSize(); // Matrix size
+        SQUAREMAT_STAT_SCOPE(Gemm, 3 * n * n, (beta == 1 ? 0 : n * n) + (alpha == 0 ? 0 : 2 * n * n * n)); // Count the call (general factors)
+        SQUAREMAT_TRACE_SCOPE("gemm", "operator"); // Timeline event
+        if (a.getSize() != n || b.getSize() != n) // Check if sizes are compatible
+        {
+            throw std::invalid_argument("Matrix sizes must match"); // Throw exception if sizes don't match
+        }
+        double *out = c.data();                         // Elements of c (private after a copy-on-write check)
+        if (alpha != 0 && (overlaps(a, c) || overlaps(b, c))) // The kernel would read rows it already overwrote
+        {
+            SquareMat product = a * b; // One temporary for the aliased case
+            const double *p = product.data();         // Elements of the product
+            ThreadPool::instance().parallelFor(0, n, ThreadPool::rowGrain(n), [&](size_t first, size_t last) {
+                for (size_t k = first * n; k < last * n; k++) // Loop through the chunk's elements
+                {
+                    out[k] = (beta == 0 ? 0 : beta * out[k]) + alpha * p[k]; // Combine both terms
+                }
+            });
+            return; // Done
+        }
+        const double *x = a[0]; // Element (0, 0) of the left factor
+        const double *y = b[0]; // Element (0, 0) of the right factor
+        ThreadPool::instance().parallelFor(0, n, ThreadPool::rowGrain(n), [&](size_t first, size_t last) {
+            if (beta == 0) // Overwrite without reading
+            {
+                std::fill(out + first * n, out + last * n, 0.0); // Clear the chunk
+            }
+            else if (beta != 1) // Scale the chunk while it is about to be accumulated into
+            {
+                for (size_t k = first * n; k < last * n; k++) // Loop through the chunk's elements
+                {
+                    out[k] *= beta; // Scale the previous contents
+                }
+            }
+            if (alpha != 0) // Product contributes
+            {
+                kernels::productRows(alpha, x, a.getStride(), y, b.getStride(), out, n, n, 0, 0, first, last); // Accumulate the chunk's rows
+            }
+        });
+    }
+} // End of squaremat namespace
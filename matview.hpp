@@ -0,0 +1,285 @@
+// orel8155@gmail.com
+#pragma once             // Ensures the header file is included only once
+#include <iostream>      // Include for input/output operations
+#include <memory_resource> // Include for the resource of materialized copies
+#include <stdexcept>     // Include for standard exceptions
+#include "squaremat.hpp" // Include for the viewed matrices and operator results
+
+namespace squaremat // Start of namespace definition
+{
+    /**
+     * @class SquareMatView
+     * @brief A read-only, non-owning square window into a SquareMat or external memory
+     *
+     * Row i of the view starts stride elements after row i-1 and its elements are
+     * contiguous, so any square block of a row-major matrix is a view without copying.
+     * Every SquareMat converts implicitly, so functions taking a view accept both.
+     * Operators on views return new SquareMat results, like the SquareMat operators.
+     *
+     * A view does not keep the elements alive: it is valid until the viewed matrix is
+     * destroyed, assigned or written (a write may move shared storage, see copy-on-write).
+     */
+    class SquareMatView // Class definition for the matrix view
+    {
+    private:
+        const double *origin; ///< Element (0, 0) of the view
+        size_t size;          ///< Size of the view (number of rows/columns)
+        size_t stride;        ///< Distance in elements between the starts of consecutive rows
+
+    public:
+        /**
+         * @brief View of a whole matrix
+         * @param mat Matrix to view
+         * @throws std::invalid_argument if mat has no elements (moved from)
+         */
+        SquareMatView(const SquareMat &mat); // Declaration of the implicit conversion
+
+        /**
+         * @brief View of the size x size block of mat starting at (row, col)
+         * @param mat Matrix to view
+         * @param row First row of the block
+         * @param col First column of the block
+         * @param size Size of the block
+         * @throws std::invalid_argument if size is not positive
+         * @throws std::out_of_range if the block does not fit in mat
+         */
+        SquareMatView(const SquareMat &mat, size_t row, size_t col, size_t size); // Declaration of the block constructor
+
+        /**
+         * @brief View of external row-major memory
+         * @param data Element (0, 0)
+         * @param size Size of the view
+         * @param stride Distance in elements between the starts of consecutive rows
+         * @throws std::invalid_argument if data is null, size is not positive or stride < size
+         */
+        SquareMatView(const double *data, size_t size, size_t stride); // Declaration of the external memory constructor
+
+        /**
+         * @brief Get the size of the view
+         * @return Size of the view (number of rows/columns)
+         */
+        size_t getSize() const { return size; } // Getter method for the view size
+
+        /**
+         * @brief Get the row stride
+         * @return Distance in elements between the starts of consecutive rows
+         */
+        size_t getStride() const { return stride; } // Getter method for the row stride
+
+        /**
+         * @brief Array subscript operator
+         * @param index Row index
+         * @return Pointer to the first element of the row
+         * @throws std::out_of_range if index is out of bounds
+         */
+        const double *operator[](size_t index) const // Subscript operator overload
+        {
+            if (index >= size) // Check if index is out of bounds
+            {
+                throw std::out_of_range("Index out of bounds"); // Throw exception for invalid index
+            }
+            return origin + index * stride; // Return pointer to the row
+        }
+
+        /**
+         * @brief Sub-block of this view
+         * @param row First row of the block
+         * @param col First column of the block
+         * @param size Size of the block
+         * @return View of the block (same stride)
+         * @throws std::invalid_argument if size is not positive
+         * @throws std::out_of_range if the block does not fit in this view
+         */
+        SquareMatView block(size_t row, size_t col, size_t size) const; // Declaration of the sub-block
+
+        /**
+         * @brief Copy the viewed elements into a new matrix
+         * @param resource Memory resource for the copy (nullptr uses SquareMat::defaultResource())
+         * @return Matrix with the same elements
+         */
+        SquareMat toSquareMat(std::pmr::memory_resource *resource = nullptr) const; // Declaration of the materialization
+
+        /**
+         * @brief Calculate sum of all elements in the view
+         *
+         * Rows are reduced in order with the kernel of the selected mode; the result can
+         * differ from SquareMat::sum() of a copy in the last bits, since that one sums
+         * fixed blocks of the contiguous storage.
+         * @param mode Accuracy mode
+         * @return Sum of all viewed elements
+         */
+        double sum(SquareMat::Summation mode = SquareMat::Summation::Compensated) const; // Declaration of the reduction
+
+        /**
+         * @brief Unary minus operator
+         * @return New matrix with negated elements
+         */
+        SquareMat operator-() const; // Declaration of unary minus operator
+
+        /**
+         * @brief Scalar multiplication operator
+         * @param scalar Value to multiply elements by
+         * @return New matrix with scaled elements
+         */
+        SquareMat operator*(double scalar) const; // Declaration of scalar multiplication operator
+
+        /**
+         * @brief Division operator
+         * @param scalar Value to divide elements by
+         * @return New matrix with divided elements
+         * @throws std::invalid_argument if scalar is zero
+         */
+        SquareMat operator/(double scalar) const; // Declaration of division operator
+
+        /**
+         * @brief Modulo operator with scalar
+         * @param scalar Value to compute modulo with
+         * @return New matrix with elements modulo scalar
+         * @throws std::invalid_argument if scalar is zero
+         */
+        SquareMat operator%(int scalar) const; // Declaration of modulo operator
+
+        /**
+         * @brief Power operator
+         *
+         * The view is copied once and raised with SquareMat::operator^.
+         * @param power The exponent to raise the view to
+         * @return New matrix containing the result
+         * @throws std::invalid_argument if power is negative
+         */
+        SquareMat operator^(int power) const; // Declaration of power operator
+
+        /**
+         * @brief Transpose operator
+         * @return New matrix that is the transpose of the view
+         */
+        SquareMat operator~() const; // Declaration of transpose operator
+
+        /**
+         * @brief Determinant operator
+         *
+         * Integer-valued blocks (see isIntegerValued) use the exact Bareiss elimination of
+         * determinantExact and return its correctly rounded value. Other blocks use cofactor
+         * expansion along the first row; minors are addressed through the view and a list
+         * of the remaining columns, so the expansion allocates nothing per minor, and zero
+         * elements skip their minor.
+         * @return Determinant of the viewed block
+         */
+        double operator!() const; // Declaration of determinant operator
+
+        /**
+         * @brief Addition operator
+         * @param a Left operand
+         * @param b Right operand
+         * @return New matrix containing the sum
+         * @throws std::invalid_argument if sizes don't match
+         */
+        friend SquareMat operator+(const SquareMatView &a, const SquareMatView &b); // Declaration of friend addition operator
+
+        /**
+         * @brief Subtraction operator
+         * @param a Left operand
+         * @param b Right operand
+         * @return New matrix containing the difference
+         * @throws std::invalid_argument if sizes don't match
+         */
+        friend SquareMat operator-(const SquareMatView &a, const SquareMatView &b); // Declaration of friend subtraction operator
+
+        /**
+         * @brief Matrix multiplication operator (blocked kernel read in place)
+         * @param a Left factor
+         * @param b Right factor
+         * @return New matrix containing a * b
+         * @throws std::invalid_argument if sizes don't match
+         */
+        friend SquareMat operator*(const SquareMatView &a, const SquareMatView &b); // Declaration of friend matrix multiplication operator
+
+        /**
+         * @brief Scalar multiplication operator (scalar on the left)
+         * @param scalar Value to multiply elements by
+         * @param view Viewed matrix
+         * @return New matrix with scaled elements
+         */
+        friend SquareMat operator*(double scalar, const SquareMatView &view) { return view * scalar; } // Commutative scalar product
+
+        /**
+         * @brief Element-wise multiplication operator
+         * @param a Left operand
+         * @param b Right operand
+         * @return New matrix with element-wise products
+         * @throws std::invalid_argument if sizes don't match
+         */
+        friend SquareMat operator%(const SquareMatView &a, const SquareMatView &b); // Declaration of friend element-wise multiplication operator
+
+        /**
+         * @brief Equality comparison operator (same rule as SquareMat: equal sums)
+         * @param a Left operand
+         * @param b Right operand
+         * @return true if the sums are equal
+         */
+        friend bool operator==(const SquareMatView &a, const SquareMatView &b) { return a.sum() == b.sum(); } // Compare sums
+
+        /**
+         * @brief Inequality comparison operator
+         * @param a Left operand
+         * @param b Right operand
+         * @return true if the sums differ
+         */
+        friend bool operator!=(const SquareMatView &a, const SquareMatView &b) { return !(a.sum() == b.sum()); } // Negate equality comparison
+
+        /**
+         * @brief Greater than comparison operator
+         * @param a Left operand
+         * @param b Right operand
+         * @return true if a has the greater sum
+         */
+        friend bool operator>(const SquareMatView &a, const SquareMatView &b) { return a.sum() > b.sum(); } // Compare sums
+
+        /**
+         * @brief Less than comparison operator
+         * @param a Left operand
+         * @param b Right operand
+         * @return true if a has the smaller sum
+         */
+        friend bool operator<(const SquareMatView &a, const SquareMatView &b) { return a.sum() < b.sum(); } // Compare sums
+
+        /**
+         * @brief Greater than or equal comparison operator
+         * @param a Left operand
+         * @param b Right operand
+         * @return true if a's sum is at least b's
+         */
+        friend bool operator>=(const SquareMatView &a, const SquareMatView &b) { return a.sum() >= b.sum(); } // Compare sums
+
+        /**
+         * @brief Less than or equal comparison operator
+         * @param a Left operand
+         * @param b Right operand
+         * @return true if a's sum is at most b's
+         */
+        friend bool operator<=(const SquareMatView &a, const SquareMatView &b) { return a.sum() <= b.sum(); } // Compare sums
+
+        /**
+         * @brief Output stream operator (same format as SquareMat)
+         * @param os Output stream to write to
+         * @param view View to output
+         * @return Reference to the output stream
+         */
+        friend std::ostream &operator<<(std::ostream &os, const SquareMatView &view); // Declaration of friend output stream operator
+    };
+
+    /**
+     * @brief GEMM on views: c = alpha * a * b + beta * c
+     *
+     * The factors are read in place through their strides with the same blocked kernel
+     * as the SquareMat overload, so blocks of large matrices need no copies. Factors that
+     * overlap c's storage are multiplied into a temporary first.
+     * @param alpha Scale of the product
+     * @param a Left factor
+     * @param b Right factor
+     * @param beta Scale of the previous contents of c (0 ignores them)
+     * @param c Matrix that receives the result
+     * @throws std::invalid_argument if sizes don't match
+     */
+    void gemm(double alpha, const SquareMatView &a, const SquareMatView &b, double beta, SquareMat &c); // Declaration of the view GEMM
+} // End of namespace
@@ -0,0 +1,212 @@
+// orel8155@gmail.com
+#include "mixed.hpp"      // Include the header file for the mixed-precision kernels
+#include "kernels.hpp"    // Include for the AXPY and LU kernels
+#include "threadpool.hpp" // Include for splitting rows across threads
+#include <algorithm>      // Include for std::min, std::max and std::swap_ranges
+#include <cfloat>         // Include for FLT_MAX
+#include <cmath>          // Include for std::fabs and std::isfinite
+#include <stdexcept>      // Include for standard exceptions
+#include <utility>        // Include for std::as_const
+
+namespace squaremat // Start of the squaremat namespace
+{
+    namespace // Helpers private to this file
+    {
+        const size_t MixedBlockK = 128; ///< Terms summed in float before they are added in double
+        const size_t MixedBlockJ = 512; ///< Columns per block (the float accumulators stay in L1)
+
+        /**
+         * @brief Infinity norm of a vector
+         * @param x Vector
+         * @return Largest absolute element
+         */
+        double maxNorm(const Vector &x) // Vector norm
+        {
+            double norm = 0;                         // Running maximum
+            for (size_t i = 0; i < x.getSize(); i++) // Loop through elements
+            {
+                norm = std::max(norm, std::fabs(x[i])); // Keep the largest
+            }
+            return norm; // Return the norm
+        }
+    } // End of the helper namespace
+
+    /**
+     * @brief Mixed-precision product implementation
+     * @param a Left factor
+     * @param b Right factor
+     * @return New matrix containing approximately a * b
+     * @throws std::invalid_argument if matrix sizes don't match
+     */
+    SquareMat multiplyMixed(const SquareMat &a, const SquareMat &b) // Mixed-precision product definition
+    {
+        if (a.getSize() != b.getSize()) // Check if matrix sizes are compatible
+        {
+            throw std::invalid_argument("Matrix sizes must match"); // Throw exception if sizes don't match
+        }
+        size_t n = a.getSize();                   // Matrix size
+        std::vector<float> left(n * n), right(n * n); // Rounded operands
+        for (size_t i = 0; i < n; i++)             // Loop through rows
+        {
+            for (size_t j = 0; j < n; j++) // Loop through columns
+            {
+                left[i * n + j] = static_cast<float>(a[i][j]);  // Round the left operand
+                right[i * n + j] = static_cast<float>(b[i][j]); // Round the right operand
+            }
+        }
+        SquareMat result(n);          // Zero matrix receiving the double-precision sums
+        double *sums = result.data(); // Contiguous elements of the result, taken once
+        ThreadPool::instance().parallelFor(0, n, ThreadPool::rowGrain(n), [&](size_t first, size_t last) {
+            float partial[MixedBlockJ];                  // Float accumulators of one block
+            for (size_t kk = 0; kk < n; kk += MixedBlockK) // Blocks of terms
+            {
+                size_t kEnd = std::min(kk + MixedBlockK, n);     // End of the term block
+                for (size_t jj = 0; jj < n; jj += MixedBlockJ)   // Blocks of columns
+                {
+                    size_t width = std::min(jj + MixedBlockJ, n) - jj; // Columns in the block
+                    for (size_t i = first; i < last; i++)              // Rows of the chunk
+                    {
+                        std::fill(partial, partial + width, 0.0f); // Clear the accumulators
+                        for (size_t k = kk; k < kEnd; k++)         // Terms of the block
+                        {
+                            kernels::axpy(left[i * n + k], right.data() + k * n + jj, partial, width); // Single-precision row update
+                        }
+                        double *out = sums + i * n + jj;   // Row segment of the result
+                        for (size_t j = 0; j < width; j++) // Add the block in double
+                        {
+                            out[j] += partial[j]; // Widen and accumulate
+                        }
+                    }
+                }
+            }
+        });
+        return result; // Return the product
+    }
+
+    /**
+     * @brief Double-precision solve implementation
+     * @param mat Matrix A
+     * @param rhs Right-hand side b
+     * @return Solution x
+     * @throws std::invalid_argument if the sizes don't match or the matrix is singular
+     */
+    Vector solve(const SquareMat &mat, const Vector &rhs) // Double-precision solve definition
+    {
+        size_t n = mat.getSize(); // Matrix size
+        if (rhs.getSize() != n)   // Check if sizes are compatible
+        {
+            throw std::invalid_argument("Vector size must match matrix size"); // Throw exception if sizes don't match
+        }
+        std::vector<double> lu(std::as_const(mat).data(), std::as_const(mat).data() + n * n); // Working copy (storage is contiguous)
+        std::vector<size_t> pivots;                     // Row interchanges
+        if (!kernels::luFactorize(lu, pivots, n))       // Eliminate
+        {
+            throw std::invalid_argument("Matrix is singular"); // Throw exception for a zero pivot
+        }
+        Vector x(rhs);                          // Start from the right-hand side
+        kernels::luSubstitute(lu, pivots, n, x.values()); // Solve in place
+        return x;                               // Return the solution
+    }
+
+    /**
+     * @brief Constructor implementation
+     * @param mat Matrix A
+     * @param tolerance Target normwise backward error
+     * @param maxIterations Refinement steps before falling back to double precision
+     * @throws std::invalid_argument if tolerance is not positive
+     */
+    MixedSolver::MixedSolver(const SquareMat &mat, double tolerance, size_t maxIterations)
+        : mat(mat), tolerance(tolerance), maxIterations(maxIterations), norm(0), lowValid(true), iterations(0), fellBack(false) // Constructor definition
+    {
+        if (!(tolerance > 0)) // Check if tolerance is valid
+        {
+            throw std::invalid_argument("Tolerance must be positive"); // Throw exception for invalid tolerance
+        }
+        size_t n = mat.getSize();   // Matrix size
+        lowFactors.resize(n * n);   // Single-precision copy
+        for (size_t i = 0; i < n; i++) // Loop through rows
+        {
+            double rowSum = 0;             // Absolute row sum
+            for (size_t j = 0; j < n; j++) // Loop through columns
+            {
+                double value = mat[i][j];                        // Element
+                rowSum += std::fabs(value);                      // Accumulate the row norm
+                lowValid = lowValid && std::fabs(value) <= FLT_MAX; // Must not overflow float
+                lowFactors[i * n + j] = static_cast<float>(value); // Round to float
+            }
+            norm = std::max(norm, rowSum); // Keep the largest row sum
+        }
+        lowValid = lowValid && kernels::luFactorize(lowFactors, lowPivots, n); // The O(n^3) work, in float
+    }
+
+    /**
+     * @brief Fallback solve implementation
+     * @param rhs Right-hand side
+     * @return Solution
+     * @throws std::invalid_argument if the matrix is singular
+     */
+    Vector MixedSolver::solveHigh(const Vector &rhs) // Fallback solve definition
+    {
+        size_t n = mat.getSize(); // Matrix size
+        if (highFactors.empty())  // First fallback
+        {
+            std::vector<double> lu(std::as_const(mat).data(), std::as_const(mat).data() + n * n); // Working copy
+            if (!kernels::luFactorize(lu, highPivots, n))   // Eliminate in double
+            {
+                throw std::invalid_argument("Matrix is singular"); // Throw exception for a zero pivot
+            }
+            highFactors.swap(lu); // Keep the factors for later solves
+        }
+        fellBack = true;                                // Record the path taken
+        Vector x(rhs);                                  // Start from the right-hand side
+        kernels::luSubstitute(highFactors, highPivots, n, x.values()); // Solve in place
+        return x;                                       // Return the solution
+    }
+
+    /**
+     * @brief Refined solve implementation
+     * @param rhs Right-hand side b
+     * @return Solution x meeting the tolerance
+     * @throws std::invalid_argument if the sizes don't match or the matrix is singular
+     */
+    Vector MixedSolver::solve(const Vector &rhs) // Refined solve definition
+    {
+        size_t n = mat.getSize(); // Matrix size
+        if (rhs.getSize() != n)   // Check if sizes are compatible
+        {
+            throw std::invalid_argument("Vector size must match matrix size"); // Throw exception if sizes don't match
+        }
+        iterations = 0;                       // Fresh count
+        fellBack = false;                     // Fresh path
+        if (!lowValid || !highFactors.empty()) // Float LU unusable, or refinement already failed once
+        {
+            return solveHigh(rhs); // Double precision directly
+        }
+        Vector x(rhs);                                    // Start from the right-hand side
+        kernels::luSubstitute(lowFactors, lowPivots, n, x.values()); // Single-precision first solution
+        Vector residual(n);                               // b - A x
+        double rhsNorm = maxNorm(rhs);                    // ||b||
+        double previous = HUGE_VAL;                       // Backward error of the previous step
+        for (;;)                                          // Refine until the tolerance is met
+        {
+            residual = rhs;                             // Start from b
+            gemv(-1, mat, x, 1, residual);              // Residual in double precision
+            double scale = norm * maxNorm(x) + rhsNorm; // Normalization of the backward error
+            double error = maxNorm(residual);           // ||b - A x||
+            if (error <= tolerance * scale)             // Accurate enough
+            {
+                return x; // Return the refined solution
+            }
+            error /= scale;                                         // Backward error
+            if (iterations == maxIterations || !(error < previous / 2)) // Out of steps, stagnating or not finite
+            {
+                break; // Give up on single precision
+            }
+            previous = error;                                         // Remember the progress
+            kernels::luSubstitute(lowFactors, lowPivots, n, residual.values()); // Correction from the float factors
+            axpy(1, residual, x);                                     // Apply it
+            iterations++;                                             // Count the step
+        }
+        return solveHigh(rhs); // Double-precision fallback
+    }
+} // End of the squaremat namespace
@@ -0,0 +1,97 @@
+// orel8155@gmail.com
+#pragma once             // Ensures the header file is included only once
+#include <cstddef>       // Include for size_t
+#include <vector>        // Include for factor storage
+#include "squaremat.hpp" // Include for the matrix operands
+#include "matvec.hpp"    // Include for right-hand sides and solutions
+
+namespace squaremat // Start of namespace definition
+{
+    /**
+     * @brief Matrix product computed with single-precision kernels
+     *
+     * The operands are rounded to float, which halves the memory traffic and doubles
+     * the SIMD width of the inner loop. Each cache block of up to 128 terms is summed
+     * in float and the blocks are summed in double, so the error per element stays
+     * about 2^-24 * 130 * (|A| |B|)_ij instead of growing with n.
+     * @param a Left factor
+     * @param b Right factor
+     * @return New matrix containing approximately a * b
+     * @throws std::invalid_argument if matrix sizes don't match
+     */
+    SquareMat multiplyMixed(const SquareMat &a, const SquareMat &b); // Declaration of the mixed-precision product
+
+    /**
+     * @brief Solve A x = b with a double-precision LU factorization with partial pivoting
+     * @param mat Matrix A
+     * @param rhs Right-hand side b
+     * @return Solution x
+     * @throws std::invalid_argument if the sizes don't match or the matrix is singular
+     */
+    Vector solve(const SquareMat &mat, const Vector &rhs); // Declaration of the double-precision solve
+
+    /**
+     * @class MixedSolver
+     * @brief Repeated solves with a single-precision LU and double-precision iterative refinement
+     *
+     * The O(n^3) factorization runs in float. Each solve then refines the solution with
+     * residuals computed in double until the normwise backward error
+     * ||b - A x|| / (||A|| ||x|| + ||b||) (infinity norms) is at most the tolerance. If
+     * that does not happen within the iteration limit (A too ill-conditioned for float),
+     * or if A does not fit in float, the solver falls back to a double LU once and uses
+     * it for the remaining solves.
+     */
+    class MixedSolver // Class definition for the mixed-precision solver
+    {
+    private:
+        SquareMat mat;                     ///< Copy of A for the double-precision residuals
+        double tolerance;                  ///< Target normwise backward error
+        size_t maxIterations;              ///< Refinement steps before falling back
+        double norm;                       ///< ||A|| (infinity norm)
+        std::vector<float> lowFactors;     ///< Single-precision L and U (row-major, unit L implied)
+        std::vector<size_t> lowPivots;     ///< Row interchanges of the single-precision LU
+        bool lowValid;                     ///< The single-precision LU exists and is non-singular
+        std::vector<double> highFactors;   ///< Double-precision L and U, computed on the first fallback
+        std::vector<size_t> highPivots;    ///< Row interchanges of the double-precision LU
+        size_t iterations;                 ///< Refinement steps of the last solve
+        bool fellBack;                     ///< The last solve used the double-precision LU
+
+        /**
+         * @brief Solve with the double-precision LU, factorizing on first use
+         * @param rhs Right-hand side
+         * @return Solution
+         * @throws std::invalid_argument if the matrix is singular
+         */
+        Vector solveHigh(const Vector &rhs); // Declaration of the fallback solve
+
+    public:
+        /**
+         * @brief Constructor that factorizes A in single precision
+         * @param mat Matrix A
+         * @param tolerance Target normwise backward error (at least about 1e-16)
+         * @param maxIterations Refinement steps before falling back to double precision
+         * @throws std::invalid_argument if tolerance is not positive
+         */
+        explicit MixedSolver(const SquareMat &mat, double tolerance = 1e-14, size_t maxIterations = 30); // Declaration of constructor
+
+        /**
+         * @brief Solve A x = b
+         * @param rhs Right-hand side b
+         * @return Solution x meeting the tolerance
+         * @throws std::invalid_argument if the sizes don't match or the matrix is singular
+         */
+        Vector solve(const Vector &rhs); // Declaration of the refined solve
+
+        /**
+         * @brief Refinement steps taken by the last solve
+         * @return Number of corrections applied (0 if the first solution met the tolerance)
+         */
+        size_t getIterations() const { return iterations; } // Getter for the iteration count
+
+        /**
+         * @brief Check whether the last solve fell back to double precision
+         * @return true if the double-precision LU produced the last solution
+         */
+        bool usedFallback() const { return fellBack; } // Getter for the fallback flag
+    };
+} // End of namespace
@@ -0,0 +1,367 @@
+// orel8155@gmail.com
+#include "modmat.hpp"     // Include the header file for ModMat class
+#include "threadpool.hpp" // Include for splitting product rows across threads
+#include <algorithm>      // Include for std::copy, std::fill and std::min
+#include <cmath>          // Include for std::trunc and std::fabs
+#include <limits>         // Include for the Barrett factor
+#include <type_traits>    // Include for the accumulator dispatch
+#include <vector>         // Include for the accumulator rows
+
+namespace squaremat // Start of the squaremat namespace
+{
+    namespace // Helpers private to this file
+    {
+        /**
+         * @brief Rows first..last-1 of c = a * b mod m with lazy reduction
+         *
+         * Each row is accumulated exactly in Acc and reduced only after every
+         * `lazy` terms, the most that can be added to a reduced value without
+         * overflowing Acc.
+         * @tparam Acc uint64_t when m <= 2^32, a 128-bit integer otherwise
+         * @param a Left factor (row-major, reduced)
+         * @param b Right factor (row-major, reduced)
+         * @param c Output (row-major)
+         * @param n Matrix size
+         * @param m Modulus
+         * @param first First row
+         * @param last One past the last row
+         * @param reduce Callable reducing an Acc value mod m
+         */
+        template <typename Acc, typename Reduce>
+        void modularRows(const uint64_t *a, const uint64_t *b, uint64_t *c, size_t n, uint64_t m, size_t first, size_t last, Reduce reduce) // Lazy-reduction product kernel
+        {
+            Acc largest = Acc(m - 1) * (m - 1);                                           // Largest single term
+            Acc room = (~Acc(0) - (m - 1)) / largest;                                     // Terms that fit on top of a reduced value
+            size_t lazy = room < Acc(n) ? static_cast<size_t>(room) : n;                  // Terms between reductions
+            std::vector<Acc> acc(n);                                                      // Accumulator row
+            for (size_t i = first; i < last; i++)                                         // Loop through the chunk's rows
+            {
+                std::fill(acc.begin(), acc.end(), Acc(0)); // Clear the accumulators
+                for (size_t k0 = 0; k0 < n; k0 += lazy)    // Blocks of terms that cannot overflow
+                {
+                    size_t k1 = std::min(n, k0 + lazy); // End of the block
+                    for (size_t k = k0; k < k1; k++)    // Loop through the block's terms
+                    {
+                        uint64_t left = a[i * n + k]; // Element of this row of a
+                        if (left == 0)                // Sparse rows (adjacency matrices) skip whole passes
+                        {
+                            continue; // Nothing to add
+                        }
+                        const uint64_t *row = b + k * n; // Row k of b
+                        Acc *out = acc.data();           // Accumulators of row i
+                        for (size_t j = 0; j < n; j++)   // Independent iterations vectorize
+                        {
+                            if constexpr (std::is_same_v<Acc, uint64_t>) // Both factors fit in 32 bits
+                            {
+                                out[j] += uint64_t(uint32_t(left)) * uint32_t(row[j]); // Widening 32x32 multiply
+                            }
+                            else
+                            {
+                                out[j] += Acc(left) * row[j]; // Full 64x64 multiply
+                            }
+                        }
+                    }
+                    for (size_t j = 0; j < n; j++) // Bring the row back below m
+                    {
+                        acc[j] = reduce(acc[j]); // One reduction per block of terms
+                    }
+                }
+                for (size_t j = 0; j < n; j++) // Store the reduced row
+                {
+                    c[i * n + j] = static_cast<uint64_t>(acc[j]); // Already in [0, m)
+                }
+            }
+        }
+    } // End of the helper namespace
+
+    /**
+     * @brief Constructor implementation
+     * @param size The size of the square matrix (number of rows/columns)
+     * @param modulus Modulus of the elements
+     * @throws std::invalid_argument if size is not positive or modulus is not in [2, 2^63]
+     */
+    ModMat::ModMat(size_t size, uint64_t modulus) : size(size), modulus(modulus), barrett(0), data(nullptr) // Constructor definition
+    {
+        if (size <= 0) // Check if size is valid
+        {
+            throw std::invalid_argument("Size must be positive"); // Throw exception for invalid size
+        }
+        if (modulus < 2 || modulus > (uint64_t(1) << 63)) // Sums of two residues must fit in 64 bits
+        {
+            throw std::invalid_argument("Modulus must be between 2 and 2^63"); // Throw exception for invalid modulus
+        }
+        barrett = std::numeric_limits<uint64_t>::max() / modulus; // Precompute the reduction factor
+        data = new uint64_t[size * size]();                        // Allocate the elements and initialize to 0
+    }
+
+    /**
+     * @brief Conversion constructor implementation
+     * @param mat Matrix whose elements are integers of magnitude below 2^63
+     * @param modulus Modulus of the elements
+     * @throws std::invalid_argument if an element is not such an integer, or modulus is invalid
+     */
+    ModMat::ModMat(const SquareMat &mat, uint64_t modulus) : ModMat(mat.getSize(), modulus) // Delegate allocation
+    {
+        for (size_t i = 0; i < size; i++) // Loop through rows
+        {
+            for (size_t j = 0; j < size; j++) // Loop through columns
+            {
+                double value = mat[i][j];                                          // Element to convert
+                if (std::trunc(value) != value || std::fabs(value) >= 9223372036854775808.0) // Not an int64 value (NaN fails too)
+                {
+                    throw std::invalid_argument("Elements must be integers below 2^63"); // Refuse lossy conversion
+                }
+                set(i, j, static_cast<int64_t>(value)); // Reduce the element
+            }
+        }
+    }
+
+    /**
+     * @brief Copy constructor implementation
+     * @param other The matrix to copy
+     */
+    ModMat::ModMat(const ModMat &other) : size(other.size), modulus(other.modulus), barrett(other.barrett), data(new uint64_t[other.size * other.size]) // Copy constructor definition
+    {
+        std::copy(other.data, other.data + size * size, data); // Copy the elements
+    }
+
+    /**
+     * @brief Assignment operator implementation
+     * @param other The matrix to assign from
+     * @return Reference to this matrix after assignment
+     */
+    ModMat &ModMat::operator=(const ModMat &other) // Assignment operator definition
+    {
+        if (this == &other) // Check for self-assignment
+        {
+            return *this; // Return if self-assignment
+        }
+        uint64_t *fresh = new uint64_t[other.size * other.size];         // Allocate before releasing (strong guarantee)
+        std::copy(other.data, other.data + other.size * other.size, fresh); // Copy the elements
+        delete[] data;                                                    // Free current resources
+        data = fresh;                                                     // Adopt the new storage
+        size = other.size;                                                // Update size
+        modulus = other.modulus;                                          // Update modulus
+        barrett = other.barrett;                                          // Update reduction factor
+        return *this;                                                     // Return reference to modified matrix
+    }
+
+    /**
+     * @brief Identity factory implementation
+     * @param size The size of the square matrix
+     * @param modulus Modulus of the elements
+     * @return Matrix with ones on the diagonal
+     */
+    ModMat ModMat::identity(size_t size, uint64_t modulus) // Identity factory definition
+    {
+        ModMat result(size, modulus);     // Zero matrix
+        for (size_t i = 0; i < size; i++) // Loop through the diagonal
+        {
+            result.data[i * size + i] = 1; // Unit diagonal element
+        }
+        return result; // Return the identity
+    }
+
+    /**
+     * @brief Operand check implementation
+     * @param other Second operand
+     * @throws std::invalid_argument if the sizes or moduli don't match
+     */
+    void ModMat::checkCompatible(const ModMat &other) const // Operand check definition
+    {
+        if (size != other.size) // Check if matrices have compatible sizes
+        {
+            throw std::invalid_argument("Matrix sizes must match"); // Throw exception if sizes don't match
+        }
+        if (modulus != other.modulus) // Residues of different rings
+        {
+            throw std::invalid_argument("Moduli must match"); // Throw exception if moduli don't match
+        }
+    }
+
+    /**
+     * @brief Element setter implementation
+     * @param row Row index
+     * @param col Column index
+     * @param value New value (negative values wrap around)
+     * @throws std::out_of_range if (row, col) is outside the matrix
+     */
+    void ModMat::set(size_t row, size_t col, int64_t value) // Element setter definition
+    {
+        if (row >= size || col >= size) // Check if index is out of bounds
+        {
+            throw std::out_of_range("Index out of bounds"); // Throw exception for invalid index
+        }
+        uint64_t magnitude = value < 0 ? uint64_t(0) - static_cast<uint64_t>(value) : static_cast<uint64_t>(value); // |value| without overflow
+        uint64_t rest = reduce(magnitude);                                                                      // |value| mod m
+        data[row * size + col] = (value < 0 && rest != 0) ? modulus - rest : rest;                            // Wrap negatives around
+    }
+
+    /**
+     * @brief Addition operator implementation
+     * @param other Matrix to add to this matrix
+     * @return New matrix with the element-wise sums mod m
+     * @throws std::invalid_argument if the sizes or moduli don't match
+     */
+    ModMat ModMat::operator+(const ModMat &other) const // Addition operator definition
+    {
+        checkCompatible(other);           // Check the operands
+        ModMat result(size, modulus);     // Create result matrix
+        for (size_t k = 0; k < size * size; k++) // Loop through the elements
+        {
+            uint64_t sum = data[k] + other.data[k];              // Below 2m <= 2^64
+            result.data[k] = sum >= modulus ? sum - modulus : sum; // Conditional subtraction
+        }
+        return result; // Return the sum
+    }
+
+    /**
+     * @brief Subtraction operator implementation
+     * @param other Matrix to subtract from this matrix
+     * @return New matrix with the element-wise differences mod m
+     * @throws std::invalid_argument if the sizes or moduli don't match
+     */
+    ModMat ModMat::operator-(const ModMat &other) const // Subtraction operator definition
+    {
+        checkCompatible(other);           // Check the operands
+        ModMat result(size, modulus);     // Create result matrix
+        for (size_t k = 0; k < size * size; k++) // Loop through the elements
+        {
+            result.data[k] = data[k] >= other.data[k] ? data[k] - other.data[k] : data[k] + (modulus - other.data[k]); // Borrow m when negative
+        }
+        return result; // Return the difference
+    }
+
+    /**
+     * @brief Unary minus operator implementation
+     * @return New matrix with the additive inverses mod m
+     */
+    ModMat ModMat::operator-() const // Unary minus operator definition
+    {
+        ModMat result(size, modulus);     // Create result matrix
+        for (size_t k = 0; k < size * size; k++) // Loop through the elements
+        {
+            result.data[k] = data[k] == 0 ? 0 : modulus - data[k]; // Additive inverse
+        }
+        return result; // Return the negation
+    }
+
+    /**
+     * @brief Matrix multiplication operator implementation
+     * @param other Matrix to multiply with this matrix
+     * @return New matrix containing the product mod m
+     * @throws std::invalid_argument if the sizes or moduli don't match
+     */
+    ModMat ModMat::operator*(const ModMat &other) const // Matrix multiplication operator definition
+    {
+        checkCompatible(other);       // Check the operands
+        ModMat result(size, modulus); // Create result matrix
+        const uint64_t *a = data;     // Elements of the left factor
+        const uint64_t *b = other.data; // Elements of the right factor
+        uint64_t *c = result.data;    // Elements of the product
+        size_t n = size;              // Matrix size
+        uint64_t m = modulus;         // Modulus
+        ThreadPool::instance().parallelFor(0, n, ThreadPool::rowGrain(n), [&](size_t first, size_t last) {
+            if (m <= (uint64_t(1) << 32)) // Terms fit in 64 bits
+            {
+                modularRows<uint64_t>(a, b, c, n, m, first, last, [this](uint64_t x) { return reduce(x); }); // Barrett reduction
+            }
+            else // Terms need 128 bits
+            {
+                modularRows<Wide>(a, b, c, n, m, first, last, [m](Wide x) { return x % m; }); // Wide division
+            }
+        });
+        return result; // Return the product
+    }
+
+    /**
+     * @brief Scalar multiplication operator implementation
+     * @param scalar Value to multiply the elements by (reduced first)
+     * @return New matrix with scaled elements mod m
+     */
+    ModMat ModMat::operator*(uint64_t scalar) const // Scalar multiplication operator definition
+    {
+        uint64_t factor = reduce(scalar);  // Reduced scalar
+        ModMat result(size, modulus);      // Create result matrix
+        for (size_t k = 0; k < size * size; k++) // Loop through the elements
+        {
+            result.data[k] = static_cast<uint64_t>(Wide(data[k]) * factor % modulus); // Scale each element
+        }
+        return result; // Return the scaled matrix
+    }
+
+    /**
+     * @brief Power operator implementation
+     * @param power Exponent (0 gives the identity)
+     * @return New matrix containing this^power mod m
+     */
+    ModMat ModMat::operator^(uint64_t power) const // Power operator definition
+    {
+        if (power == 0) // Zero power
+        {
+            return identity(size, modulus); // Return identity matrix
+        }
+        ModMat base(*this);       // Repeated squares of this matrix
+        while ((power & 1) == 0) // Skip the low zero bits
+        {
+            base = base * base; // Square
+            power >>= 1;        // Next bit
+        }
+        ModMat result(base); // Lowest set bit, no multiplication by the identity
+        power >>= 1;         // Remaining bits
+        while (power > 0)    // Loop through the remaining bits
+        {
+            base = base * base; // Square
+            if (power & 1)      // Bit set
+            {
+                result = result * base; // Multiply it in
+            }
+            power >>= 1; // Next bit
+        }
+        return result; // Return the power
+    }
+
+    /**
+     * @brief Equality operator implementation
+     * @param other Matrix to compare with
+     * @return true if size, modulus and every element are equal
+     */
+    bool ModMat::operator==(const ModMat &other) const // Equality operator definition
+    {
+        return size == other.size && modulus == other.modulus && std::equal(data, data + size * size, other.data); // Compare everything
+    }
+
+    /**
+     * @brief Conversion implementation
+     * @return Matrix with the residues (exact below 2^53)
+     */
+    SquareMat ModMat::toSquareMat() const // Conversion definition
+    {
+        SquareMat result(size);           // Create result matrix
+        double *out = result.data();      // Elements of the result (contiguous)
+        for (size_t k = 0; k < size * size; k++) // Loop through elements
+        {
+            out[k] = static_cast<double>(data[k]); // Copy the residue
+        }
+        return result; // Return the converted matrix
+    }
+
+    /**
+     * @brief Output stream operator implementation
+     * @param os Output stream to write to
+     * @param mat Matrix to output
+     * @return Reference to the output stream
+     */
+    std::ostream &operator<<(std::ostream &os, const ModMat &mat) // Output stream operator definition
+    {
+        for (size_t i = 0; i < mat.size; i++) // Loop through rows
+        {
+            for (size_t j = 0; j < mat.size; j++) // Loop through columns
+            {
+                os << mat(i, j) << "\t"; // Output element with tab separator
+            }
+            os << std::endl; // End line after each row
+        }
+        return os; // Return reference to output stream
+    }
+} // End of the squaremat namespace
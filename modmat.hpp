@@ -0,0 +1,230 @@
+// orel8155@gmail.com
+#pragma once             // Ensures the header file is included only once
+#include <cstdint>       // Include for fixed-width integers
+#include <iostream>      // Include for input/output operations
+#include <stdexcept>     // Include for standard exceptions
+#include <utility>       // Include for std::swap
+#include "squaremat.hpp" // Include for conversion to and from SquareMat
+
+namespace squaremat // Start of namespace definition
+{
+    /**
+     * @class ModMat
+     * @brief A square matrix of integers modulo m, for walk counting and linear recurrences
+     *
+     * Elements are kept reduced in [0, m) for any modulus 2 <= m <= 2^63. The product
+     * accumulates exact partial sums and reduces each one only once every few terms:
+     * in 64-bit integers when m <= 2^32, in 128-bit integers otherwise. operator^ uses
+     * binary exponentiation, so A^(10^18) takes about 120 products.
+     */
+    class ModMat // Class definition for modular matrix
+    {
+    private:
+        __extension__ typedef unsigned __int128 Wide; ///< Exact 64x64-bit products (GCC/Clang extension)
+
+        size_t size;      ///< Size of the square matrix (number of rows/columns)
+        uint64_t modulus; ///< Modulus of every element
+        uint64_t barrett; ///< floor((2^64 - 1) / modulus), for reducing 64-bit values
+        uint64_t *data;   ///< Row-major element storage, every value in [0, modulus)
+
+        /**
+         * @brief Reduce a 64-bit value with the precomputed Barrett factor
+         * @param value Value to reduce
+         * @return value mod modulus
+         */
+        uint64_t reduce(uint64_t value) const // Barrett reduction
+        {
+            uint64_t quotient = static_cast<uint64_t>((Wide(value) * barrett) >> 64); // Underestimates by at most 2
+            uint64_t rest = value - quotient * modulus; // Remainder plus a small multiple of the modulus
+            while (rest >= modulus)                     // At most two corrections
+            {
+                rest -= modulus; // Correct the estimate
+            }
+            return rest; // Return the reduced value
+        }
+
+        /**
+         * @brief Throw if the other matrix has a different size or modulus
+         * @param other Second operand
+         * @throws std::invalid_argument if the sizes or moduli don't match
+         */
+        void checkCompatible(const ModMat &other) const; // Declaration of the operand check
+
+    public:
+        /**
+         * @brief Constructor that creates a zero matrix
+         * @param size The size of the square matrix (number of rows/columns)
+         * @param modulus Modulus of the elements
+         * @throws std::invalid_argument if size is not positive or modulus is not in [2, 2^63]
+         */
+        ModMat(size_t size, uint64_t modulus); // Declaration of constructor
+
+        /**
+         * @brief Constructor that reduces an integer-valued matrix
+         * @param mat Matrix whose elements are integers of magnitude below 2^63
+         * @param modulus Modulus of the elements
+         * @throws std::invalid_argument if an element is not such an integer, or modulus is invalid
+         */
+        ModMat(const SquareMat &mat, uint64_t modulus); // Declaration of conversion constructor
+
+        /**
+         * @brief Copy constructor
+         * @param other The matrix to copy
+         */
+        ModMat(const ModMat &other); // Declaration of copy constructor
+
+        /**
+         * @brief Move constructor
+         * @param other The matrix to take the storage from (left empty)
+         */
+        ModMat(ModMat &&other) noexcept : size(other.size), modulus(other.modulus), barrett(other.barrett), data(other.data) // Move constructor definition
+        {
+            other.size = 0;       // Source no longer owns elements
+            other.data = nullptr; // Source no longer owns storage
+        }
+
+        /**
+         * @brief Destructor to free allocated memory
+         */
+        ~ModMat() { delete[] data; } // Destructor definition
+
+        /**
+         * @brief Assignment operator
+         * @param other The matrix to assign from (its modulus is adopted)
+         * @return Reference to this matrix after assignment
+         */
+        ModMat &operator=(const ModMat &other); // Declaration of assignment operator
+
+        /**
+         * @brief Move assignment operator
+         * @param other The matrix to take the storage from (receives this matrix's storage)
+         * @return Reference to this matrix after assignment
+         */
+        ModMat &operator=(ModMat &&other) noexcept // Move assignment operator definition
+        {
+            std::swap(size, other.size);       // Exchange sizes
+            std::swap(modulus, other.modulus); // Exchange moduli
+            std::swap(barrett, other.barrett); // Exchange reduction factors
+            std::swap(data, other.data);       // Exchange storage (other frees ours)
+            return *this;                      // Return reference to modified matrix
+        }
+
+        /**
+         * @brief Identity matrix
+         * @param size The size of the square matrix
+         * @param modulus Modulus of the elements
+         * @return Matrix with ones on the diagonal
+         * @throws std::invalid_argument if size is not positive or modulus is invalid
+         */
+        static ModMat identity(size_t size, uint64_t modulus); // Declaration of the identity factory
+
+        /**
+         * @brief Get the size of the matrix
+         * @return Size of the matrix (number of rows/columns)
+         */
+        size_t getSize() const { return size; } // Getter method for matrix size
+
+        /**
+         * @brief Get the modulus
+         * @return Modulus of the elements
+         */
+        uint64_t getModulus() const { return modulus; } // Getter method for the modulus
+
+        /**
+         * @brief Element access
+         * @param row Row index
+         * @param col Column index
+         * @return Element in [0, modulus)
+         * @throws std::out_of_range if (row, col) is outside the matrix
+         */
+        uint64_t operator()(size_t row, size_t col) const // Const element access
+        {
+            if (row >= size || col >= size) // Check if index is out of bounds
+            {
+                throw std::out_of_range("Index out of bounds"); // Throw exception for invalid index
+            }
+            return data[row * size + col]; // Return the stored element
+        }
+
+        /**
+         * @brief Set an element, reducing it modulo the modulus
+         * @param row Row index
+         * @param col Column index
+         * @param value New value (negative values wrap around)
+         * @throws std::out_of_range if (row, col) is outside the matrix
+         */
+        void set(size_t row, size_t col, int64_t value); // Declaration of the element setter
+
+        /**
+         * @brief Addition operator
+         * @param other Matrix to add to this matrix
+         * @return New matrix with the element-wise sums mod m
+         * @throws std::invalid_argument if the sizes or moduli don't match
+         */
+        ModMat operator+(const ModMat &other) const; // Declaration of addition operator
+
+        /**
+         * @brief Subtraction operator
+         * @param other Matrix to subtract from this matrix
+         * @return New matrix with the element-wise differences mod m
+         * @throws std::invalid_argument if the sizes or moduli don't match
+         */
+        ModMat operator-(const ModMat &other) const; // Declaration of subtraction operator
+
+        /**
+         * @brief Unary minus operator
+         * @return New matrix with the additive inverses mod m
+         */
+        ModMat operator-() const; // Declaration of unary minus operator
+
+        /**
+         * @brief Matrix multiplication operator with lazy reduction
+         * @param other Matrix to multiply with this matrix
+         * @return New matrix containing the product mod m
+         * @throws std::invalid_argument if the sizes or moduli don't match
+         */
+        ModMat operator*(const ModMat &other) const; // Declaration of matrix multiplication operator
+
+        /**
+         * @brief Scalar multiplication operator
+         * @param scalar Value to multiply the elements by (reduced first)
+         * @return New matrix with scaled elements mod m
+         */
+        ModMat operator*(uint64_t scalar) const; // Declaration of scalar multiplication operator
+
+        /**
+         * @brief Power operator using binary exponentiation
+         * @param power Exponent (0 gives the identity)
+         * @return New matrix containing this^power mod m
+         */
+        ModMat operator^(uint64_t power) const; // Declaration of power operator
+
+        /**
+         * @brief Equality operator
+         * @param other Matrix to compare with
+         * @return true if size, modulus and every element are equal
+         */
+        bool operator==(const ModMat &other) const; // Declaration of equality operator
+
+        /**
+         * @brief Inequality operator
+         * @param other Matrix to compare with
+         * @return true if the matrices differ
+         */
+        bool operator!=(const ModMat &other) const { return !(*this == other); } // Inequality via equality
+
+        /**
+         * @brief Convert to a matrix of doubles
+         * @return Matrix with the residues (exact below 2^53)
+         */
+        SquareMat toSquareMat() const; // Declaration of the conversion
+
+        /**
+         * @brief Output stream operator
+         * @param os Output stream to write to
+         * @param mat Matrix to output
+         * @return Reference to the output stream
+         */
+        friend std::ostream &operator<<(std::ostream &os, const ModMat &mat); // Declaration of friend output stream operator
+    };
+} // End of namespace
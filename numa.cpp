@@ -0,0 +1,186 @@
+// orel8155@gmail.com
+#include "numa.hpp" // Include the header file for the NUMA helpers
+#include <cstdint>  // Include for uintptr_t
+#include <fstream>  // Include for reading /sys and /proc
+#include <sstream>  // Include for parsing lists
+#include <string>   // Include for std::string
+#if defined(__linux__)
+#include <pthread.h>     // Include for pthread_setaffinity_np
+#include <sched.h>       // Include for cpu_set_t
+#include <sys/syscall.h> // Include for SYS_mbind
+#include <unistd.h>      // Include for syscall
+#endif
+
+namespace squaremat // Start of the squaremat namespace
+{
+    namespace numa // Start of the NUMA helpers
+    {
+        namespace // Helpers private to this translation unit
+        {
+            const int InterleavePolicy = 3; ///< MPOL_INTERLEAVE from <linux/mempolicy.h>
+
+            /**
+             * @brief Parse a kernel list such as "0-3,8,10-11"
+             * @param text List text
+             * @return Every id in the list
+             */
+            std::vector<int> parseList(const std::string &text) // List parser
+            {
+                std::vector<int> ids;          // Parsed ids
+                std::istringstream items(text); // Comma-separated items
+                std::string item;              // Current item
+                while (std::getline(items, item, ',')) // Loop through the items
+                {
+                    if (item.empty() || item == "\n") // Trailing separator
+                    {
+                        continue; // Skip it
+                    }
+                    size_t dash = item.find('-');                              // Range separator
+                    int low = std::stoi(item.substr(0, dash));                 // First id
+                    int high = dash == std::string::npos ? low : std::stoi(item.substr(dash + 1)); // Last id
+                    for (int id = low; id <= high; id++)                        // Expand the range
+                    {
+                        ids.push_back(id); // Add the id
+                    }
+                }
+                return ids; // Return the ids
+            }
+
+            /**
+             * @brief Read the first line of a file
+             * @param path File path
+             * @return The line, or an empty string if the file is missing
+             */
+            std::string readLine(const std::string &path) // File reader
+            {
+                std::ifstream file(path); // Open the file
+                std::string line;         // First line
+                std::getline(file, line); // Read it (stays empty on failure)
+                return line;              // Return the line
+            }
+        } // End of anonymous namespace
+
+        /**
+         * @brief Node count implementation
+         * @return Highest online node id plus one (1 if the topology is unknown)
+         */
+        size_t nodeCount() // Node count definition
+        {
+            static const size_t count = []() {                                            // Topology does not change at runtime
+                std::vector<int> nodes = parseList(readLine("/sys/devices/system/node/online")); // Online nodes
+                int highest = 0;                                                            // Highest node id
+                for (int node : nodes)                                                      // Loop through the nodes
+                {
+                    highest = node > highest ? node : highest; // Track the maximum
+                }
+                return static_cast<size_t>(highest) + 1; // Node ids are dense in practice
+            }();
+            return count; // Return the cached count
+        }
+
+        /**
+         * @brief CPU list implementation
+         * @param node Node id
+         * @return CPU ids from the node's cpulist (empty if unknown)
+         */
+        std::vector<int> nodeCpus(size_t node) // CPU list definition
+        {
+            return parseList(readLine("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist")); // Kernel CPU list
+        }
+
+        /**
+         * @brief Thread binding implementation
+         * @param thread Native handle of the thread
+         * @param node Node id
+         * @return true if the affinity was set
+         */
+        bool bindThread(std::thread::native_handle_type thread, size_t node) // Thread binding definition
+        {
+#if defined(__linux__)
+            std::vector<int> cpus = nodeCpus(node); // CPUs of the node
+            if (cpus.empty())                       // Unknown node
+            {
+                return false; // Nothing to bind to
+            }
+            cpu_set_t set;    // Affinity mask
+            CPU_ZERO(&set);   // Start empty
+            for (int cpu : cpus) // Loop through the node's CPUs
+            {
+                CPU_SET(cpu, &set); // Allow the CPU
+            }
+            return pthread_setaffinity_np(thread, sizeof(set), &set) == 0; // Apply the mask
+#else
+            (void)thread; // No affinity API
+            (void)node;   // No topology
+            return false; // Not supported
+#endif
+        }
+
+        /**
+         * @brief Interleave policy implementation
+         * @param memory Start of the region
+         * @param bytes Length of the region
+         * @return true if the policy was set (false on single-node systems)
+         */
+        bool interleave(void *memory, size_t bytes) // Interleave policy definition
+        {
+#if defined(__linux__) && defined(SYS_mbind)
+            size_t nodes = nodeCount(); // Nodes to spread over
+            if (nodes < 2)              // Nothing to interleave across
+            {
+                return false; // Policy would be a no-op
+            }
+            const size_t bitsPerWord = 8 * sizeof(unsigned long);                 // Bits in one mask word
+            std::vector<unsigned long> mask(nodes / bitsPerWord + 1, 0);          // Node mask
+            for (size_t node = 0; node < nodes; node++)                           // Loop through the nodes
+            {
+                mask[node / bitsPerWord] |= 1ul << (node % bitsPerWord); // Include the node
+            }
+            return syscall(SYS_mbind, memory, bytes, InterleavePolicy, mask.data(), mask.size() * bitsPerWord, 0) == 0; // Set the policy
+#else
+            (void)memory; // No mbind
+            (void)bytes;  // No mbind
+            return false; // Not supported
+#endif
+        }
+
+        /**
+         * @brief /proc check implementation
+         * @param memory Any address inside the mapping
+         * @return Page count per node (empty if the information is unavailable)
+         */
+        std::vector<size_t> residentPages(const void *memory) // /proc check definition
+        {
+            uintptr_t address = reinterpret_cast<uintptr_t>(memory); // Address to look up
+            std::ifstream maps("/proc/self/numa_maps");              // Per-mapping placement
+            std::vector<size_t> pages;                               // Counts of the best mapping so far
+            std::string line;                                        // Current line
+            while (std::getline(maps, line))                         // Mappings are listed in address order
+            {
+                std::istringstream fields(line); // Split the line
+                std::string start;               // Start address in hex
+                fields >> start;                 // First field
+                if (std::stoull(start, nullptr, 16) > address) // Past the address
+                {
+                    break; // The previous mapping contains it
+                }
+                pages.assign(nodeCount(), 0); // Reset the counts for this mapping
+                std::string field;            // Current field
+                while (fields >> field)       // Loop through the fields
+                {
+                    if (field.size() > 1 && field[0] == 'N' && field.find('=') != std::string::npos) // "N<node>=<pages>"
+                    {
+                        size_t equals = field.find('=');                        // Separator
+                        size_t node = std::stoul(field.substr(1, equals - 1));  // Node id
+                        if (node >= pages.size())                               // More nodes than /sys reported
+                        {
+                            pages.resize(node + 1, 0); // Grow the counts
+                        }
+                        pages[node] = std::stoul(field.substr(equals + 1)); // Page count
+                    }
+                }
+            }
+            return pages; // Return the counts
+        }
+    } // End of the NUMA helpers
+} // End of squaremat namespace
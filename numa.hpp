@@ -0,0 +1,59 @@
+// orel8155@gmail.com
+#pragma once     // Ensures the header file is included only once
+#include <cstddef> // Include for size_t
+#include <thread>  // Include for std::thread::native_handle_type
+#include <vector>  // Include for CPU lists and per-node counts
+
+namespace squaremat // Start of namespace definition
+{
+    /**
+     * @brief NUMA topology, placement and verification without libnuma
+     *
+     * Topology comes from /sys/devices/system/node, placement from the mbind system call
+     * and verification from /proc/self/numa_maps. On systems without that information
+     * everything behaves as a single node and the placement calls report failure.
+     */
+    namespace numa // Start of the NUMA helpers
+    {
+        /**
+         * @brief Number of online memory nodes
+         * @return Highest online node id plus one (1 if the topology is unknown)
+         */
+        size_t nodeCount(); // Declaration of the node count
+
+        /**
+         * @brief CPUs that belong to a node
+         * @param node Node id
+         * @return CPU ids from the node's cpulist (empty if unknown)
+         */
+        std::vector<int> nodeCpus(size_t node); // Declaration of the CPU list
+
+        /**
+         * @brief Restrict a thread to the CPUs of one node
+         * @param thread Native handle of the thread
+         * @param node Node id
+         * @return true if the affinity was set
+         */
+        bool bindThread(std::thread::native_handle_type thread, size_t node); // Declaration of thread binding
+
+        /**
+         * @brief Spread the pages of a region round-robin over all nodes (MPOL_INTERLEAVE)
+         *
+         * Applies to pages touched after the call; the region should be page aligned.
+         * @param memory Start of the region
+         * @param bytes Length of the region
+         * @return true if the policy was set (false on single-node systems)
+         */
+        bool interleave(void *memory, size_t bytes); // Declaration of the interleave policy
+
+        /**
+         * @brief Resident pages per node of the mapping that contains an address
+         *
+         * Reads the N<node>=<pages> fields of /proc/self/numa_maps. The counts cover the
+         * whole mapping, so blocks from a shared heap include their neighbours.
+         * @param memory Any address inside the mapping
+         * @return Page count per node (empty if the information is unavailable)
+         */
+        std::vector<size_t> residentPages(const void *memory); // Declaration of the /proc check
+    } // End of the NUMA helpers
+} // End of namespace
@@ -0,0 +1,180 @@
+// orel8155@gmail.com
+#include "pagealloc.hpp" // Include the header file for HugePageResource class
+#include "numa.hpp"      // Include for the interleave policy
+#include <cstdint>       // Include for uintptr_t
+#include <fstream>       // Include for reading /proc
+#include <sstream>       // Include for parsing /proc lines
+#include <string>        // Include for std::string
+#if defined(__linux__)
+#include <sys/mman.h> // Include for mmap, munmap and madvise
+#endif
+
+namespace squaremat // Start of the squaremat namespace
+{
+    namespace // Helpers private to this translation unit
+    {
+        /**
+         * @brief Round a byte count up to a whole number of huge pages
+         * @param bytes Byte count
+         * @return Smallest multiple of HugePageSize not below bytes
+         */
+        size_t roundToHugePages(size_t bytes) // Rounding helper
+        {
+            const size_t page = HugePageResource::HugePageSize;   // Huge page size
+            return (bytes + page - 1) / page * page;             // Round up
+        }
+    } // End of anonymous namespace
+
+    /**
+     * @brief Constructor implementation
+     * @param threshold Smallest block placed on huge pages (raised to HugePageSize)
+     * @param upstream Resource for small blocks and fallbacks (nullptr: std::pmr::get_default_resource() at construction)
+     */
+    HugePageResource::HugePageResource(size_t threshold, std::pmr::memory_resource *upstream) // Constructor definition
+        : threshold(threshold < HugePageSize ? HugePageSize : threshold), hugeTlb(false), interleaved(false), upstream(upstream ? upstream : std::pmr::get_default_resource()), liveHugeBytes(0), hugeAllocations(0), fallbacks(0)
+    {
+    }
+
+    /**
+     * @brief Shared resource accessor implementation
+     * @return Reference to the process-wide resource
+     */
+    HugePageResource &HugePageResource::instance() // Shared resource definition
+    {
+        static HugePageResource resource(2 * HugePageSize, std::pmr::new_delete_resource()); // Default threshold, fixed upstream
+        return resource;                  // Return the shared resource
+    }
+
+    /**
+     * @brief Allocation implementation
+     * @param bytes Number of bytes requested
+     * @param alignment Required alignment
+     * @return Pointer to the block
+     */
+    void *HugePageResource::do_allocate(size_t bytes, size_t alignment) // Allocation definition
+    {
+        if (bytes < threshold.load() || alignment > HugePageSize) // Small block, or alignment mmap can't promise
+        {
+            return upstream->allocate(bytes, alignment); // Ordinary allocation
+        }
+#if defined(__linux__)
+        size_t length = roundToHugePages(bytes); // Whole huge pages
+#if defined(MAP_HUGETLB)
+        if (hugeTlb.load()) // Reserved hugetlbfs pool requested
+        {
+            void *pool = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0); // Explicit huge pages
+            if (pool != MAP_FAILED) // Pool had enough pages
+            {
+                if (interleaved.load()) // Spread over the nodes before any page is touched
+                {
+                    numa::interleave(pool, length); // Best effort
+                }
+                std::lock_guard<std::mutex> lock(mappingMutex); // Protect the registry
+                mappings[pool] = {pool, length, true};          // Remember the mapping
+                liveHugeBytes += length;                        // Count the huge bytes
+                hugeAllocations++;                              // Count the block
+                return pool;                                    // Return the block
+            }
+        }
+#endif
+        size_t padded = length + HugePageSize;                                                         // Room to align the start
+        void *raw = mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0); // Anonymous mapping
+        if (raw != MAP_FAILED)                                                                         // Mapping succeeded
+        {
+            char *base = static_cast<char *>(raw);                                                                           // Byte view of the mapping
+            char *aligned = reinterpret_cast<char *>((reinterpret_cast<uintptr_t>(base) + HugePageSize - 1) & ~(HugePageSize - 1)); // 2 MB boundary
+            if (aligned > base)                                                                                              // Unaligned head
+            {
+                munmap(base, aligned - base); // Trim the head
+            }
+            size_t tail = (base + padded) - (aligned + length); // Unused bytes after the block
+            if (tail > 0)                                        // Unaligned tail
+            {
+                munmap(aligned + length, tail); // Trim the tail
+            }
+            if (interleaved.load()) // Spread over the nodes before any page is touched
+            {
+                numa::interleave(aligned, length); // Best effort
+            }
+            bool huge = true;                                   // Assume transparent huge pages apply
+#if defined(MADV_HUGEPAGE)
+            huge = madvise(aligned, length, MADV_HUGEPAGE) == 0; // Ask for transparent huge pages
+#else
+            huge = false; // No way to ask for them
+#endif
+            std::lock_guard<std::mutex> lock(mappingMutex); // Protect the registry
+            mappings[aligned] = {aligned, length, huge};    // Remember the mapping
+            if (huge)                                       // Advice accepted
+            {
+                liveHugeBytes += length; // Count the huge bytes
+                hugeAllocations++;       // Count the block
+            }
+            else
+            {
+                fallbacks++; // Mapped, but on small pages
+            }
+            return aligned; // Return the block
+        }
+#endif
+        fallbacks++;                                           // No mapping possible
+        return upstream->allocate(bytes, alignment); // Ordinary allocation
+    }
+
+    /**
+     * @brief Deallocation implementation
+     * @param memory Pointer to the block
+     * @param bytes Size passed to do_allocate
+     * @param alignment Alignment passed to do_allocate
+     */
+    void HugePageResource::do_deallocate(void *memory, size_t bytes, size_t alignment) // Deallocation definition
+    {
+#if defined(__linux__)
+        if (bytes >= HugePageSize) // Only blocks of at least one huge page are ever mapped (the threshold never goes lower)
+        {
+            Mapping mapping{nullptr, 0, false}; // Mapping of this block, if any
+            {
+                std::lock_guard<std::mutex> lock(mappingMutex); // Protect the registry
+                auto found = mappings.find(memory);             // Look the block up
+                if (found != mappings.end())                    // Block was mmap'ed
+                {
+                    mapping = found->second; // Copy the bookkeeping
+                    mappings.erase(found);   // Forget the block
+                }
+            }
+            if (mapping.base != nullptr) // Block was mmap'ed
+            {
+                if (mapping.huge) // Was counted as huge
+                {
+                    liveHugeBytes -= mapping.length; // Uncount the huge bytes
+                }
+                munmap(mapping.base, mapping.length); // Return the pages to the kernel
+                return;                               // Done
+            }
+        }
+#endif
+        upstream->deallocate(memory, bytes, alignment); // Ordinary block
+    }
+
+    /**
+     * @brief /proc check implementation
+     * @return Resident huge-page bytes, or 0 if the information is unavailable
+     */
+    size_t HugePageResource::residentHugePageBytes() // /proc check definition
+    {
+        std::ifstream smaps("/proc/self/smaps_rollup"); // Per-process memory summary
+        std::string line;                               // Current line
+        size_t kilobytes = 0;                           // Accumulated huge-page kB
+        while (std::getline(smaps, line))               // Loop through the summary
+        {
+            std::istringstream fields(line); // Split "Name:  value kB"
+            std::string name;                // Field name
+            size_t value = 0;                // Field value in kB
+            fields >> name >> value;         // Parse the fields
+            if (name == "AnonHugePages:" || name == "Shared_Hugetlb:" || name == "Private_Hugetlb:") // Huge-page fields
+            {
+                kilobytes += value; // Accumulate
+            }
+        }
+        return kilobytes * 1024; // Convert to bytes
+    }
+} // End of squaremat namespace
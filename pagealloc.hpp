@@ -0,0 +1,142 @@
+// orel8155@gmail.com
+#pragma once             // Ensures the header file is included only once
+#include <atomic>        // Include for the statistics counters
+#include <cstddef>       // Include for size_t
+#include <memory_resource> // Include for std::pmr::memory_resource
+#include <mutex>         // Include for the mapping registry lock
+#include <unordered_map> // Include for the mapping registry
+
+namespace squaremat // Start of namespace definition
+{
+    /**
+     * @class HugePageResource
+     * @brief Memory resource that places large blocks on 2 MB pages
+     *
+     * Blocks of at least the threshold size are mapped directly with mmap, aligned to
+     * 2 MB: first from the hugetlbfs pool (MAP_HUGETLB) when enabled, otherwise as
+     * anonymous memory advised with MADV_HUGEPAGE for transparent huge pages. If mapping
+     * fails, or on non-Linux systems, or for smaller blocks, the upstream resource is used.
+     * The shared instance() is the heap resource behind every SquareMat.
+     */
+    class HugePageResource : public std::pmr::memory_resource // Class definition for the huge page resource
+    {
+    public:
+        static constexpr size_t HugePageSize = size_t(2) << 20; ///< Size of an x86-64 / arm64 huge page
+
+    private:
+        /**
+         * @brief Bookkeeping for one mmap'ed block
+         */
+        struct Mapping
+        {
+            void *base;    ///< Start of the mapping (may precede the returned pointer)
+            size_t length; ///< Length of the mapping in bytes
+            bool huge;     ///< Whether the block was placed on huge pages
+        };
+
+        std::atomic<size_t> threshold;             ///< Smallest block placed on huge pages
+        std::atomic<bool> hugeTlb;                 ///< Try the hugetlbfs pool before transparent huge pages
+        std::atomic<bool> interleaved;             ///< Interleave mapped blocks across NUMA nodes
+        std::pmr::memory_resource *const upstream; ///< Resource for small blocks and fallbacks (fixed at construction)
+        std::mutex mappingMutex;                   ///< Protects mappings
+        std::unordered_map<void *, Mapping> mappings; ///< Blocks obtained from mmap, by returned pointer
+        std::atomic<size_t> liveHugeBytes;         ///< Bytes currently on huge-page mappings
+        std::atomic<size_t> hugeAllocations;       ///< Blocks placed on huge pages so far
+        std::atomic<size_t> fallbacks;             ///< Large blocks that had to fall back to upstream
+
+        /**
+         * @brief Allocate a block, on huge pages when it is large enough
+         * @param bytes Number of bytes requested
+         * @param alignment Required alignment
+         * @return Pointer to the block
+         */
+        void *do_allocate(size_t bytes, size_t alignment) override; // Declaration of allocation
+
+        /**
+         * @brief Release a block obtained from do_allocate
+         * @param memory Pointer to the block
+         * @param bytes Size passed to do_allocate
+         * @param alignment Alignment passed to do_allocate
+         */
+        void do_deallocate(void *memory, size_t bytes, size_t alignment) override; // Declaration of deallocation
+
+        /**
+         * @brief Huge page resources are only equal to themselves
+         * @param other Resource to compare with
+         * @return true if other is this resource
+         */
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; } // Identity comparison
+
+    public:
+        /**
+         * @brief Constructor
+         * @param threshold Smallest block placed on huge pages (raised to HugePageSize)
+         * @param upstream Resource for small blocks and fallbacks (nullptr: std::pmr::get_default_resource() at construction)
+         */
+        explicit HugePageResource(size_t threshold = 2 * HugePageSize, std::pmr::memory_resource *upstream = nullptr); // Declaration of constructor
+
+        /**
+         * @brief Shared resource used as the SquareMat heap
+         *
+         * Its upstream is std::pmr::new_delete_resource(), never the current default, so
+         * std::pmr::set_default_resource() cannot route a block's release to another resource.
+         * @return Reference to the process-wide resource
+         */
+        static HugePageResource &instance(); // Declaration of the shared resource accessor
+
+        /**
+         * @brief Set the smallest block placed on huge pages (SIZE_MAX disables huge pages)
+         * @param bytes New threshold in bytes (raised to HugePageSize, smaller blocks would waste most of a page)
+         */
+        void setThreshold(size_t bytes) { threshold.store(bytes < HugePageSize ? HugePageSize : bytes); } // Threshold setter
+
+        /**
+         * @brief Get the smallest block placed on huge pages
+         * @return Threshold in bytes
+         */
+        size_t getThreshold() const { return threshold.load(); } // Threshold getter
+
+        /**
+         * @brief Try the hugetlbfs pool (vm.nr_hugepages) before transparent huge pages
+         * @param enabled Whether to use MAP_HUGETLB
+         */
+        void setUseHugeTlb(bool enabled) { hugeTlb.store(enabled); } // Pool setter
+
+        /**
+         * @brief Spread mapped blocks round-robin over all NUMA nodes instead of first-touch placement
+         *
+         * Useful for matrices shared by threads on every node; has no effect on single-node systems.
+         * @param enabled Whether to apply MPOL_INTERLEAVE to new mappings
+         */
+        void setInterleave(bool enabled) { interleaved.store(enabled); } // Interleave setter
+
+        /**
+         * @brief Bytes currently on huge-page backed mappings
+         *
+         * Counts hugetlbfs mappings and mappings advised with MADV_HUGEPAGE; the kernel may
+         * still back parts of the latter with small pages (see residentHugePageBytes()).
+         * @return Live huge-page bytes
+         */
+        size_t hugePageBytes() const { return liveHugeBytes.load(); } // Live huge bytes getter
+
+        /**
+         * @brief Number of blocks placed on huge pages so far
+         * @return Huge-page allocation count
+         */
+        size_t hugePageAllocations() const { return hugeAllocations.load(); } // Allocation count getter
+
+        /**
+         * @brief Number of large blocks that fell back to the upstream resource
+         * @return Fallback count
+         */
+        size_t fallbackAllocations() const { return fallbacks.load(); } // Fallback count getter
+
+        /**
+         * @brief Huge-page memory the kernel reports for this process
+         *
+         * Sums AnonHugePages and the hugetlb fields of /proc/self/smaps_rollup.
+         * @return Resident huge-page bytes, or 0 if the information is unavailable
+         */
+        static size_t residentHugePageBytes(); // Declaration of the /proc check
+    };
+} // End of namespace
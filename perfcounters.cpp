@@ -0,0 +1,237 @@
+// orel8155@gmail.com
+#include "perfcounters.hpp" // Include the header file for the counters
+#if defined(__linux__)
+#include <cstdlib>                // Include for strtol
+#include <cstring>                // Include for memset
+#include <dirent.h>               // Include for listing the threads of the process
+#include <linux/perf_event.h>     // Include for perf_event_attr
+#include <sys/ioctl.h>            // Include for enabling and resetting counters
+#include <sys/syscall.h>          // Include for SYS_perf_event_open
+#include <unistd.h>               // Include for syscall, read and close
+#endif
+
+namespace squaremat // Start of the squaremat namespace
+{
+    namespace perf // Start of the performance counter helpers
+    {
+        namespace // Helpers private to this translation unit
+        {
+            const char *const Names[EventCount] = {"cycles", "instructions", "l1d-misses", "llc-misses", "dtlb-misses", "branch-misses"}; ///< Event names, in enum order
+
+#if defined(__linux__) && defined(SYS_perf_event_open)
+            /**
+             * @brief Cache event config from its cache id, operation and result
+             * @param cache PERF_COUNT_HW_CACHE_* id
+             * @param result PERF_COUNT_HW_CACHE_RESULT_* id
+             * @return perf_event_attr config value
+             */
+            uint64_t cacheEvent(uint64_t cache, uint64_t result) // Cache event encoder
+            {
+                return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (result << 16); // Layout from <linux/perf_event.h>
+            }
+
+            /**
+             * @brief Open one event for one thread
+             * @param event Event to open
+             * @param thread Thread id (0 for the calling thread)
+             * @return File descriptor, or -1 if the event is not available
+             */
+            int openEvent(Event event, pid_t thread) // Event opener
+            {
+                perf_event_attr attr;              // Event description
+                std::memset(&attr, 0, sizeof(attr)); // Unused fields must be zero
+                attr.size = sizeof(attr);          // Structure version
+                attr.disabled = 1;                 // Start stopped
+                attr.exclude_kernel = 1;           // User space only (allowed with perf_event_paranoid <= 2)
+                attr.exclude_hv = 1;               // No hypervisor counts
+                attr.inherit = 1;                  // Threads started later by this one count too
+                attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING; // Times for multiplex scaling
+                switch (event)                     // Map the event to its type and config
+                {
+                case Event::Cycles:
+                    attr.type = PERF_TYPE_HARDWARE;           // Generic hardware event
+                    attr.config = PERF_COUNT_HW_CPU_CYCLES;   // Cycles
+                    break;
+                case Event::Instructions:
+                    attr.type = PERF_TYPE_HARDWARE;           // Generic hardware event
+                    attr.config = PERF_COUNT_HW_INSTRUCTIONS; // Instructions
+                    break;
+                case Event::L1Misses:
+                    attr.type = PERF_TYPE_HW_CACHE;                                                          // Cache event
+                    attr.config = cacheEvent(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_RESULT_MISS);     // L1 data read misses
+                    break;
+                case Event::LLCMisses:
+                    attr.type = PERF_TYPE_HARDWARE;            // Generic hardware event
+                    attr.config = PERF_COUNT_HW_CACHE_MISSES;  // Last-level cache misses
+                    break;
+                case Event::DTLBMisses:
+                    attr.type = PERF_TYPE_HW_CACHE;                                                          // Cache event
+                    attr.config = cacheEvent(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_RESULT_MISS);    // Data TLB read misses
+                    break;
+                default:
+                    attr.type = PERF_TYPE_HARDWARE;             // Generic hardware event
+                    attr.config = PERF_COUNT_HW_BRANCH_MISSES;  // Branch mispredictions
+                    break;
+                }
+                return static_cast<int>(syscall(SYS_perf_event_open, &attr, thread, -1, -1, 0)); // One thread, any CPU, no group
+            }
+
+            /**
+             * @brief Ids of the other threads of the process that are running now
+             * @return Thread ids, without the calling thread (empty if /proc is not readable)
+             */
+            std::vector<pid_t> otherThreads() // Thread lister
+            {
+                std::vector<pid_t> threads;                           // Result
+                pid_t self = static_cast<pid_t>(syscall(SYS_gettid)); // Calling thread
+                DIR *dir = opendir("/proc/self/task");                // One entry per thread
+                if (dir == nullptr)                                   // No /proc
+                {
+                    return threads; // Calling thread only
+                }
+                while (dirent *entry = readdir(dir)) // Loop through the entries
+                {
+                    pid_t id = static_cast<pid_t>(std::strtol(entry->d_name, nullptr, 10)); // 0 for "." and ".."
+                    if (id > 0 && id != self)                                              // Another thread
+                    {
+                        threads.push_back(id); // Count it as well
+                    }
+                }
+                closedir(dir);  // Release the listing
+                return threads; // Return the ids
+            }
+#endif
+        } // End of anonymous namespace
+
+        /**
+         * @brief Event name implementation
+         * @param event Event
+         * @return Name such as "cycles" or "dtlb-misses"
+         */
+        const char *eventName(Event event) // Event name definition
+        {
+            return Names[static_cast<size_t>(event)]; // Index by enum value
+        }
+
+        /**
+         * @brief IPC implementation
+         * @return IPC, or 0 if cycles or instructions were not counted
+         */
+        double Sample::ipc() const // IPC definition
+        {
+            if (!has(Event::Cycles) || !has(Event::Instructions) || (*this)[Event::Cycles] == 0) // Missing a counter
+            {
+                return 0; // No meaningful ratio
+            }
+            return static_cast<double>((*this)[Event::Instructions]) / (*this)[Event::Cycles]; // Instructions per cycle
+        }
+
+        /**
+         * @brief Constructor implementation
+         */
+        Counters::Counters() // Constructor definition
+        {
+#if defined(__linux__) && defined(SYS_perf_event_open)
+            std::vector<pid_t> threads = otherThreads(); // Threads besides the caller
+            for (size_t e = 0; e < EventCount; e++)      // Loop through the events
+            {
+                int own = openEvent(static_cast<Event>(e), 0); // -1 when not supported or not permitted
+                if (own < 0)                                   // Event not available
+                {
+                    continue; // Leave it without descriptors
+                }
+                descriptors[e].push_back(own); // Calling thread first
+                for (pid_t thread : threads)   // Loop through the other threads
+                {
+                    int fd = openEvent(static_cast<Event>(e), thread); // Fails if the thread has exited meanwhile
+                    if (fd >= 0)                                       // Opened
+                    {
+                        descriptors[e].push_back(fd); // Count that thread too
+                    }
+                }
+            }
+#endif
+        }
+
+        /**
+         * @brief Destructor implementation
+         */
+        Counters::~Counters() // Destructor definition
+        {
+#if defined(__linux__)
+            for (const std::vector<int> &fds : descriptors) // Loop through the events
+            {
+                for (int fd : fds) // Loop through the threads
+                {
+                    close(fd); // Release it
+                }
+            }
+#endif
+        }
+
+        /**
+         * @brief Availability check implementation
+         * @return true if measuring gives any counts
+         */
+        bool Counters::available() const // Availability check definition
+        {
+            for (const std::vector<int> &fds : descriptors) // Loop through the events
+            {
+                if (!fds.empty()) // Opened event
+                {
+                    return true; // At least one counter works
+                }
+            }
+            return false; // Nothing to count with
+        }
+
+        /**
+         * @brief Start implementation
+         */
+        void Counters::start() // Start definition
+        {
+#if defined(__linux__)
+            for (const std::vector<int> &fds : descriptors) // Loop through the events
+            {
+                for (int fd : fds) // Loop through the threads
+                {
+                    ioctl(fd, PERF_EVENT_IOC_RESET, 0);  // Zero the count
+                    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0); // Start counting
+                }
+            }
+#endif
+        }
+
+        /**
+         * @brief Stop implementation
+         * @return Counts since start()
+         */
+        Sample Counters::stop() // Stop definition
+        {
+            Sample sample; // Result (everything invalid by default)
+#if defined(__linux__)
+            for (const std::vector<int> &fds : descriptors) // Disable everything before reading
+            {
+                for (int fd : fds) // Loop through the threads
+                {
+                    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0); // Stop counting
+                }
+            }
+            for (size_t e = 0; e < EventCount; e++) // Loop through the events
+            {
+                for (int fd : descriptors[e]) // Loop through the threads
+                {
+                    uint64_t data[3]; // Value, time enabled, time running
+                    if (read(fd, data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0) // Failed or never scheduled (an idle thread)
+                    {
+                        continue; // Adds nothing
+                    }
+                    sample.values[e] += data[2] < data[1] ? static_cast<uint64_t>(static_cast<double>(data[0]) * data[1] / data[2]) : data[0]; // Scale multiplexed counts
+                    sample.valid[e] = true;                                                                                                   // Counted
+                }
+            }
+#endif
+            return sample; // Return the counts
+        }
+    } // End of the performance counter helpers
+} // End of squaremat namespace
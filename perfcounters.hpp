@@ -0,0 +1,122 @@
+// orel8155@gmail.com
+#pragma once     // Ensures the header file is included only once
+#include <cstddef> // Include for size_t
+#include <cstdint> // Include for uint64_t
+#include <vector>  // Include for the per-thread descriptors
+
+namespace squaremat // Start of namespace definition
+{
+    /**
+     * @brief Hardware performance counters through Linux perf_event_open
+     *
+     * Each counter is opened on its own, so an event the CPU or kernel does not offer only
+     * drops that counter. When perf_event_open is not permitted (perf_event_paranoid,
+     * containers, non-Linux systems) every counter reports as unavailable and measuring
+     * still works. Counters cover every thread of the process in user space only: each
+     * thread running when the set is opened gets its own descriptor, and threads started
+     * later by a counted thread are inherited, so work spread over the ThreadPool shows up
+     * in the totals.
+     */
+    namespace perf // Start of the performance counter helpers
+    {
+        /**
+         * @brief Hardware events that can be counted
+         */
+        enum class Event
+        {
+            Cycles,       ///< CPU cycles
+            Instructions, ///< Retired instructions
+            L1Misses,     ///< L1 data cache read misses
+            LLCMisses,    ///< Last-level cache misses
+            DTLBMisses,   ///< Data TLB read misses
+            BranchMisses, ///< Mispredicted branches
+            Count         ///< Number of events
+        };
+
+        static constexpr size_t EventCount = static_cast<size_t>(Event::Count); ///< Number of countable events
+
+        /**
+         * @brief Short name of an event
+         * @param event Event
+         * @return Name such as "cycles" or "dtlb-misses"
+         */
+        const char *eventName(Event event); // Declaration of the event name
+
+        /**
+         * @brief Counter values of one measured interval
+         */
+        struct Sample
+        {
+            uint64_t values[EventCount] = {}; ///< Count per event (scaled if the kernel multiplexed it)
+            bool valid[EventCount] = {};      ///< Whether the event was counted
+
+            /**
+             * @brief Value of one event
+             * @param event Event to read
+             * @return The count (0 if the event was not counted)
+             */
+            uint64_t operator[](Event event) const { return values[static_cast<size_t>(event)]; } // Indexed read
+
+            /**
+             * @brief Check whether an event was counted
+             * @param event Event to check
+             * @return true if the value is meaningful
+             */
+            bool has(Event event) const { return valid[static_cast<size_t>(event)]; } // Validity check
+
+            /**
+             * @brief Instructions per cycle
+             * @return IPC, or 0 if cycles or instructions were not counted
+             */
+            double ipc() const; // Declaration of IPC
+        };
+
+        /**
+         * @class Counters
+         * @brief One set of open counters for all threads of the process
+         */
+        class Counters // Class definition for the counter set
+        {
+        private:
+            std::vector<int> descriptors[EventCount]; ///< File descriptors per event, one per thread (empty if unavailable)
+
+        public:
+            /**
+             * @brief Open every event for every thread of the process (unavailable ones are skipped)
+             */
+            Counters(); // Declaration of constructor
+
+            /**
+             * @brief Close the counters
+             */
+            ~Counters(); // Declaration of destructor
+
+            Counters(const Counters &) = delete;            // Descriptors are not shared
+            Counters &operator=(const Counters &) = delete; // Descriptors are not shared
+
+            /**
+             * @brief Check whether at least one event could be opened
+             * @return true if measuring gives any counts
+             */
+            bool available() const; // Declaration of the availability check
+
+            /**
+             * @brief Check whether one event could be opened
+             * @param event Event to check
+             * @return true if the event is counted
+             */
+            bool available(Event event) const { return !descriptors[static_cast<size_t>(event)].empty(); } // Per-event availability
+
+            /**
+             * @brief Zero and enable the counters
+             */
+            void start(); // Declaration of start
+
+            /**
+             * @brief Disable the counters and read them
+             * @return Counts since start(), summed over the threads
+             */
+            Sample stop(); // Declaration of stop
+        };
+    } // End of the performance counter helpers
+} // End of namespace
@@ -1,8 +1,499 @@
 // orel8155@gmail.com
 #include "squaremat.hpp" // Include the header file for SquareMat class
+#include "pagealloc.hpp" // Include for the huge-page heap resource
+#include "threadpool.hpp" // Include for first-touch initialization
+#include "kernels.hpp"    // Include for the reduction kernels
+#include "matview.hpp"    // Include for the copy-free cofactor expansion
+#include <algorithm>     // Include for std::min and std::max
+#include <cstdint>       // Include for uintptr_t
+#include <new>           // Include for placement new of the block header
+#include <vector>        // Include for permutation and column bookkeeping
 
 namespace squaremat // Start of the squaremat namespace
 {
+    namespace // Helpers private to this translation unit
+    {
+        thread_local SquareMat::Arena *activeArena = nullptr; ///< Innermost live arena on this thread
+
+        const size_t StorageAlignment = 64; ///< Matrix storage and arena chunks start on a cache line
+
+        static_assert(kernels::UpperTriangular == SquareMat::UpperTriangular && kernels::LowerTriangular == SquareMat::LowerTriangular, "Product kernel flags must match Structure"); // Flags are passed through unchanged
+
+        /**
+         * @brief Floating-point operations of kernels::productRows over the whole matrix
+         * @param n Matrix size
+         * @param left Structure flags of the left operand
+         * @param right Structure flags of the right operand
+         * @return Multiply-adds times two
+         */
+        [[maybe_unused]] uint64_t productFlops(size_t n, unsigned left, unsigned right) // Flop count of the product kernel
+        {
+            uint64_t flops = 0;              // Running count
+            for (size_t i = 0; i < n; i++)   // Rows of the result
+            {
+                size_t kLo = (left & SquareMat::UpperTriangular) ? i : 0;     // First term
+                size_t kHi = (left & SquareMat::LowerTriangular) ? i + 1 : n; // One past the last term
+                for (size_t k = kLo; k < kHi; k++)                            // Terms of the row
+                {
+                    size_t jLo = (right & SquareMat::UpperTriangular) ? k : 0;     // First column
+                    size_t jHi = (right & SquareMat::LowerTriangular) ? k + 1 : n; // One past the last column
+                    flops += 2 * (jHi - jLo);                                      // Multiply-add per column
+                }
+            }
+            return flops; // Return the count
+        }
+
+        /**
+         * @brief Read the permutation of a matrix known to be a permutation matrix
+         * @param mat Permutation matrix
+         * @return perm where row i has its single 1 in column perm[i]
+         */
+        std::vector<size_t> permutationOf(const SquareMat &mat) // Permutation extraction
+        {
+            std::vector<size_t> perm(mat.getSize());   // One column index per row
+            for (size_t i = 0; i < mat.getSize(); i++) // Loop through rows
+            {
+                const double *row = mat[i];              // Current row
+                for (size_t j = 0; j < mat.getSize(); j++) // Loop through columns
+                {
+                    if (row[j] == 1) // Found the single 1 of the row
+                    {
+                        perm[i] = j; // Record its column
+                        break;       // Rest of the row is zero
+                    }
+                }
+            }
+            return perm; // Return the permutation
+        }
+
+        /**
+         * @brief Raise a scalar to a non-negative integer power by repeated squaring
+         * @param base Value to raise
+         * @param power Non-negative exponent
+         * @return base^power using O(log power) multiplications
+         */
+        double integerPower(double base, int power) // Scalar fast exponentiation
+        {
+            double result = 1; // Empty product
+            while (power > 0)  // Process the exponent bit by bit
+            {
+                if (power & 1) // Current bit is set
+                {
+                    result *= base; // Multiply the running square into the result
+                }
+                base *= base; // Square the base
+                power >>= 1;  // Move to the next bit
+            }
+            return result; // Return the power
+        }
+    } // End of anonymous namespace
+
+    /**
+     * @brief Constructor implementation
+     * @param size The size of the square matrix (number of rows/columns)
+     * @throws std::invalid_argument if size is not positive
+     */
+    SquareMat::SquareMat(size_t size, std::pmr::memory_resource *resource) : size(size), matrix(nullptr), resource(nullptr), structureCache(UnknownStructure) // Constructor with initialization list
+    {
+        if (size <= 0) // Check if size is valid
+        {
+            throw std::invalid_argument("Size must be positive"); // Throw exception for invalid size
+        }
+        acquireStorage(resource ? resource : defaultResource()); // One block from the chosen resource
+        forEachRowChunk([this](size_t first, size_t last) {
+            std::fill(matrix[first], matrix[0] + last * this->size, 0.0); // First touch puts the rows on the node of the thread that will process them
+        });
+    }
+
+    /**
+     * @brief Copy constructor implementation
+     * @param other The matrix to copy
+     */
+    SquareMat::SquareMat(const SquareMat &other) : size(other.size), matrix(nullptr), resource(other.derivedResource()), structureCache(other.cachedStructure()) // Copy constructor with initialization list (a copy has the same structure)
+    {
+        bool shared = canShare(other, resource, true); // Heap blocks are shared with any resource
+        SQUAREMAT_STAT_SCOPE(Copy, shared ? 0 : 2 * size * size, 0); // Count the call (no traffic when shared)
+        SQUAREMAT_TRACE_SCOPE("copy", "operator"); // Timeline event
+        if (shared) // Copy-on-write
+        {
+            shareStorage(other); // Take a reference to other's block
+            return;              // Done
+        }
+        copyStorage(other, resource); // Private block from the inherited resource
+    }
+
+    /**
+     * @brief Resource copy constructor implementation
+     * @param other The matrix to copy
+     * @param resource Memory resource for the storage of the copy
+     */
+    SquareMat::SquareMat(const SquareMat &other, std::pmr::memory_resource *resource) : size(other.size), matrix(nullptr), resource(resource ? resource : defaultResource()), structureCache(other.cachedStructure()) // Copy constructor with initialization list (a copy has the same structure)
+    {
+        bool shared = canShare(other, this->resource, false); // Only blocks already on the requested resource
+        SQUAREMAT_STAT_SCOPE(Copy, shared ? 0 : 2 * size * size, 0); // Count the call (no traffic when shared)
+        SQUAREMAT_TRACE_SCOPE("copy", "operator"); // Timeline event
+        if (shared) // Copy-on-write
+        {
+            shareStorage(other); // Take a reference to other's block
+            return;              // Done
+        }
+        copyStorage(other, this->resource); // Private block from the chosen resource
+    }
+
+    /**
+     * @brief Storage allocation implementation
+     * @param owner Memory resource to allocate from
+     */
+    void SquareMat::acquireStorage(std::pmr::memory_resource *owner) // Storage allocation definition
+    {
+        resource = owner; // New storage of this matrix comes from here
+        matrix = size == 0 ? nullptr : allocateBlock(size, owner); // Moved-from matrices have no elements
+    }
+
+    /**
+     * @brief Block allocation implementation
+     * @param size Matrix size (must be positive)
+     * @param owner Memory resource to allocate from
+     * @return Row pointers into the uninitialized elements
+     */
+    double **SquareMat::allocateBlock(size_t size, std::pmr::memory_resource *owner) // Block allocation definition
+    {
+        SQUAREMAT_TRACE_SCOPE("allocate", "phase");                  // Timeline event
+        size_t bytes = storageBytes(size);                           // Elements, row pointers and header
+        void *block = owner->allocate(bytes, StorageAlignment);      // Single allocation
+        SQUAREMAT_STAT_ALLOCATION(bytes);                             // Attribute it to the running operator
+        double *data = static_cast<double *>(block);                 // Elements come first
+        double **rows = reinterpret_cast<double **>(data + size * size); // Row pointers follow the elements
+        for (size_t i = 0; i < size; i++)                            // Loop through rows
+        {
+            rows[i] = data + i * size; // Point each row into the block
+        }
+        new (rows + size) StorageHeader(owner); // Header follows the row pointers
+        return rows;                            // Return the row pointers
+    }
+
+    /**
+     * @brief Block release implementation
+     * @param rows Row pointers of the block (nullptr is ignored)
+     * @param size Matrix size of the block
+     */
+    void SquareMat::releaseBlock(double **rows, size_t size) // Block release definition
+    {
+        if (rows == nullptr) // Nothing to release after a move
+        {
+            return; // Done
+        }
+        StorageHeader *info = reinterpret_cast<StorageHeader *>(rows + size); // Header of the block
+        if (info->owners.fetch_sub(1, std::memory_order_acq_rel) == 1)          // Last owner frees the block
+        {
+            std::pmr::memory_resource *owner = info->owner;                    // Resource the block came from
+            info->~StorageHeader();                                           // End the header's lifetime
+            owner->deallocate(rows[0], storageBytes(size), StorageAlignment); // Row 0 is the start of the block
+        }
+    }
+
+    /**
+     * @brief Storage release implementation
+     */
+    void SquareMat::releaseStorage() // Storage release definition
+    {
+        releaseBlock(matrix, size); // Drop our reference
+        matrix = nullptr;           // No storage anymore
+    }
+
+    /**
+     * @brief Sharing rule implementation
+     * @param other Matrix whose block would be shared
+     * @param target Resource of the matrix that would share it
+     * @param anyHeapBlock Also share heap blocks when target is a different resource
+     * @return true if sharing is safe
+     */
+    bool SquareMat::canShare(const SquareMat &other, std::pmr::memory_resource *target, bool anyHeapBlock) // Sharing rule definition
+    {
+        if (other.matrix == nullptr || other.header()->unshareable.load(std::memory_order_relaxed)) // Moved-from, or a row pointer is out
+        {
+            return false; // Nothing to share, or writes through the pointer would reach the copy
+        }
+        std::pmr::memory_resource *owner = other.header()->owner; // Resource the block came from
+        return owner == target || *owner == *target || (anyHeapBlock && owner == heapResource()); // Same resource, or the library heap
+    }
+
+    /**
+     * @brief Storage sharing implementation
+     * @param other Matrix to share with (must have storage)
+     */
+    void SquareMat::shareStorage(const SquareMat &other) // Storage sharing definition
+    {
+        double **old = matrix;                                     // Block we give up
+        size_t oldSize = size;                                     // Its size
+        other.header()->owners.fetch_add(1, std::memory_order_relaxed); // One more reader (other keeps it alive meanwhile)
+        matrix = other.matrix;                                     // Same elements
+        size = other.size;                                         // Same size
+        releaseBlock(old, oldSize);                                // Drop our old block
+        structureCache.store(other.cachedStructure(), std::memory_order_relaxed); // Same contents, same structure
+    }
+
+    /**
+     * @brief Deep copy implementation
+     * @param other Matrix to copy
+     * @param owner Memory resource to allocate from
+     */
+    void SquareMat::copyStorage(const SquareMat &other, std::pmr::memory_resource *owner) // Deep copy definition
+    {
+        acquireStorage(owner); // One block from the chosen resource
+        if (size > 0)          // Moved-from matrices have nothing to copy
+        {
+            forEachRowChunk([&](size_t first, size_t last) {
+                std::copy(other.matrix[first], other.matrix[0] + last * this->size, matrix[first]); // Copy values in the kernels' row chunks (first touch)
+            });
+        }
+    }
+
+    /**
+     * @brief Deferred copy implementation
+     */
+    void SquareMat::unshare() // Deferred copy definition
+    {
+        SQUAREMAT_STAT_SCOPE(Unshare, 2 * size * size, 0); // Count the call
+        SQUAREMAT_TRACE_SCOPE("unshare", "operator");      // Timeline event
+        double **old = matrix;                   // Shared block
+        double **fresh = allocateBlock(size, resource); // Private block from our own resource
+        forEachRowChunk([&](size_t first, size_t last) {
+            std::copy(old[first], old[0] + last * size, fresh[first]); // Copy values in the kernels' row chunks (first touch)
+        });
+        matrix = fresh;          // Switch to the private block
+        releaseBlock(old, size); // Drop our reference to the shared one
+    }
+
+    /**
+     * @brief Postfix step implementation
+     * @param delta Value added to every element of this matrix
+     * @return Matrix holding the previous contents
+     */
+    SquareMat SquareMat::takeShifted(double delta) // Postfix kernel definition
+    {
+        double **fresh = size > 0 ? allocateBlock(size, resource) : nullptr; // Allocate before giving anything away
+        SquareMat old(std::move(*this));       // The result keeps the current block (shared or not)
+        size = old.size;                       // Same size again
+        matrix = fresh;                        // Write into the new block
+        invalidateStructure();                 // Contents change
+        if (size > 0)                          // Moved-from matrices have nothing to shift
+        {
+            const double *in = old.matrix[0]; // Previous elements
+            double *out = matrix[0];          // New elements
+            forEachRowChunk([&](size_t first, size_t last) {
+                for (size_t k = first * size; k < last * size; k++) // Loop through the chunk's elements
+                {
+                    out[k] = in[k] + delta; // Shift every element
+                }
+            });
+        }
+        return old; // Return the original matrix
+    }
+
+    /**
+     * @brief Default resource accessor implementation
+     * @return Innermost live Arena on this thread, or heapResource()
+     */
+    std::pmr::memory_resource *SquareMat::defaultResource() // Default resource accessor definition
+    {
+        if (activeArena != nullptr) // An arena scope is open on this thread
+        {
+            return activeArena; // Temporaries go to the arena
+        }
+        return heapResource(); // Library heap
+    }
+
+    /**
+     * @brief Heap resource accessor implementation
+     * @return The shared HugePageResource
+     */
+    std::pmr::memory_resource *SquareMat::heapResource() // Heap resource accessor definition
+    {
+        return &HugePageResource::instance(); // Huge pages for big matrices, new/delete otherwise
+    }
+
+    /**
+     * @brief Arena constructor implementation
+     * @param initialBytes Capacity of the first chunk (later chunks double in size)
+     * @param upstream Resource the chunks are obtained from
+     */
+    SquareMat::Arena::Arena(size_t initialBytes, std::pmr::memory_resource *upstream) : offset(0), used(0), previous(activeArena), upstream(upstream) // Arena constructor definition
+    {
+        size_t capacity = std::max<size_t>(initialBytes, StorageAlignment);                                    // Keep at least one line
+        chunks.push_back({static_cast<char *>(upstream->allocate(capacity, StorageAlignment)), capacity}); // First chunk
+        activeArena = this;                                                                                 // Become the active arena
+    }
+
+    /**
+     * @brief Arena destructor implementation
+     */
+    SquareMat::Arena::~Arena() // Arena destructor definition
+    {
+        activeArena = previous;        // Reactivate the enclosing arena
+        for (Chunk &chunk : chunks)    // Loop through owned chunks
+        {
+            upstream->deallocate(chunk.memory, chunk.capacity, StorageAlignment); // Release the chunk
+        }
+    }
+
+    /**
+     * @brief Active arena accessor implementation
+     * @return Innermost live arena, or nullptr if none
+     */
+    SquareMat::Arena *SquareMat::Arena::current() // Active arena accessor definition
+    {
+        return activeArena; // Thread-local arena pointer
+    }
+
+    /**
+     * @brief Bump allocation implementation
+     * @param bytes Number of bytes requested
+     * @param alignment Required alignment (a power of two)
+     * @return Pointer to the block (valid until the arena is destroyed)
+     */
+    void *SquareMat::Arena::do_allocate(size_t bytes, size_t alignment) // Bump allocation definition
+    {
+        auto alignedStart = [&](const Chunk &chunk, size_t from) // Offset of the first aligned address at or after `from`
+        {
+            uintptr_t address = reinterpret_cast<uintptr_t>(chunk.memory) + from;           // Absolute candidate address
+            uintptr_t aligned = (address + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1); // Round up
+            return static_cast<size_t>(aligned - reinterpret_cast<uintptr_t>(chunk.memory)); // Back to an offset
+        };
+        size_t start = alignedStart(chunks.back(), offset); // Align the bump pointer
+        if (start + bytes > chunks.back().capacity)         // Current chunk is full
+        {
+            size_t capacity = std::max(2 * chunks.back().capacity, bytes + alignment);                              // Grow geometrically, with room to align
+            chunks.push_back({static_cast<char *>(upstream->allocate(capacity, StorageAlignment)), capacity}); // Start a new chunk
+            start = alignedStart(chunks.back(), 0);                                                             // Align inside the fresh chunk
+        }
+        offset = start + bytes; // Bump past the block
+        used += bytes;          // Count the handed-out bytes
+        return chunks.back().memory + start; // Return the block
+    }
+
+    /**
+     * @brief Reduction implementation
+     * @param mode Accuracy mode
+     * @return Sum of all matrix elements
+     */
+    double SquareMat::sum(Summation mode) const // Reduction definition
+    {
+        SQUAREMAT_TRACE_SCOPE("sum", "operator"); // Timeline event
+        if (size == 0) // Moved-from matrices have no elements
+        {
+            return 0; // Empty sum
+        }
+        const double *data = matrix[0];                // Elements of this matrix
+        size_t count = size * size;                    // Number of elements
+        size_t blocks = (count + SumBlock - 1) / SumBlock; // Fixed blocks
+        auto blockLength = [&](size_t b) { return std::min(SumBlock, count - b * SumBlock); }; // Last block may be short
+        bool follow = SQUAREMAT_TRACE_RECORDING(); // Workers record their blocks when the call is sampled
+        (void)follow;                              // Unused when tracing is compiled out
+
+        if (mode == Summation::Compensated) // Carry every block's compensation to the end
+        {
+            if (blocks == 1) // Small matrix, no bookkeeping needed
+            {
+                double s = 0, c = 0;                      // Sum and compensation
+                kernels::compensatedSum(data, count, s, c); // Single block
+                return s + c;                              // Apply the compensation
+            }
+            std::vector<double> sums(blocks), comps(blocks); // Per-block results
+            ThreadPool::instance().parallelFor(0, blocks, ThreadPool::ParallelElements / SumBlock, [&](size_t first, size_t last) {
+                SQUAREMAT_TRACE_FOLLOW("kernel", "phase", follow); // Timeline event on the worker
+                for (size_t b = first; b < last; b++) // Loop through the chunk's blocks
+                {
+                    kernels::compensatedSum(data + b * SumBlock, blockLength(b), sums[b], comps[b]); // Block sum
+                }
+            });
+            SQUAREMAT_TRACE_SCOPE("reduce", "phase"); // Timeline event
+            double s = 0, c = 0;               // Combined sum and compensation
+            for (size_t b = 0; b < blocks; b++) // Fixed block order
+            {
+                kernels::neumaierAdd(s, c, sums[b]); // Block sum
+                c += comps[b];                       // Block compensation
+            }
+            return s + c; // Apply the compensation
+        }
+
+        auto blockSum = [&](size_t b) // Sum of one block in the selected mode
+        {
+            const double *start = data + b * SumBlock;                                                  // First element of the block
+            return mode == Summation::Pairwise ? kernels::pairwiseSum(start, blockLength(b)) : kernels::sum(start, blockLength(b)); // Block kernel
+        };
+        if (blocks == 1) // Small matrix, no bookkeeping needed
+        {
+            return blockSum(0); // Single block
+        }
+        std::vector<double> partial(blocks); // Per-block results
+        ThreadPool::instance().parallelFor(0, blocks, ThreadPool::ParallelElements / SumBlock, [&](size_t first, size_t last) {
+            SQUAREMAT_TRACE_FOLLOW("kernel", "phase", follow); // Timeline event on the worker
+            for (size_t b = first; b < last; b++) // Loop through the chunk's blocks
+            {
+                partial[b] = blockSum(b); // Block sum
+            }
+        });
+        {
+            SQUAREMAT_TRACE_SCOPE("reduce", "phase"); // Timeline event
+            return mode == Summation::Pairwise ? kernels::pairwiseSum(partial.data(), blocks) : kernels::sum(partial.data(), blocks); // Combine in a fixed order
+        }
+    }
+
+    /**
+     * @brief One-pass structural classifier implementation
+     *
+     * Tracks in a single sweep whether anything lies below or above the diagonal and
+     * whether the matrix is a 0/1 matrix with exactly one 1 per row and column, stopping
+     * early as soon as no structure can apply.
+     * @return Structure flags of the current contents
+     */
+    unsigned SquareMat::classify() const // Classifier definition
+    {
+        bool upper = true;                          // Nothing seen below the diagonal yet
+        bool lower = true;                          // Nothing seen above the diagonal yet
+        bool permutation = true;                    // Still a candidate permutation matrix
+        std::vector<unsigned char> columnUsed(size); // Columns that already hold a 1
+        for (size_t i = 0; i < size; i++)           // Loop through rows
+        {
+            size_t onesInRow = 0;             // Number of 1s in this row
+            for (size_t j = 0; j < size; j++) // Loop through columns
+            {
+                double value = matrix[i][j]; // Current element
+                if (value == 0)              // Zeros never break a structure
+                {
+                    continue; // Next element
+                }
+                if (j < i) // Non-zero below the diagonal
+                {
+                    upper = false; // Not upper triangular
+                }
+                else if (j > i) // Non-zero above the diagonal
+                {
+                    lower = false; // Not lower triangular
+                }
+                if (value != 1 || columnUsed[j]) // Not a 0/1 matrix, or the column has two 1s
+                {
+                    permutation = false; // Not a permutation matrix
+                }
+                else
+                {
+                    columnUsed[j] = 1; // Column now holds its 1
+                    onesInRow++;       // Count the 1 in this row
+                }
+            }
+            if (onesInRow != 1) // Every row of a permutation has exactly one 1
+            {
+                permutation = false; // Not a permutation matrix
+            }
+            if (!upper && !lower && !permutation) // No structure left to detect
+            {
+                return General; // Stop early
+            }
+        }
+        return (upper ? UpperTriangular : 0u) | (lower ? LowerTriangular : 0u) | (permutation ? Permutation : 0u); // Combine flags
+    }
+
     /**
      * @brief Matrix multiplication operator implementation
      * @param other Matrix to multiply with this matrix
@@ -11,24 +502,161 @@ namespace squaremat // Start of the squaremat namespace
      */
     SquareMat SquareMat::operator*(const SquareMat &other) const // Matrix multiplication operator definition
     {
+        SQUAREMAT_STAT_SCOPE(Multiply, 3 * size * size, 0); // Count the call (flops depend on the path)
+        SQUAREMAT_TRACE_SCOPE("*", "operator"); // Timeline event
         if (size != other.size) // Check if matrices have compatible sizes
         {
             throw std::invalid_argument("Matrix sizes must match"); // Throw exception if sizes don't match
         }
-        SquareMat result(size);           // Create result matrix with same size
-        for (size_t i = 0; i < size; i++) // Loop through rows
+        SquareMat result(size, derivedResource());         // Create result matrix with same size
+        unsigned left = structure();        // Structure of the left operand
+        unsigned right = other.structure(); // Structure of the right operand
+
+        if ((left & Diagonal) == Diagonal) // Diagonal * B scales the rows of B in O(n^2)
         {
-            for (size_t j = 0; j < size; j++) // Loop through columns
+            SQUAREMAT_STAT_FLOPS(size * size); // One multiplication per element
+            for (size_t i = 0; i < size; i++) // Loop through rows
+            {
+                for (size_t j = 0; j < size; j++) // Loop through columns
+                {
+                    result.matrix[i][j] = matrix[i][i] * other.matrix[i][j]; // Scale row i by d_i
+                }
+            }
+            return result; // Return the resulting matrix
+        }
+        if ((right & Diagonal) == Diagonal) // A * Diagonal scales the columns of A in O(n^2)
+        {
+            SQUAREMAT_STAT_FLOPS(size * size); // One multiplication per element
+            for (size_t i = 0; i < size; i++) // Loop through rows
+            {
+                for (size_t j = 0; j < size; j++) // Loop through columns
+                {
+                    result.matrix[i][j] = matrix[i][j] * other.matrix[j][j]; // Scale column j by d_j
+                }
+            }
+            return result; // Return the resulting matrix
+        }
+        if (left & Permutation) // P * B permutes the rows of B in O(n^2)
+        {
+            std::vector<size_t> perm = permutationOf(*this); // Row i of the result is row perm[i] of B
+            for (size_t i = 0; i < size; i++)                // Loop through rows
+            {
+                std::copy(other.matrix[perm[i]], other.matrix[perm[i]] + size, result.matrix[i]); // Copy the selected row
+            }
+            return result; // Return the resulting matrix
+        }
+        if (right & Permutation) // A * P permutes the columns of A in O(n^2)
+        {
+            std::vector<size_t> perm = permutationOf(other); // Column k of A moves to column perm[k]
+            for (size_t i = 0; i < size; i++)                // Loop through rows
             {
-                for (size_t k = 0; k < size; k++) // Loop for dot product calculation
+                for (size_t k = 0; k < size; k++) // Loop through columns of A
                 {
-                    result.matrix[i][j] += matrix[i][k] * other.matrix[k][j]; // Accumulate dot product
+                    result.matrix[i][perm[k]] = matrix[i][k]; // Move the element to its new column
                 }
             }
+            return result; // Return the resulting matrix
         }
+
+        SQUAREMAT_STAT_FLOPS(productFlops(size, left, right)); // Multiply-add per term (only computed with counters on)
+        result.accumulateProduct(1.0, *this, other, left, right); // Blocked kernel into the zeroed result
         return result; // Return the resulting matrix
     }
 
+    /**
+     * @brief Shared product kernel implementation
+     * @param alpha Scale of the product
+     * @param a Left operand
+     * @param b Right operand
+     * @param left Structure flags of a
+     * @param right Structure flags of b
+     */
+    void SquareMat::accumulateProduct(double alpha, const SquareMat &a, const SquareMat &b, unsigned left, unsigned right) // Shared product kernel definition
+    {
+        makeWritable();                   // Contents change
+        const double *x = a.matrix[0];    // Elements of the left operand
+        const double *y = b.matrix[0];    // Elements of the right operand
+        double *out = matrix[0];          // Elements of this matrix
+        forEachRowChunk([&](size_t first, size_t last) {
+            kernels::productRows(alpha, x, size, y, size, out, size, size, left, right, first, last); // Blocked rows of the product
+        });
+    }
+
+    /**
+     * @brief In-place product accumulation implementation
+     * @param a Left factor
+     * @param b Right factor
+     * @param alpha Scale of the product
+     * @return Reference to this matrix
+     * @throws std::invalid_argument if matrix sizes don't match
+     */
+    SquareMat &SquareMat::addProduct(const SquareMat &a, const SquareMat &b, double alpha) // In-place product accumulation definition
+    {
+        gemm(alpha, a, b, 1.0, *this); // beta = 1 keeps the current contents
+        return *this;                  // Return reference to modified matrix
+    }
+
+    /**
+     * @brief GEMM implementation
+     * @param alpha Scale of the product
+     * @param a Left factor
+     * @param b Right factor
+     * @param beta Scale of the previous contents of c
+     * @param c Matrix that receives the result
+     * @throws std::invalid_argument if matrix sizes don't match
+     */
+    void gemm(double alpha, const SquareMat &a, const SquareMat &b, double beta, SquareMat &c) // GEMM definition
+    {
+        SQUAREMAT_STAT_SCOPE(Gemm, 3 * c.size * c.size, beta == 1 ? 0 : c.size * c.size); // Count the call (scaling of c up front)
+        SQUAREMAT_TRACE_SCOPE("gemm", "operator"); // Timeline event
+        if (a.size != b.size || a.size != c.size) // Check if matrix sizes are compatible
+        {
+            throw std::invalid_argument("Matrix sizes must match"); // Throw exception if sizes don't match
+        }
+        if (&c == &a || &c == &b) // The kernel would read rows it already overwrote
+        {
+            SquareMat product = a * b; // One temporary for the aliased case
+            c.makeWritable();   // Contents change
+            double *out = c.matrix[0];             // Elements of c
+            const double *p = product.matrix[0];   // Elements of the product
+            c.forEachRowChunk([&](size_t first, size_t last) {
+                for (size_t k = first * c.size; k < last * c.size; k++) // Loop through the chunk's elements
+                {
+                    out[k] = (beta == 0 ? 0 : beta * out[k]) + alpha * p[k]; // Combine both terms
+                }
+            });
+            return; // Done
+        }
+        unsigned left = alpha == 0 ? unsigned(SquareMat::General) : a.structure();  // Structure of the left factor
+        unsigned right = alpha == 0 ? unsigned(SquareMat::General) : b.structure(); // Structure of the right factor
+        if (alpha != 0)                                                            // The product contributes
+        {
+            SQUAREMAT_STAT_FLOPS(productFlops(c.size, left, right)); // Multiply-add per term (only computed with counters on)
+        }
+        c.makeWritable();       // Contents change
+        const double *x = a.matrix[0]; // Elements of the left factor
+        const double *y = b.matrix[0]; // Elements of the right factor
+        double *out = c.matrix[0];     // Elements of c
+        size_t n = c.size;             // Matrix size
+        c.forEachRowChunk([&](size_t first, size_t last) {
+            if (beta == 0) // Overwrite without reading
+            {
+                std::fill(out + first * n, out + last * n, 0.0); // Clear the chunk
+            }
+            else if (beta != 1) // Scale the chunk while it is about to be accumulated into
+            {
+                for (size_t k = first * n; k < last * n; k++) // Loop through the chunk's elements
+                {
+                    out[k] *= beta; // Scale the previous contents
+                }
+            }
+            if (alpha != 0) // Product contributes
+            {
+                kernels::productRows(alpha, x, n, y, n, out, n, n, left, right, first, last); // Accumulate the chunk's rows
+            }
+        });
+    }
+
     /**
      * @brief Scalar multiplication operator (right side) implementation
      * @param scalar Value to multiply matrix elements by
@@ -36,14 +664,17 @@ namespace squaremat // Start of the squaremat namespace
      */
     SquareMat SquareMat::operator*(double scalar) const // Scalar multiplication operator definition
     {
-        SquareMat result(size);           // Create result matrix with same size
-        for (size_t i = 0; i < size; i++) // Loop through rows
-        {
-            for (size_t j = 0; j < size; j++) // Loop through columns
+        SQUAREMAT_STAT_SCOPE(ScalarMultiply, 2 * size * size, size * size); // Count the call
+        SQUAREMAT_TRACE_SCOPE("* scalar", "operator"); // Timeline event
+        SquareMat result(size, derivedResource()); // Create result matrix with same size
+        const double *a = matrix[0];               // Elements of this matrix
+        double *out = result.matrix[0];            // Elements of the result
+        forEachRowChunk([&](size_t first, size_t last) {
+            for (size_t k = first * size; k < last * size; k++) // Loop through the chunk's elements
             {
-                result.matrix[i][j] = matrix[i][j] * scalar; // Multiply each element by scalar
+                out[k] = a[k] * scalar; // Multiply each element by scalar
             }
-        }
+        });
         return result; // Return the resulting matrix
     }
 
@@ -66,19 +697,22 @@ namespace squaremat // Start of the squaremat namespace
      */
     SquareMat SquareMat::operator%(const SquareMat &other) const // Element-wise multiplication operator definition
     {
+        SQUAREMAT_STAT_SCOPE(ElementwiseMultiply, 3 * size * size, size * size); // Count the call
+        SQUAREMAT_TRACE_SCOPE("% matrix", "operator"); // Timeline event
         if (size != other.size) // Check if matrices have compatible sizes
         {
             throw std::invalid_argument("Matrix sizes must match"); // Throw exception if sizes don't match
         }
-        SquareMat result(size); // Create result matrix with same size
-
-        for (size_t i = 0; i < size; i++) // Loop through rows
-        {
-            for (size_t j = 0; j < size; j++) // Loop through columns
+        SquareMat result(size, derivedResource()); // Create result matrix with same size
+        const double *a = matrix[0];               // Elements of this matrix
+        const double *b = other.matrix[0];         // Elements of the other matrix
+        double *out = result.matrix[0];            // Elements of the result
+        forEachRowChunk([&](size_t first, size_t last) {
+            for (size_t k = first * size; k < last * size; k++) // Loop through the chunk's elements
             {
-                result.matrix[i][j] = matrix[i][j] * other.matrix[i][j]; // Multiply corresponding elements
+                out[k] = a[k] * b[k]; // Multiply corresponding elements
             }
-        }
+        });
         return result; // Return the resulting matrix
     }
 
@@ -90,18 +724,21 @@ namespace squaremat // Start of the squaremat namespace
      */
     SquareMat SquareMat::operator%(int scalar) const // Modulo operator definition
     {
+        SQUAREMAT_STAT_SCOPE(Modulo, 2 * size * size, size * size); // Count the call
+        SQUAREMAT_TRACE_SCOPE("% scalar", "operator"); // Timeline event
         if (scalar == 0) // Check if scalar is zero
         {
             throw std::invalid_argument("Scalar must be non-zero"); // Throw exception if scalar is zero
         }
-        SquareMat result(size);           // Create result matrix with same size
-        for (size_t i = 0; i < size; i++) // Loop through rows
-        {
-            for (size_t j = 0; j < size; j++) // Loop through columns
+        SquareMat result(size, derivedResource()); // Create result matrix with same size
+        const double *a = matrix[0];               // Elements of this matrix
+        double *out = result.matrix[0];            // Elements of the result
+        forEachRowChunk([&](size_t first, size_t last) {
+            for (size_t k = first * size; k < last * size; k++) // Loop through the chunk's elements
             {
-                result.matrix[i][j] = fmod(matrix[i][j], scalar); // Apply modulo to each element
+                out[k] = fmod(a[k], scalar); // Apply modulo to each element
             }
-        }
+        });
         return result; // Return the resulting matrix
     }
 
@@ -113,15 +750,19 @@ namespace squaremat // Start of the squaremat namespace
      */
     SquareMat SquareMat::operator^(int power) const // Power operator definition
     {
+        SQUAREMAT_STAT_SCOPE(Power, size * size, 0); // Count the call (products count their own flops)
+        SQUAREMAT_TRACE_SCOPE("^", "operator"); // Timeline event
         if (power < 0) // Check if power is negative
         {
             throw std::invalid_argument("Power must be non-negative"); // Throw exception if power is negative
         }
 
-        // Power 0 returns identity matrix
-        if (power == 0) // Check if power is zero
+        unsigned shape = structure(); // Structure of the base
+
+        // Power 0 and any power of the identity return the identity matrix
+        if (power == 0 || shape == Identity) // Check if the result is the identity
         {
-            SquareMat result(size);           // Create result matrix with same size
+            SquareMat result(size, derivedResource());           // Create result matrix with same size
             for (size_t i = 0; i < size; i++) // Loop through diagonal elements
             {
                 result.matrix[i][i] = 1; // Set diagonal elements to 1 (identity matrix)
@@ -135,53 +776,158 @@ namespace squaremat // Start of the squaremat namespace
             return SquareMat(*this); // Return copy of current matrix
         }
 
-        // Simple solution: multiply the matrix by itself 'power' times
-        SquareMat result(*this); // Initialize result with current matrix
+        // Diagonal matrices are raised element-wise in O(n log power)
+        if ((shape & Diagonal) == Diagonal) // Check if the matrix is diagonal
+        {
+            SquareMat result(size, derivedResource());           // Create result matrix with same size
+            for (size_t i = 0; i < size; i++) // Loop through diagonal elements
+            {
+                result.matrix[i][i] = integerPower(matrix[i][i], power); // Raise each diagonal element
+            }
+            return result; // Return the resulting matrix
+        }
 
-        for (int i = 1; i < power; i++) // Loop power-1 times
+        // Permutation matrices compose their permutation by repeated squaring in O(n log power)
+        if (shape & Permutation) // Check if the matrix is a permutation
         {
-            result *= *this; // Multiply result by original matrix
+            std::vector<size_t> base = permutationOf(*this); // Permutation of P^(2^k)
+            std::vector<size_t> acc(size);                   // Permutation of the accumulated power
+            std::vector<size_t> next(size);                  // Scratch for compositions
+            for (size_t i = 0; i < size; i++)                // Start from the identity permutation
+            {
+                acc[i] = i; // Identity maps every row to itself
+            }
+            while (power > 0) // Process the exponent bit by bit
+            {
+                if (power & 1) // Current bit is set
+                {
+                    for (size_t i = 0; i < size; i++) // Compose acc with base
+                    {
+                        next[i] = base[acc[i]]; // Row i of acc*base holds its 1 in column base[acc[i]]
+                    }
+                    acc.swap(next); // Adopt the composition
+                }
+                for (size_t i = 0; i < size; i++) // Square the base permutation
+                {
+                    next[i] = base[base[i]]; // Apply base twice
+                }
+                base.swap(next); // Adopt the square
+                power >>= 1;     // Move to the next bit
+            }
+            SquareMat result(size, derivedResource());           // Create result matrix with same size
+            for (size_t i = 0; i < size; i++) // Loop through rows
+            {
+                result.matrix[i][acc[i]] = 1; // Place the single 1 of the row
+            }
+            return result; // Return the resulting matrix
         }
 
+        // Binary exponentiation: at most 2 log2(power) products, each into a reused buffer
+        SquareMat base(*this);                      // A^(2^k)
+        SquareMat scratch(size, derivedResource()); // Target of each product
+        SquareMat result(size, derivedResource());  // Accumulated power
+        bool started = false;                       // result holds a power yet
+        while (true)                                // Process the exponent bit by bit
+        {
+            if (power & 1) // Current bit is set
+            {
+                if (!started) // First factor: copy instead of multiplying by I
+                {
+                    std::copy(base.matrix[0], base.matrix[0] + size * size, result.matrix[0]); // Elements of A^(2^k)
+                    started = true;                                                     // Later bits multiply
+                }
+                else // Multiply into the scratch buffer and exchange
+                {
+                    gemm(1, result, base, 0, scratch); // result * A^(2^k)
+                    std::swap(result, scratch);        // Adopt the product
+                }
+            }
+            power >>= 1; // Move to the next bit
+            if (power == 0) // No bits left
+            {
+                break; // Skip the unused square
+            }
+            gemm(1, base, base, 0, scratch); // Square the base
+            std::swap(base, scratch);        // Adopt the square
+        }
         return result; // Return the resulting matrix
     }
 
+    /**
+     * @brief Transpose operator implementation
+     *
+     * Diagonal matrices are their own transpose, and triangular matrices only move
+     * their stored triangle; the result inherits the mirrored structure flags.
+     * @return New matrix that is the transpose of this matrix
+     */
+    SquareMat SquareMat::operator~() const // Transpose operator definition
+    {
+        SQUAREMAT_STAT_SCOPE(Transpose, 2 * size * size, 0); // Count the call
+        SQUAREMAT_TRACE_SCOPE("~", "operator"); // Timeline event
+        unsigned shape = structure(); // Structure of the matrix
+        if ((shape & Diagonal) == Diagonal) // Diagonal matrices are symmetric
+        {
+            return SquareMat(*this); // Return copy of current matrix
+        }
+
+        SquareMat result(size, derivedResource());           // Create result matrix of same size
+        for (size_t i = 0; i < size; i++) // Loop through rows
+        {
+            size_t first = (shape & UpperTriangular) ? i : 0;        // Skip known zeros left of the diagonal
+            size_t last = (shape & LowerTriangular) ? i : size - 1;  // Skip known zeros right of the diagonal
+            for (size_t j = first; j <= last; j++)                   // Loop through columns
+            {
+                result.matrix[j][i] = matrix[i][j]; // Swap row and column indices
+            }
+        }
+        unsigned mirrored = (shape & Permutation)                                   // Transposed permutation is a permutation
+                            | ((shape & UpperTriangular) ? LowerTriangular : 0u)    // Upper becomes lower
+                            | ((shape & LowerTriangular) ? UpperTriangular : 0u);   // Lower becomes upper
+        result.structureCache.store(mirrored, std::memory_order_relaxed);          // Structure is known without a scan
+        return result;                                                              // Return the transposed matrix
+    }
+
     /**
      * @brief Determinant operator implementation
      * @return Determinant of the matrix
      */
     double SquareMat::operator!() const // Determinant operator definition
     {
-        if (size == 1) // Base case: 1x1 matrix
-        {
-            return matrix[0][0]; // Return the single element
-        }
+        SQUAREMAT_STAT_SCOPE(Determinant, size * size, 0); // Count the call (recursive calls fold in)
+        SQUAREMAT_TRACE_SCOPE("!", "operator"); // Timeline event
+        unsigned shape = structure(); // Structure of the matrix
 
-        if (size == 2) // Base case: 2x2 matrix
+        if (shape & (UpperTriangular | LowerTriangular)) // Triangular: product of the diagonal in O(n)
         {
-            return matrix[0][0] * matrix[1][1] - matrix[0][1] * matrix[1][0]; // Use 2x2 determinant formula
+            SQUAREMAT_STAT_FLOPS(size); // One multiplication per diagonal element
+            double det = 1;                   // Initialize determinant to one
+            for (size_t i = 0; i < size; i++) // Loop through diagonal elements
+            {
+                det *= matrix[i][i]; // Multiply the diagonal
+            }
+            return det; // Return the calculated determinant
         }
 
-        double det = 0;                   // Initialize determinant to zero
-        for (size_t j = 0; j < size; j++) // Loop through first row elements
+        if (shape & Permutation) // Permutation: sign of the permutation in O(n)
         {
-            SquareMat submat(size - 1);       // Create submatrix of size-1
-            for (size_t i = 1; i < size; i++) // Loop through rows (skip first row)
+            std::vector<size_t> perm = permutationOf(*this); // Column of the 1 in every row
+            std::vector<unsigned char> seen(size);           // Rows already assigned to a cycle
+            size_t cycles = 0;                               // Number of cycles in the permutation
+            for (size_t i = 0; i < size; i++)                // Loop through rows
             {
-                size_t col_idx = 0;               // Initialize column index for submatrix
-                for (size_t k = 0; k < size; k++) // Loop through columns
+                if (!seen[i]) // Start of a new cycle
                 {
-                    if (k != j) // Skip the current column
+                    cycles++;                                      // Count it
+                    for (size_t k = i; !seen[k]; k = perm[k])      // Walk the cycle
                     {
-                        submat.matrix[i - 1][col_idx] = matrix[i][k]; // Copy element to submatrix
-                        col_idx++;                                    // Increment submatrix column index
+                        seen[k] = 1; // Mark the row
                     }
                 }
             }
-            double sign = (j % 2 == 0) ? 1.0 : -1.0; // Determine sign based on column index
-            det += sign * matrix[0][j] * (!submat);  // Add term to determinant (recursive call)
+            return ((size - cycles) % 2 == 0) ? 1.0 : -1.0; // Sign is (-1)^(n - cycles)
         }
-        return det; // Return the calculated determinant
+
+        return !SquareMatView(*this); // No structure to exploit: cofactor expansion without copying minors
     }
 
     /**
@@ -191,34 +937,60 @@ namespace squaremat // Start of the squaremat namespace
      */
     SquareMat &SquareMat::operator=(const SquareMat &other) // Assignment operator definition
     {
+        SQUAREMAT_STAT_SCOPE(Assign, 2 * other.size * other.size, 0); // Count the call
+        SQUAREMAT_TRACE_SCOPE("assign", "operator"); // Timeline event
         if (this == &other) // Check for self-assignment
         {
             return *this; // Return if self-assignment
         }
 
-        // Free current resources
-        for (size_t i = 0; i < size; i++) // Loop through current rows
+        if (canShare(other, resource, true)) // Copy-on-write
         {
-            delete[] matrix[i]; // Delete each row
+            shareStorage(other); // Take a reference to other's block
+            return *this;        // Return reference to modified matrix
         }
-        delete[] matrix; // Delete the array of pointers
-
-        // Allocate new resources
-        size = other.size;           // Update size
-        matrix = new double *[size]; // Allocate new array of pointers
-
-        for (size_t i = 0; i < size; i++) // Loop through rows
+        if (size != other.size || isShared()) // Existing storage can't be reused
         {
-            matrix[i] = new double[size];     // Allocate new row
-            for (size_t j = 0; j < size; j++) // Loop through columns
-            {
-                matrix[i][j] = other.matrix[i][j]; // Copy values from other matrix
-            }
+            std::pmr::memory_resource *owner = resource; // New storage comes from our own resource
+            releaseStorage();      // Free current resources
+            size = other.size;     // Update size
+            acquireStorage(owner); // Allocate new resources
         }
+        if (size > 0) // Moved-from matrices have nothing to copy
+        {
+            std::copy(other.matrix[0], other.matrix[0] + size * size, matrix[0]); // Copy values from other matrix
+            header()->unshareable.store(false, std::memory_order_relaxed);        // Assignment invalidates earlier row pointers
+        }
+        structureCache.store(other.cachedStructure(), std::memory_order_relaxed); // Same contents, same structure
 
         return *this; // Return reference to modified matrix
     }
 
+    /**
+     * @brief Move assignment operator implementation
+     * @param other The matrix to move from
+     * @return Reference to this matrix after assignment
+     */
+    SquareMat &SquareMat::operator=(SquareMat &&other) // Move assignment operator definition
+    {
+        SQUAREMAT_STAT_SCOPE(MoveAssign, 0, 0); // Count the call
+        SQUAREMAT_TRACE_SCOPE("move assign", "operator"); // Timeline event
+        if (this == &other) // Check for self-assignment
+        {
+            return *this; // Return if self-assignment
+        }
+        if (!(*resource == *other.resource)) // Storage from incompatible resources: copy into our own
+        {
+            return *this = static_cast<const SquareMat &>(other); // Reuse or reallocate from our own storage source
+        }
+        std::swap(size, other.size);                                          // Exchange sizes
+        std::swap(matrix, other.matrix);                                      // Exchange storage (other frees ours)
+        unsigned mine = structureCache.load(std::memory_order_relaxed);       // Our cached structure
+        structureCache.store(other.structureCache.load(std::memory_order_relaxed), std::memory_order_relaxed); // Adopt the cached structure
+        other.structureCache.store(mine, std::memory_order_relaxed);          // Other now holds our old contents
+        return *this;                                                         // Return reference to modified matrix
+    }
+
     /**
      * @brief Compound assignment addition operator implementation
      * @param other Matrix to add to this matrix
@@ -227,17 +999,21 @@ namespace squaremat // Start of the squaremat namespace
      */
     SquareMat &SquareMat::operator+=(const SquareMat &other) // Compound addition operator definition
     {
+        SQUAREMAT_STAT_SCOPE(AddAssign, 3 * size * size, size * size); // Count the call
+        SQUAREMAT_TRACE_SCOPE("+=", "operator"); // Timeline event
         if (size != other.size) // Check if matrices have compatible sizes
         {
             throw std::invalid_argument("Matrix sizes must match"); // Throw exception if sizes don't match
         }
-        for (size_t i = 0; i < size; i++) // Loop through rows
-        {
-            for (size_t j = 0; j < size; j++) // Loop through columns
+        makeWritable();                    // Contents change
+        double *a = matrix[0];             // Elements of this matrix
+        const double *b = other.matrix[0]; // Elements of the other matrix (may alias a)
+        forEachRowChunk([&](size_t first, size_t last) {
+            for (size_t k = first * size; k < last * size; k++) // Loop through the chunk's elements
             {
-                matrix[i][j] += other.matrix[i][j]; // Add corresponding elements
+                a[k] += b[k]; // Add corresponding elements
             }
-        }
+        });
         return *this; // Return reference to modified matrix
     }
 
@@ -249,17 +1025,21 @@ namespace squaremat // Start of the squaremat namespace
      */
     SquareMat &SquareMat::operator-=(const SquareMat &other) // Compound subtraction operator definition
     {
+        SQUAREMAT_STAT_SCOPE(SubtractAssign, 3 * size * size, size * size); // Count the call
+        SQUAREMAT_TRACE_SCOPE("-=", "operator"); // Timeline event
         if (size != other.size) // Check if matrices have compatible sizes
         {
             throw std::invalid_argument("Matrix sizes must match"); // Throw exception if sizes don't match
         }
-        for (size_t i = 0; i < size; i++) // Loop through rows
-        {
-            for (size_t j = 0; j < size; j++) // Loop through columns
+        makeWritable();                    // Contents change
+        double *a = matrix[0];             // Elements of this matrix
+        const double *b = other.matrix[0]; // Elements of the other matrix (may alias a)
+        forEachRowChunk([&](size_t first, size_t last) {
+            for (size_t k = first * size; k < last * size; k++) // Loop through the chunk's elements
             {
-                matrix[i][j] -= other.matrix[i][j]; // Subtract corresponding elements
+                a[k] -= b[k]; // Subtract corresponding elements
             }
-        }
+        });
         return *this; // Return reference to modified matrix
     }
 
@@ -271,14 +1051,88 @@ namespace squaremat // Start of the squaremat namespace
      */
     SquareMat &SquareMat::operator*=(const SquareMat &other) // Compound multiplication operator definition
     {
+        SQUAREMAT_STAT_SCOPE(MultiplyAssign, size * size, 0); // Count the call (the product counts its own flops)
+        SQUAREMAT_TRACE_SCOPE("*=", "operator"); // Timeline event
         if (size != other.size) // Check if matrices have compatible sizes
         {
             throw std::invalid_argument("Matrix sizes must match"); // Throw exception if sizes don't match
         }
 
-        SquareMat temp = *this * other; // Calculate product using regular multiplication
-        *this = temp;                   // Preserve size (since size doesn't change)
+        *this = *this * other; // Calculate product and move it in (size doesn't change)
+
+        return *this; // Return reference to modified matrix
+    }
 
+    /**
+     * @brief Fused scaled addition implementation
+     * @param other Matrix to add
+     * @param scalar Scale of other
+     * @return Reference to this matrix
+     * @throws std::invalid_argument if matrix sizes don't match
+     */
+    SquareMat &SquareMat::addScaled(const SquareMat &other, double scalar) // Fused scaled addition definition
+    {
+        SQUAREMAT_STAT_SCOPE(AddScaled, 3 * size * size, 2 * size * size); // Count the call
+        SQUAREMAT_TRACE_SCOPE("addScaled", "operator"); // Timeline event
+        if (size != other.size) // Check if matrices have compatible sizes
+        {
+            throw std::invalid_argument("Matrix sizes must match"); // Throw exception if sizes don't match
+        }
+        makeWritable();        // Contents change
+        if (this == &other) // this += scalar * this
+        {
+            double factor = 1 + scalar;  // Combined scale of the single operand
+            double *a = matrix[0]; // Elements of this matrix
+            forEachRowChunk([&](size_t first, size_t last) {
+                for (size_t k = first * size; k < last * size; k++) // Loop through the chunk's elements
+                {
+                    a[k] *= factor; // Scale in place (zero allowed, unlike *=)
+                }
+            });
+            return *this; // Return reference to modified matrix
+        }
+        double *a = matrix[0];             // Elements of this matrix
+        const double *b = other.matrix[0]; // Elements of the other matrix (distinct storage)
+        forEachRowChunk([&](size_t first, size_t last) {
+            kernels::axpy(scalar, b + first * size, a + first * size, (last - first) * size); // Vectorized update of the chunk
+        });
+        return *this; // Return reference to modified matrix
+    }
+
+    /**
+     * @brief Fused scale and add implementation
+     * @param scale Scale of this matrix
+     * @param other Matrix to add
+     * @param otherScale Scale of other
+     * @return Reference to this matrix
+     * @throws std::invalid_argument if matrix sizes don't match
+     */
+    SquareMat &SquareMat::scaleAndAdd(double scale, const SquareMat &other, double otherScale) // Fused scale and add definition
+    {
+        SQUAREMAT_STAT_SCOPE(AddScaled, 3 * size * size, 3 * size * size); // Count the call
+        SQUAREMAT_TRACE_SCOPE("scaleAndAdd", "operator"); // Timeline event
+        if (size != other.size) // Check if matrices have compatible sizes
+        {
+            throw std::invalid_argument("Matrix sizes must match"); // Throw exception if sizes don't match
+        }
+        makeWritable();        // Contents change
+        if (this == &other) // this = (scale + otherScale) * this
+        {
+            double factor = scale + otherScale;  // Combined scale of the single operand
+            double *a = matrix[0]; // Elements of this matrix
+            forEachRowChunk([&](size_t first, size_t last) {
+                for (size_t k = first * size; k < last * size; k++) // Loop through the chunk's elements
+                {
+                    a[k] *= factor; // Scale in place (zero allowed, unlike *=)
+                }
+            });
+            return *this; // Return reference to modified matrix
+        }
+        double *a = matrix[0];             // Elements of this matrix
+        const double *b = other.matrix[0]; // Elements of the other matrix (distinct storage)
+        forEachRowChunk([&](size_t first, size_t last) {
+            kernels::axpby(otherScale, b + first * size, scale, a + first * size, (last - first) * size); // Vectorized update of the chunk
+        });
         return *this; // Return reference to modified matrix
     }
 
@@ -290,17 +1144,20 @@ namespace squaremat // Start of the squaremat namespace
      */
     SquareMat &SquareMat::operator*=(double scalar) // Compound scalar multiplication operator definition
     {
+        SQUAREMAT_STAT_SCOPE(ScalarMultiplyAssign, 2 * size * size, size * size); // Count the call
+        SQUAREMAT_TRACE_SCOPE("*= scalar", "operator"); // Timeline event
         if (scalar == 0) // Check if scalar is zero
         {
             throw std::invalid_argument("Scalar must be non-zero"); // Throw exception if scalar is zero
         }
-        for (size_t i = 0; i < size; i++) // Loop through rows
-        {
-            for (size_t j = 0; j < size; j++) // Loop through columns
+        makeWritable();                    // Contents change
+        double *a = matrix[0];             // Elements of this matrix
+        forEachRowChunk([&](size_t first, size_t last) {
+            for (size_t k = first * size; k < last * size; k++) // Loop through the chunk's elements
             {
-                matrix[i][j] *= scalar; // Multiply each element by scalar
+                a[k] *= scalar; // Multiply each element by scalar
             }
-        }
+        });
         return *this; // Return reference to modified matrix
     }
 
@@ -312,17 +1169,20 @@ namespace squaremat // Start of the squaremat namespace
      */
     SquareMat &SquareMat::operator/=(double scalar) // Compound division operator definition
     {
+        SQUAREMAT_STAT_SCOPE(DivideAssign, 2 * size * size, size * size); // Count the call
+        SQUAREMAT_TRACE_SCOPE("/=", "operator"); // Timeline event
         if (scalar == 0) // Check if scalar is zero
         {
             throw std::invalid_argument("Scalar must be non-zero"); // Throw exception if scalar is zero
         }
-        for (size_t i = 0; i < size; i++) // Loop through rows
-        {
-            for (size_t j = 0; j < size; j++) // Loop through columns
+        makeWritable();                    // Contents change
+        double *a = matrix[0];             // Elements of this matrix
+        forEachRowChunk([&](size_t first, size_t last) {
+            for (size_t k = first * size; k < last * size; k++) // Loop through the chunk's elements
             {
-                matrix[i][j] /= scalar; // Divide each element by scalar
+                a[k] /= scalar; // Divide each element by scalar
             }
-        }
+        });
         return *this; // Return reference to modified matrix
     }
 
@@ -334,17 +1194,21 @@ namespace squaremat // Start of the squaremat namespace
      */
     SquareMat &SquareMat::operator%=(const SquareMat &other) // Compound element-wise multiplication operator definition
     {
+        SQUAREMAT_STAT_SCOPE(ElementwiseMultiplyAssign, 3 * size * size, size * size); // Count the call
+        SQUAREMAT_TRACE_SCOPE("%= matrix", "operator"); // Timeline event
         if (size != other.size) // Check if matrices have compatible sizes
         {
             throw std::invalid_argument("Matrix sizes must match"); // Throw exception if sizes don't match
         }
-        for (size_t i = 0; i < size; i++) // Loop through rows
-        {
-            for (size_t j = 0; j < size; j++) // Loop through columns
+        makeWritable();                    // Contents change
+        double *a = matrix[0];             // Elements of this matrix
+        const double *b = other.matrix[0]; // Elements of the other matrix (may alias a)
+        forEachRowChunk([&](size_t first, size_t last) {
+            for (size_t k = first * size; k < last * size; k++) // Loop through the chunk's elements
             {
-                matrix[i][j] *= other.matrix[i][j]; // Multiply corresponding elements
+                a[k] *= b[k]; // Multiply corresponding elements
             }
-        }
+        });
         return *this; // Return reference to modified matrix
     }
 
@@ -356,17 +1220,20 @@ namespace squaremat // Start of the squaremat namespace
      */
     SquareMat &SquareMat::operator%=(int scalar) // Compound modulo operator definition
     {
+        SQUAREMAT_STAT_SCOPE(ModuloAssign, 2 * size * size, size * size); // Count the call
+        SQUAREMAT_TRACE_SCOPE("%= scalar", "operator"); // Timeline event
         if (scalar == 0) // Check if scalar is zero
         {
             throw std::invalid_argument("Scalar must be non-zero"); // Throw exception if scalar is zero
         }
-        for (size_t i = 0; i < size; i++) // Loop through rows
-        {
-            for (size_t j = 0; j < size; j++) // Loop through columns
+        makeWritable();                    // Contents change
+        double *a = matrix[0];             // Elements of this matrix
+        forEachRowChunk([&](size_t first, size_t last) {
+            for (size_t k = first * size; k < last * size; k++) // Loop through the chunk's elements
             {
-                matrix[i][j] = fmod(matrix[i][j], scalar); // Apply modulo to each element
+                a[k] = fmod(a[k], scalar); // Apply modulo to each element
             }
-        }
+        });
         return *this; // Return reference to modified matrix
     }
 
@@ -3,6 +3,12 @@
 #include <iostream>  // Include for input/output operations
 #include <stdexcept> // Include for standard exceptions
 #include <cmath>     // Include for mathematical functions
+#include <atomic>    // Include for the thread-safe structure cache
+#include <vector>    // Include for the arena's chunk list
+#include <memory_resource> // Include for pluggable std::pmr allocation
+#include "threadpool.hpp" // Include for the parallel element-wise loops
+#include "stats.hpp"      // Include for the optional operator counters
+#include "trace.hpp"      // Include for the timeline events
 
 /**
  * @namespace squaremat
@@ -19,66 +25,307 @@ namespace squaremat // Start of namespace definition
      */
     class SquareMat // Class definition for square matrix
     {
+    public:
+        /**
+         * @brief Bit flags describing the structure detected by structure()
+         *
+         * Diagonal is the combination of both triangular flags, and Identity is a
+         * diagonal permutation, so `(structure() & flags) == flags` tests for a shape.
+         */
+        enum Structure : unsigned
+        {
+            General = 0,                            ///< No special structure
+            UpperTriangular = 1u << 0,              ///< All elements below the diagonal are zero
+            LowerTriangular = 1u << 1,              ///< All elements above the diagonal are zero
+            Diagonal = UpperTriangular | LowerTriangular, ///< All off-diagonal elements are zero
+            Permutation = 1u << 2,                  ///< Exactly one 1 in every row and column, zeros elsewhere
+            Identity = Diagonal | Permutation       ///< The identity matrix
+        };
+
+        /**
+         * @brief Accuracy mode of sum()
+         */
+        enum class Summation
+        {
+            Naive,      ///< Plain multi-accumulator sum, error grows with n^2
+            Pairwise,   ///< Cascade sum, error grows with log n
+            Compensated ///< Neumaier compensated sum, error independent of n
+        };
+
+        static constexpr size_t SumBlock = 4096; ///< Elements per fixed block of sum(); blocks never depend on the thread count
+
+        class Arena; // Scoped bump allocator for temporaries, defined below
+
+        /**
+         * @brief Resource that new matrices use when none is given
+         * @return Innermost live Arena on this thread, or heapResource()
+         */
+        static std::pmr::memory_resource *defaultResource(); // Declaration of the default resource accessor
+
+        /**
+         * @brief Heap resource behind matrices outside any arena
+         *
+         * Places matrices above HugePageResource::instance().getThreshold() bytes on 2 MB pages
+         * and forwards everything else to std::pmr::new_delete_resource().
+         * @return The shared HugePageResource
+         */
+        static std::pmr::memory_resource *heapResource(); // Declaration of the heap resource accessor
+
     private:
-        size_t size;     ///< Size of the square matrix (number of rows/columns) - Unsigned integer
-        double **matrix; ///< 2D array to store matrix elements - Pointer to array of pointers
+        static constexpr unsigned UnknownStructure = 1u << 31; ///< Cache marker for "not classified since the last write"
 
-    public:
         /**
-         * @brief Constructor that creates a square matrix of specified size
-         * @param size The size of the square matrix (number of rows/columns)
-         * @throws std::invalid_argument if size is not positive
+         * @brief Bookkeeping stored after the row pointers of every storage block
          */
-        SquareMat(size_t size) : size(size), matrix(new double *[size]) // Constructor with initialization list
+        struct StorageHeader
         {
-            if (size <= 0) // Check if size is valid
-            {
-                throw std::invalid_argument("Size must be positive"); // Throw exception for invalid size
-            }
-            for (size_t i = 0; i < size; i++) // Loop through each row
+            std::atomic<size_t> owners;       ///< Matrices sharing the block (thread-safe)
+            std::pmr::memory_resource *owner; ///< Resource the block was allocated from
+            std::atomic<bool> unshareable;    ///< A mutable row pointer was handed out, so copies must not share the block
+
+            /**
+             * @brief Header of a block with a single owner
+             * @param owner Resource the block was allocated from
+             */
+            explicit StorageHeader(std::pmr::memory_resource *owner) : owners(1), owner(owner), unshareable(false) {} // Constructor with initialization list
+        };
+
+        size_t size;                                ///< Size of the square matrix (number of rows/columns) - Unsigned integer
+        double **matrix;                            ///< 2D array to store matrix elements - Row pointers into one contiguous block
+        std::pmr::memory_resource *resource;        ///< Memory resource new storage of this matrix comes from
+        mutable std::atomic<unsigned> structureCache; ///< Cached Structure flags, UnknownStructure when stale
+
+        /**
+         * @brief Mark the cached structure as stale after a write
+         */
+        void invalidateStructure() { structureCache.store(UnknownStructure, std::memory_order_relaxed); } // Drop the cached flags
+
+        /**
+         * @brief Cached structure flags that may be trusted
+         *
+         * Writes through a row pointer handed out by operator[] bypass invalidation, so
+         * the cache of such a block is never trusted (and never copied).
+         * @return structureCache, or UnknownStructure while a row pointer is out
+         */
+        unsigned cachedStructure() const // Trusted cache lookup
+        {
+            if (matrix != nullptr && header()->unshareable.load(std::memory_order_relaxed)) // A row pointer is out
             {
-                matrix[i] = new double[size](); // Allocate memory for each row and initialize to 0
+                return UnknownStructure; // Contents may have changed behind the cache
             }
+            return structureCache.load(std::memory_order_relaxed); // Cache is current
         }
 
         /**
-         * @brief Copy constructor
-         * @param other The matrix to copy
+         * @brief Header of the current storage block
+         * @return Header located after the row pointers (matrix must not be null)
+         */
+        StorageHeader *header() const { return reinterpret_cast<StorageHeader *>(matrix + size); } // Header lookup
+
+        /**
+         * @brief Prepare the storage for a write: take a private copy if it is shared
+         *
+         * Every mutating member calls this before it takes element pointers.
          */
-        SquareMat(const SquareMat &other) : size(other.size), matrix(new double *[other.size]) // Copy constructor with initialization list
+        void makeWritable() // Copy-on-write check
         {
-            for (size_t i = 0; i < size; i++) // Loop through each row
+            if (matrix != nullptr && header()->owners.load(std::memory_order_acquire) != 1) // Someone else still reads the block
             {
-                matrix[i] = new double[size];     // Allocate memory for each row
-                for (size_t j = 0; j < size; j++) // Loop through each column
-                {
-                    matrix[i][j] = other.matrix[i][j]; // Copy values from other matrix
-                }
+                unshare(); // Deep copy now
             }
+            invalidateStructure(); // Contents change
         }
 
         /**
-         * @brief Destructor to free allocated memory
+         * @brief Replace shared storage by a private copy from this matrix's resource
+         */
+        void unshare(); // Declaration of the deferred copy
+
+        /**
+         * @brief Check whether another matrix's block may be shared by a matrix using target
+         *
+         * Blocks are shared within the same resource, and blocks of the library heap
+         * (which outlives every matrix) with anyone, so a shared block never outlives
+         * its resource. Blocks marked unshareable by operator[] are never shared.
+         * @param other Matrix whose block would be shared
+         * @param target Resource of the matrix that would share it
+         * @param anyHeapBlock Also share heap blocks when target is a different resource
+         * @return true if sharing is safe
+         */
+        static bool canShare(const SquareMat &other, std::pmr::memory_resource *target, bool anyHeapBlock); // Declaration of the sharing rule
+
+        /**
+         * @brief Release the current storage and share other's block instead
+         * @param other Matrix to share with (must have storage)
+         */
+        void shareStorage(const SquareMat &other); // Declaration of storage sharing
+
+        /**
+         * @brief Allocate storage from owner and copy other's elements into it
+         * @param other Matrix to copy
+         * @param owner Memory resource to allocate from
+         */
+        void copyStorage(const SquareMat &other, std::pmr::memory_resource *owner); // Declaration of the deep copy
+
+        /**
+         * @brief Postfix step: hand the current storage to the result and refill this matrix
+         * @param delta Value added to every element of this matrix
+         * @return Matrix holding the previous contents
+         */
+        SquareMat takeShifted(double delta); // Declaration of the postfix kernel
+
+        /**
+         * @brief One-pass structural classifier
+         * @return Structure flags of the current contents
+         */
+        unsigned classify() const; // Declaration of the classifier
+
+        /**
+         * @brief this += alpha * a * b with the blocked, row-parallel product kernel
+         *
+         * Sizes must match and this must not be a or b; the chunks are this matrix's
+         * first-touch row chunks.
+         * @param alpha Scale of the product
+         * @param a Left operand
+         * @param b Right operand
+         * @param left Structure flags of a
+         * @param right Structure flags of b
+         */
+        void accumulateProduct(double alpha, const SquareMat &a, const SquareMat &b, unsigned left, unsigned right); // Declaration of the shared product kernel
+
+        /**
+         * @brief Allocate uninitialized storage for the current size as a single block
+         *
+         * The block holds the size*size elements followed by the row pointers and the
+         * StorageHeader, so a matrix costs one allocation instead of size+1.
+         * @param owner Memory resource to allocate from
+         */
+        void acquireStorage(std::pmr::memory_resource *owner); // Declaration of storage allocation
+
+        /**
+         * @brief Allocate and lay out one storage block with a single owner
+         * @param size Matrix size (must be positive)
+         * @param owner Memory resource to allocate from
+         * @return Row pointers into the uninitialized elements
+         */
+        static double **allocateBlock(size_t size, std::pmr::memory_resource *owner); // Declaration of block allocation
+
+        /**
+         * @brief Drop one owner of a block and free it after the last one
+         * @param rows Row pointers of the block (nullptr is ignored)
+         * @param size Matrix size of the block
+         */
+        static void releaseBlock(double **rows, size_t size); // Declaration of block release
+
+        /**
+         * @brief Give up this matrix's share of its storage block
          */
-        ~SquareMat() // Destructor definition
+        void releaseStorage(); // Declaration of storage release
+
+        /**
+         * @brief Resource for matrices derived from this one (operator results and copies)
+         *
+         * A resource chosen explicitly is inherited, so a whole computation stays in it;
+         * matrices on the library heap resource follow the active arena instead.
+         * @return Memory resource for the derived matrix
+         */
+        std::pmr::memory_resource *derivedResource() const // Derived resource selection
+        {
+            return resource == heapResource() ? defaultResource() : resource; // Inherit explicit resources only
+        }
+
+        /**
+         * @brief Run body(first, last) over contiguous row chunks of this matrix
+         *
+         * Matrices too small for two chunks of ThreadPool::ParallelElements run inline;
+         * larger ones are split across the shared pool with the same chunks the
+         * constructors use for first touch.
+         * @param body Callable receiving the first row and one past the last row of a chunk
+         */
+        template <typename Body>
+        void forEachRowChunk(const Body &body) const // Row chunk loop
         {
-            if (matrix != nullptr) // Check if matrix is not null
+            if (size * size < 2 * ThreadPool::ParallelElements) // Not worth a task
             {
-                for (size_t i = 0; i < size; i++) // Loop through each row
-                {
-                    delete[] matrix[i]; // Delete each row array
-                }
-                delete[] matrix; // Delete the array of pointers
+                SQUAREMAT_TRACE_SCOPE("kernel", "phase"); // Timeline event
+                body(0, size);                            // Serial inline path
+                return;                                   // Done
             }
+            bool follow = SQUAREMAT_TRACE_RECORDING(); // Workers record their chunks when the operator is sampled
+            (void)follow;                              // Unused when tracing is compiled out
+            ThreadPool::instance().parallelFor(0, size, ThreadPool::rowGrain(size), [&](size_t first, size_t last) {
+                SQUAREMAT_TRACE_FOLLOW("kernel", "phase", follow); // Timeline event on the worker
+                body(first, last);                                 // One chunk per thread
+            });
         }
 
+    public:
+        /**
+         * @brief Constructor that creates a zero square matrix of specified size
+         * @param size The size of the square matrix (number of rows/columns)
+         * @param resource Memory resource for the storage (nullptr uses defaultResource())
+         * @throws std::invalid_argument if size is not positive
+         */
+        SquareMat(size_t size, std::pmr::memory_resource *resource = nullptr); // Declaration of constructor
+
+        /**
+         * @brief Copy constructor
+         *
+         * The copy inherits an explicitly chosen resource of other; otherwise it follows
+         * defaultResource(). It shares other's storage (copy-on-write) when the block is
+         * on that resource or on the library heap, and copies the elements otherwise.
+         * @param other The matrix to copy
+         */
+        SquareMat(const SquareMat &other); // Declaration of copy constructor
+
+        /**
+         * @brief Copy constructor with an explicit memory resource
+         *
+         * Shares other's storage only when it already lives on resource, so the
+         * elements of the copy are always placed where requested.
+         * @param other The matrix to copy
+         * @param resource Memory resource for the storage of the copy
+         */
+        SquareMat(const SquareMat &other, std::pmr::memory_resource *resource); // Declaration of resource copy constructor
+
+        /**
+         * @brief Move constructor that takes over the storage of a temporary
+         * @param other The matrix to move from (left empty)
+         */
+        SquareMat(SquareMat &&other) noexcept : size(other.size), matrix(other.matrix), resource(other.resource), structureCache(other.structureCache.load(std::memory_order_relaxed)) // Move constructor with initialization list
+        {
+            other.size = 0;         // Source no longer owns elements
+            other.matrix = nullptr; // Source no longer owns storage
+        }
+
+        /**
+         * @brief Destructor to free allocated memory
+         */
+        ~SquareMat() { releaseStorage(); } // Destructor definition
+
         /**
          * @brief Assignment operator
+         *
+         * Shares other's storage under the same rule as the copy constructor. Otherwise the
+         * storage is reused when the sizes match and it is not shared; new storage comes from
+         * this matrix's own resource (the resource is never propagated by assignment), so
+         * assigning into a matrix declared outside an arena scope never leaves it pointing
+         * into the arena.
          * @param other The matrix to assign from
          * @return Reference to this matrix after assignment
          */
         SquareMat &operator=(const SquareMat &other); // Declaration of assignment operator
 
+        /**
+         * @brief Move assignment operator
+         *
+         * Takes over the storage when both matrices use equal memory resources and falls
+         * back to copying otherwise.
+         * @param other The matrix to move from
+         * @return Reference to this matrix after assignment
+         */
+        SquareMat &operator=(SquareMat &&other); // Declaration of move assignment operator
+
         /**
          * @brief Addition operator for matrices
          * @param other Matrix to add to this matrix
@@ -87,18 +334,22 @@ namespace squaremat // Start of namespace definition
          */
         SquareMat operator+(const SquareMat &other) const // Addition operator overload
         {
+            SQUAREMAT_STAT_SCOPE(Add, 3 * size * size, size * size); // Count the call
+            SQUAREMAT_TRACE_SCOPE("+", "operator"); // Timeline event
             if (size != other.size) // Check if matrices have same size
             {
                 throw std::invalid_argument("Matrix sizes must match"); // Throw exception if sizes don't match
             }
-            SquareMat result(size);           // Create result matrix of same size
-            for (size_t i = 0; i < size; i++) // Loop through rows
-            {
-                for (size_t j = 0; j < size; j++) // Loop through columns
+            SquareMat result(size, derivedResource()); // Create result matrix of same size
+            const double *a = matrix[0];               // Elements of this matrix
+            const double *b = other.matrix[0];         // Elements of the other matrix
+            double *out = result.matrix[0];            // Elements of the result
+            forEachRowChunk([&](size_t first, size_t last) {
+                for (size_t k = first * size; k < last * size; k++) // Loop through the chunk's elements
                 {
-                    result.matrix[i][j] = matrix[i][j] + other.matrix[i][j]; // Add corresponding elements
+                    out[k] = a[k] + b[k]; // Add corresponding elements
                 }
-            }
+            });
             return result; // Return the resulting matrix
         }
 
@@ -110,18 +361,22 @@ namespace squaremat // Start of namespace definition
          */
         SquareMat operator-(const SquareMat &other) const // Subtraction operator overload
         {
+            SQUAREMAT_STAT_SCOPE(Subtract, 3 * size * size, size * size); // Count the call
+            SQUAREMAT_TRACE_SCOPE("-", "operator"); // Timeline event
             if (size != other.size) // Check if matrices have same size
             {
                 throw std::invalid_argument("Matrix sizes must match"); // Throw exception if sizes don't match
             }
-            SquareMat result(size);           // Create result matrix of same size
-            for (size_t i = 0; i < size; i++) // Loop through rows
-            {
-                for (size_t j = 0; j < size; j++) // Loop through columns
+            SquareMat result(size, derivedResource()); // Create result matrix of same size
+            const double *a = matrix[0];               // Elements of this matrix
+            const double *b = other.matrix[0];         // Elements of the other matrix
+            double *out = result.matrix[0];            // Elements of the result
+            forEachRowChunk([&](size_t first, size_t last) {
+                for (size_t k = first * size; k < last * size; k++) // Loop through the chunk's elements
                 {
-                    result.matrix[i][j] = matrix[i][j] - other.matrix[i][j]; // Subtract corresponding elements
+                    out[k] = a[k] - b[k]; // Subtract corresponding elements
                 }
-            }
+            });
             return result; // Return the resulting matrix
         }
 
@@ -131,25 +386,59 @@ namespace squaremat // Start of namespace definition
          */
         SquareMat operator-() const // Unary minus operator overload
         {
-            SquareMat result(size);           // Create result matrix of same size
-            for (size_t i = 0; i < size; i++) // Loop through rows
-            {
-                for (size_t j = 0; j < size; j++) // Loop through columns
+            SQUAREMAT_STAT_SCOPE(Negate, 2 * size * size, size * size); // Count the call
+            SQUAREMAT_TRACE_SCOPE("unary -", "operator"); // Timeline event
+            SquareMat result(size, derivedResource()); // Create result matrix of same size
+            const double *a = matrix[0];               // Elements of this matrix
+            double *out = result.matrix[0];            // Elements of the result
+            forEachRowChunk([&](size_t first, size_t last) {
+                for (size_t k = first * size; k < last * size; k++) // Loop through the chunk's elements
                 {
-                    result.matrix[i][j] = -matrix[i][j]; // Negate each element
+                    out[k] = -a[k]; // Negate each element
                 }
-            }
+            });
             return result; // Return the resulting matrix
         }
 
         /**
          * @brief Matrix multiplication operator
+         *
+         * Diagonal and permutation operands reduce to O(n^2) row/column scaling or
+         * permutation, and triangular operands skip their known zeros.
          * @param other Matrix to multiply with this matrix
          * @return New matrix containing the product
          * @throws std::invalid_argument if matrix sizes don't match
          */
         SquareMat operator*(const SquareMat &other) const; // Declaration of matrix multiplication operator
 
+        /**
+         * @brief Accumulate a scaled product into this matrix: this += alpha * a * b
+         *
+         * Uses the multiplication kernel directly on this matrix's storage, so no
+         * temporaries are allocated unless this matrix is a or b.
+         * @param a Left factor
+         * @param b Right factor
+         * @param alpha Scale of the product
+         * @return Reference to this matrix
+         * @throws std::invalid_argument if matrix sizes don't match
+         */
+        SquareMat &addProduct(const SquareMat &a, const SquareMat &b, double alpha = 1.0); // Declaration of in-place product accumulation
+
+        /**
+         * @brief BLAS-style general product: c = alpha * a * b + beta * c, in place
+         *
+         * beta = 0 overwrites c without reading it (NaNs in c do not propagate), as in
+         * BLAS. Each row chunk of c is scaled and then accumulated while it is in cache.
+         * If c is a or b, the product is formed in one temporary first.
+         * @param alpha Scale of the product
+         * @param a Left factor
+         * @param b Right factor
+         * @param beta Scale of the previous contents of c
+         * @param c Matrix that receives the result
+         * @throws std::invalid_argument if matrix sizes don't match
+         */
+        friend void gemm(double alpha, const SquareMat &a, const SquareMat &b, double beta, SquareMat &c); // Declaration of the friend GEMM
+
         /**
          * @brief Scalar multiplication operator (right side)
          * @param scalar Value to multiply matrix elements by
@@ -189,23 +478,30 @@ namespace squaremat // Start of namespace definition
          */
         SquareMat operator/(double scalar) const // Division operator overload
         {
+            SQUAREMAT_STAT_SCOPE(Divide, 2 * size * size, size * size); // Count the call
+            SQUAREMAT_TRACE_SCOPE("/", "operator"); // Timeline event
             if (scalar == 0) // Check if scalar is zero
             {
                 throw std::invalid_argument("Division by zero"); // Throw exception for division by zero
             }
-            SquareMat result(size);           // Create result matrix of same size
-            for (size_t i = 0; i < size; i++) // Loop through rows
-            {
-                for (size_t j = 0; j < size; j++) // Loop through columns
+            SquareMat result(size, derivedResource()); // Create result matrix of same size
+            const double *a = matrix[0];               // Elements of this matrix
+            double *out = result.matrix[0];            // Elements of the result
+            forEachRowChunk([&](size_t first, size_t last) {
+                for (size_t k = first * size; k < last * size; k++) // Loop through the chunk's elements
                 {
-                    result.matrix[i][j] = matrix[i][j] / scalar; // Divide each element by scalar
+                    out[k] = a[k] / scalar; // Divide each element by scalar
                 }
-            }
+            });
             return result; // Return the resulting matrix
         }
 
         /**
          * @brief Power operator
+         *
+         * Identity, diagonal and permutation matrices are raised in O(n log power)
+         * (plus O(n^2) to build the result); other matrices use binary exponentiation
+         * with at most 2 log2(power) products through gemm().
          * @param power The exponent to raise the matrix to
          * @return New matrix containing the result of matrix^power
          * @throws std::invalid_argument if power is negative
@@ -218,25 +514,31 @@ namespace squaremat // Start of namespace definition
          */
         SquareMat operator++()                // Prefix increment operator overload
         {                                     // prefix increment
-            for (size_t i = 0; i < size; i++) // Loop through rows
-            {
-                for (size_t j = 0; j < size; j++) // Loop through columns
+            SQUAREMAT_STAT_SCOPE(Increment, size * size, size * size); // Count the call
+            SQUAREMAT_TRACE_SCOPE("++", "operator"); // Timeline event
+            makeWritable();         // Contents change (copy first if shared)
+            double *a = matrix[0];  // Elements of this matrix
+            forEachRowChunk([&](size_t first, size_t last) {
+                for (size_t k = first * size; k < last * size; k++) // Loop through the chunk's elements
                 {
-                    matrix[i][j]++; // Increment each element
+                    a[k]++; // Increment each element
                 }
-            }
+            });
             return *this; // return the modified matrix
         }
 
         /**
          * @brief Postfix increment operator
-         * @return Copy of the matrix before incrementing
-         */
-        SquareMat operator++(int)  // Postfix increment operator overload
-        {                          // postfix increment
-            SquareMat temp(*this); // Create a copy of current matrix
-            ++(*this);             // Call prefix increment on this matrix
-            return temp;           // return the original matrix
+         *
+         * The returned matrix takes over the current storage and the incremented values
+         * are written to new storage, so nothing is copied.
+         * @return The matrix before incrementing
+         */
+        SquareMat operator++(int) // Postfix increment operator overload
+        {                         // postfix increment
+            SQUAREMAT_STAT_SCOPE(Increment, 2 * size * size, size * size); // Count the call
+            SQUAREMAT_TRACE_SCOPE("++", "operator"); // Timeline event
+            return takeShifted(1);                   // return the original matrix
         }
 
         /**
@@ -245,46 +547,48 @@ namespace squaremat // Start of namespace definition
          */
         SquareMat operator--()                // Prefix decrement operator overload
         {                                     // prefix decrement
-            for (size_t i = 0; i < size; i++) // Loop through rows
-            {
-                for (size_t j = 0; j < size; j++) // Loop through columns
+            SQUAREMAT_STAT_SCOPE(Decrement, size * size, size * size); // Count the call
+            SQUAREMAT_TRACE_SCOPE("--", "operator"); // Timeline event
+            makeWritable();         // Contents change (copy first if shared)
+            double *a = matrix[0];  // Elements of this matrix
+            forEachRowChunk([&](size_t first, size_t last) {
+                for (size_t k = first * size; k < last * size; k++) // Loop through the chunk's elements
                 {
-                    matrix[i][j]--; // Decrement each element
+                    a[k]--; // Decrement each element
                 }
-            }
+            });
             return *this; // return the modified matrix
         }
 
         /**
          * @brief Postfix decrement operator
-         * @return Copy of the matrix before decrementing
-         */
-        SquareMat operator--(int)  // Postfix decrement operator overload
-        {                          // postfix decrement
-            SquareMat temp(*this); // Create a copy of current matrix
-            --(*this);             // Call prefix decrement on this matrix
-            return temp;           // return the original matrix
+         *
+         * The returned matrix takes over the current storage and the decremented values
+         * are written to new storage, so nothing is copied.
+         * @return The matrix before decrementing
+         */
+        SquareMat operator--(int) // Postfix decrement operator overload
+        {                         // postfix decrement
+            SQUAREMAT_STAT_SCOPE(Decrement, 2 * size * size, size * size); // Count the call
+            SQUAREMAT_TRACE_SCOPE("--", "operator"); // Timeline event
+            return takeShifted(-1);                  // return the original matrix
         }
 
         /**
          * @brief Transpose operator
+         *
+         * Diagonal matrices are copied and triangular matrices only move their stored triangle.
          * @return New matrix that is the transpose of this matrix
          */
-        SquareMat operator~() const           // Transpose operator overload
-        {                                     // transpose
-            SquareMat result(size);           // Create result matrix of same size
-            for (size_t i = 0; i < size; i++) // Loop through rows
-            {
-                for (size_t j = 0; j < size; j++) // Loop through columns
-                {
-                    result.matrix[j][i] = matrix[i][j]; // Swap row and column indices
-                }
-            }
-            return result; // Return the transposed matrix
-        }
+        SquareMat operator~() const; // Declaration of transpose operator
 
         /**
          * @brief Array subscript operator (non-const version)
+         *
+         * The returned row may be written through, so the cached structure is dropped.
+         * The caller may also keep the pointer, so the block is marked unshareable (as
+         * copy-on-write strings did): later copies take a private block instead of
+         * sharing it, until this matrix is assigned to, which invalidates row pointers.
          * @param index Row index
          * @return Pointer to the row for further indexing
          * @throws std::out_of_range if index is out of bounds
@@ -295,9 +599,32 @@ namespace squaremat // Start of namespace definition
             {
                 throw std::out_of_range("Index out of bounds"); // Throw exception for invalid index
             }
-            return matrix[index]; // Return pointer to the row
+            makeWritable();                                               // Caller may write through the row pointer
+            header()->unshareable.store(true, std::memory_order_relaxed); // Caller may keep writing through it after a copy
+            return matrix[index];                                         // Return pointer to the row
         }
 
+        /**
+         * @brief Writable elements for library kernels, without marking the block
+         *
+         * The size*size elements are contiguous and row-major. Like operator[], this
+         * takes a private copy of shared storage and drops the cached structure, but the
+         * block stays shareable: the pointer is only valid until the next copy of this
+         * matrix or structure() query, so kernels use it to fill a result and drop it.
+         * @return Pointer to element (0, 0), or nullptr for a moved-from matrix
+         */
+        double *data() // Non-const element accessor
+        {
+            makeWritable();                      // Contents change (copy first if shared)
+            return matrix ? matrix[0] : nullptr; // Row 0 is the start of the elements
+        }
+
+        /**
+         * @brief Read-only elements (contiguous, row-major)
+         * @return Pointer to element (0, 0), or nullptr for a moved-from matrix
+         */
+        const double *data() const { return matrix ? matrix[0] : nullptr; } // Const element accessor
+
         /**
          * @brief Array subscript operator (const version)
          * @param index Row index
@@ -320,22 +647,65 @@ namespace squaremat // Start of namespace definition
         size_t getSize() const { return size; } // Getter method for matrix size
 
         /**
-         * @brief Calculate sum of all elements in the matrix
-         * @return Sum of all matrix elements
+         * @brief Get the memory resource that owns the storage
+         * @return Memory resource of this matrix
+         */
+        std::pmr::memory_resource *getResource() const { return resource; } // Getter method for the resource
+
+        /**
+         * @brief Check whether the storage is shared with a copy (copy-on-write)
+         * @return true if another matrix still reads the same elements
          */
-        double sum() const // Method to calculate sum of all elements
+        bool isShared() const { return matrix != nullptr && header()->owners.load(std::memory_order_acquire) != 1; } // Reference count check
+
+        /**
+         * @brief Bytes of one storage block
+         * @param size Matrix size
+         * @return Elements, row pointers and the sharing header of a size x size matrix
+         */
+        static size_t storageBytes(size_t size) { return size * size * sizeof(double) + size * sizeof(double *) + sizeof(StorageHeader); } // Block size
+
+        /**
+         * @brief Structural classification of the matrix, cached until the next write
+         *
+         * While a row pointer from operator[] is out, the matrix is classified on every
+         * call instead, since writes through the pointer cannot drop the cache.
+         * @return Combination of Structure flags (General if none apply)
+         */
+        unsigned structure() const // Cached structure getter
         {
-            double sum = 0;                   // Initialize sum to zero
-            for (size_t i = 0; i < size; i++) // Loop through rows
+            if (matrix != nullptr && header()->unshareable.load(std::memory_order_relaxed)) // A row pointer is out
             {
-                for (size_t j = 0; j < size; j++) // Loop through columns
-                {
-                    sum += matrix[i][j]; // Add each element to sum
-                }
+                return classify(); // Fresh classification, not cached
             }
-            return sum; // Return the total sum
+            unsigned flags = structureCache.load(std::memory_order_relaxed); // Read the cached flags
+            if (flags == UnknownStructure)                                  // Stale cache
+            {
+                flags = classify();                                        // Classify in one pass
+                structureCache.store(flags, std::memory_order_relaxed);    // Remember the result
+            }
+            return flags; // Return the structure flags
         }
 
+        /**
+         * @brief Check whether the matrix has all of the given structure flags
+         * @param flags Structure flags to test (e.g. SquareMat::Diagonal)
+         * @return true if every flag applies, false otherwise
+         */
+        bool hasStructure(unsigned flags) const { return (structure() & flags) == flags; } // Structure test
+
+        /**
+         * @brief Calculate sum of all elements in the matrix
+         *
+         * The elements are cut into fixed blocks of SumBlock elements, the blocks are summed
+         * in parallel and the block results are combined in index order, so the result is
+         * bit-identical for any number of threads. The comparison operators use the
+         * default Compensated mode.
+         * @param mode Accuracy mode
+         * @return Sum of all matrix elements
+         */
+        double sum(Summation mode = Summation::Compensated) const; // Declaration of the reduction
+
         /**
          * @brief Equality comparison operator
          * @param other Matrix to compare with
@@ -398,6 +768,9 @@ namespace squaremat // Start of namespace definition
 
         /**
          * @brief Determinant operator
+         *
+         * Triangular matrices use the diagonal product and permutation matrices the
+         * permutation sign, both in O(n); other matrices use cofactor expansion.
          * @return Determinant of the matrix
          */
         double operator!() const; // Declaration of determinant operator
@@ -426,6 +799,49 @@ namespace squaremat // Start of namespace definition
          */
         SquareMat &operator*=(const SquareMat &other); // Declaration of compound matrix multiplication operator
 
+        /**
+         * @brief Fused scaled addition: this += scalar * other
+         *
+         * One pass over both matrices with no temporary, instead of the allocation and
+         * second pass of this += other * scalar.
+         * @param other Matrix to add
+         * @param scalar Scale of other (use a negative scale for this -= s * other)
+         * @return Reference to this matrix
+         * @throws std::invalid_argument if matrix sizes don't match
+         */
+        SquareMat &addScaled(const SquareMat &other, double scalar); // Declaration of fused scaled addition
+
+        /**
+         * @brief Fused scale and add: this = scale * this + otherScale * other
+         *
+         * scale = 0 overwrites this matrix without reading it (NaNs do not propagate).
+         * @param scale Scale of this matrix
+         * @param other Matrix to add
+         * @param otherScale Scale of other
+         * @return Reference to this matrix
+         * @throws std::invalid_argument if matrix sizes don't match
+         */
+        SquareMat &scaleAndAdd(double scale, const SquareMat &other, double otherScale); // Declaration of fused scale and add
+
+        /**
+         * @brief In-place AXPY on matrices: y += alpha * x
+         * @param alpha Scale factor
+         * @param x Input matrix
+         * @param y Matrix to update
+         * @throws std::invalid_argument if matrix sizes don't match
+         */
+        friend void axpy(double alpha, const SquareMat &x, SquareMat &y) { y.addScaled(x, alpha); } // Same argument order as the vector AXPY
+
+        /**
+         * @brief In-place AXPBY on matrices: y = alpha * x + beta * y
+         * @param alpha Scale of x
+         * @param x Input matrix
+         * @param beta Scale of y (0 overwrites y without reading it)
+         * @param y Matrix to update
+         * @throws std::invalid_argument if matrix sizes don't match
+         */
+        friend void axpby(double alpha, const SquareMat &x, double beta, SquareMat &y) { y.scaleAndAdd(beta, x, alpha); } // BLAS argument order
+
         /**
          * @brief Compound assignment scalar multiplication operator
          * @param scalar Value to multiply matrix elements by
@@ -465,4 +881,93 @@ namespace squaremat // Start of namespace definition
          */
         friend std::ostream &operator<<(std::ostream &os, const SquareMat &mat); // Declaration of friend output stream operator
     };
+
+    /**
+     * @class SquareMat::Arena
+     * @brief Scoped bump allocator for the matrices created while it is alive
+     *
+     * While an Arena object exists, every SquareMat constructed on the same thread without
+     * an explicit resource (including the temporaries of operator chains) takes its storage
+     * from the arena with a pointer bump, and destroying those matrices frees nothing. All
+     * memory is released in one shot when the arena goes out of scope. Arenas nest and must
+     * be destroyed in reverse order of creation on the thread that created them.
+     *
+     * The arena is a std::pmr::memory_resource, so it can also be passed explicitly to
+     * SquareMat constructors or used by any pmr container.
+     *
+     * Matrices allocated inside the scope must not outlive it: keep results by assigning
+     * them into a matrix declared outside the scope.
+     */
+    class SquareMat::Arena : public std::pmr::memory_resource // Class definition for the scoped arena
+    {
+    private:
+        /**
+         * @brief One block of memory carved up by the arena
+         */
+        struct Chunk
+        {
+            char *memory;    ///< Start of the block
+            size_t capacity; ///< Size of the block in bytes
+        };
+
+        std::vector<Chunk> chunks; ///< Blocks owned by the arena, the last one is being filled
+        size_t offset;             ///< Bytes used in the last chunk
+        size_t used;               ///< Total bytes handed out
+        Arena *previous;           ///< Arena that was active before this one
+        std::pmr::memory_resource *upstream; ///< Resource the chunks come from
+
+        /**
+         * @brief Carve an aligned block out of the arena with a pointer bump
+         * @param bytes Number of bytes requested
+         * @param alignment Required alignment (a power of two)
+         * @return Pointer to the block (valid until the arena is destroyed)
+         */
+        void *do_allocate(size_t bytes, size_t alignment) override; // Declaration of bump allocation
+
+        /**
+         * @brief Individual blocks are never returned; the arena frees everything at once
+         */
+        void do_deallocate(void *, size_t, size_t) override {} // Deallocation is a no-op
+
+        /**
+         * @brief Arenas are only equal to themselves
+         * @param other Resource to compare with
+         * @return true if other is this arena
+         */
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; } // Identity comparison
+
+    public:
+        /**
+         * @brief Constructor that activates the arena on the calling thread
+         * @param initialBytes Capacity of the first chunk (later chunks double in size)
+         * @param upstream Resource the chunks are obtained from
+         */
+        explicit Arena(size_t initialBytes = 1 << 20, std::pmr::memory_resource *upstream = std::pmr::get_default_resource()); // Declaration of constructor
+
+        /**
+         * @brief Destructor that deactivates the arena and frees all of its memory
+         */
+        ~Arena(); // Declaration of destructor
+
+        Arena(const Arena &) = delete;            // Arenas are not copyable
+        Arena &operator=(const Arena &) = delete; // Arenas are not assignable
+
+        /**
+         * @brief Arena that new matrices on this thread allocate from
+         * @return Innermost live arena, or nullptr if none
+         */
+        static Arena *current(); // Declaration of the active arena accessor
+
+        /**
+         * @brief Total bytes handed out by the arena
+         * @return Bytes allocated so far
+         */
+        size_t bytesUsed() const { return used; } // Getter for handed-out bytes
+
+        /**
+         * @brief Number of chunks obtained from the heap
+         * @return Upstream allocations made by the arena
+         */
+        size_t chunkCount() const { return chunks.size(); } // Getter for chunk count
+    };
 } // End of namespace
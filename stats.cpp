@@ -0,0 +1,153 @@
+// orel8155@gmail.com
+#include "stats.hpp" // Include the header file for the counters
+#include <atomic>    // Include for the shared counters
+#include <sstream>   // Include for building the JSON dump
+
+namespace squaremat // Start of the squaremat namespace
+{
+    namespace stats // Start of the instrumentation namespace
+    {
+        namespace // Helpers private to this translation unit
+        {
+            const size_t OperationCount = static_cast<size_t>(Operation::Count); ///< Number of operations
+
+            const char *const Names[OperationCount] = {"+", "-", "unary -", "*", "* scalar", "% matrix", "% scalar", "/", "^", "!", "~", "++", "--",
+                                                       "+=", "-=", "*=", "*= scalar", "/=", "%= matrix", "%= scalar", "gemm", "axpy", "factorize", "expm", "unshare", "copy", "assign", "move assign", "construct"}; ///< Operator spellings, in enum order
+
+            /**
+             * @brief Shared counters of one operation
+             */
+            struct Counters
+            {
+                std::atomic<uint64_t> calls{0};       ///< Number of calls
+                std::atomic<uint64_t> elements{0};    ///< Elements touched
+                std::atomic<uint64_t> flops{0};       ///< Floating-point operations
+                std::atomic<uint64_t> allocations{0}; ///< Storage blocks allocated
+                std::atomic<uint64_t> bytes{0};       ///< Storage bytes allocated
+                std::atomic<uint64_t> nanoseconds{0}; ///< Wall-clock time
+            };
+
+            Counters counters[OperationCount]; ///< One set per operation
+
+            thread_local Scope *current = nullptr; ///< Innermost open scope on this thread
+
+            /**
+             * @brief Counters of an operation
+             * @param op Operation
+             * @return Its shared counters
+             */
+            Counters &of(Operation op) // Counter lookup
+            {
+                return counters[static_cast<size_t>(op)]; // Index by enum value
+            }
+        } // End of anonymous namespace
+
+        /**
+         * @brief Single-operation read implementation
+         * @param op Operation to read
+         * @return Current counters
+         */
+        OperationStats get(Operation op) // Single-operation read definition
+        {
+            Counters &c = of(op); // Counters to read
+            return {Names[static_cast<size_t>(op)], c.calls.load(), c.elements.load(), c.flops.load(), c.allocations.load(), c.bytes.load(), c.nanoseconds.load()}; // Copy them out
+        }
+
+        /**
+         * @brief Snapshot implementation
+         * @return One entry per Operation, in enum order
+         */
+        std::vector<OperationStats> snapshot() // Snapshot definition
+        {
+            std::vector<OperationStats> all;               // Result
+            for (size_t i = 0; i < OperationCount; i++) // Loop through the operations
+            {
+                all.push_back(get(static_cast<Operation>(i))); // Read each one
+            }
+            return all; // Return the snapshot
+        }
+
+        /**
+         * @brief Reset implementation
+         */
+        void reset() // Reset definition
+        {
+            for (Counters &c : counters) // Loop through the operations
+            {
+                c.calls = 0;       // Clear calls
+                c.elements = 0;    // Clear elements
+                c.flops = 0;       // Clear flops
+                c.allocations = 0; // Clear allocations
+                c.bytes = 0;       // Clear bytes
+                c.nanoseconds = 0; // Clear time
+            }
+        }
+
+        /**
+         * @brief JSON dump implementation
+         * @return {"enabled": ..., "operations": {"+": {"calls": ..., ...}, ...}}
+         */
+        std::string toJson() // JSON dump definition
+        {
+            std::ostringstream json;                                                        // Output buffer
+            json << "{\"enabled\": " << (Enabled ? "true" : "false") << ", \"operations\": {"; // Header
+            bool first = true;                                                              // No separator before the first entry
+            for (const OperationStats &s : snapshot())                                      // Loop through the operations
+            {
+                if (s.calls == 0 && s.allocations == 0) // Unused operation
+                {
+                    continue; // Keep the dump short
+                }
+                json << (first ? "" : ", ") << "\"" << s.name << "\": {\"calls\": " << s.calls << ", \"elements\": " << s.elements
+                     << ", \"flops\": " << s.flops << ", \"allocations\": " << s.allocations << ", \"bytes\": " << s.bytes
+                     << ", \"nanoseconds\": " << s.nanoseconds << "}"; // One object per operation
+                first = false;                                           // Separate the following entries
+            }
+            json << "}}";      // Close both objects
+            return json.str(); // Return the dump
+        }
+
+        /**
+         * @brief Allocation hook implementation
+         * @param bytes Size of the block
+         */
+        void recordAllocation(size_t bytes) // Allocation hook definition
+        {
+            Counters &c = of(current ? current->getOperation() : Operation::Construct); // Innermost operation, or a plain construction
+            c.allocations.fetch_add(1, std::memory_order_relaxed);                      // Count the block
+            c.bytes.fetch_add(bytes, std::memory_order_relaxed);                        // Count the bytes
+        }
+
+        /**
+         * @brief Constructor implementation
+         * @param op Operation being counted
+         * @param elements Elements the operation touches
+         * @param flops Floating-point operations known up front
+         */
+        Scope::Scope(Operation op, uint64_t elements, uint64_t flops) // Constructor definition
+            : op(op), parent(current), folded(current != nullptr && current->op == op), elements(elements), flops(flops), start(std::chrono::steady_clock::now())
+        {
+            current = this; // Become the innermost scope
+        }
+
+        /**
+         * @brief Destructor implementation
+         */
+        Scope::~Scope() // Destructor definition
+        {
+            current = parent; // Leave the scope
+            if (folded)       // Recursive call of the same operation
+            {
+                parent->elements += elements; // Fold into the outer call
+                parent->flops += flops;       // Fold into the outer call
+                return;                       // Outer call counts time and the call itself
+            }
+            Counters &c = of(op);                                                                                     // Counters to update
+            uint64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count(); // Duration of the call
+            c.calls.fetch_add(1, std::memory_order_relaxed);           // Count the call
+            c.elements.fetch_add(elements, std::memory_order_relaxed); // Count the elements
+            c.flops.fetch_add(flops, std::memory_order_relaxed);       // Count the flops
+            c.nanoseconds.fetch_add(elapsed, std::memory_order_relaxed); // Count the time
+        }
+    } // End of the instrumentation namespace
+} // End of squaremat namespace
@@ -0,0 +1,165 @@
+// orel8155@gmail.com
+#pragma once     // Ensures the header file is included only once
+#include <chrono>  // Include for operator timing
+#include <cstddef> // Include for size_t
+#include <cstdint> // Include for uint64_t
+#include <string>  // Include for the JSON dump
+#include <vector>  // Include for snapshots
+
+/**
+ * @file stats.hpp
+ * @brief Per-operator counters for SquareMat, compiled in with -DSQUAREMAT_STATS
+ *
+ * Operators open a SQUAREMAT_STAT_SCOPE that counts the call, the elements it touches,
+ * its floating-point operations, the storage it allocates and the time it takes.
+ * Without SQUAREMAT_STATS the macros expand to nothing and the counters stay zero.
+ */
+namespace squaremat // Start of namespace definition
+{
+    namespace stats // Start of the instrumentation namespace
+    {
+#if defined(SQUAREMAT_STATS)
+        constexpr bool Enabled = true; ///< Counters are compiled in
+#else
+        constexpr bool Enabled = false; ///< Counters are compiled out
+#endif
+
+        /**
+         * @brief Instrumented operations
+         */
+        enum class Operation
+        {
+            Add,                       ///< a + b
+            Subtract,                  ///< a - b
+            Negate,                    ///< -a
+            Multiply,                  ///< a * b
+            ScalarMultiply,            ///< a * s and s * a
+            ElementwiseMultiply,       ///< a % b
+            Modulo,                    ///< a % s
+            Divide,                    ///< a / s
+            Power,                     ///< a ^ p
+            Determinant,               ///< !a (recursive calls fold into the outer one)
+            Transpose,                 ///< ~a
+            Increment,                 ///< ++a and a++
+            Decrement,                 ///< --a and a--
+            AddAssign,                 ///< a += b
+            SubtractAssign,            ///< a -= b
+            MultiplyAssign,            ///< a *= b
+            ScalarMultiplyAssign,      ///< a *= s
+            DivideAssign,              ///< a /= s
+            ElementwiseMultiplyAssign, ///< a %= b
+            ModuloAssign,              ///< a %= s
+            Gemm,                      ///< gemm() and addProduct()
+            AddScaled,                 ///< addScaled(), scaleAndAdd(), axpy() and axpby()
+            Factorize,                 ///< LU and Cholesky factorizations (Factorization, solve(), MixedSolver)
+            Exponential,               ///< expm() (its products count as gemm)
+            Unshare,                   ///< Deferred copy of shared storage before a write
+            Copy,                      ///< Copy construction
+            Assign,                    ///< Copy assignment
+            MoveAssign,                ///< Move assignment
+            Construct,                 ///< Storage allocated outside any other operation
+            Count                      ///< Number of operations
+        };
+
+        /**
+         * @brief Counters of one operation
+         */
+        struct OperationStats
+        {
+            const char *name;     ///< Operator spelling, e.g. "+="
+            uint64_t calls;       ///< Number of calls
+            uint64_t elements;    ///< Matrix elements read or written
+            uint64_t flops;       ///< Floating-point operations
+            uint64_t allocations; ///< Storage blocks allocated
+            uint64_t bytes;       ///< Storage bytes allocated
+            uint64_t nanoseconds; ///< Wall-clock time, including nested operations
+        };
+
+        /**
+         * @brief Counters of one operation
+         * @param op Operation to read
+         * @return Current counters
+         */
+        OperationStats get(Operation op); // Declaration of the single-operation read
+
+        /**
+         * @brief Counters of every operation
+         * @return One entry per Operation, in enum order
+         */
+        std::vector<OperationStats> snapshot(); // Declaration of the snapshot
+
+        /**
+         * @brief Reset every counter to zero
+         */
+        void reset(); // Declaration of the reset
+
+        /**
+         * @brief Counters of every operation that was used, as a JSON object
+         * @return {"enabled": ..., "operations": {"+": {"calls": ..., ...}, ...}}
+         */
+        std::string toJson(); // Declaration of the JSON dump
+
+        /**
+         * @brief Attribute a storage allocation to the innermost open scope on this thread
+         * @param bytes Size of the block
+         */
+        void recordAllocation(size_t bytes); // Declaration of the allocation hook
+
+        /**
+         * @class Scope
+         * @brief Counts one operator call from construction to destruction
+         *
+         * A scope directly inside a scope of the same operation (the recursive determinant)
+         * adds its elements and flops to the outer call instead of counting a new one.
+         */
+        class Scope // Class definition for the operator scope
+        {
+        private:
+            Operation op;                                 ///< Operation being counted
+            Scope *parent;                                ///< Enclosing scope on this thread
+            bool folded;                                  ///< Nested in a scope of the same operation
+            uint64_t elements;                            ///< Elements touched so far
+            uint64_t flops;                               ///< Floating-point operations so far
+            std::chrono::steady_clock::time_point start; ///< Start of the call
+
+        public:
+            /**
+             * @brief Open a scope
+             * @param op Operation being counted
+             * @param elements Elements the operation touches
+             * @param flops Floating-point operations known up front
+             */
+            Scope(Operation op, uint64_t elements, uint64_t flops); // Declaration of constructor
+
+            /**
+             * @brief Close the scope and add its counters
+             */
+            ~Scope(); // Declaration of destructor
+
+            Scope(const Scope &) = delete;            // Scopes are not copyable
+            Scope &operator=(const Scope &) = delete; // Scopes are not assignable
+
+            /**
+             * @brief Add floating-point operations discovered while running
+             * @param count Operations to add
+             */
+            void addFlops(uint64_t count) { flops += count; } // Flop accumulator
+
+            /**
+             * @brief Operation being counted
+             * @return The operation
+             */
+            Operation getOperation() const { return op; } // Getter for the operation
+        };
+    } // End of the instrumentation namespace
+} // End of namespace
+
+#if defined(SQUAREMAT_STATS)
+#define SQUAREMAT_STAT_SCOPE(op, elements, flops) ::squaremat::stats::Scope statScope(::squaremat::stats::Operation::op, (elements), (flops))
+#define SQUAREMAT_STAT_FLOPS(count) statScope.addFlops(count)
+#define SQUAREMAT_STAT_ALLOCATION(bytes) ::squaremat::stats::recordAllocation(bytes)
+#else
+#define SQUAREMAT_STAT_SCOPE(op, elements, flops) ((void)0)
+#define SQUAREMAT_STAT_FLOPS(count) ((void)0)
+#define SQUAREMAT_STAT_ALLOCATION(bytes) ((void)0)
+#endif
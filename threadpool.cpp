@@ -0,0 +1,383 @@
+// orel8155@gmail.com
+#include "threadpool.hpp" // Include the header file for ThreadPool class
+#include "numa.hpp"       // Include for worker binding
+#include <algorithm>      // Include for std::min and std::max
+#include <atomic>         // Include for the chunk countdown
+#include <exception>      // Include for std::exception_ptr
+
+namespace squaremat // Start of the squaremat namespace
+{
+    namespace // Helpers private to this translation unit
+    {
+        thread_local bool isWorker = false;               ///< Set on the pool's worker threads
+        thread_local const ThreadPool *ownerPool = nullptr; ///< Pool the current worker belongs to
+        thread_local size_t ownIndex = 0;                  ///< Position of the current worker in its pool
+    } // End of anonymous namespace
+
+    /**
+     * @brief Constructor implementation
+     * @param threads Number of worker threads (0 runs everything on the caller)
+     */
+    ThreadPool::ThreadPool(size_t threads) : workerTasks(threads), spawned(threads), spawnedCount(0), workerNodes(threads, -1), occupied(threads), stopping(false) // Constructor definition
+    {
+        for (size_t i = 0; i < threads; i++) // Start each worker
+        {
+            workers.emplace_back([this, i]() { workerLoop(i); }); // Worker runs the main loop
+        }
+    }
+
+    /**
+     * @brief Destructor implementation
+     */
+    ThreadPool::~ThreadPool() // Destructor definition
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex); // Protect the flag
+            stopping = true;                         // Ask workers to finish
+        }
+        wakeup.notify_all();             // Wake every sleeping worker
+        for (std::thread &worker : workers) // Loop through workers
+        {
+            worker.join(); // Wait for the worker to exit
+        }
+    }
+
+    /**
+     * @brief Shared pool accessor implementation
+     * @return Reference to the process-wide pool
+     */
+    ThreadPool &ThreadPool::instance() // Shared pool definition
+    {
+        static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1); // Caller thread makes up the last slot
+        return pool;                                                                   // Return the shared pool
+    }
+
+    /**
+     * @brief Worker check implementation
+     * @return true on a worker thread, false otherwise
+     */
+    bool ThreadPool::onWorkerThread() // Worker check definition
+    {
+        return isWorker; // Thread-local flag set in workerLoop
+    }
+
+    /**
+     * @brief Worker loop implementation
+     * @param index Position of the worker in workers
+     */
+    void ThreadPool::workerLoop(size_t index) // Worker loop definition
+    {
+        isWorker = true;  // Mark this thread as a worker
+        ownerPool = this; // Remember which pool it serves
+        ownIndex = index; // Remember its position
+        for (;;)          // Run until the pool stops
+        {
+            std::function<void()> task; // Next task to run
+            bool chunk = false;         // Task is a pinned chunk (own or delayed)
+            {
+                std::unique_lock<std::mutex> lock(mutex);                    // Protect the queues
+                std::deque<std::function<void()>> &own = workerTasks[index]; // Chunks pinned to this worker
+                std::deque<std::function<void()>> &local = spawned[index];   // Tasks this worker spawned
+                wakeup.wait(lock, [&]() { return stopping || !own.empty() || !tasks.empty() || spawnedCount > 0 || delayedOwnerLocked(index) < workers.size(); }); // Sleep until there is work
+                if (!own.empty()) // Pinned chunks first
+                {
+                    task = std::move(own.front()); // Take the oldest chunk
+                    own.pop_front();               // Remove it from the queue
+                    chunk = true;                  // Keeps the worker free for its chunks
+                }
+                else if (takeDelayedLocked(index, task)) // Then chunks stuck behind an occupied worker
+                {
+                    chunk = true; // Keeps the worker free for its chunks
+                }
+                else if (!local.empty()) // Then the newest task this worker spawned
+                {
+                    task = std::move(local.front()); // Take it
+                    local.pop_front();               // Remove it from the deque
+                    spawnedCount--;                  // Keep the total in step
+                }
+                else if (!tasks.empty()) // Then the shared queue
+                {
+                    task = std::move(tasks.front()); // Take the oldest task
+                    tasks.pop_front();               // Remove it from the queue
+                }
+                else if (!stealLocked(index, task)) // Finally steal; nothing at all means stopping
+                {
+                    return; // End the worker
+                }
+                occupied[index].store(!chunk, std::memory_order_relaxed); // Under the lock, so a waiting caller sees it before giving up
+            }
+            task();                                                  // Run the task outside the lock
+            occupied[index].store(false, std::memory_order_relaxed); // Free for its chunks again
+        }
+    }
+
+    /**
+     * @brief Delayed chunk lookup implementation
+     * @param thief Position of the looking worker (workers.size() for other threads)
+     * @return Position of an occupied worker with a queued chunk, or workers.size() if there is none
+     */
+    size_t ThreadPool::delayedOwnerLocked(size_t thief) const // Delayed chunk lookup definition
+    {
+        for (size_t w = 0; w < workers.size(); w++) // Loop through the workers
+        {
+            if (w != thief && !workerTasks[w].empty() && occupied[w].load(std::memory_order_relaxed)) // Chunk waiting behind another task
+            {
+                return w; // Its chunks can move
+            }
+        }
+        return workers.size(); // Every chunk will run on its own worker soon
+    }
+
+    /**
+     * @brief Delayed chunk step implementation
+     * @param thief Position of the taking worker (workers.size() for other threads)
+     * @param task Output task
+     * @return true if a chunk was taken
+     */
+    bool ThreadPool::takeDelayedLocked(size_t thief, std::function<void()> &task) // Delayed chunk step definition
+    {
+        size_t owner = delayedOwnerLocked(thief); // Occupied worker with a queued chunk
+        if (owner == workers.size())              // None
+        {
+            return false; // No chunk was taken
+        }
+        task = std::move(workerTasks[owner].front()); // Take its oldest chunk
+        workerTasks[owner].pop_front();               // Remove it from the queue
+        return true;                                  // Taken
+    }
+
+    /**
+     * @brief Stealing step implementation
+     * @param thief Position of the stealing worker (workers.size() for other threads)
+     * @param task Output task
+     * @return true if a task was taken
+     */
+    bool ThreadPool::stealLocked(size_t thief, std::function<void()> &task) // Stealing step definition
+    {
+        if (spawnedCount == 0) // Nothing to steal
+        {
+            return false; // No task was taken
+        }
+        for (size_t k = 1; k <= spawned.size(); k++) // Visit the other workers, starting after the thief
+        {
+            std::deque<std::function<void()>> &victim = spawned[(thief + k) % spawned.size()]; // Next deque
+            if (!victim.empty())                                                                // Has work
+            {
+                task = std::move(victim.back()); // Take its oldest task
+                victim.pop_back();               // Remove it from the deque
+                spawnedCount--;                  // Keep the total in step
+                return true;                     // Stolen
+            }
+        }
+        return false; // Every deque was empty
+    }
+
+    /**
+     * @brief Helping step implementation
+     * @return true if a task was run, false if the queue was empty
+     */
+    bool ThreadPool::runPendingTask() // Helping step definition
+    {
+        std::function<void()> task; // Task to run
+        {
+            std::lock_guard<std::mutex> lock(mutex);                  // Protect the queues
+            size_t thief = ownerPool == this ? ownIndex : workers.size(); // Position of the calling thread
+            if (!takeDelayedLocked(thief, task))                        // Chunks stuck behind an occupied worker first
+            {
+                if (!tasks.empty()) // Then shared work
+                {
+                    task = std::move(tasks.front()); // Take the oldest task
+                    tasks.pop_front();               // Remove it from the queue
+                }
+                else if (!stealLocked(thief, task)) // Then spawned work of the workers
+                {
+                    return false; // No task was run
+                }
+            }
+        }
+        task();      // Run the task on the calling thread
+        return true; // A task was run
+    }
+
+    /**
+     * @brief Task submission implementation
+     * @param task Callable to run on a worker
+     */
+    void ThreadPool::submit(std::function<void()> task) // Task submission definition
+    {
+        if (workers.empty()) // No workers to hand the task to
+        {
+            task(); // Run it on the caller
+            return; // Done
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex); // Protect the queue
+            tasks.push_back(std::move(task));        // Queue the task
+        }
+        wakeup.notify_one(); // Wake one worker
+    }
+
+    /**
+     * @brief Local submission implementation
+     * @param task Callable to run on a worker
+     */
+    void ThreadPool::spawn(std::function<void()> task) // Local submission definition
+    {
+        if (ownerPool != this) // Not one of this pool's workers
+        {
+            submit(std::move(task)); // Shared queue (or inline without workers)
+            return;                  // Done
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);          // Protect the deques
+            spawned[ownIndex].push_front(std::move(task));     // Newest at the front, run next by the owner
+            spawnedCount++;                                    // Keep the total in step
+        }
+        wakeup.notify_one(); // Let an idle worker steal it
+    }
+
+    /**
+     * @brief Pinned submission implementation
+     * @param worker Position of the worker in workers
+     * @param task Callable to run on that worker
+     */
+    void ThreadPool::submitTo(size_t worker, std::function<void()> task) // Pinned submission definition
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);        // Protect the queues
+            workerTasks[worker].push_back(std::move(task)); // Queue the task for that worker
+        }
+        wakeup.notify_all(); // The shared condition can't target one worker
+    }
+
+    /**
+     * @brief NUMA binding implementation
+     * @return Number of workers that were bound
+     */
+    size_t ThreadPool::bindToNodes() // NUMA binding definition
+    {
+        size_t nodes = numa::nodeCount(); // Nodes to spread over
+        size_t bound = 0;                 // Successfully bound workers
+        for (size_t w = 0; w < workers.size(); w++) // Loop through the workers
+        {
+            size_t node = (w + 1) * nodes / getThreadCount();        // Same node for neighbouring chunks
+            if (numa::bindThread(workers[w].native_handle(), node)) // Restrict the worker
+            {
+                workerNodes[w] = static_cast<int>(node); // Remember the node
+                bound++;                                 // Count it
+            }
+        }
+        return bound; // Return the number of bound workers
+    }
+
+    /**
+     * @brief Split rule implementation
+     * @param begin First index of the range
+     * @param end One past the last index of the range
+     * @param chunks Number of chunks
+     * @param index Chunk number in [0, chunks)
+     * @param first Output first index of the chunk
+     * @param last Output one past the last index of the chunk
+     */
+    void ThreadPool::chunkBounds(size_t begin, size_t end, size_t chunks, size_t index, size_t &first, size_t &last) // Split rule definition
+    {
+        size_t count = end - begin;           // Number of indices
+        size_t base = count / chunks;         // Indices every chunk gets
+        size_t extra = count % chunks;        // The first `extra` chunks get one more
+        first = begin + index * base + std::min(index, extra); // Start of the chunk
+        last = first + base + (index < extra ? 1 : 0);          // End of the chunk
+    }
+
+    /**
+     * @brief Chunk count implementation
+     * @param count Number of indices in the range
+     * @param grain Minimum number of indices per chunk
+     * @return Number of chunks (1 means the range runs inline)
+     */
+    size_t ThreadPool::chunkCount(size_t count, size_t grain) const // Chunk count definition
+    {
+        size_t byGrain = count / std::max<size_t>(grain, 1);         // Chunks that still meet the grain
+        return std::max<size_t>(1, std::min(byGrain, getThreadCount())); // At most one chunk per thread
+    }
+
+    /**
+     * @brief Parallel loop implementation
+     * @param begin First index of the range
+     * @param end One past the last index of the range
+     * @param grain Minimum number of indices per chunk (smaller ranges run inline)
+     * @param body Callable receiving (first, last) of each chunk
+     * @throws Rethrows the first exception thrown by body
+     */
+    void ThreadPool::parallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)> &body) // Parallel loop definition
+    {
+        if (begin >= end) // Empty range
+        {
+            return; // Nothing to do
+        }
+        size_t chunks = chunkCount(end - begin, grain); // Number of pieces
+        if (chunks == 1 || onWorkerThread())            // Too small, or nested inside a worker
+        {
+            body(begin, end); // Run inline
+            return;           // Done
+        }
+
+        std::atomic<size_t> remaining(chunks - 1); // Chunks still running on workers
+        std::exception_ptr failure;                // First exception thrown by a chunk
+        std::mutex failureMutex;                   // Protects failure
+        std::mutex doneMutex;                      // Protects the completion wait
+        std::condition_variable done;              // Signals the last finished chunk
+
+        for (size_t c = 1; c < chunks; c++) // Hand every chunk but the first to the workers
+        {
+            size_t first = 0;                              // Start of the chunk
+            size_t last = 0;                               // End of the chunk
+            chunkBounds(begin, end, chunks, c, first, last); // Compute the bounds
+            submitTo(c - 1, [&, first, last]() {           // Chunk c always runs on worker c - 1
+                try
+                {
+                    body(first, last); // Run the chunk
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(failureMutex); // Protect failure
+                    if (!failure)                                   // Keep the first exception only
+                    {
+                        failure = std::current_exception(); // Capture it
+                    }
+                }
+                std::lock_guard<std::mutex> lock(doneMutex); // Count down under the lock so the caller can't leave early
+                if (remaining.fetch_sub(1) == 1)             // Last chunk to finish
+                {
+                    done.notify_one(); // Wake the caller
+                }
+            });
+        }
+
+        size_t first = 0;                              // Start of the caller's chunk
+        size_t last = 0;                               // End of the caller's chunk
+        chunkBounds(begin, end, chunks, 0, first, last); // Compute the bounds
+        try
+        {
+            body(first, last); // The caller runs the first chunk itself
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(failureMutex); // Protect failure
+            if (!failure)                                   // Keep the first exception only
+            {
+                failure = std::current_exception(); // Capture it
+            }
+        }
+        while (remaining.load() > 0 && runPendingTask()) // Help instead of idling (takes chunks delayed behind occupied workers)
+        {
+        }
+        {
+            std::unique_lock<std::mutex> lock(doneMutex);              // Protect the wait
+            done.wait(lock, [&]() { return remaining.load() == 0; }); // Wait for the workers' chunks
+        }
+        if (failure) // A chunk failed
+        {
+            std::rethrow_exception(failure); // Propagate the first exception
+        }
+    }
+} // End of squaremat namespace
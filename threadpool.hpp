@@ -0,0 +1,198 @@
+// orel8155@gmail.com
+#pragma once                // Ensures the header file is included only once
+#include <atomic>           // Include for the occupied flags
+#include <condition_variable> // Include for worker wake-ups
+#include <cstddef>          // Include for size_t
+#include <deque>            // Include for the task queue
+#include <functional>       // Include for std::function
+#include <mutex>            // Include for std::mutex
+#include <thread>           // Include for std::thread
+#include <vector>           // Include for the worker list
+
+namespace squaremat // Start of namespace definition
+{
+    /**
+     * @class ThreadPool
+     * @brief A fixed set of worker threads shared by the parallel matrix kernels
+     *
+     * Kernels split their index range with parallelFor(); the calling thread runs the
+     * first chunk itself and helps drain the queue while it waits. Chunk c goes to
+     * worker c - 1, so a row range first touched by a worker is later processed by the
+     * same worker (and, after bindToNodes(), on the same NUMA node). A chunk only moves
+     * when its worker is occupied by another task: the caller or an idle worker then takes
+     * it instead of waiting behind that task. Calls made from a worker thread run inline,
+     * so nested parallel kernels can never deadlock.
+     *
+     * Tasks spawned from a worker (task-graph nodes) go to that worker's own deque: the
+     * worker runs its newest task next, and idle threads steal the oldest ones.
+     */
+    class ThreadPool // Class definition for the worker pool
+    {
+    private:
+        std::vector<std::thread> workers;         ///< Worker threads
+        std::deque<std::function<void()>> tasks;  ///< Pending tasks for any worker
+        std::vector<std::deque<std::function<void()>>> workerTasks; ///< Pending chunks pinned to each worker
+        std::vector<std::deque<std::function<void()>>> spawned;     ///< Stealable tasks spawned by each worker
+        size_t spawnedCount;                      ///< Tasks in all spawned deques
+        std::vector<int> workerNodes;             ///< NUMA node each worker is bound to (-1: unbound)
+        std::vector<std::atomic<bool>> occupied;  ///< Worker is running a task other than a pinned chunk
+        std::mutex mutex;                         ///< Protects the queues and stopping
+        std::condition_variable wakeup;           ///< Signals new tasks or shutdown
+        bool stopping;                            ///< Set by the destructor to end the workers
+
+        /**
+         * @brief Main loop of every worker thread
+         * @param index Position of the worker in workers
+         */
+        void workerLoop(size_t index); // Declaration of the worker loop
+
+        /**
+         * @brief Queue a task for one specific worker
+         * @param worker Position of the worker in workers
+         * @param task Callable to run on that worker
+         */
+        void submitTo(size_t worker, std::function<void()> task); // Declaration of pinned submission
+
+        /**
+         * @brief Take the oldest task of another worker's spawned deque (mutex must be held)
+         * @param thief Position of the stealing worker (workers.size() for other threads)
+         * @param task Output task
+         * @return true if a task was taken
+         */
+        bool stealLocked(size_t thief, std::function<void()> &task); // Declaration of the stealing step
+
+        /**
+         * @brief Find a worker whose queued chunk waits behind another task (mutex must be held)
+         * @param thief Position of the looking worker (workers.size() for other threads)
+         * @return Position of that worker, or workers.size() if there is none
+         */
+        size_t delayedOwnerLocked(size_t thief) const; // Declaration of the delayed chunk lookup
+
+        /**
+         * @brief Take the oldest pinned chunk of a worker that is occupied by another task (mutex must be held)
+         * @param thief Position of the taking worker (workers.size() for other threads)
+         * @param task Output task
+         * @return true if a chunk was taken
+         */
+        bool takeDelayedLocked(size_t thief, std::function<void()> &task); // Declaration of the delayed chunk step
+
+    public:
+        /**
+         * @brief Constructor that starts the worker threads
+         * @param threads Number of worker threads (0 runs everything on the caller)
+         */
+        explicit ThreadPool(size_t threads); // Declaration of constructor
+
+        /**
+         * @brief Destructor that finishes queued tasks and joins the workers
+         */
+        ~ThreadPool(); // Declaration of destructor
+
+        ThreadPool(const ThreadPool &) = delete;            // Pools are not copyable
+        ThreadPool &operator=(const ThreadPool &) = delete; // Pools are not assignable
+
+        /**
+         * @brief Shared pool used by all matrix kernels, sized to the hardware
+         * @return Reference to the process-wide pool
+         */
+        static ThreadPool &instance(); // Declaration of the shared pool accessor
+
+        /**
+         * @brief Check whether the calling thread is one of the pool's workers
+         * @return true on a worker thread, false otherwise
+         */
+        static bool onWorkerThread(); // Declaration of the worker check
+
+        /**
+         * @brief Number of threads that take part in parallelFor (workers plus the caller)
+         * @return Degree of parallelism
+         */
+        size_t getThreadCount() const { return workers.size() + 1; } // Getter for the parallelism
+
+        static constexpr size_t ParallelElements = size_t(1) << 15; ///< Matrix elements per chunk below which kernels stay serial
+
+        /**
+         * @brief Minimum rows per parallel chunk for rows of a given length
+         *
+         * Shared by the kernels and the first-touch initialization so both split a
+         * matrix into the same row chunks.
+         * @param rowLength Elements per row
+         * @return Row grain for parallelFor
+         */
+        static size_t rowGrain(size_t rowLength) { return rowLength >= ParallelElements ? 1 : ParallelElements / rowLength; } // Grain computation
+
+        /**
+         * @brief Bind the workers to NUMA nodes in chunk order
+         *
+         * Worker w (which runs chunk w + 1) goes to node (w + 1) * nodes / getThreadCount(),
+         * so consecutive row chunks stay on one node. The calling thread is left alone;
+         * chunk 0 lands wherever it runs.
+         * @return Number of workers that were bound
+         */
+        size_t bindToNodes(); // Declaration of NUMA binding
+
+        /**
+         * @brief NUMA node of a worker
+         * @param worker Position of the worker (chunk worker + 1)
+         * @return Node id, or -1 if the worker is not bound
+         */
+        int getWorkerNode(size_t worker) const { return worker < workerNodes.size() ? workerNodes[worker] : -1; } // Getter for a worker's node
+
+        /**
+         * @brief Queue a task for asynchronous execution
+         * @param task Callable to run on a worker
+         */
+        void submit(std::function<void()> task); // Declaration of task submission
+
+        /**
+         * @brief Queue a task close to the caller
+         *
+         * On a worker of this pool the task goes to the front of that worker's deque, so
+         * dependent work stays on a warm cache, while idle threads steal from the other
+         * end. Other threads submit to the shared queue.
+         * @param task Callable to run on a worker
+         */
+        void spawn(std::function<void()> task); // Declaration of local submission
+
+        /**
+         * @brief Run one queued task on the calling thread, if there is one
+         *
+         * Used by threads that wait for pool work (parallelFor callers, Future::wait) so
+         * that waiting on a worker never starves the queue.
+         * @return true if a task was run, false if the shared queue, the spawned deques and the delayed chunks were empty
+         */
+        bool runPendingTask(); // Declaration of the helping step
+
+        /**
+         * @brief Bounds of chunk `index` when [begin, end) is split into `chunks` equal parts
+         *
+         * Every parallel kernel and the first-touch initialization use this split, so a
+         * chunk of rows is always handled by the same position in the pool.
+         * @param begin First index of the range
+         * @param end One past the last index of the range
+         * @param chunks Number of chunks
+         * @param index Chunk number in [0, chunks)
+         * @param first Output first index of the chunk
+         * @param last Output one past the last index of the chunk
+         */
+        static void chunkBounds(size_t begin, size_t end, size_t chunks, size_t index, size_t &first, size_t &last); // Declaration of the split rule
+
+        /**
+         * @brief Number of chunks parallelFor would use for a range
+         * @param count Number of indices in the range
+         * @param grain Minimum number of indices per chunk
+         * @return Number of chunks (1 means the range runs inline)
+         */
+        size_t chunkCount(size_t count, size_t grain) const; // Declaration of the chunk count
+
+        /**
+         * @brief Run body over [begin, end) split into contiguous chunks across the pool
+         * @param begin First index of the range
+         * @param end One past the last index of the range
+         * @param grain Minimum number of indices per chunk (smaller ranges run inline)
+         * @param body Callable receiving (first, last) of each chunk
+         * @throws Rethrows the first exception thrown by body
+         */
+        void parallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)> &body); // Declaration of parallel loop
+    };
+} // End of namespace
@@ -0,0 +1,264 @@
+// orel8155@gmail.com
+#include "trace.hpp" // Include the header file for the tracing scopes
+#include <atomic>    // Include for the lock-free ring buffers
+#include <chrono>    // Include for timestamps
+#include <memory>    // Include for shared buffer ownership
+#include <mutex>     // Include for the buffer registry
+#include <vector>    // Include for the buffer registry
+
+namespace squaremat // Start of the squaremat namespace
+{
+    namespace trace // Start of the tracing namespace
+    {
+        namespace // Helpers private to this translation unit
+        {
+            /**
+             * @brief One buffered event; fields are atomics so a concurrent flush is race-free
+             */
+            struct Event
+            {
+                std::atomic<const char *> name{nullptr};     ///< Event name
+                std::atomic<const char *> category{nullptr}; ///< Event category
+                std::atomic<uint64_t> start{0};              ///< Start time in nanoseconds
+                std::atomic<uint64_t> duration{0};           ///< Duration in nanoseconds
+            };
+
+            /**
+             * @brief Single-writer ring buffer of one thread
+             */
+            struct RingBuffer
+            {
+                Event events[BufferEvents];   ///< Event slots
+                std::atomic<uint64_t> head{0}; ///< Number of events ever written
+                size_t thread;                ///< Trace thread id
+            };
+
+            std::atomic<bool> running(false);                ///< Recording switch
+            std::atomic<unsigned> sampleRate(1);             ///< Record one in this many top-level scopes
+            std::mutex registryMutex;                        ///< Protects buffers
+            std::vector<std::shared_ptr<RingBuffer>> buffers; ///< Every thread's buffer (kept after the thread exits)
+            const auto epoch = std::chrono::steady_clock::now(); ///< Time origin of the trace
+
+            thread_local std::shared_ptr<RingBuffer> localBuffer; ///< This thread's buffer, created on first event
+            thread_local unsigned sampleCounter = 0;             ///< Top-level scopes seen on this thread
+            thread_local bool insideScope = false;               ///< A scope is open on this thread
+            thread_local bool insideRecording = false;           ///< The innermost open scope is recorded
+
+            /**
+             * @brief Nanoseconds since the trace epoch
+             * @return Current timestamp
+             */
+            uint64_t now() // Timestamp helper
+            {
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count(); // Elapsed time
+            }
+
+            /**
+             * @brief This thread's buffer, registered on first use
+             * @return Reference to the buffer
+             */
+            RingBuffer &threadBuffer() // Buffer lookup
+            {
+                if (!localBuffer) // First event on this thread
+                {
+                    localBuffer = std::make_shared<RingBuffer>();     // Allocate the ring
+                    std::lock_guard<std::mutex> lock(registryMutex); // Protect the registry (once per thread)
+                    localBuffer->thread = buffers.size();            // Dense thread id
+                    buffers.push_back(localBuffer);                  // Make it visible to the flush
+                }
+                return *localBuffer; // Return the buffer
+            }
+
+            /**
+             * @brief Escape a string for JSON output
+             * @param os Output stream
+             * @param text Text to write
+             */
+            void writeString(std::ostream &os, const char *text) // JSON string writer
+            {
+                os << '"';                         // Opening quote
+                for (const char *c = text; *c; c++) // Loop through the characters
+                {
+                    if (*c == '"' || *c == '\\') // Characters that need escaping
+                    {
+                        os << '\\'; // Escape them
+                    }
+                    os << *c; // Write the character
+                }
+                os << '"'; // Closing quote
+            }
+        } // End of anonymous namespace
+
+        /**
+         * @brief Start implementation
+         * @param sampleEvery Record one in every sampleEvery top-level scopes per thread (1 records all)
+         */
+        void start(unsigned sampleEvery) // Start definition
+        {
+            setSampleRate(sampleEvery); // Apply the sampling rate
+            running.store(true);        // Turn recording on
+        }
+
+        /**
+         * @brief Stop implementation
+         */
+        void stop() // Stop definition
+        {
+            running.store(false); // Turn recording off
+        }
+
+        /**
+         * @brief State check implementation
+         * @return true between start() and stop()
+         */
+        bool active() // State check definition
+        {
+            return running.load(std::memory_order_relaxed); // Current switch
+        }
+
+        /**
+         * @brief Sampling knob implementation
+         * @param sampleEvery Record one in every sampleEvery top-level scopes per thread (0 is treated as 1)
+         */
+        void setSampleRate(unsigned sampleEvery) // Sampling knob definition
+        {
+            sampleRate.store(sampleEvery == 0 ? 1 : sampleEvery); // Never divide by zero
+        }
+
+        /**
+         * @brief Nesting check implementation
+         * @return true inside a recorded scope
+         */
+        bool recording() // Nesting check definition
+        {
+            return insideRecording; // Innermost scope state
+        }
+
+        /**
+         * @brief Clear implementation
+         */
+        void clear() // Clear definition
+        {
+            std::lock_guard<std::mutex> lock(registryMutex); // Protect the registry
+            for (auto &buffer : buffers)                      // Loop through the threads
+            {
+                buffer->head.store(0); // Forget the events (slots are overwritten later)
+            }
+        }
+
+        /**
+         * @brief Event count implementation
+         * @return Event count
+         */
+        size_t eventCount() // Event count definition
+        {
+            std::lock_guard<std::mutex> lock(registryMutex); // Protect the registry
+            size_t count = 0;                                 // Total events
+            for (auto &buffer : buffers)                      // Loop through the threads
+            {
+                uint64_t head = buffer->head.load(std::memory_order_acquire);   // Events ever written
+                count += head < BufferEvents ? head : BufferEvents;               // Held events
+            }
+            return count; // Return the total
+        }
+
+        /**
+         * @brief Flush implementation
+         * @param os Output stream
+         */
+        void writeChromeJson(std::ostream &os) // Flush definition
+        {
+            std::lock_guard<std::mutex> lock(registryMutex); // Protect the registry
+            os << "{\"traceEvents\": [";                     // Open the event list
+            bool first = true;                                // No separator before the first event
+            for (auto &buffer : buffers)                      // Loop through the threads
+            {
+                uint64_t end = buffer->head.load(std::memory_order_acquire);          // Newest event
+                uint64_t begin = end > BufferEvents ? end - BufferEvents : 0;        // Oldest event still held
+                for (uint64_t index = begin; index < end; index++)                   // Loop through the events
+                {
+                    const Event &e = buffer->events[index % BufferEvents]; // Event slot
+                    const char *name = e.name.load(std::memory_order_relaxed);         // Copy the fields
+                    const char *category = e.category.load(std::memory_order_relaxed); // Copy the fields
+                    uint64_t start = e.start.load(std::memory_order_relaxed);          // Copy the fields
+                    uint64_t duration = e.duration.load(std::memory_order_relaxed);    // Copy the fields
+                    uint64_t head = buffer->head.load(std::memory_order_acquire);      // Writer position after the copy
+                    if (head >= index + BufferEvents)                                  // Slot was (or is being) reused while reading
+                    {
+                        continue; // Skip the torn event
+                    }
+                    os << (first ? "" : ",") << "\n{\"name\": "; // Separator and name key
+                    writeString(os, name);                        // Event name
+                    os << ", \"cat\": ";                          // Category key
+                    writeString(os, category);                    // Event category
+                    os << ", \"ph\": \"X\", \"ts\": " << start / 1000.0 << ", \"dur\": " << duration / 1000.0
+                       << ", \"pid\": 1, \"tid\": " << buffer->thread << "}"; // Complete event in microseconds
+                    first = false;                                           // Separate the following events
+                }
+            }
+            os << "\n], \"displayTimeUnit\": \"ns\"}\n"; // Close the document
+        }
+
+        /**
+         * @brief Common setup implementation
+         * @param decision Whether to record
+         */
+        void Scope::open(bool decision) // Common setup definition
+        {
+            record = decision;               // Remember the decision
+            outerRecording = insideRecording; // Save the enclosing state
+            outerOpen = insideScope;          // Save the enclosing state
+            insideScope = true;               // This scope is now innermost
+            insideRecording = decision;       // Nested scopes follow it
+            start = decision ? now() : 0;     // Only recorded scopes read the clock
+        }
+
+        /**
+         * @brief Constructor implementation
+         * @param name Event name (string literal)
+         * @param category Event category (string literal)
+         */
+        Scope::Scope(const char *name, const char *category) : name(name), category(category) // Constructor definition
+        {
+            bool decision = false;                                 // Not recorded by default
+            if (running.load(std::memory_order_relaxed))           // Tracing is on
+            {
+                decision = insideScope ? insideRecording                                     // Nested: follow the parent
+                                       : sampleCounter++ % sampleRate.load(std::memory_order_relaxed) == 0; // Top level: sample
+            }
+            open(decision); // Apply the decision
+        }
+
+        /**
+         * @brief Following constructor implementation
+         * @param name Event name (string literal)
+         * @param category Event category (string literal)
+         * @param follow recording() of the thread that started the work
+         */
+        Scope::Scope(const char *name, const char *category, bool follow) : name(name), category(category) // Following constructor definition
+        {
+            open(follow && running.load(std::memory_order_relaxed)); // Record exactly when the originator does
+        }
+
+        /**
+         * @brief Destructor implementation
+         */
+        Scope::~Scope() // Destructor definition
+        {
+            insideScope = outerOpen;          // Restore the enclosing state
+            insideRecording = outerRecording; // Restore the enclosing state
+            if (!record)                      // Not sampled
+            {
+                return; // Nothing to write
+            }
+            RingBuffer &buffer = threadBuffer();                              // This thread's ring
+            uint64_t slot = buffer.head.load(std::memory_order_relaxed);      // Next slot (only this thread writes)
+            Event &e = buffer.events[slot % BufferEvents];                    // Slot to fill
+            e.name.store(name, std::memory_order_relaxed);                    // Event name
+            e.category.store(category, std::memory_order_relaxed);            // Event category
+            e.start.store(start, std::memory_order_relaxed);                  // Start time
+            e.duration.store(now() - start, std::memory_order_relaxed);       // Duration
+            buffer.head.store(slot + 1, std::memory_order_release);           // Publish the event
+        }
+    } // End of the tracing namespace
+} // End of squaremat namespace
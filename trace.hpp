@@ -0,0 +1,128 @@
+// orel8155@gmail.com
+#pragma once      // Ensures the header file is included only once
+#include <cstddef>  // Include for size_t
+#include <cstdint>  // Include for uint64_t
+#include <ostream>  // Include for the JSON output
+
+/**
+ * @file trace.hpp
+ * @brief Scoped timeline events of SquareMat operators in Chrome trace format
+ *
+ * Operators and their internal phases (allocate, pack, kernel, reduce) open a
+ * SQUAREMAT_TRACE_SCOPE. While tracing is started, every sampled top-level scope and
+ * everything nested in it is written as one complete event to a fixed-size ring buffer
+ * owned by the recording thread; the writer never takes a lock. writeChromeJson() turns
+ * the buffers into a file that chrome://tracing and ui.perfetto.dev load directly.
+ * Defining SQUAREMAT_NO_TRACE compiles the scopes out.
+ */
+namespace squaremat // Start of namespace definition
+{
+    namespace trace // Start of the tracing namespace
+    {
+        static constexpr size_t BufferEvents = size_t(1) << 14; ///< Events kept per thread (oldest are overwritten)
+
+        /**
+         * @brief Start recording
+         * @param sampleEvery Record one in every sampleEvery top-level scopes per thread (1 records all)
+         */
+        void start(unsigned sampleEvery = 1); // Declaration of start
+
+        /**
+         * @brief Stop recording (buffered events are kept until clear())
+         */
+        void stop(); // Declaration of stop
+
+        /**
+         * @brief Check whether recording is on
+         * @return true between start() and stop()
+         */
+        bool active(); // Declaration of the state check
+
+        /**
+         * @brief Change the sampling rate while recording
+         * @param sampleEvery Record one in every sampleEvery top-level scopes per thread (0 is treated as 1)
+         */
+        void setSampleRate(unsigned sampleEvery); // Declaration of the sampling knob
+
+        /**
+         * @brief Check whether the innermost scope on this thread is being recorded
+         * @return true inside a recorded scope
+         */
+        bool recording(); // Declaration of the nesting check
+
+        /**
+         * @brief Drop every buffered event (call while no thread is inside a recorded scope)
+         */
+        void clear(); // Declaration of clear
+
+        /**
+         * @brief Number of events currently held in all buffers
+         * @return Event count
+         */
+        size_t eventCount(); // Declaration of the event count
+
+        /**
+         * @brief Write the buffered events as Chrome trace JSON
+         * @param os Output stream
+         */
+        void writeChromeJson(std::ostream &os); // Declaration of the flush
+
+        /**
+         * @class Scope
+         * @brief One complete ("X") event from construction to destruction
+         */
+        class Scope // Class definition for the trace scope
+        {
+        private:
+            const char *name;     ///< Event name (must be a string literal)
+            const char *category; ///< Event category (must be a string literal)
+            bool record;          ///< Whether this scope is recorded
+            bool outerRecording;  ///< Recording state of the enclosing scope
+            bool outerOpen;       ///< Whether there was an enclosing scope
+            uint64_t start;       ///< Start time in nanoseconds since the trace epoch
+
+            /**
+             * @brief Open the scope with a known recording decision
+             * @param decision Whether to record
+             */
+            void open(bool decision); // Declaration of the common setup
+
+        public:
+            /**
+             * @brief Open a scope; top-level scopes are sampled, nested ones follow their parent
+             * @param name Event name (string literal)
+             * @param category Event category (string literal)
+             */
+            Scope(const char *name, const char *category); // Declaration of constructor
+
+            /**
+             * @brief Open a scope that follows a decision made on another thread
+             *
+             * Used by parallel chunks so the work of a sampled operator is recorded on
+             * every worker that runs part of it.
+             * @param name Event name (string literal)
+             * @param category Event category (string literal)
+             * @param follow recording() of the thread that started the work
+             */
+            Scope(const char *name, const char *category, bool follow); // Declaration of the following constructor
+
+            /**
+             * @brief Close the scope and write the event if it was recorded
+             */
+            ~Scope(); // Declaration of destructor
+
+            Scope(const Scope &) = delete;            // Scopes are not copyable
+            Scope &operator=(const Scope &) = delete; // Scopes are not assignable
+        };
+    } // End of the tracing namespace
+} // End of namespace
+
+#if defined(SQUAREMAT_NO_TRACE)
+#define SQUAREMAT_TRACE_SCOPE(name, category) ((void)0)
+#define SQUAREMAT_TRACE_FOLLOW(name, category, follow) ((void)0)
+#define SQUAREMAT_TRACE_RECORDING() false
+#else
+#define SQUAREMAT_TRACE_SCOPE(name, category) ::squaremat::trace::Scope traceScope(name, category)
+#define SQUAREMAT_TRACE_FOLLOW(name, category, follow) ::squaremat::trace::Scope traceScope(name, category, follow)
+#define SQUAREMAT_TRACE_RECORDING() ::squaremat::trace::recording()
+#endif